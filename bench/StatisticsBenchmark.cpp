@@ -0,0 +1,147 @@
+// StatisticsDAO 基准测试
+// 用法: ./bin/statistics_benchmark [行数=1000000] [数据库路径=bench_statistics.db]
+// 生成指定行数的 tasks（以及一半数量的 pomodoro_sessions），然后逐个计时 StatisticsDAO 的方法。
+
+#include "database/DatabaseManager.h"
+#include "database/DAO/StatisticsDAO.h"
+#include "statistics/StreakTracker.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+    const int HISTORY_DAYS = 730;
+
+    std::string randomTimestamp(std::mt19937& rng, int today) {
+        int day = today - static_cast<int>(rng() % HISTORY_DAYS);
+        int secs = static_cast<int>(rng() % 86400);
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%s %02d:%02d:%02d", StreakTracker::dateFromDay(day).c_str(),
+                      secs / 3600, (secs / 60) % 60, secs % 60);
+        return buf;
+    }
+
+    void populate(sqlite3* db, int rows) {
+        std::mt19937 rng(42);
+        int today = StreakTracker::today();
+
+        sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+
+        sqlite3_stmt* task = nullptr;
+        sqlite3_prepare_v2(db,
+            "INSERT INTO tasks (title, priority, completed, created_date, completed_date, completed_day) "
+            "VALUES (?1, ?2, ?3, ?4, ?5, CAST(julianday(substr(?5, 1, 10)) - 2440587.5 AS INTEGER));",
+            -1, &task, nullptr);
+        for (int i = 0; i < rows; ++i) {
+            std::string created = randomTimestamp(rng, today);
+            bool completed = rng() % 10 < 7;
+            sqlite3_bind_text(task, 1, "benchmark task", -1, SQLITE_STATIC);
+            sqlite3_bind_int(task, 2, static_cast<int>(rng() % 3));
+            sqlite3_bind_int(task, 3, completed ? 1 : 0);
+            sqlite3_bind_text(task, 4, created.c_str(), -1, SQLITE_TRANSIENT);
+            if (completed) {
+                std::string done = randomTimestamp(rng, today);
+                sqlite3_bind_text(task, 5, done.c_str(), -1, SQLITE_TRANSIENT);
+            } else {
+                sqlite3_bind_null(task, 5);
+            }
+            sqlite3_step(task);
+            sqlite3_reset(task);
+        }
+        sqlite3_finalize(task);
+
+        sqlite3_stmt* session = nullptr;
+        sqlite3_prepare_v2(db,
+            "INSERT INTO pomodoro_sessions (task_id, start_time, duration, completed, interrupted, start_day, focus_seconds) "
+            "VALUES (?1, ?2, 25, ?3, ?4, CAST(julianday(substr(?2, 1, 10)) - 2440587.5 AS INTEGER), ?5);",
+            -1, &session, nullptr);
+        for (int i = 0; i < rows / 2; ++i) {
+            std::string start = randomTimestamp(rng, today);
+            bool interrupted = rng() % 10 == 0;
+            sqlite3_bind_int(session, 1, 1 + static_cast<int>(rng() % rows));
+            sqlite3_bind_text(session, 2, start.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int(session, 3, interrupted ? 0 : 1);
+            sqlite3_bind_int(session, 4, interrupted ? 1 : 0);
+            sqlite3_bind_int(session, 5, interrupted ? static_cast<int>(rng() % 1500) : 1500);
+            sqlite3_step(session);
+            sqlite3_reset(session);
+        }
+        sqlite3_finalize(session);
+
+        sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+        sqlite3_exec(db, "ANALYZE;", nullptr, nullptr, nullptr);
+    }
+
+    void measure(const std::string& name, const std::function<void()>& fn) {
+        const int runs = 5;
+        double best = 1e18, total = 0;
+        for (int i = 0; i < runs; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = std::min(best, ms);
+            total += ms;
+        }
+        std::printf("  %-32s best %9.3f ms   avg %9.3f ms\n", name.c_str(), best, total / runs);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int rows = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::string dbPath = argc > 2 ? argv[2] : "bench_statistics.db";
+
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::filesystem::remove(dbPath + suffix);
+    }
+
+    auto& dbManager = DatabaseManager::getInstance();
+    if (!dbManager.initialize(dbPath)) {
+        std::cerr << "无法初始化数据库: " << dbPath << std::endl;
+        return 1;
+    }
+
+    std::cout << "生成 " << rows << " 条任务记录..." << std::endl;
+    auto genStart = std::chrono::steady_clock::now();
+    populate(dbManager.getRawConnection(), rows);
+    std::cout << "  用时 " << std::chrono::duration<double>(std::chrono::steady_clock::now() - genStart).count()
+              << " s\n" << std::endl;
+
+    auto dao = createStatisticsDAO();
+    auto now = std::chrono::system_clock::now();
+    auto monthAgo = now - std::chrono::hours(24 * 30);
+    auto yearAgo = now - std::chrono::hours(24 * 365);
+    int today = StreakTracker::today();
+    std::string ymd = StreakTracker::dateFromDay(today);
+    int year = std::atoi(ymd.substr(0, 4).c_str());
+    int month = std::atoi(ymd.substr(5, 2).c_str());
+
+    std::cout << "StatisticsDAO (" << rows << " rows):" << std::endl;
+    measure("getDailyCompletionStats", [&] { dao->getDailyCompletionStats(now); });
+    measure("getWeeklyCompletionStats", [&] { dao->getWeeklyCompletionStats(now - std::chrono::hours(24 * 6)); });
+    measure("getMonthlyCompletionStats", [&] { dao->getMonthlyCompletionStats(year, month); });
+    measure("getHeatmapData(365)", [&] { dao->getHeatmapData(365); });
+    measure("getCompletionCountByDate(30d)", [&] { dao->getCompletionCountByDate(monthAgo, now); });
+    measure("getCompletedCount(30d)", [&] { dao->getCompletedCount(monthAgo, now); });
+    measure("generateProductivityReport(1y)", [&] { dao->generateProductivityReport(yearAgo, now); });
+    measure("getPomodoroStatistics(30d)", [&] { dao->getPomodoroStatistics(monthAgo, now); });
+    measure("getPomodoroFocusByDay(30)", [&] { dao->getPomodoroFocusByDay(monthAgo, 30); });
+    measure("getPomodoroFocusByTask(30d)", [&] { dao->getPomodoroFocusByTask(monthAgo, now); });
+    measure("getPomodoroFocusForTask", [&] { dao->getPomodoroFocusForTask(1); });
+    measure("getCompletionTrend(30)", [&] { dao->getCompletionTrend(30); });
+    measure("getProductivityTrend(30)", [&] { dao->getProductivityTrend(30); });
+    measure("getCurrentCompletionStreak", [&] { dao->getCurrentCompletionStreak(); });
+    measure("getLongestCompletionStreak", [&] { dao->getLongestCompletionStreak(); });
+    measure("getStreakHistory", [&] { dao->getStreakHistory(); });
+    measure("getChallengeCompletionStats", [&] { dao->getChallengeCompletionStats(); });
+    measure("getAchievementUnlockStats", [&] { dao->getAchievementUnlockStats(); });
+    measure("getOverallStatistics", [&] { dao->getOverallStatistics(); });
+
+    dao.reset();
+    dbManager.close();
+    return 0;
+}
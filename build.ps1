@@ -15,19 +15,34 @@ $SOURCES = @(
     "src\database\databasemanager.cpp",
     "src\database\DAO\ProjectDAO.cpp",
     "src\database\DAO\AchievementDAO.cpp",
+    "src\database\DAO\ExperienceDAO.cpp",
+    "src\database\DAO\StatisticsDAO.cpp",
+    "src\database\DAO\HeatmapVisualizerDao.cpp",
+    "src\database\DAO\PomodoroSessionDAO.cpp",
     "src\achievement\AchievementManager.cpp",
+    "src\achievement\AchievementRules.cpp",
     "src\database\DAO\ReminderDAO.cpp",
     "src\reminder\ReminderSystem.cpp",
+    "src\reminder\TimingWheel.cpp",
+    "src\reminder\Recurrence.cpp",
     "src\database\DAO\TaskDAOImpl.cpp",
     "src\project\Project.cpp",
     "src\project\ProjectManager.cpp",
     "src\statistics\StatisticsAnalyzer.cpp",
+    "src\statistics\StreakTracker.cpp",
+    "src\statistics\ReportExecutor.cpp",
     "src\gamification\XPSystem.cpp",
+    "src\gamification\UserProfileCache.cpp",
+    "src\gamification\EventBus.cpp",
     "src\HeatmapVisualizer\HeatmapVisualizer.cpp",
     "src\ui\UIManager.cpp",
     "src\task\task.cpp",
     "src\task\TaskManager.cpp",
-    "src\Pomodoro\pomodoro.cpp"
+    "src\task\TagRegistry.cpp",
+    "src\Pomodoro\pomodoro.cpp",
+    "src\Pomodoro\TimerService.cpp",
+    "src\Pomodoro\PomodoroSessionLog.cpp",
+    "src\Pomodoro\PomodoroEngine.cpp"
 )
 
 # Create directories
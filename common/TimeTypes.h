@@ -0,0 +1,214 @@
+// common/TimeTypes.h
+#ifndef TIME_TYPES_H
+#define TIME_TYPES_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+/**
+ * @brief 时间值类型 - 内存与数据库中统一保存为整数，只在 API 边界（CLI / Web / Qt）格式化
+ *
+ * Timestamp 对应 reminders.trigger_epoch / anchor_epoch（epoch 秒），
+ * DayNumber 对应 tasks.due_day / completed_day（自 1970-01-01 起的天数）。
+ * 调度器与统计的热路径只做整数比较和加减，不再解析 "YYYY-MM-DD HH:MM:SS" 字符串。
+ */
+namespace civil {
+    // Howard Hinnant 的 civil date 算法：公历日期 <-> 自 1970-01-01 起的天数
+    constexpr int daysFromCivil(int y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        const int era = (y >= 0 ? y : y - 399) / 400;
+        const unsigned yoe = static_cast<unsigned>(y - era * 400);
+        const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int>(doe) - 719468;
+    }
+
+    constexpr void civilFromDays(int z, int& y, unsigned& m, unsigned& d) {
+        z += 719468;
+        const int era = (z >= 0 ? z : z - 146096) / 146097;
+        const unsigned doe = static_cast<unsigned>(z - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp < 10 ? mp + 3 : mp - 9;
+        y = static_cast<int>(yoe) + era * 400 + (m <= 2);
+    }
+
+    // 周一 = 0 ... 周日 = 6；1970-01-01 是周四
+    constexpr int weekday(int day) {
+        return ((day % 7) + 7 + 3) % 7;
+    }
+
+    constexpr int daysInMonth(int y, unsigned m) {
+        return m == 12 ? 31 : daysFromCivil(y, m + 1, 1) - daysFromCivil(y, m, 1);
+    }
+
+    constexpr std::int64_t floorDiv(std::int64_t a, std::int64_t b) {
+        return a >= 0 ? a / b : -((-a + b - 1) / b);
+    }
+
+    // 线程安全的 localtime
+    inline void toLocalTm(std::time_t t, std::tm& tm) {
+#if defined(_WIN32) || defined(_WIN64)
+        localtime_s(&tm, &t);
+#else
+        localtime_r(&t, &tm);
+#endif
+    }
+}
+
+/**
+ * @brief 日期：自 1970-01-01 起的天数
+ */
+struct DayNumber {
+    static constexpr std::int64_t SECONDS_PER_DAY = 86400;
+
+    std::int32_t value = 0;
+
+    constexpr DayNumber() = default;
+    constexpr explicit DayNumber(std::int32_t day) : value(day) {}
+
+    static constexpr DayNumber fromCivil(int y, unsigned m, unsigned d) {
+        return DayNumber(civil::daysFromCivil(y, m, d));
+    }
+
+    // UTC 日期，与 datetime('now') 写入的 completed_date 一致
+    static DayNumber todayUtc() {
+        return DayNumber(static_cast<std::int32_t>(civil::floorDiv(std::time(nullptr), SECONDS_PER_DAY)));
+    }
+
+    // 解析 "YYYY-MM-DD"（之后的时间部分被忽略），失败返回 false
+    static bool parse(const std::string& text, DayNumber& day) {
+        int y = 0;
+        unsigned m = 0, d = 0;
+        if (std::sscanf(text.c_str(), "%d-%u-%u", &y, &m, &d) != 3 ||
+            m < 1 || m > 12 || d < 1 || d > 31) {
+            return false;
+        }
+        day = fromCivil(y, m, d);
+        return true;
+    }
+
+    constexpr void toCivil(int& y, unsigned& m, unsigned& d) const {
+        civil::civilFromDays(value, y, m, d);
+    }
+
+    constexpr int weekday() const { return civil::weekday(value); }
+
+    std::string toString() const {
+        int y = 0;
+        unsigned m = 0, d = 0;
+        toCivil(y, m, d);
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u", y, m, d);
+        return buf;
+    }
+
+    constexpr DayNumber operator+(int days) const { return DayNumber(value + days); }
+    constexpr DayNumber operator-(int days) const { return DayNumber(value - days); }
+    constexpr int operator-(DayNumber other) const { return value - other.value; }
+    constexpr bool operator==(DayNumber other) const { return value == other.value; }
+    constexpr bool operator!=(DayNumber other) const { return value != other.value; }
+    constexpr bool operator<(DayNumber other) const { return value < other.value; }
+    constexpr bool operator<=(DayNumber other) const { return value <= other.value; }
+    constexpr bool operator>(DayNumber other) const { return value > other.value; }
+    constexpr bool operator>=(DayNumber other) const { return value >= other.value; }
+};
+
+/**
+ * @brief 时间点：epoch 秒，字符串形式统一为本地时间 "YYYY-MM-DD HH:MM:SS"
+ */
+struct Timestamp {
+    std::int64_t seconds = 0;
+
+    constexpr Timestamp() = default;
+    constexpr explicit Timestamp(std::int64_t epochSeconds) : seconds(epochSeconds) {}
+
+    static Timestamp now() { return Timestamp(std::time(nullptr)); }
+
+    static Timestamp fromTimePoint(const std::chrono::system_clock::time_point& tp) {
+        return Timestamp(std::chrono::system_clock::to_time_t(tp));
+    }
+
+    // 解析本地时间 "YYYY-MM-DD HH:MM:SS"，夏令时由 mktime 判断；失败返回 false
+    static bool parseLocal(const std::string& text, Timestamp& ts) {
+        int y, mo, d, h, mi, s;
+        if (std::sscanf(text.c_str(), "%d-%d-%d %d:%d:%d", &y, &mo, &d, &h, &mi, &s) != 6 ||
+            mo < 1 || mo > 12 || d < 1 || d > 31 || h < 0 || h > 23 || mi < 0 || mi > 59 || s < 0 || s > 60) {
+            return false;
+        }
+        std::tm tm = {};
+        tm.tm_year = y - 1900;
+        tm.tm_mon = mo - 1;
+        tm.tm_mday = d;
+        tm.tm_hour = h;
+        tm.tm_min = mi;
+        tm.tm_sec = s;
+        tm.tm_isdst = -1;
+        const std::time_t t = std::mktime(&tm);
+        if (t == -1) {
+            return false;
+        }
+        ts = Timestamp(t);
+        return true;
+    }
+
+    // 本地日历上 day 当天的零点
+    static Timestamp startOfLocalDay(DayNumber day) {
+        int y = 0;
+        unsigned m = 0, d = 0;
+        day.toCivil(y, m, d);
+        std::tm tm = {};
+        tm.tm_year = y - 1900;
+        tm.tm_mon = static_cast<int>(m) - 1;
+        tm.tm_mday = static_cast<int>(d);
+        tm.tm_isdst = -1;
+        return Timestamp(std::mktime(&tm));
+    }
+
+    std::time_t toTimeT() const { return static_cast<std::time_t>(seconds); }
+
+    std::chrono::system_clock::time_point toTimePoint() const {
+        return std::chrono::system_clock::from_time_t(toTimeT());
+    }
+
+    std::string toLocalString() const {
+        std::tm tm = {};
+        civil::toLocalTm(toTimeT(), tm);
+        char buf[32];
+        std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+        return buf;
+    }
+
+    // 本地日历上的日期
+    DayNumber localDay() const {
+        std::tm tm = {};
+        civil::toLocalTm(toTimeT(), tm);
+        return DayNumber::fromCivil(tm.tm_year + 1900, static_cast<unsigned>(tm.tm_mon + 1),
+                                    static_cast<unsigned>(tm.tm_mday));
+    }
+
+    constexpr DayNumber utcDay() const {
+        return DayNumber(static_cast<std::int32_t>(civil::floorDiv(seconds, DayNumber::SECONDS_PER_DAY)));
+    }
+
+    constexpr Timestamp operator+(std::int64_t delta) const { return Timestamp(seconds + delta); }
+    constexpr Timestamp operator-(std::int64_t delta) const { return Timestamp(seconds - delta); }
+    constexpr std::int64_t operator-(Timestamp other) const { return seconds - other.seconds; }
+    constexpr bool operator==(Timestamp other) const { return seconds == other.seconds; }
+    constexpr bool operator!=(Timestamp other) const { return seconds != other.seconds; }
+    constexpr bool operator<(Timestamp other) const { return seconds < other.seconds; }
+    constexpr bool operator<=(Timestamp other) const { return seconds <= other.seconds; }
+    constexpr bool operator>(Timestamp other) const { return seconds > other.seconds; }
+    constexpr bool operator>=(Timestamp other) const { return seconds >= other.seconds; }
+};
+
+static_assert(DayNumber::fromCivil(1970, 1, 1).value == 0 && DayNumber::fromCivil(2000, 3, 1).value == 11017);
+static_assert(DayNumber::fromCivil(1970, 1, 1).weekday() == 3 && civil::daysInMonth(2024, 2) == 29);
+static_assert(Timestamp(-1).utcDay().value == -1 && Timestamp(86400).utcDay().value == 1);
+
+#endif // TIME_TYPES_H
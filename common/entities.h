@@ -6,8 +6,7 @@
 #include <vector>
 #include <chrono>
 #include <map>
-#include <sstream>
-#include <iomanip>
+#include "TimeTypes.h"
 
 /**
  * @brief 任务状态枚举
@@ -126,43 +125,35 @@ struct Reminder {
     int id;
     std::string title;
     std::string message;
-    std::string trigger_time;
-    std::chrono::system_clock::time_point triggerTime; // 精确时间点，便于数据库计算
+    Timestamp triggerAt;        // 下一次触发时间（reminders.trigger_epoch）
+    Timestamp anchorAt;         // 重复规则的起点，即首次触发时间（reminders.anchor_epoch）
     ReminderType type;
     ReminderStatus status;
-    std::string recurrence; // "once", "daily", "weekly", "monthly"
-    std::string recurrenceRule;
+    std::string recurrence;     // 分类："once", "daily", "weekly", "monthly"
+    std::string recurrenceRule; // 完整规则，例如 "FREQ=WEEKLY;BYDAY=MO,WE"
     bool triggered;
     int task_id;
-    int taskId;
     bool enabled;
     std::string last_triggered;
 
     Reminder()
         : id(0),
-          triggerTime(std::chrono::system_clock::now()),
+          triggerAt(Timestamp::now()),
+          anchorAt(triggerAt),
           type(ReminderType::ONCE),
           status(ReminderStatus::PENDING),
+          recurrence("once"),
+          recurrenceRule("once"),
           triggered(false),
           task_id(0),
-          taskId(0),
-          enabled(true) {
-        recurrenceRule = recurrence;
-    }
+          enabled(true) {}
 
     Reminder(int id, const std::string& title, const std::string& message,
-             const std::string& trigger_time, const std::string& recurrence = "once",
+             Timestamp triggerAt, const std::string& recurrence = "once",
              int task_id = 0)
-        : id(id), title(title), message(message), trigger_time(trigger_time),
-          recurrence(recurrence), triggered(false), task_id(task_id), taskId(task_id),
-          enabled(true) {
-        // 将字符串时间解析为 time_point，便于 DAO 复用
-        std::tm tm = {};
-        std::istringstream ss(trigger_time);
-        ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-        std::time_t tt = ss.fail() ? std::time(nullptr) : std::mktime(&tm);
-        triggerTime = std::chrono::system_clock::from_time_t(tt);
-
+        : id(id), title(title), message(message), triggerAt(triggerAt), anchorAt(triggerAt),
+          status(ReminderStatus::PENDING), recurrence(recurrence), recurrenceRule(recurrence),
+          triggered(false), task_id(task_id), enabled(true) {
         if (recurrence == "daily") {
             type = ReminderType::DAILY;
         } else if (recurrence == "weekly") {
@@ -172,9 +163,6 @@ struct Reminder {
         } else {
             type = ReminderType::ONCE;
         }
-
-        status = triggered ? ReminderStatus::TRIGGERED : ReminderStatus::PENDING;
-        recurrenceRule = recurrence;
     }
 };
 
@@ -244,6 +232,7 @@ struct UserSettings : BaseEntity {
     std::string theme = "default";       // 主题设置
     std::string language = "zh";         // 语言设置
     bool auto_start_pomodoros = false;   // 是否自动开始番茄钟
+    int user_id = 1;                     // 所属用户
     
     UserSettings() = default;
 };
@@ -334,6 +323,33 @@ struct PomodoroStatistics {
     double averagePomodorosPerDay = 0.0;
 };
 
+/**
+ * @brief 番茄钟会话 - 对应 pomodoro_sessions 表的一行，会话结束（完成或中断）时整行追加
+ */
+struct PomodoroSession {
+    int taskId = -1;                    // -1 表示未关联任务
+    Timestamp startAt;
+    Timestamp endAt;
+    int plannedMinutes = 0;             // 写入 duration 列
+    int focusSeconds = 0;               // 实际专注时长
+    bool completed = false;
+    bool interrupted = false;
+    std::string interruptionReason;
+};
+
+/**
+ * @brief 番茄钟专注统计 - 按天或按任务汇总 pomodoro_sessions
+ */
+struct PomodoroFocusStats {
+    std::string date;                   // 按任务汇总时为空
+    int taskId = -1;                    // 按天汇总时为 -1
+    int sessions = 0;
+    int completed = 0;
+    int interrupted = 0;
+    int focusMinutes = 0;
+    double interruptionRate = 0.0;      // interrupted / sessions
+};
+
 /**
  * @brief 连续记录 - 统计系统
  */
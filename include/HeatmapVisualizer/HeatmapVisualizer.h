@@ -2,24 +2,49 @@
 #define HEATMAP_VISUALIZER_H
 
 #include <string>
+#include <list>
 #include <map>
+#include <unordered_map>
 #include <vector>
-#include <sqlite3.h>
+#include <cstdint>
 
 using namespace std;
 
 class HeatmapVisualizer {
 private:
-    sqlite3* db;
     string dbPath;
     
-    bool openDatabase();
-    void closeDatabase();
+    // 按天索引的紧凑网格：dayGrid[i] 为 baseDay + i（UTC 天数）的完成数，覆盖全部历史（可跨多年）
+    // intensity[i] 为对应的颜色档位 0-3，加载时一次遍历算出
+    // 只有 tasks 表版本号变化（或跨天）时才重新查询一次
+    mutable vector<uint16_t> dayGrid;
+    mutable vector<uint8_t> intensity;
+    mutable int baseDay;
+    mutable int cachedToday;
+    mutable uint64_t cachedVersion;
+    mutable bool cacheValid;
+    mutable int totalCompleted;
     
-    string getColorBlock(int count);
+    // 从快照加载的热力图不再跟随数据库，"今天"取快照的最后一天
+    bool detached;
+    
+    // 渲染结果缓存：key 为 "视图:范围"，数据版本变化时整体清空。
+    // 范围来自调用方（Web 路由的月份/日期参数），按最近使用保留至多 MAX_RENDERED 项
+    static constexpr size_t MAX_RENDERED = 32;
+    using RenderedList = list<pair<string, string>>;
+    mutable RenderedList renderOrder;      // 最近使用的在前
+    mutable unordered_map<string, RenderedList::iterator> renderCache;
+    
+    void refreshCache() const;
+    void computeIntensity() const;
+    int currentDay() const;
+    int countForDay(int day);
+    int levelForDay(int day);
+    const string* findRendered(const string& key);
+    const string& storeRendered(const string& key, string rendered);
+    
+    static const string& getColorBlock(int level);
     int getTaskCount(string date);
-    map<string, int> getTaskDataFromDB(int days);
-    vector<string> generateDateRange(int days);
     
 public:
     HeatmapVisualizer();
@@ -32,9 +57,31 @@ public:
     string generateMonthView(string month);
     string generateWeekView(string startDate);
     
+    /**
+     * @brief 最近 days 天中有完成记录的日期 -> 完成数（来自缓存）
+     */
+    map<string, int> getCompletionData(int days = 90);
+    
     int getTotalTasks();
     string getMostActiveDay();
     int getCurrentStreak();
+    
+    // === 快照（供 HeatmapVisualizerDAO 持久化） ===
+    
+    /**
+     * @brief 网格起始日（自 1970-01-01 起的 UTC 天数）
+     */
+    int getBaseDay() const;
+    
+    /**
+     * @brief 按天的完成数网格，第 i 项对应 getBaseDay() + i
+     */
+    const vector<uint16_t>& getDayGrid() const;
+    
+    /**
+     * @brief 用快照数据替换当前网格，之后不再从数据库刷新
+     */
+    void loadSnapshot(int baseDay, const uint16_t* counts, size_t dayCount);
 };
 
 #endif
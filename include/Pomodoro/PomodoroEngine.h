@@ -0,0 +1,184 @@
+#ifndef POMODORO_ENGINE_H
+#define POMODORO_ENGINE_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "common/entities.h"
+#include "Pomodoro/TimerService.h"
+
+class TaskDAO;
+class XPSystem;
+
+enum class PomodoroPhase { Idle, Work, ShortBreak, LongBreak };
+
+// "idle" / "work" / "short_break" / "long_break"
+const char* pomodoroPhaseName(PomodoroPhase phase);
+bool parsePomodoroPhase(const std::string& name, PomodoroPhase& phase);
+
+// 一个会话使用的时长配置，默认取自该用户的 user_settings
+struct PomodoroConfig {
+    int workMinutes = 25;
+    int shortBreakMinutes = 5;
+    int longBreakMinutes = 15;
+    int pomodorosUntilLongBreak = 4;
+    bool autoStart = false;         // 一段结束后自动开始下一段
+
+    int minutesOf(PomodoroPhase phase) const;
+};
+
+/**
+ * @brief 会话状态快照 - 发布后不再修改，读取方持有 shared_ptr 即可无锁访问
+ *
+ * 截止时间以服务端 steady_clock 为准；客户端只根据 remainingMs 重新对齐显示，
+ * 断线重连后再取一次快照就能精确恢复倒计时。
+ */
+struct PomodoroState {
+    using Clock = TimerService::Clock;
+
+    int userId = 1;
+    std::string sessionId;
+    PomodoroPhase phase = PomodoroPhase::Idle;      // 正在进行的阶段，Idle 表示没有计时
+    PomodoroPhase nextPhase = PomodoroPhase::Work;  // 空闲时下一次开始的阶段
+    bool paused = false;
+    bool lastPhaseCompleted = false;    // 上一阶段是正常到期还是被停止
+    int taskId = -1;
+    int completedInCycle = 0;       // 距上次长休息完成的工作时段数
+    int completedTotal = 0;
+    PomodoroConfig config;
+    int phaseSeconds = 0;           // 当前阶段的总时长
+    Clock::time_point deadline;     // 运行中有效
+    std::int64_t pausedRemainingMs = 0;
+    std::uint64_t revision = 0;     // 每次状态变化递增，客户端可据此判断是否需要重绘
+
+    bool isActive() const { return phase != PomodoroPhase::Idle; }
+    bool isRunning() const { return isActive() && !paused; }
+    // 剩余毫秒数，空闲时为 0
+    std::int64_t remainingMs(Clock::time_point now = Clock::now()) const;
+    // 剩余秒数（向上取整），空闲时为 -1
+    int remainingSeconds() const;
+};
+
+using PomodoroStatePtr = std::shared_ptr<const PomodoroState>;
+
+/**
+ * @brief 番茄钟状态机 - 按 (用户, 会话) 管理多个独立的番茄钟
+ *
+ * 工作 → 短休息 → 工作 → ... 第 pomodoros_until_long_break 个工作时段之后进入长休息，
+ * 长休息结束后重新计数。所有计时都在共享的 TimerService 上进行，
+ * 到期由服务端推进状态，Web 端和 Qt 界面只读取快照，不再各自维护倒计时。
+ *
+ * 状态变化都在 mutex 下完成并发布新快照；取消计时器和调用回调都在锁外进行。
+ * 工作时段结束或被中断时写入 pomodoro_sessions（经 PomodoroSessionLog 批量写入）。
+ * 工作时段到期完成时由引擎发放经验值、给关联任务的番茄数加一并发布 PomodoroCompleted，
+ * 每个时段只发放一次，与打开了几个客户端无关；客户端只读取状态。
+ */
+class PomodoroEngine {
+public:
+    using TickCallback = std::function<void(int)>;
+    // 参数 true 表示阶段正常完成，false 表示被停止或被新开始的阶段替换
+    using FinishCallback = std::function<void(bool)>;
+
+    static PomodoroEngine& getInstance();
+
+    PomodoroEngine(const PomodoroEngine&) = delete;
+    PomodoroEngine& operator=(const PomodoroEngine&) = delete;
+
+    // 会话不存在时返回按用户设置初始化的空闲状态
+    PomodoroStatePtr getState(int userId, const std::string& sessionId);
+
+    /**
+     * @brief 开始一个阶段，正在进行的阶段以“中断”结束
+     * @param phase Idle 表示开始状态机给出的下一阶段
+     * @param onTick / onFinish 只对本阶段有效：暂停后继续仍会回调，自动开始的下一阶段不会
+     */
+    PomodoroStatePtr start(int userId, const std::string& sessionId,
+                           PomodoroPhase phase = PomodoroPhase::Idle,
+                           TickCallback onTick = nullptr,
+                           FinishCallback onFinish = nullptr);
+
+    // 停止当前阶段；工作时段以 reason 作为中断原因记录，下一阶段回到工作
+    PomodoroStatePtr stop(int userId, const std::string& sessionId, const std::string& reason = "");
+    PomodoroStatePtr pause(int userId, const std::string& sessionId);
+    PomodoroStatePtr resume(int userId, const std::string& sessionId);
+
+    // 之后开始的工作时段关联的任务，-1 表示不关联
+    PomodoroStatePtr setTaskId(int userId, const std::string& sessionId, int taskId);
+    // 覆盖该会话的时长配置（不写回 user_settings），对之后开始的阶段生效
+    PomodoroStatePtr setConfig(int userId, const std::string& sessionId, const PomodoroConfig& config);
+    // 用户设置修改后重新读取；未覆盖配置的会话在下一阶段开始时生效
+    void reloadConfig(int userId);
+    PomodoroStatePtr resetCounters(int userId, const std::string& sessionId);
+
+    // 移除空闲会话，正在计时的会话不移除
+    bool removeSession(int userId, const std::string& sessionId);
+    size_t sessionCount();
+
+    // 中断所有会话并记录（进程退出时调用）
+    void shutdown(const std::string& reason = "shutdown");
+
+    // 读取用户的番茄钟设置，没有设置行时返回默认值
+    static PomodoroConfig loadConfig(int userId);
+
+private:
+    PomodoroEngine();
+    ~PomodoroEngine();
+
+    using Key = std::pair<int, std::string>;
+    using Clock = TimerService::Clock;
+
+    struct Session {
+        PomodoroStatePtr state;
+        bool configOverridden = false;
+        TimerHandle timer;
+        std::uint64_t generation = 0;   // 每次启动、暂停、停止递增，过期的到期回调据此忽略
+        TickCallback onTick;
+        FinishCallback onFinish;
+
+        // 当前工作时段的记录；暂停期间不计入专注时长
+        PomodoroSession record;
+        Clock::duration focused{0};
+        Clock::time_point runningSince;
+    };
+
+    // 锁外需要完成的收尾：取消计时器、写入记录、通知回调
+    struct Aftermath {
+        TimerHandle timer;
+        bool hasRecord = false;
+        PomodoroSession record;
+        FinishCallback onFinish;
+        bool completed = false;
+
+        void run();
+    };
+
+    std::mutex mutex;
+    std::map<Key, Session> sessions;
+    
+    // 完成奖励在计时线程上发放，首次使用时才创建，避免在数据库打开前访问
+    std::once_flag rewardsInit;
+    std::unique_ptr<XPSystem> xpSystem;
+    std::unique_ptr<TaskDAO> taskDAO;
+    std::map<int, PomodoroConfig> userConfigs;  // 按用户缓存的 user_settings
+
+    Session& sessionFor(const Key& key, const PomodoroConfig& config);  // 调用方持有 mutex
+    PomodoroConfig configFor(int userId);       // 不能持有 mutex
+
+    static void publish(Session& session, PomodoroState state);
+    // 开始阶段，调用方持有 mutex；previous 收到被替换阶段的收尾
+    void beginPhase(const Key& key, Session& session, PomodoroPhase phase,
+                    TickCallback onTick, FinishCallback onFinish, Aftermath& previous);
+    // 结束当前阶段并移出计时器、回调和记录，调用方持有 mutex
+    void endPhase(Session& session, bool completed, const std::string& reason, Aftermath& out);
+    void armTimer(const Key& key, Session& session, Clock::duration remaining);
+    void onDeadline(const Key& key, std::uint64_t generation);
+    // 工作时段正常完成后的奖励，不能持有 mutex
+    void rewardCompletedWork(int userId, int taskId);
+};
+
+#endif // POMODORO_ENGINE_H
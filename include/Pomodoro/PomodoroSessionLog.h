@@ -0,0 +1,70 @@
+#ifndef POMODORO_SESSION_LOG_H
+#define POMODORO_SESSION_LOG_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/entities.h"
+#include "database/DAO/PomodoroSessionDAO.h"
+
+/**
+ * @brief 番茄钟会话的批量追加写入器
+ *
+ * append() 只把记录放进内存队列并立即返回，可以在计时线程的回调里调用。
+ * 后台线程把一段时间内（至多 LINGER）攒下的记录放在一个事务里写入 pomodoro_sessions，
+ * 大量用户同时结束番茄钟时每次提交写入多行，而不是每行一个事务。
+ * 写入失败的记录留在队列中稍后重试；进程退出前会写完队列中剩余的记录。
+ */
+class PomodoroSessionLog {
+public:
+    static PomodoroSessionLog& getInstance();
+
+    PomodoroSessionLog(const PomodoroSessionLog&) = delete;
+    PomodoroSessionLog& operator=(const PomodoroSessionLog&) = delete;
+
+    void append(const PomodoroSession& session);
+
+    /**
+     * @brief 阻塞到此前追加的记录全部落库（读取统计前调用）
+     * @return 写入失败时返回 false
+     */
+    bool flush();
+
+    // 尚未落库的记录数
+    size_t pendingCount();
+
+    // 写完剩余记录并停止后台线程
+    void shutdown();
+
+private:
+    PomodoroSessionLog();
+    ~PomodoroSessionLog();
+
+    static constexpr size_t MAX_BATCH = 256;
+    static constexpr std::chrono::milliseconds LINGER{200};
+    static constexpr std::chrono::seconds RETRY_INTERVAL{5};
+
+    std::unique_ptr<PomodoroSessionDAO> sessionDAO;
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable written;
+    std::thread worker;
+    bool running = false;
+    bool flushRequested = false;
+
+    std::vector<PomodoroSession> pending;
+    std::uint64_t appendedCount = 0;    // 累计追加的记录数
+    std::uint64_t writtenCount = 0;     // 累计落库的记录数
+    std::uint64_t failedWrites = 0;
+
+    void runLoop();
+    void ensureStarted();               // 调用方持有 mutex
+};
+
+#endif // POMODORO_SESSION_LOG_H
@@ -0,0 +1,124 @@
+#ifndef TIMER_SERVICE_H
+#define TIMER_SERVICE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class TimerService;
+
+/**
+ * @brief 计时器句柄 - 只保存编号，可随意复制；计时器结束或被取消后句柄自动失效
+ */
+class TimerHandle {
+public:
+    TimerHandle() = default;
+
+    bool valid() const { return id != 0; }
+    std::uint64_t getId() const { return id; }
+
+    // 取消计时，完成回调以 completed = false 立即调用；计时器已结束时返回 false
+    bool cancel() const;
+    // 剩余秒数（向上取整），计时器已结束时返回 -1
+    int remainingSeconds() const;
+
+private:
+    friend class TimerService;
+    explicit TimerHandle(std::uint64_t timerId) : id(timerId) {}
+
+    std::uint64_t id = 0;
+};
+
+/**
+ * @brief 计时服务 - 所有番茄钟共用一个线程
+ *
+ * 每个计时器保存 steady_clock 上的绝对截止时间，调度线程用小根堆等待最早的事件，
+ * 没有到期事件时一直休眠，不再每个计时器一个线程、每秒 sleep 一次。
+ * 每秒倒计时显示等需要周期回调时，可在启动时订阅 tick；不订阅的计时器只在截止时唤醒一次，
+ * 因此同时运行成千上万个番茄钟的开销只是堆中的一个条目。
+ *
+ * 回调都在调度线程上执行，必须尽快返回；cancel() 例外，其完成回调在调用线程上同步执行。
+ */
+class TimerService {
+public:
+    using Clock = std::chrono::steady_clock;
+    // 参数为剩余秒数（向上取整）
+    using TickCallback = std::function<void(int)>;
+    // 参数为 true 表示正常到期，false 表示被取消
+    using DoneCallback = std::function<void(bool)>;
+
+    static TimerService& getInstance();
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    /**
+     * @brief 启动倒计时
+     * @param duration 计时长度
+     * @param onTick 可为空；非空时立即回调一次，之后每隔 tickInterval 回调一次（按绝对时间对齐，不累积误差）
+     * @param onDone 可为空；到期或被取消时调用且只调用一次
+     */
+    TimerHandle start(Clock::duration duration,
+                      TickCallback onTick,
+                      DoneCallback onDone,
+                      std::chrono::seconds tickInterval = std::chrono::seconds(1));
+
+    /**
+     * @brief 取消计时器
+     *
+     * 若该计时器的回调正在调度线程上执行，会等待其返回，因此返回后不会再有该计时器的回调，
+     * 调用方可以安全释放回调引用的对象。计时器已结束时返回 false。
+     */
+    bool cancel(const TimerHandle& handle);
+
+    int remainingSeconds(const TimerHandle& handle);
+    bool isActive(const TimerHandle& handle);
+    size_t activeCount();
+
+    // 停止调度线程，未到期的计时器全部丢弃（不调用回调）
+    void shutdown();
+
+private:
+    TimerService() = default;
+    ~TimerService();
+
+    struct Timer {
+        Clock::time_point deadline;
+        Clock::time_point nextTick;     // 没有订阅 tick 时等于 deadline
+        Clock::duration tickInterval;
+        TickCallback onTick;
+        DoneCallback onDone;
+    };
+
+    struct Wakeup {
+        Clock::time_point when;
+        std::uint64_t timerId;
+        bool operator>(const Wakeup& other) const { return when > other.when; }
+    };
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable callbackDone;
+    std::thread worker;
+    std::thread::id workerId;
+    bool running = false;
+
+    std::unordered_map<std::uint64_t, Timer> timers;
+    // 每个计时器在堆中只有一个有效条目；被取消的计时器条目留到出堆时丢弃，过多时整体重建
+    std::priority_queue<Wakeup, std::vector<Wakeup>, std::greater<Wakeup>> queue;
+    std::uint64_t nextId = 1;
+    std::uint64_t callbackTimerId = 0;  // 正在执行回调的计时器
+
+    void runLoop();
+    void ensureStarted();                       // 调用方持有 mutex
+    void compactQueue();                        // 调用方持有 mutex
+    static int secondsUntil(Clock::time_point deadline, Clock::time_point now);
+};
+
+#endif // TIMER_SERVICE_H
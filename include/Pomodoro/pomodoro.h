@@ -2,45 +2,80 @@
 #define POMODORO_H
 
 #include <functional>
+#include <string>
 
+#include "Pomodoro/PomodoroEngine.h"
+
+/**
+ * @brief 番茄钟 - PomodoroEngine 上一个会话的句柄
+ *
+ * 状态和计时都在共享的 PomodoroEngine 中，同一 (userId, sessionId) 的多个 Pomodoro
+ * （例如 Web 服务与 Qt 界面）看到的是同一个番茄钟。
+ */
 class Pomodoro {
+public:
+    using Phase = PomodoroPhase;
+
 private:
-    int workDuration;       // minutes
-    int breakDuration;      // minutes
-    int longBreakDuration;  // minutes
-    int cycleCount;
-    bool isRunning;
-    bool shouldStop;
+    int userId;
+    std::string sessionId;
+
+    bool runCountdown(Phase phase, std::function<void(int)> callback);
 
 public:
-    Pomodoro(int work = 25, int brk = 5, int longBrk = 15);
+    explicit Pomodoro(int userId = 1, std::string sessionId = "default");
+    ~Pomodoro();
+
+    Pomodoro(const Pomodoro&) = delete;
+    Pomodoro& operator=(const Pomodoro&) = delete;
 
     // 启动计时器（阻塞版本）
     void startWork();
     void startBreak();
     void startLongBreak();
 
-    // 启动带回调的计时器（可显示倒计时）
-    // callback: 每秒回调一次，参数为剩余秒数
+    // 启动带回调的计时器（可显示倒计时），阻塞到计时结束
+    // callback: 每秒回调一次（在计时线程上），参数为剩余秒数
     // 返回值: true表示正常完成，false表示被中断
     bool startWorkWithCountdown(std::function<void(int)> callback);
     bool startBreakWithCountdown(std::function<void(int)> callback);
     bool startLongBreakWithCountdown(std::function<void(int)> callback);
 
-    // 停止当前计时
-    void stop();
+    /**
+     * @brief 非阻塞启动：在共享的 TimerService 上计时，立即返回
+     *
+     * 正在进行的计时先被取消。phase 为 Idle 时开始状态机给出的下一阶段；onTick 可为空（不订阅每秒回调）；
+     * onFinish 在计时结束时调用，参数 true 表示正常完成、false 表示被中断。
+     */
+    bool start(Phase phase,
+               std::function<void(int)> onTick = nullptr,
+               std::function<void(bool)> onFinish = nullptr);
+
+    // 停止当前计时，立即生效；工作时段以 reason 作为中断原因记入 pomodoro_sessions
+    void stop(const std::string& reason = "");
+    void pause();
+    void resume();
+
+    PomodoroStatePtr getState() const;
     bool getIsRunning() const;
+    // 当前计时的剩余秒数，没有计时时返回 -1
+    int getRemainingSeconds() const;
+    Phase getActivePhase() const;
 
     // 获取器
+    int getUserId() const { return userId; }
+    const std::string& getSessionId() const { return sessionId; }
     int getCycleCount() const;
     int getWorkDuration() const;
     int getBreakDuration() const;
     int getLongBreakDuration() const;
 
-    // 设置器
+    // 设置器（只影响本会话，不写回 user_settings）
     void setWorkDuration(int minutes);
     void setBreakDuration(int minutes);
     void setLongBreakDuration(int minutes);
+    // 之后开始的工作时段关联的任务，-1 表示不关联
+    void setTaskId(int id);
     void resetCycleCount();
 };
 
@@ -3,7 +3,14 @@
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
 #include "../database/DAO/AchievementDAO.h"
+#include "../gamification/EventBus.h"
+#include "AchievementRules.h"
 #include "../statistics/StatisticsAnalyzer.h"
 #include "../common/entities.h"  // 包含实体定义
 
@@ -38,15 +45,78 @@ private:
     // 成就定义缓存
     std::vector<Achievement> achievementDefinitions;
     std::unordered_map<std::string, Achievement> userAchievements;
+
+    // 由 unlock_condition 编译得到的阈值表：指标键 -> 按阈值升序排列的成就
+    struct ThresholdEntry {
+        int threshold;
+        std::string key;
+        Achievement* userEntry;   // 指向 userAchievements 中的节点，随缓存刷新重建
+    };
+    struct MetricIndex {
+        MetricKey metric;
+        std::vector<ThresholdEntry> entries;
+        size_t unlockedPrefix = 0;   // 前缀内的成就均已解锁，评估时直接跳过
+        int value = 0;               // 指标当前值
+        bool progressStale = false;  // 指标变化后尚未同步到未解锁成就的进度
+    };
+    std::unordered_map<std::string, MetricIndex> metricIndex;
+    bool metricsSeeded = false;
+    bool progressStale = false;
+
+    std::vector<EventBus::SubscriptionId> subscriptions;
+
+    // 事件回调、后台写回线程和 UI/Web 调用都会进入，公开方法持锁（可重入：解锁会触发写回和索引重建）
+    mutable std::recursive_mutex stateMutex;
+
+    // 写回缓存：未解锁成就的进度只在内存中修改并记入脏表，由后台线程定时、解锁或退出时批量落盘。
+    // 每次记入脏表时同时追加一行日志，崩溃后下次启动重放；由指标推导的进度另外会在启动时从数据库重新统计
+    std::unordered_map<std::string, int> dirtyProgress;
+    std::string journalPath;            // 默认与数据库文件同目录；为空时不记日志
+    std::ofstream journalOut;           // 追加模式，写回成功后关闭并删除文件
+    bool journalNeedsReplay = false;    // 启动时重放失败，文件保留，写回前再试
+    static constexpr std::chrono::seconds FLUSH_INTERVAL{30};
+
+    std::thread flusher;
+    std::mutex flusherMutex;
+    std::condition_variable flusherWakeup;
+    bool flusherRunning = false;
+
+    void setProgress(Achievement& achievement, const std::string& key, int progress);
+    void appendJournal(const std::string& key, int progress);
+    bool replayJournal();
+    void runFlusher();
+
+    void subscribeEvents();
+    void onGameEvent(const GameEvent& event);
+    void rebuildAchievementIndex();
+    void seedMetrics();
+    void advanceMetric(MetricIndex& index, int newValue);
+    void advanceMetric(const std::string& metricKey, int delta, bool absolute);
+    void materializeProgress();
+    int queryMetric(const MetricKey& metric) const;
+    void syncCacheEntry(const std::string& key);
     
 public:
     AchievementManager(std::unique_ptr<AchievementDAO> dao, int userId = 1);
+    ~AchievementManager();
+
+    AchievementManager(const AchievementManager&) = delete;
+    AchievementManager& operator=(const AchievementManager&) = delete;
     
     // 核心方法
     void initialize();
+    // 从数据库重新统计全部指标并评估所有成就（仅用于手动检查，日常更新走事件）
     void checkAllAchievements();
     void unlockAchievement(const std::string& achievementId);
 
+    /**
+     * @brief 立即把内存中的脏进度写入数据库（一个事务）
+     *
+     * 提交成功后删除进度日志；若进程在两次写回之间崩溃，下次启动时 initialize() 会重放日志。
+     */
+    bool flushPendingProgress();
+    void setJournalPath(const std::string& path);
+
     // 成就进度核心方法
     // 旧接口，基于字符串成就ID 的进度更新（用于兼容已有代码）
     void updateAchievementProgress(const std::string& achievementId, int progress);
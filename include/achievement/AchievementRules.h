@@ -0,0 +1,72 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/**
+ * @brief 成就规则 DSL（保存在 achievements.unlock_condition 中）
+ *
+ * 语法：
+ *   rule   := metric ('>=' | '>') INT
+ *   metric := 'streak'
+ *           | 'count(' source [ 'where' filter { 'and' filter } ] ')'
+ *   source := 'tasks.completed' | 'pomodoros' | 'projects.completed'
+ *   filter := ('priority' | 'project_id') '=' INT          （仅 tasks.completed 支持）
+ *
+ * 例如 "count(tasks.completed where priority=2) >= 50"、"streak >= 7"。
+ * 旧版键 task_N / streak_N / pomodoro_N / project_N 视为对应指标 >= target_value；
+ * 其余纯标识符（如 custom_xxx）为手动成就，不参与自动评估。
+ *
+ * 规则只编译一次，得到「指标键 + 阈值」；同一指标键的所有成就按阈值排序后
+ * 由 AchievementManager 在指标更新时增量评估。
+ */
+enum class MetricSource {
+    TasksCompleted,
+    Pomodoros,
+    Streak,
+    ProjectsCompleted
+};
+
+struct MetricFilter {
+    std::string field;   // "priority" / "project_id"
+    int value;
+};
+
+struct MetricKey {
+    MetricSource source = MetricSource::TasksCompleted;
+    std::vector<MetricFilter> filters;   // 按字段名排序
+    std::string canonical;               // 规范化文本，用作索引键，例如 "tasks.completed[priority=2]"
+};
+
+struct CompiledRule {
+    MetricKey metric;
+    int threshold = 0;
+};
+
+enum class RuleParseResult {
+    Compiled,   // 可自动评估的规则
+    Manual,     // 纯标识符，手动成就
+    Invalid     // 语法错误
+};
+
+class AchievementRules {
+public:
+    /**
+     * @brief 编译 unlock_condition
+     * @param targetValue 旧版键使用的阈值（achievements.target_value）
+     * @param error 语法错误时写入原因
+     */
+    static RuleParseResult compile(const std::string& condition, int targetValue,
+                                   CompiledRule& rule, std::string* error = nullptr);
+
+    static std::string canonicalKey(MetricSource source, const std::vector<MetricFilter>& filters);
+
+    /**
+     * @brief 一次任务完成/撤销会影响的所有任务指标键（无过滤、按优先级、按项目、两者组合）
+     */
+    static std::vector<std::string> taskMetricKeys(int priority, int projectId);
+
+    /**
+     * @brief 统计指标当前值的 SQL，过滤条件按 filters 顺序以 ? 占位；Streak 返回空串
+     */
+    static std::string countSql(const MetricKey& metric);
+};
@@ -1,64 +1,80 @@
 #pragma once
 #include <string>
 #include <vector>
-#include <map>
+#include <memory>
+#include <utility>
 #include "../common/entities.h"  // 包含实体定义
 
+/**
+ * @brief 成就数据访问接口
+ *
+ * 成就定义保存在 achievements 表（unlock_condition 为唯一键），用户进度保存在
+ * user_achievements(user_id, achievement_key) 表，每次进度/解锁只写一行。
+ * getUserAchievements / getUserAchievement 返回最近一次 loadUserAchievements 加载的内存副本。
+ */
 class AchievementDAO {
-private:
-    std::string dataFilePath;
-
-    std::vector<Achievement> achievementDefinitions;
-    std::vector<Achievement> userAchievements;
-
-    std::string getDefinitionFilePath() const;
-    std::string getUserAchievementFilePath(int userId) const;
-    bool fileExists(const std::string& filename) const;
-    bool writeFile(const std::string& filename, const std::string& content);
-
 public:
-    AchievementDAO();
-    explicit AchievementDAO(const std::string& basePath);
+    virtual ~AchievementDAO() = default;
+
+    // 成就定义
+    virtual bool loadAchievementDefinitions() = 0;
+    virtual bool saveAchievementDefinitions() = 0;
+    virtual std::vector<Achievement> getAllAchievementDefinitions() const = 0;
+    virtual Achievement getAchievementDefinition(const std::string& achievementKey) const = 0;
 
-    bool loadAchievementDefinitions();
-    bool saveAchievementDefinitions();
-    std::vector<Achievement> getAllAchievementDefinitions() const;
-    Achievement getAchievementDefinition(const std::string& achievementKey) const;
+    // 用户成就（定义 + 该用户的进度）
+    virtual bool loadUserAchievements(int userId) = 0;
+    virtual bool saveUserAchievements(int userId) = 0;
+    virtual std::vector<Achievement> getUserAchievements(int userId) const = 0;
+    virtual Achievement* getUserAchievement(int userId, const std::string& achievementKey) = 0;
 
-    bool loadUserAchievements(int userId);
-    bool saveUserAchievements(int userId);
-    std::vector<Achievement> getUserAchievements(int userId) const;
-    Achievement* getUserAchievement(int userId, const std::string& achievementKey);
+    // 单行更新
+    virtual bool unlockAchievement(int userId, const std::string& achievementKey) = 0;
+    virtual bool updateAchievementProgress(int userId, const std::string& achievementKey, int progress) = 0;
+    virtual bool resetUserAchievements(int userId) = 0;
 
-    bool unlockAchievement(int userId, const std::string& achievementKey);
-    bool updateAchievementProgress(int userId, const std::string& achievementKey, int progress);
-    bool resetUserAchievements(int userId);
+    /**
+     * @brief 在一个事务内批量写入未解锁成就的进度（成就键 -> 进度），已解锁的记录保持不变
+     */
+    virtual bool saveProgressBatch(int userId, const std::vector<std::pair<std::string, int>>& progress) = 0;
 
-    int getUnlockedAchievementCount(int userId) const;
-    int getTotalXP(int userId) const;
-    std::vector<Achievement> getRecentlyUnlockedAchievements(int userId, int count = 5) const;
+    // 统计查询
+    virtual int getUnlockedAchievementCount(int userId) const = 0;
+    virtual int getTotalXP(int userId) const = 0;
+    virtual std::vector<Achievement> getRecentlyUnlockedAchievements(int userId, int count = 5) const = 0;
 
     // Update achievement definition (name, description, target value)
-    bool updateAchievementDefinition(int id,
-                                     const std::string& name,
-                                     const std::string& description,
-                                     int targetValue = -1);
+    virtual bool updateAchievementDefinition(int id,
+                                             const std::string& name,
+                                             const std::string& description,
+                                             int targetValue = -1) = 0;
 
     // Create a new achievement definition
-    int createAchievementDefinition(const std::string& name,
-                                    const std::string& description,
-                                    const std::string& unlockCondition,
-                                    int targetValue,
-                                    int rewardXP = 100,
-                                    const std::string& category = "custom",
-                                    const std::string& icon = "🏆");
+    virtual int createAchievementDefinition(const std::string& name,
+                                            const std::string& description,
+                                            const std::string& unlockCondition,
+                                            int targetValue,
+                                            int rewardXP = 100,
+                                            const std::string& category = "custom",
+                                            const std::string& icon = "🏆") = 0;
 
-    void initializeDefaultAchievements();
-    bool userAchievementFileExists(int userId) const;
+    /**
+     * @brief 导入旧版 CSV 数据（achievement_definitions.csv / user_achievements_<id>.csv）
+     *
+     * 已存在的定义保持不变，用户进度取较大值；导入成功的文件重命名为 *.imported，不会重复导入。
+     * @return 是否导入了任何数据
+     */
+    virtual bool importFromCSV(const std::string& directory) = 0;
 
-    static std::string getCurrentTimestamp();
+    virtual void initializeDefaultAchievements() = 0;
 
-private:
-    int generateAchievementId();
-    int nextAchievementId = 1;
+    static std::string getCurrentTimestamp();
 };
+
+/**
+ * @brief 创建基于 SQLite 的成就 DAO
+ * @param legacyDataPath 旧版 CSV 文件所在目录，首次启动时自动迁移
+ * @param dbPath 数据库尚未打开时使用的数据库文件
+ */
+std::unique_ptr<AchievementDAO> createAchievementDAO(const std::string& legacyDataPath = "./data/",
+                                                     const std::string& dbPath = "task_manager.db");
@@ -4,13 +4,38 @@
 #include "common/entities.h"
 #include <vector>
 #include <map>
+#include <memory>
+#include <string>
 
+/**
+ * @brief 一次经验值奖励的结果
+ */
+struct ExperienceAward {
+    int totalXP = 0;         // 奖励后的总经验值
+    int previousLevel = 1;   // 奖励前的等级
+    int newLevel = 1;        // 奖励后的等级
+};
+
+/**
+ * @brief 经验值数据访问接口
+ *
+ * user_stats.total_xp / level 为当前值，xp_ledger 表记录每一笔经验值变化。
+ */
 class ExperienceDAO {
 public:
     virtual ~ExperienceDAO() = default;
     
     // 经验值管理
     virtual bool awardExperience(int userId, int amount, const std::string& source, const std::string& description = "") = 0;
+
+    /**
+     * @brief 原子地增加经验值并追加流水
+     *
+     * 经验值通过单条 UPDATE ... RETURNING 累加，不经过“读-改-写”，并发奖励不会互相覆盖；
+     * 流水与等级更新在同一个保存点内提交。
+     */
+    virtual bool addExperienceAtomic(int userId, int amount, const std::string& source,
+                                     const std::string& description, ExperienceAward& award) = 0;
     virtual bool deductExperience(int userId, int amount, const std::string& reason) = 0;
     
     // 等级管理
@@ -44,5 +69,11 @@ public:
     virtual bool updateLevelDefinition(const LevelDefinition& definition) = 0;
 };
 
+/**
+ * @brief 创建基于 SQLite 的经验值 DAO
+ * @param levels 等级定义（按等级升序），用于由总经验值推算等级
+ */
+std::unique_ptr<ExperienceDAO> createExperienceDAO(const std::vector<LevelDefinition>& levels);
+
 #endif // EXPERIENCE_DAO_H
 
@@ -1,25 +1,56 @@
 #ifndef HEATMAP_VISUALIZER_DAO_H
 #define HEATMAP_VISUALIZER_DAO_H
 
-#include "HeatmapVisualizer.h"
+#include "HeatmapVisualizer/HeatmapVisualizer.h"
 #include <string>
 #include <vector>
 #include <map>
+#include <cstdint>
 
 using namespace std;
 
+/**
+ * 热力图快照文件格式（heatmap_<id>.hmap，主机字节序）:
+ *
+ *   偏移  大小  字段
+ *   0     4     magic "HMAP"
+ *   4     2     格式版本（当前为 1）
+ *   6     2     保留
+ *   8     4     baseDay   网格起始日（自 1970-01-01 起的 UTC 天数）
+ *   12    4     dayCount  天数
+ *   16    4     totalCompleted
+ *   20    4     保留
+ *   24    2*N   uint16_t 每日完成数
+ *
+ * 读取时 mmap 整个文件，校验头部后直接把计数数组交给 HeatmapVisualizer，无需逐行解析。
+ */
+struct HeatmapFileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t reserved;
+    int32_t baseDay;
+    uint32_t dayCount;
+    uint32_t totalCompleted;
+    uint32_t reserved2;
+};
+
 class HeatmapVisualizerDAO {
 private:
     string dataFilePath;
     
-    // 数据序列化方法
-    string serializeTaskData(const map<string, int>& taskData);
+    string snapshotPath(const string& identifier) const;
+    string legacyPath(const string& identifier) const;
+    
+    // 旧版文本格式（date:count 每行一条），仅用于迁移
     map<string, int> deserializeTaskData(const string& data);
     
     // 文件操作
     bool fileExists(const string& filename);
     string readFile(const string& filename);
-    bool writeFile(const string& filename, const string& content);
+    bool writeSnapshot(const string& filename, int baseDay, const vector<uint16_t>& counts);
+    bool readSnapshot(const string& filename, HeatmapVisualizer& visualizer);
+    
+    static void loadFromDateCounts(HeatmapVisualizer& visualizer, const map<string, int>& taskData);
 
 public:
     HeatmapVisualizerDAO();
@@ -0,0 +1,25 @@
+#ifndef POMODORO_SESSION_DAO_H
+#define POMODORO_SESSION_DAO_H
+
+#include "common/entities.h"
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 番茄钟会话数据访问接口
+ *
+ * pomodoro_sessions 只追加不修改：会话结束时写入完整一行。
+ * 按天/按任务的汇总查询在 StatisticsDAO 中。
+ */
+class PomodoroSessionDAO {
+public:
+    virtual ~PomodoroSessionDAO() = default;
+
+    // 在一个事务中追加一批会话记录；任一行失败时整批回滚
+    virtual bool appendSessions(const std::vector<PomodoroSession>& sessions) = 0;
+};
+
+// 工厂函数声明
+std::unique_ptr<PomodoroSessionDAO> createPomodoroSessionDAO();
+
+#endif // POMODORO_SESSION_DAO_H
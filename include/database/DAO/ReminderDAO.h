@@ -4,9 +4,17 @@
 #include "../common/entities.h"  // 包含实体定义
 #include <vector>
 #include <optional>
-#include <chrono>
 #include <string>
 #include <memory>
+#include <cstdint>
+
+/**
+ * @brief 待触发提醒的调度信息（仅 ID 与触发时间，供调度器按时间窗口加载）
+ */
+struct ReminderScheduleEntry {
+    int id;
+    std::int64_t triggerEpoch;
+};
 
 class ReminderDAO {
 public:
@@ -28,26 +36,43 @@ public:
     // recurrence 示例: "once", "daily", "weekly", "monthly"
     virtual std::vector<Reminder> getRemindersByRecurrence(const std::string& recurrence) = 0;
 
-    virtual std::vector<Reminder> getDueReminders(
-        const std::chrono::system_clock::time_point& currentTime) = 0;
+    virtual std::vector<Reminder> getDueReminders(Timestamp currentTime) = 0;
+
+    /**
+     * @brief 触发时间在 [fromEpoch, untilEpoch) 内的待触发提醒，按触发时间升序
+     */
+    virtual std::vector<ReminderScheduleEntry> getPendingSchedule(std::int64_t fromEpoch,
+                                                                  std::int64_t untilEpoch) = 0;
     
     // 时间相关查询
     virtual std::vector<Reminder> getRemindersDueToday() = 0;
     virtual std::vector<Reminder> getRemindersDueThisWeek() = 0;
 
     // 范围查询
-    virtual std::vector<Reminder> getRemindersByDateRange(
-        const std::chrono::system_clock::time_point& start,
-        const std::chrono::system_clock::time_point& end) = 0;
+    virtual std::vector<Reminder> getRemindersByDateRange(Timestamp start, Timestamp end) = 0;
 
     // 状态管理
     virtual bool markReminderAsTriggered(int reminderId) = 0;
     virtual bool markReminderAsCompleted(int reminderId) = 0;
-    virtual bool rescheduleReminder(int reminderId,
-        const std::chrono::system_clock::time_point& newTime) = 0;
+    virtual bool rescheduleReminder(int reminderId, Timestamp newTime) = 0;
+
+    /**
+     * @brief 触发时间在 [from, until) 内的待触发一次性提醒，以及下一次触发早于 until 的重复提醒
+     *
+     * 重复提醒只有一行，具体落在区间内的各次触发时间由调用方按规则展开。
+     */
+    virtual std::vector<Reminder> getAgendaCandidates(std::int64_t fromEpoch, std::int64_t untilEpoch) = 0;
 
     // 重复提醒
-    virtual bool createNextRecurringReminder(int originalReminderId) = 0;
+    // 把重复提醒的下一次触发时间原地推进到 nextTime，不新增记录
+    virtual bool advanceRecurringReminder(int reminderId, Timestamp nextTime) = 0;
+
+    /**
+     * @brief 在一个事务内完成一批到期提醒：triggeredIds 标记为已触发，advances 中的重复提醒推进到新时间
+     * @return 任一步失败时整体回滚并返回 false
+     */
+    virtual bool completeDueReminders(const std::vector<int>& triggeredIds,
+        const std::vector<std::pair<int, Timestamp>>& advances) = 0;
     virtual std::vector<Reminder> getRecurringReminders() = 0;
 
     // 清理与统计
@@ -4,6 +4,7 @@
 #include "common/entities.h"
 #include <vector>
 #include <map>
+#include <memory>
 #include <chrono>
 
 struct CompletionTrend {
@@ -57,6 +58,10 @@ public:
     virtual std::map<std::chrono::system_clock::time_point, int> getCompletionCountByDate(
         const std::chrono::system_clock::time_point& startDate,
         const std::chrono::system_clock::time_point& endDate) = 0;
+    // [startDate, endDate] 内完成的任务总数（单条 COUNT，不按天分组）
+    virtual int getCompletedCount(
+        const std::chrono::system_clock::time_point& startDate,
+        const std::chrono::system_clock::time_point& endDate) = 0;
     
     // 生产力分析
     virtual ProductivityReport generateProductivityReport(
@@ -67,6 +72,14 @@ public:
     virtual PomodoroStatistics getPomodoroStatistics(
         const std::chrono::system_clock::time_point& startDate,
         const std::chrono::system_clock::time_point& endDate) = 0;
+    // 从 startDate 起连续 days 天的专注统计（缺失的天各项为 0）
+    virtual std::vector<PomodoroFocusStats> getPomodoroFocusByDay(
+        const std::chrono::system_clock::time_point& startDate, int days) = 0;
+    // [startDate, endDate] 内按任务汇总，按专注时长降序；未关联任务的会话不计入
+    virtual std::vector<PomodoroFocusStats> getPomodoroFocusByTask(
+        const std::chrono::system_clock::time_point& startDate,
+        const std::chrono::system_clock::time_point& endDate) = 0;
+    virtual PomodoroFocusStats getPomodoroFocusForTask(int taskId) = 0;
     
     // 趋势分析
     virtual CompletionTrend getCompletionTrend(int days = 30) = 0;
@@ -85,6 +98,9 @@ public:
     virtual std::map<std::string, int> getOverallStatistics() = 0;
 };
 
+// 工厂函数声明
+std::unique_ptr<StatisticsDAO> createStatisticsDAO();
+
 #endif // STATISTICS_DAO_H
 
 
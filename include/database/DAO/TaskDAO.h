@@ -5,6 +5,24 @@
 #include <optional>
 #include <string>
 #include "task/task.h"
+#include "task/TaskQuery.h"
+
+// 全文检索结果中匹配词的标记，展示层据此替换为高亮（例如 <mark>）
+constexpr const char* TASK_SEARCH_MARK_BEGIN = "\x02";
+constexpr const char* TASK_SEARCH_MARK_END = "\x03";
+
+struct TaskSearchHit {
+    Task task;
+    double score = 0.0;             // bm25 相关度，越小越相关
+    std::string titleHighlight;     // 完整标题，匹配词带标记
+    std::string snippet;            // 描述中匹配处附近的片段，匹配词带标记
+};
+
+struct TagCount {
+    std::string name;
+    int taskCount = 0;              // 关联的未删除任务数
+    int openCount = 0;              // 其中未完成的任务数
+};
 
 class TaskDAO {
 
@@ -27,6 +45,31 @@ public:
     virtual std::vector<Task> getOverdueTasks() = 0;
     virtual std::vector<Task> getTodayTasks() = 0;
     
+    /**
+     * @brief 按标题、描述、标签全文检索未删除的任务，按相关度排序
+     * @param query 用户输入，按空白分词，每个词按前缀匹配，所有词都须出现
+     * @param truncated 非空时写入：命中过多，只对最新的一批命中排序，更早的命中检索不到，
+     *                  分页也止于这一批的末尾
+     */
+    virtual std::vector<TaskSearchHit> searchTasks(const std::string& query, int limit, int offset = 0,
+                                                   bool* truncated = nullptr) = 0;
+    
+    /**
+     * @brief 按任意组合的条件查询未删除的任务（一页）
+     * @return 数据库错误时返回 false；条件不可能满足时返回 true 且结果为空
+     */
+    virtual bool queryTasks(const TaskQuery& query, TaskPage& page) = 0;
+    
+    // 标签操作：tasks.tags 与 task_tags 在同一事务中写入
+    virtual bool setTaskTags(int taskId, const std::string& tags) = 0;
+    /**
+     * @brief 按标签过滤未删除的任务，每个标签走 task_tags(tag_id) 索引
+     * @param matchAll true 要求包含全部标签（交集），false 包含任一标签（并集）
+     */
+    virtual std::vector<Task> getTasksByTags(const std::vector<std::string>& tags, bool matchAll) = 0;
+    // 标签云：每个标签关联的未删除任务数，按数量降序
+    virtual std::vector<TagCount> getTagCounts(int limit) = 0;
+    
     // 统计操作
     virtual int countAllTasks() = 0;
     virtual int countCompletedTasks() = 0;
@@ -48,6 +91,8 @@ private:
     // 数据库连接辅助方法
     sqlite3* getDatabaseConnection();
     bool executeSQL(const std::string& sql);
+    // 用 tags 的拆分结果替换任务在 task_tags 中的关联，调用方负责事务
+    bool writeTaskTags(sqlite3* db, int taskId, const std::vector<std::string>& tags);
     
 public:
     TaskDAOImpl(const std::string& dbPath = "task_manager.db");
@@ -64,6 +109,14 @@ public:
     std::vector<Task> getTasksByProject(int projectId) override;
     std::vector<Task> getOverdueTasks() override;
     std::vector<Task> getTodayTasks() override;
+    std::vector<TaskSearchHit> searchTasks(const std::string& query, int limit, int offset = 0,
+                                           bool* truncated = nullptr) override;
+    
+    bool queryTasks(const TaskQuery& query, TaskPage& page) override;
+    
+    bool setTaskTags(int taskId, const std::string& tags) override;
+    std::vector<Task> getTasksByTags(const std::vector<std::string>& tags, bool matchAll) override;
+    std::vector<TagCount> getTagCounts(int limit) override;
     
     int countAllTasks() override;
     int countCompletedTasks() override;
@@ -8,6 +8,8 @@
 #include <functional>
 #include <mutex>
 #include <atomic>
+#include <condition_variable>
+#include <thread>
 #include <sqlite3.h>
 
 // 前置声明
@@ -27,8 +29,43 @@ struct SQLiteDeleter {
     }
 };
 
+class DatabaseManager;
+
+// 只读连接：WAL 模式下与写连接互不阻塞，每个连接缓存自己的预编译语句
+struct ReadConnection {
+    sqlite3* db = nullptr;
+    bool ownsConnection = true;   // false 表示回退为共享主连接（如内存数据库）
+    std::unordered_map<std::string, sqlite3_stmt*> statements;
+};
+
+// 只读连接租约（RAII），析构时自动归还连接池
+class ReadConnectionLease {
+public:
+    ReadConnectionLease() = default;
+    ReadConnectionLease(DatabaseManager* owner, ReadConnection* conn);
+    ReadConnectionLease(ReadConnectionLease&& other) noexcept;
+    ReadConnectionLease& operator=(ReadConnectionLease&& other) noexcept;
+    ~ReadConnectionLease();
+
+    ReadConnectionLease(const ReadConnectionLease&) = delete;
+    ReadConnectionLease& operator=(const ReadConnectionLease&) = delete;
+
+    sqlite3* get() const;
+    // 在该连接上获取缓存的预编译语句（已 reset 并清除绑定）
+    sqlite3_stmt* prepare(const std::string& sql);
+    explicit operator bool() const { return conn != nullptr && conn->db != nullptr; }
+
+private:
+    void release();
+
+    DatabaseManager* owner = nullptr;
+    ReadConnection* conn = nullptr;
+};
+
 class DatabaseManager {
 private:
+    friend class ReadConnectionLease;
+
     static std::unique_ptr<DatabaseManager> instance;
     static std::mutex instanceMutex;
     
@@ -40,22 +77,48 @@ private:
     
     mutable std::mutex dbMutex;
     
+    // 写事务锁：主连接上的 SAVEPOINT / BEGIN 期间由发起线程持有，其他线程的写入语句等待其结束，
+    // 避免混入别人的事务后随之回滚。可重入，持有者自己的 execute 与嵌套保存点照常执行
+    std::recursive_mutex writeMutex;
+    std::thread::id transactionOwner;
+    
     // 预编译语句缓存
     std::unordered_map<std::string, sqlite3_stmt*> preparedStatements;
     std::mutex stmtMutex;  // ✅ 新增：预编译语句的互斥锁
     
+    // 只读连接池
+    std::vector<std::unique_ptr<ReadConnection>> readConnections;
+    std::vector<ReadConnection*> idleReadConnections;
+    size_t maxReadConnections = 4;
+    std::mutex poolMutex;
+    std::condition_variable poolCv;
+    
+    // 表数据版本号：主连接上的每次行变更都会使对应表的版本号递增，供缓存判断是否失效
+    std::unordered_map<std::string, uint64_t> tableVersions;
+    mutable std::mutex versionMutex;
+    static void onRowChanged(void* self, int op, const char* dbName, const char* table, sqlite3_int64 rowid);
+    
     // 私有方法
     bool createProjectTable();
     bool createTaskTable();
+    bool createTaskSearchIndex();
+    bool createTaskTagTables();
     bool createChallengeTable();
     bool createReminderTable();
     bool createAchievementTable();
+    bool migrateLegacyAchievementTable();
     bool createUserStatsTable();
+    bool createExperienceLedgerTable();
     bool createUserSettingsTable();
     bool createPomodoroTable();  // ✅ 新增：Pomodoro表
     
     // 清理预编译语句
     void cleanupPreparedStatements();
+    
+    // 只读连接池
+    ReadConnection* openReadConnection();
+    void releaseReadConnection(ReadConnection* conn);
+    void closeReadConnections();
 
 public:
     DatabaseManager();
@@ -91,6 +154,9 @@ public:
     bool rollbackTransaction();
     bool isInTransaction() const;
     
+    // 多语句写入（保存点）在整个保存点期间持有此锁；beginTransaction 到提交/回滚之间自动持有
+    std::unique_lock<std::recursive_mutex> lockWrites();
+    
     // 数据库维护
     bool backupDatabase(const std::string& backupPath);
     bool restoreDatabase(const std::string& backupPath);
@@ -122,6 +188,14 @@ public:
     // ✅ 新增：预编译语句管理
     sqlite3_stmt* getPreparedStatement(const std::string& sql);
     void releasePreparedStatement(const std::string& key);
+    
+    // 只读连接池：统计/报表等读路径使用，连接用完自动归还；池满时等待空闲连接
+    ReadConnectionLease acquireReadConnection();
+    void setMaxReadConnections(size_t count);
+    size_t getMaxReadConnections() const;
+    
+    // 数据版本：表内容变化后版本号递增，版本号不变即可复用缓存结果
+    uint64_t getTableVersion(const std::string& tableName) const;
 };
 
 #endif // DATABASE_MANAGER_H
@@ -0,0 +1,70 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 游戏化事件类型
+ */
+enum class GameEventType {
+    TaskCompleted,      // 任务被标记为完成，value = 本次变化量（通常为 1）
+    TaskReopened,       // 已完成任务被重新打开或删除，value = 减少量
+    PomodoroCompleted,  // 完成一个番茄钟，value = 本次变化量
+    StreakChanged,      // 当前连续打卡天数变化，value = 新的连续天数
+    LevelUp             // 用户升级，value = 新等级
+};
+
+struct GameEvent {
+    GameEventType type;
+    int userId = 1;
+    int value = 1;
+    int priority = -1;    // 任务事件：任务优先级，供按优先级过滤的成就规则使用
+    int projectId = -1;   // 任务事件：所属项目，-1 表示无项目
+};
+
+/**
+ * @brief 进程内事件总线 - 业务层发布事件，成就等订阅方只处理与自己相关的事件
+ *
+ * 同步分发：publish() 在调用线程中依次执行订阅回调。订阅表采用写时复制，
+ * 发布时只需在锁内复制一个 shared_ptr，回调执行期间不持有锁，
+ * 因此回调中可以再次发布事件或增删订阅。
+ */
+class EventBus {
+public:
+    using SubscriptionId = size_t;
+    using Handler = std::function<void(const GameEvent&)>;
+
+    static EventBus& getInstance();
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    /**
+     * @brief 订阅某类事件
+     * @return 订阅 ID，用于 unsubscribe
+     */
+    SubscriptionId subscribe(GameEventType type, Handler handler);
+    void unsubscribe(SubscriptionId id);
+
+    void publish(const GameEvent& event);
+
+private:
+    EventBus() = default;
+
+    struct Subscription {
+        SubscriptionId id;
+        GameEventType type;
+        Handler handler;
+    };
+    using SubscriptionList = std::vector<Subscription>;
+
+    std::mutex mutex;
+    std::shared_ptr<const SubscriptionList> subscriptions = std::make_shared<SubscriptionList>();
+    SubscriptionId nextId = 1;
+};
+
+#endif // EVENT_BUS_H
@@ -0,0 +1,110 @@
+#ifndef LEVEL_TABLE_H
+#define LEVEL_TABLE_H
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @brief 等级定义：等级、所需总经验值、称号
+ */
+struct LevelInfo {
+    int level;
+    int requiredXP;
+    std::string_view title;
+};
+
+/**
+ * @brief 编译期等级表 - 等级曲线与称号
+ *
+ * 所有查询均为 constexpr，不分配内存；等级查找在 20 项有序数组上二分，
+ * 可直接在 static_assert 中使用。
+ */
+class LevelTable {
+public:
+    static constexpr std::array<LevelInfo, 20> LEVELS = {{
+        {1, 0, "新手"},
+        {2, 100, "初学者"},
+        {3, 250, "学徒"},
+        {4, 500, "实践者"},
+        {5, 1000, "熟练者"},
+        {6, 1750, "资深者"},
+        {7, 2750, "精英"},
+        {8, 4000, "专家"},
+        {9, 5500, "大师"},
+        {10, 7500, "宗师"},
+        {11, 10000, "传奇"},
+        {12, 13000, "史诗"},
+        {13, 16500, "神话"},
+        {14, 20500, "不朽"},
+        {15, 25000, "永恒"},
+        {16, 30000, "至尊"},
+        {17, 36000, "主宰"},
+        {18, 43000, "神圣"},
+        {19, 51000, "超凡"},
+        {20, 60000, "传说"},
+    }};
+
+    static constexpr int MIN_LEVEL = 1;
+    static constexpr int MAX_LEVEL = static_cast<int>(LEVELS.size());
+
+    /**
+     * @brief 总经验值对应的等级（requiredXP <= totalXP 的最后一级）
+     */
+    static constexpr int levelForXP(int totalXP) {
+        // 二分查找第一个 requiredXP > totalXP 的位置，其下标即为等级
+        std::size_t lo = 1, hi = LEVELS.size();
+        while (lo < hi) {
+            std::size_t mid = lo + (hi - lo) / 2;
+            if (LEVELS[mid].requiredXP <= totalXP) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return static_cast<int>(lo);
+    }
+
+    static constexpr int clamp(int level) {
+        return level < MIN_LEVEL ? MIN_LEVEL : (level > MAX_LEVEL ? MAX_LEVEL : level);
+    }
+
+    /**
+     * @brief 达到该等级所需的总经验值（超出范围时按最近的等级计算）
+     */
+    static constexpr int requiredXP(int level) {
+        return LEVELS[static_cast<std::size_t>(clamp(level) - 1)].requiredXP;
+    }
+
+    /**
+     * @brief 下一等级所需的总经验值；满级时返回满级门槛
+     */
+    static constexpr int nextLevelXP(int level) {
+        return requiredXP(level + 1);
+    }
+
+    /**
+     * @brief 等级称号，超出范围时返回 "未知"
+     */
+    static constexpr std::string_view title(int level) {
+        return level < MIN_LEVEL || level > MAX_LEVEL
+            ? std::string_view("未知")
+            : LEVELS[static_cast<std::size_t>(level - 1)].title;
+    }
+
+    static constexpr bool isValid() {
+        for (std::size_t i = 0; i < LEVELS.size(); ++i) {
+            if (LEVELS[i].level != static_cast<int>(i) + 1) return false;
+            if (i > 0 && LEVELS[i].requiredXP <= LEVELS[i - 1].requiredXP) return false;
+        }
+        return LEVELS[0].requiredXP == 0;
+    }
+};
+
+static_assert(LevelTable::isValid(), "等级表必须从 0 经验开始、等级连续且门槛严格递增");
+static_assert(LevelTable::levelForXP(0) == 1 && LevelTable::levelForXP(99) == 1);
+static_assert(LevelTable::levelForXP(100) == 2 && LevelTable::levelForXP(7499) == 9);
+static_assert(LevelTable::levelForXP(60000) == 20 && LevelTable::levelForXP(1000000) == 20);
+static_assert(LevelTable::nextLevelXP(20) == 60000);
+
+#endif // LEVEL_TABLE_H
@@ -0,0 +1,73 @@
+#ifndef USER_PROFILE_CACHE_H
+#define USER_PROFILE_CACHE_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "EventBus.h"
+
+/**
+ * @brief 用户档案快照（只读）
+ */
+struct UserProfile {
+    int totalXP = 0;
+    int level = 1;
+    int xpIntoLevel = 0;        // 当前等级内已获得的经验值
+    int levelStartXP = 0;       // 当前等级的起始经验值
+    int nextLevelXP = 0;        // 下一等级所需的总经验值（满级时等于当前等级起点）
+    double levelProgress = 0.0; // 0.0 - 1.0
+    std::string title;
+
+    int currentStreak = 0;
+    int longestStreak = 0;
+    int streakDay = 0;          // currentStreak 计算时的日期（自 1970-01-01 起的天数）
+
+    int totalTasksCompleted = 0;
+    int totalPomodoros = 0;
+};
+
+/**
+ * @brief 用户档案缓存 - UI 与 API 读取等级/经验/连续打卡时不访问数据库
+ *
+ * 快照不可变，写路径复制一份修改后整体替换（atomic shared_ptr 交换），
+ * 读取方拿到的 shared_ptr 在使用期间始终有效且不会被修改。
+ * 经验值由 XPSystem 在奖励后写入；任务、番茄钟、连续打卡通过 EventBus 事件增量更新。
+ */
+class UserProfileCache {
+public:
+    using Mutator = std::function<void(UserProfile&)>;
+
+    static UserProfileCache& getInstance();
+
+    UserProfileCache(const UserProfileCache&) = delete;
+    UserProfileCache& operator=(const UserProfileCache&) = delete;
+
+    /**
+     * @brief 当前快照；尚未加载时返回默认档案
+     */
+    std::shared_ptr<const UserProfile> snapshot();
+
+    bool isLoaded() const;
+
+    /**
+     * @brief 用完整档案替换快照（初次加载或手动刷新）
+     */
+    void reset(const UserProfile& profile);
+
+    /**
+     * @brief 复制当前快照、修改后发布；与其他写入并发时自动重试。尚未加载时忽略
+     */
+    void update(const Mutator& mutate);
+
+private:
+    UserProfileCache();
+    ~UserProfileCache();
+
+    void onGameEvent(const GameEvent& event);
+
+    std::shared_ptr<const UserProfile> current;   // 仅通过 std::atomic_load/atomic_store 访问
+    std::vector<EventBus::SubscriptionId> subscriptions;
+};
+
+#endif // USER_PROFILE_CACHE_H
@@ -3,7 +3,12 @@
 
 #include <string>
 #include <map>
+#include <memory>
+#include <string_view>
 #include "../database/DatabaseManager.h"
+#include "../database/DAO/ExperienceDAO.h"
+#include "UserProfileCache.h"
+#include "LevelTable.h"
 
 using namespace std;
 
@@ -16,36 +21,29 @@ using namespace std;
 class XPSystem {
 private:
     DatabaseManager* dbManager;
-    
-    // 等级配置：等级 -> 所需总经验值
-    map<int, int> levelThresholds;
-    
-    // 等级称号
-    map<int, string> levelTitles;
-    
-    /**
-     * @brief 根据总经验值计算等级
-     */
-    int calculateLevel(int totalXP);
+    std::unique_ptr<ExperienceDAO> experienceDAO;
     
     /**
-     * @brief 初始化等级系统配置
+     * @brief 按总经验值和等级填写档案中的等级相关字段
      */
-    void initializeLevelSystem();
-    
-    /**
-     * @brief 更新用户统计表中的等级和经验值
-     */
-    void updateUserStats(int totalXP, int level);
+    void fillLevelFields(UserProfile& profile, int totalXP, int level) const;
     
 public:
     XPSystem();
     ~XPSystem();
     
+    /**
+     * @brief 从数据库重新加载 UserProfileCache 的完整快照
+     */
+    void refreshProfile();
+    
     // === 经验值管理 ===
     
     /**
      * @brief 奖励经验值
+     *
+     * 通过 ExperienceDAO 原子累加并记入 xp_ledger，可在多个线程中同时调用；
+     * 升级时发布 GameEventType::LevelUp 事件。
      * @param amount 经验值数量
      * @param source 来源描述
      * @return 是否成功
@@ -86,14 +84,14 @@ public:
     double getLevelProgress();
     
     /**
-     * @brief 获取等级称号
+     * @brief 获取等级称号（指向静态等级表，无需复制）
      */
-    string getLevelTitle(int level);
+    std::string_view getLevelTitle(int level) const;
     
     /**
      * @brief 获取当前等级称号
      */
-    string getCurrentLevelTitle();
+    std::string_view getCurrentLevelTitle();
     
     // === 经验值奖励标准 ===
     
@@ -0,0 +1,122 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include "../common/entities.h"
+
+/**
+ * @brief 重复规则（RRULE 子集）
+ *
+ * 支持 FREQ=DAILY|WEEKLY|MONTHLY、INTERVAL、BYDAY（MO..SU，不支持序号）、
+ * BYMONTHDAY（1..31，-1 表示月末）、COUNT、UNTIL（YYYYMMDD[THHMMSS[Z]]），
+ * 例如 "FREQ=WEEKLY;INTERVAL=2;BYDAY=MO,WE"。
+ * 旧的 "once"/"daily"/"weekly"/"monthly" 仍可解析；按月重复且未指定 BYDAY/BYMONTHDAY 时，
+ * 起点日期超出当月天数则取月末（显式 BYMONTHDAY 按 RFC 5545 跳过该月）。
+ */
+struct RecurrenceRule {
+    enum class Frequency : std::uint8_t { None, Daily, Weekly, Monthly };
+
+    Frequency freq = Frequency::None;
+    int interval = 1;
+    std::uint8_t byDayMask = 0;         // bit 0 = 周一 ... bit 6 = 周日
+    std::uint32_t byMonthDayMask = 0;   // bit d = 每月第 d 天，bit 0 = 月末
+    int count = 0;                      // 0 表示不限次数
+    std::int64_t until = 0;             // 0 表示不限结束时间（epoch 秒，含）
+
+    bool isRecurring() const { return freq != Frequency::None; }
+
+    // 解析失败时返回 false，error 给出原因
+    static bool parse(const std::string& text, RecurrenceRule& rule, std::string* error = nullptr);
+    static RecurrenceRule fromType(ReminderType type);
+    ReminderType type() const;
+    // 对应 reminders.recurrence 列的分类："once"/"daily"/"weekly"/"monthly"
+    const char* category() const;
+};
+
+/**
+ * @brief 一条规则加上起点，按本地日历在整数天上展开触发时间
+ *
+ * 起点在构造时拆成本地日期编号（自 1970-01-01 起的天数）与当天秒数，之后的计算都是整数运算，
+ * 只在输出时用 mktime 换算回 epoch，因此跨夏令时保持墙上时间不变。所有方法都不分配内存。
+ */
+class RecurrenceSeries {
+public:
+    RecurrenceSeries(const RecurrenceRule& rule, std::time_t anchor);
+
+    const RecurrenceRule& rule() const { return recurrenceRule; }
+    std::time_t anchor() const { return anchorEpoch; }
+
+    // 严格晚于 after 的第一次触发；没有更多触发时返回 -1
+    std::time_t nextAfter(std::time_t after) const;
+
+    // 把严格晚于 after 的至多 n 次触发写入 out，返回实际个数
+    size_t nextN(std::time_t after, std::time_t* out, size_t n) const;
+
+private:
+    friend class OccurrenceIterator;
+
+    static constexpr int MAX_DAYS_PER_PERIOD = 31;
+
+    RecurrenceRule recurrenceRule;
+    std::time_t anchorEpoch;
+    int anchorDay;          // 本地日期编号
+    int secondsOfDay;       // 当天的时分秒
+    int anchorMonth;        // year * 12 + (month - 1)
+    int anchorMonthDay;
+
+    // 第 period 个周期内的候选日期（升序，已过滤掉起点之前的日期），返回个数
+    int candidates(long long period, int* days) const;
+    // 不会越过 after 所在日期的最大周期下标（有 COUNT 时只能从 0 开始数）
+    long long firstPeriodNear(std::time_t after) const;
+    std::time_t toEpoch(int day) const;
+};
+
+/**
+ * @brief 惰性展开一条规则在 [from, until) 内的触发时间，不写数据库、不预先生成列表
+ *
+ * 用法：for (OccurrenceIterator it(series, from, until); it.valid(); ++it) { *it ... }
+ */
+class OccurrenceIterator {
+public:
+    OccurrenceIterator(const RecurrenceSeries& series, std::time_t from, std::time_t until);
+
+    bool valid() const { return current != -1 && current < until; }
+    std::time_t operator*() const { return current; }
+    OccurrenceIterator& operator++();
+
+private:
+    const RecurrenceSeries& series;
+    std::time_t until;
+    long long period = 0;
+    std::array<int, RecurrenceSeries::MAX_DAYS_PER_PERIOD> days{};
+    int dayCount = 0;
+    int dayIndex = 0;
+    int emitted = 0;            // 已经过的触发次数（用于 COUNT）
+    std::time_t current = -1;
+
+    void step(int skipBeforeDay);   // 早于 skipBeforeDay 的候选日只计入 COUNT
+};
+
+/**
+ * @brief 单个提醒接下来 K 次触发时间的缓存，规则或起点变化时失效
+ */
+struct NextFireCache {
+    static constexpr size_t K = 8;
+
+    std::string rule;
+    std::time_t anchor = -1;
+    std::time_t from = -1;              // times 是严格晚于 from 的前 count 次
+    std::array<std::time_t, K> times{};
+    size_t count = 0;
+
+    bool matches(const std::string& ruleText, std::time_t anchorEpoch) const {
+        return anchor == anchorEpoch && rule == ruleText;
+    }
+
+    /**
+     * @brief 命中时写入 next（没有更多触发时为 -1）并返回 true；需要重新计算时返回 false
+     */
+    bool lookup(std::time_t after, std::time_t& next) const;
+    void refill(const std::string& ruleText, const RecurrenceSeries& series, std::time_t after);
+};
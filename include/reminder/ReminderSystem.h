@@ -1,24 +1,87 @@
 #pragma once
 #include <vector>
+#include <cstdint>
 #include <string>
 #include <chrono>
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <functional>
+#include <optional>
 #include "../database/DAO/ReminderDAO.h"  // 包含队友的DAO头文件
 #include "../common/entities.h"  // 包含实体定义
+#include "TimingWheel.h"
+#include "Recurrence.h"
+
+/**
+ * @brief 日程视图中的一次提醒；重复提醒按规则展开，不对应单独的数据库记录
+ */
+struct ReminderOccurrence {
+    Reminder reminder;
+    Timestamp occursAt;
+};
+
+/**
+ * @brief 补发策略：守护线程停机或休眠后，对超过宽限期的错过提醒如何通知
+ *
+ * 无论哪种策略，错过的提醒都会被标记为已触发（重复提醒推进到下一次），只影响是否弹出通知。
+ */
+enum class CatchUpPolicy {
+    FireAll,      // 全部通知（按任务合并）
+    FireLatest,   // 只通知最晚的一个错过提醒
+    Skip          // 不通知错过的提醒
+};
 
 class ReminderSystem {
+public:
+    /**
+     * @brief 提醒的触发时间发生变化时回调；due 为空表示该提醒不再需要触发（删除、禁用、已触发）
+     */
+    using ScheduleListener = std::function<void(int reminderId, std::optional<Timestamp> due)>;
+
 private:
-    std::vector<Reminder> reminders;
     std::unique_ptr<ReminderDAO> reminderDAO;
+    ScheduleListener scheduleListener;
+    std::mutex listenerMutex;
+    std::atomic<CatchUpPolicy> catchUpPolicy{CatchUpPolicy::FireAll};
+    std::atomic<int> catchUpGraceSeconds{300};
+    std::mutex fireMutex;   // 守护线程与手动检查不能同时处理同一批到期提醒
+
+    // 每个重复提醒接下来的 K 次触发时间，规则或起点变化时自动失效
+    std::unordered_map<int, NextFireCache> fireTimeCache;
+    std::mutex fireTimeCacheMutex;
+
+    // 严格晚于 after 的下一次触发时间，一次性提醒或规则已结束（COUNT/UNTIL）时返回 -1
+    std::time_t nextOccurrenceAfter(const Reminder& reminder, std::time_t after);
+    void forgetFireTimes(int reminderId);
+    // 按关联任务合并通知，同一任务的多个提醒只输出一次
+    void notifyGrouped(const std::vector<const Reminder*>& reminders);
+
+    void notifyScheduleChanged(const Reminder& reminder);
+    void notifyScheduleRemoved(int reminderId);
     
 public:
     ReminderSystem(std::unique_ptr<ReminderDAO> dao);
+
+    // 由 ReminderDaemon 注册，用于在增删改提醒时唤醒调度线程
+    void setScheduleListener(ScheduleListener listener);
+    
+    // 超过 graceSeconds 仍未触发的提醒视为错过，按 policy 处理
+    void setCatchUpPolicy(CatchUpPolicy policy, int graceSeconds = 300);
+    // "all" / "latest" / "skip"
+    static bool parseCatchUpPolicy(const std::string& text, CatchUpPolicy& policy);
     
     // 核心方法
     void initialize();
     void checkDueReminders();
+    /**
+     * @brief 触发所有到期提醒：一个事务内批量标记/推进，按任务合并通知
+     * @return 本次处理的到期提醒数；写库失败时返回 -1，这一批保持待触发
+     */
+    int fireDueReminders();
     bool addReminder(const std::string& title, const std::string& message,
                     const std::string& time, const std::string& rule = "once",
                     int task_id = 0);
@@ -27,24 +90,33 @@ public:
     
     // 工具方法
     bool isReminderDue(const Reminder& reminder) const;
+    // 把重复提醒的下一次触发时间原地推进到当前时间之后，不新增记录
     void processRecurringReminder(const Reminder& reminder);
+    // 一次提醒触发后的收尾：一次性提醒标记为已触发，重复提醒推进到下一次
+    bool finishOccurrence(const Reminder& reminder);
     std::string calculateNextTriggerTime(const Reminder& reminder) const;
     // 重复提醒计算：根据当前时间和提醒类型计算下一次提醒时间
     std::string calculateNextReminderTime(
         const std::string& currentTime,
         ReminderType type) const;
-    bool loadRemindersFromDB();
+    bool loadRemindersFromDB();   // 仅统计待触发数量，提醒按需从数据库读取
     
-    // 时间工具方法
+    // 时间工具方法：字符串只在 CLI / Web 边界出现，内部一律使用 Timestamp
     std::string getCurrentTime() const;
-    std::time_t parseTimeString(const std::string& timeStr) const;
+    std::time_t parseTimeString(const std::string& timeStr) const;   // 失败返回 -1
     std::string formatTime(std::time_t time) const;
-    std::chrono::system_clock::time_point stringToTimePoint(const std::string& timeStr) const;
     
     // 新增方法
+    std::optional<Reminder> getReminder(int reminderId);
     std::vector<Reminder> getActiveReminders();
     std::vector<Reminder> getRemindersByTask(int taskId);
     std::vector<Reminder> getDueRemindersForToday();
+    // [from, until) 内所有待触发的提醒，重复提醒惰性展开为各次触发，按时间排序
+    std::vector<ReminderOccurrence> getAgenda(Timestamp from, Timestamp until);
+    std::vector<ReminderOccurrence> getTodayAgenda();
+    std::vector<ReminderOccurrence> getWeekAgenda();   // 今天起 7 天
+    // 触发时间在 [fromEpoch, untilEpoch) 内的待触发提醒（仅 ID 与时间）
+    std::vector<ReminderScheduleEntry> getPendingSchedule(std::int64_t fromEpoch, std::int64_t untilEpoch);
     bool markReminderAsTriggered(int reminderId);
     bool rescheduleReminder(int reminderId, const std::string& newTime);
     bool updateReminder(int reminderId,
@@ -60,24 +132,55 @@ public:
     void notifyUser(const Reminder& reminder);
 };
 
+/**
+ * @brief 提醒调度守护线程
+ *
+ * 只把未来 7 天内的待触发提醒（ID + 触发时间）放进分层时间轮，更远的提醒留在数据库，
+ * 跨天时按 trigger_epoch 索引加载新进入窗口的一天。线程在 condition_variable 上睡到
+ * 时间轮的下一个到期槽位或边界；ReminderSystem 增删改提醒时通过 ScheduleListener
+ * 更新时间轮并唤醒线程。
+ */
 class ReminderDaemon {
 private:
     ReminderSystem& reminderSystem;
     std::thread worker;
     std::atomic<bool> running{false};
 
-    void runLoop();  // 后台循环：定期调用checkPendingReminders
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    TimingWheel wheel;
+    // 窗口内每个提醒当前有效的代号；时间轮中代号不一致的旧条目到期时丢弃
+    std::unordered_map<int, std::uint32_t> generations;
+    std::uint32_t nextGeneration = 1;
+    std::int64_t loadedUntil = 0;   // 已从数据库加载到的时间（不含）
+    int retryDelaySeconds = 0;      // 触发失败后的重试间隔，成功后清零
+
+    static constexpr int RETRY_MIN_SECONDS = 5;
+    static constexpr int RETRY_MAX_SECONDS = 300;
+
+    void runLoop();
+    void schedule(int reminderId, std::optional<Timestamp> due);
+    void loadPending();
+    void loadWindow(std::int64_t fromEpoch, std::int64_t untilEpoch);   // 调用方持有 mutex
+    void enqueue(int reminderId, std::int64_t dueEpoch);                // 调用方持有 mutex
 
 public:
     explicit ReminderDaemon(ReminderSystem& system);
     ~ReminderDaemon();
 
-    // 启动定期检查
+    ReminderDaemon(const ReminderDaemon&) = delete;
+    ReminderDaemon& operator=(const ReminderDaemon&) = delete;
+
+    // 启动调度线程
     void startChecking();
+    void stop();
 
-    // 检查待触发的提醒（供守护线程或手动调用）
+    // 重新从数据库加载待触发提醒（供手动调用）
     void checkPendingReminders();
 
     // 触发单个提醒
     void triggerReminder(int reminderId);
+
+    // 时间窗口内等待触发的提醒数量
+    size_t pendingCount();
 };
@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief 分层时间轮 - 秒/分/时/天四层，覆盖未来 7 天
+ *
+ * 插入按距离当前刻度的时间差直接定位到某一层的槽位，O(1)；
+ * 推进时逐秒处理秒轮，跨越分/时/天边界时把上一层对应槽位的条目重新分配到下层。
+ * 槽位里只保存 16 字节的 Entry，提醒的完整数据仍在数据库中。
+ * 非线程安全，由 ReminderDaemon 在自己的互斥锁内使用。
+ */
+class TimingWheel {
+public:
+    struct Entry {
+        std::int64_t dueEpoch;
+        std::int32_t reminderId;
+        std::uint32_t generation;   // 与调度方记录的代号不一致时视为已删除或已改期
+    };
+    static_assert(sizeof(Entry) == 16, "时间轮槽位条目应保持 16 字节");
+
+    static constexpr std::int64_t SECONDS_PER_DAY = 86400;
+    static constexpr std::int64_t HORIZON_DAYS = 7;
+
+    explicit TimingWheel(std::int64_t nowEpoch = 0);
+
+    // 清空并把当前刻度设为 nowEpoch
+    void reset(std::int64_t nowEpoch);
+
+    /**
+     * @brief 插入条目；已到期的条目在下一次 advance 时立即返回
+     * @return 超出 horizonEnd() 时返回 false，由调用方在窗口滑动后再加载
+     */
+    bool insert(const Entry& entry);
+
+    /**
+     * @brief 推进到 nowEpoch，把到期条目追加到 expired（可能包含失效条目，由调用方按代号过滤）
+     */
+    void advance(std::int64_t nowEpoch, std::vector<Entry>& expired);
+
+    /**
+     * @brief 下一次需要推进的时间：最早到期的秒槽或最早的非空上层槽位边界；为空时返回 INT64_MAX
+     */
+    std::int64_t nextWakeEpoch() const;
+
+    // 当前刻度所在天的起点 + 7 天；早于该时间的条目都能放进时间轮
+    std::int64_t horizonEnd() const;
+
+    std::int64_t currentEpoch() const { return tick; }
+    size_t size() const { return total; }
+    bool empty() const { return total == 0; }
+
+private:
+    struct Level {
+        std::int64_t resolution;    // 每个槽位覆盖的秒数
+        std::vector<std::vector<Entry>> slots;
+        size_t count = 0;
+    };
+
+    static constexpr size_t LEVEL_COUNT = 4;
+
+    std::array<Level, LEVEL_COUNT> levels;
+    std::vector<Entry> ready;       // 插入时已到期的条目
+    std::int64_t tick = 0;
+    size_t total = 0;
+
+    void place(const Entry& entry);
+    void cascade(size_t level);
+    std::int64_t span(size_t level) const;
+};
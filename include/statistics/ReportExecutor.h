@@ -0,0 +1,51 @@
+#ifndef REPORT_EXECUTOR_H
+#define REPORT_EXECUTOR_H
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief 报表任务图执行器 - 把相互独立的统计查询分发到多个只读连接并行执行
+ *
+ * 每个节点是一个无返回值的任务（通常在 lambda 中把结果写入调用方的局部变量），
+ * 可声明依赖的节点；run() 按依赖关系调度，所有节点完成后返回。
+ * 并行度默认等于 DatabaseManager 的只读连接池大小。
+ */
+class ReportExecutor {
+public:
+    using NodeId = size_t;
+
+    explicit ReportExecutor(size_t maxParallel = 0);
+
+    /**
+     * @brief 添加任务节点
+     * @param task 任务
+     * @param dependencies 需要先完成的节点
+     * @return 节点 ID，可作为其他节点的依赖
+     */
+    NodeId add(std::function<void()> task, const std::vector<NodeId>& dependencies = {});
+
+    /**
+     * @brief 执行所有节点并等待完成（每个 ReportExecutor 只执行一次）
+     *
+     * 节点抛出的异常在工作线程内捕获，依赖它的节点不再执行；全部线程结束后
+     * 在调用线程重新抛出第一个失败节点（按添加顺序）的异常。
+     */
+    void run();
+
+private:
+    struct Node {
+        std::function<void()> task;
+        std::vector<NodeId> dependents;
+        size_t pendingDependencies = 0;
+        bool skipped = false;           // 依赖的节点失败或被跳过
+        std::exception_ptr error;
+    };
+
+    std::vector<Node> nodes;
+    size_t maxParallel;
+};
+
+#endif // REPORT_EXECUTOR_H
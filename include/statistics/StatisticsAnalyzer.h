@@ -4,7 +4,10 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 #include "../database/DatabaseManager.h"
+#include "database/DAO/StatisticsDAO.h"
+#include "common/entities.h"
 
 using namespace std;
 
@@ -17,6 +20,7 @@ using namespace std;
 class StatisticsAnalyzer {
 private:
     DatabaseManager* dbManager;
+    unique_ptr<StatisticsDAO> statsDAO;   // 时间维度/趋势类统计统一走 DAO 的预编译查询
     
     // 辅助方法
     int queryInt(const string& sql);
@@ -24,6 +28,7 @@ private:
     string getCurrentDate();
     string getWeekStartDate();
     string getMonthStartDate();
+    int countCompletedSince(int startDay);
     
 public:
     StatisticsAnalyzer();
@@ -91,14 +96,19 @@ public:
     int getLongestStreak();
     
     /**
-     * @brief 更新连续打卡记录
+     * @brief 获取连续打卡历史（每段连续区间一条记录）
+     */
+    vector<StreakRecord> getStreakHistory();
+    
+    /**
+     * @brief 将连续打卡结果同步到 user_stats 表
      */
     void updateStreak();
     
     // === 番茄钟统计 ===
     
     /**
-     * @brief 获取总番茄钟数
+     * @brief 获取总番茄钟数（pomodoro_sessions 中完成的会话数）
      */
     int getTotalPomodoros();
     
@@ -167,6 +177,11 @@ public:
      * @return 日期->完成数映射
      */
     map<string, int> getTaskCompletionData(int days = 90);
+    
+    /**
+     * @brief 获取底层统计 DAO（趋势、生产力、番茄钟等细分统计）
+     */
+    StatisticsDAO& getStatisticsDAO();
 };
 
 #endif // STATISTICS_ANALYZER_H
@@ -0,0 +1,65 @@
+#ifndef STREAK_TRACKER_H
+#define STREAK_TRACKER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include "common/entities.h"
+
+/**
+ * @brief 连续打卡引擎 - 基于真实的每日完成记录推导连续天数
+ *
+ * 启动后首次读取时用一条 GROUP BY 查询加载所有"有完成任务的日期"，
+ * 顺序扫描一次合并为若干连续区间 [startDay, endDay]；之后每次完成任务
+ * 只需 O(log n) 地合并相邻区间，当前/最长连续天数与历史记录都直接从内存读取。
+ *
+ * 日期统一使用 DayNumber 的天数（UTC），直接对应 tasks.completed_day 列，
+ * 与 datetime('now') 写入的 completed_date 保持一致。
+ */
+class StreakTracker {
+public:
+    static StreakTracker& getInstance();
+
+    StreakTracker(const StreakTracker&) = delete;
+    StreakTracker& operator=(const StreakTracker&) = delete;
+
+    /**
+     * @brief 记录某天有任务完成（增量更新，不访问数据库）
+     * @return 当前连续天数是否发生变化
+     */
+    bool recordCompletion(int day);
+
+    /**
+     * @brief 标记缓存失效（任务被重新打开等无法增量处理的情况），下次读取时重新加载
+     */
+    void invalidate();
+
+    int getCurrentStreak();
+    int getLongestStreak();
+
+    /**
+     * @brief 获取所有连续区间（按时间先后），最后一段如仍在延续则 isActive = true
+     */
+    std::vector<StreakRecord> getStreakHistory();
+
+    // === 日期工具 ===
+    static int today();
+    static int dayFromDate(const std::string& date);   // "YYYY-MM-DD..." -> 天数，失败返回 INT_MIN
+    static std::string dateFromDay(int day);           // 天数 -> "YYYY-MM-DD"
+
+private:
+    StreakTracker() = default;
+
+    void ensureLoaded();
+    void loadFromDatabase();
+    void insertDay(int day);
+    int currentStreakLocked(int todayDay) const;
+
+    std::mutex mutex;
+    bool loaded = false;
+    std::map<int, int> runs;   // 区间起始日 -> 区间结束日（含）
+    int longestStreak = 0;
+};
+
+#endif // STREAK_TRACKER_H
@@ -0,0 +1,51 @@
+#ifndef TAG_REGISTRY_H
+#define TAG_REGISTRY_H
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 标签名驻留表 - tags 表在内存中的镜像
+ *
+ * 每个标签名在进程内只保存一份，任务与标签的关联（task_tags）只存整数 id，
+ * 过滤和标签云都按 id 查询，展示时再由 id 取回名称。
+ * 名称按 ASCII 不区分大小写，与 tags.name 的 COLLATE NOCASE 一致；首次使用时从 tags 表整体加载。
+ */
+class TagRegistry {
+public:
+    static TagRegistry& getInstance();
+
+    TagRegistry(const TagRegistry&) = delete;
+    TagRegistry& operator=(const TagRegistry&) = delete;
+
+    // 把 "a, b，c" 拆成去掉首尾空白、去重（不区分大小写）的标签列表，保持输入顺序
+    static std::vector<std::string> parse(const std::string& tags);
+    // 规范化后的存储格式："a,b,c"
+    static std::string join(const std::vector<std::string>& tags);
+
+    // 取得标签 id，不存在时写入 tags 表（在主连接上，可处于调用方的事务中）；失败返回 -1
+    int intern(const std::string& name);
+    // 只查不建，从未出现过的标签返回 nullopt
+    std::optional<int> find(const std::string& name);
+    // 未知 id 返回空串
+    std::string nameOf(int id);
+
+    // 写入 tags 的事务回滚或数据库重建后调用，下次使用时重新加载
+    void clear();
+
+private:
+    TagRegistry() = default;
+
+    std::mutex mutex;
+    bool loaded = false;
+    std::unordered_map<std::string, int> ids;       // 键为小写名称
+    std::unordered_map<int, std::string> names;
+
+    bool ensureLoaded();                            // 调用方持有 mutex
+    void remember(int id, const std::string& name); // 调用方持有 mutex
+};
+
+#endif // TAG_REGISTRY_H
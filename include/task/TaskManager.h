@@ -41,6 +41,18 @@ public:
     // ===== 查询功能 =====
     std::vector<Task> getOverdueTasks();
     std::vector<Task> getTodayTasks();
+    // 全文检索标题/描述/标签，按相关度排序；truncated 见 TaskDAO::searchTasks
+    std::vector<TaskSearchHit> searchTasks(const std::string& query, int limit = 20, int offset = 0,
+                                           bool* truncated = nullptr);
+    // 组合条件查询一页任务，见 TaskQuery
+    bool queryTasks(const TaskQuery& query, TaskPage& page);
+
+    // ===== 标签 =====
+    // tags 为逗号分隔的完整标签列表，替换任务原有的标签
+    bool setTaskTags(int taskId, const std::string& tags);
+    // matchAll 为 true 时要求包含全部标签，否则包含任一标签
+    std::vector<Task> getTasksByTags(const std::vector<std::string>& tags, bool matchAll = true);
+    std::vector<TagCount> getTagCloud(int limit = 50);
 
     // ===== 统计 =====
     int getTaskCount();
@@ -0,0 +1,72 @@
+#ifndef TASK_QUERY_H
+#define TASK_QUERY_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/TimeTypes.h"
+#include "task/task.h"
+
+// 游标：上一页最后一行的排序键与 id，含义随排序方式而定（按最新排序时 key 不使用）
+struct TaskCursor {
+    std::int64_t key = 0;
+    int id = 0;
+};
+
+/**
+ * @brief 任务查询条件 - 各条件可任意组合，由 TaskDAO 编译成一条参数化 SQL
+ *
+ * 只有“用了哪些条件、按什么排序”决定 SQL 文本（查询形状），取值全部是绑定参数，
+ * 同一形状复用同一条预编译语句，每种形状对应一个驱动索引（见 TaskDAOImpl::queryTasks）。
+ * 分页使用游标而不是 OFFSET，翻到第几页代价都一样。
+ *
+ *     TaskQuery q;
+ *     q.status(false).dueBetween(std::nullopt, DayNumber::todayUtc() - 1).sortBy(TaskQuery::Sort::DueDate);
+ */
+struct TaskQuery {
+    enum class Sort { Newest, DueDate, Priority };
+
+    static constexpr int DEFAULT_LIMIT = 50;
+    static constexpr int MAX_LIMIT = 500;
+
+    std::optional<bool> completed;
+    std::optional<int> projectId;
+    std::optional<int> minPriority;
+    std::optional<int> maxPriority;
+    std::optional<DayNumber> dueFrom;       // 闭区间；设置任一端时不含没有截止日期的任务
+    std::optional<DayNumber> dueTo;
+    std::vector<std::string> tagNames;
+    bool matchAllTags = true;               // false 表示包含任一标签即可
+    std::string text;                       // 全文检索，规则同 TaskDAO::searchTasks
+    Sort sort = Sort::Newest;               // 最新创建 / 截止日期最早（无截止日期排最后）/ 优先级最高
+    int limit = DEFAULT_LIMIT;              // 0 表示不限
+    std::optional<TaskCursor> after;
+
+    TaskQuery& status(bool isCompleted) { completed = isCompleted; return *this; }
+    TaskQuery& project(int id) { projectId = id; return *this; }
+    TaskQuery& priorityBetween(int low, int high) { minPriority = low; maxPriority = high; return *this; }
+    TaskQuery& dueBetween(std::optional<DayNumber> from, std::optional<DayNumber> to) {
+        dueFrom = from;
+        dueTo = to;
+        return *this;
+    }
+    TaskQuery& tags(std::vector<std::string> names, bool matchAll = true) {
+        tagNames = std::move(names);
+        matchAllTags = matchAll;
+        return *this;
+    }
+    TaskQuery& matching(const std::string& query) { text = query; return *this; }
+    TaskQuery& sortBy(Sort order) { sort = order; return *this; }
+    TaskQuery& take(int n) { limit = n; return *this; }
+    TaskQuery& startAfter(const TaskCursor& cursor) { after = cursor; return *this; }
+};
+
+struct TaskPage {
+    std::vector<Task> tasks;
+    std::optional<TaskCursor> next;     // 还有下一页时给出
+    std::string index;                  // 本次查询形状的驱动索引，便于排查慢查询
+};
+
+#endif // TASK_QUERY_H
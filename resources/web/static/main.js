@@ -12,11 +12,17 @@ let pomoPaused = false;
 let pomoRemainingMs = 0;
 let pomoTotalMs = 0;
 let pomoCompletionPending = false; // Flag to prevent duplicate XP awards
+let pomoCycles = 0;
 let reminderCheckInterval = null;
 let remindersEnabled = true;
 let pendingReminderQueue = [];
 let previousXpLevel = 0;
 let previousAchievements = [];
+let taskSearchQuery = "";
+let taskSearchTimer = null;
+let taskSearchSeq = 0;
+let selectedTags = [];
+let taskQueryNext = null;
 
 async function fetchJSON(url) {
   const r = await fetch(url);
@@ -220,6 +226,162 @@ function toggleReminders(enabled) {
   }
 }
 
+// ============================================
+// TASK SEARCH & TAG FILTER
+// ============================================
+// Full-text search and tag filtering both run on the server. Search results
+// carry nameHtml/snippetHtml already escaped with matches wrapped in <mark>.
+// The two are exclusive: typing a query clears the selected tags and vice versa.
+// Tags, status and sort combine into one /api/tasks/query call paged by cursor.
+const TASK_SEARCH_DEBOUNCE_MS = 200;
+const TASK_SEARCH_LIMIT = 50;
+const TASK_QUERY_LIMIT = 50;
+const TAG_CLOUD_LIMIT = 30;
+
+function renderTaskResult(t, nameHtml, detailHtml) {
+  const priorityClass = t.priority === 2 ? 'high-priority' : t.priority === 1 ? 'medium-priority' : 'low-priority';
+  return `
+    <div class="task-item ${priorityClass} ${t.completed ? 'completed' : ''}">
+      <div class="task-header">
+        <div class="task-title-section">
+          <div class="task-name">${t.completed ? '✅ ' : ''}${nameHtml}</div>
+          ${detailHtml ? `<div class="task-desc">${detailHtml}</div>` : ''}
+        </div>
+      </div>
+      <div class="task-badges">
+        ${t.tags ? `<span class="task-badge">🏷️ ${escapeHtml(t.tags)}</span>` : ''}
+        ${t.due ? `<span class="task-badge">📅 ${escapeHtml(t.due)}</span>` : ''}
+      </div>
+      <div class="controls" style="margin-top: 12px;">
+        <button class="btn-gamified ${t.completed ? '' : 'btn-complete'}" data-action="complete" data-id="${t.id}">${t.completed ? '↩️ Undo' : '✅ Complete'}</button>
+        <button data-action="edit-task" data-id="${t.id}">✏️ Edit</button>
+        <button data-action="delete" data-id="${t.id}">🗑️ Delete</button>
+      </div>
+    </div>
+  `;
+}
+
+async function runTaskSearch() {
+  const seq = ++taskSearchSeq;
+  const query = taskSearchQuery;
+  const res = await fetchJSON(`/api/tasks/search?q=${encodeURIComponent(query)}&limit=${TASK_SEARCH_LIMIT}`);
+  if (seq !== taskSearchSeq) return; // a newer query is in flight
+
+  const resultsEl = document.getElementById("task-search-results");
+  document.getElementById("task-count").textContent =
+    `${res.results.length}${res.hasMore ? '+' : ''} matches`;
+  if (!res.results.length) {
+    resultsEl.innerHTML = `<div class="muted micro">No tasks match "${escapeHtml(query)}"</div>`;
+    return;
+  }
+  let note = "";
+  if (res.truncated) {
+    note = `<div class="muted micro">Too many matches — only the most recent tasks were ranked and older ones are not shown. Refine the query to reach them.</div>`;
+  } else if (res.hasMore) {
+    note = `<div class="muted micro">Showing the top ${res.results.length} matches — refine the query to narrow it down.</div>`;
+  }
+  resultsEl.innerHTML = res.results.map(t => renderTaskResult(t, t.nameHtml, t.snippetHtml)).join('') + note;
+}
+
+function taskQueryUrl(after) {
+  const params = new URLSearchParams({
+    status: document.getElementById("task-status-filter").value,
+    sort: document.getElementById("task-sort").value,
+    limit: TASK_QUERY_LIMIT,
+  });
+  if (selectedTags.length) params.set("tags", selectedTags.join(','));
+  if (after) params.set("after", after);
+  return `/api/tasks/query?${params}`;
+}
+
+// append=true follows the cursor of the previous page
+async function runTaskQuery(append = false) {
+  const seq = append ? taskSearchSeq : ++taskSearchSeq;
+  const res = await fetchJSON(taskQueryUrl(append ? taskQueryNext : null));
+  if (seq !== taskSearchSeq) return;
+
+  const resultsEl = document.getElementById("task-search-results");
+  resultsEl.querySelector(".load-more")?.remove();
+  const html = res.tasks.map(t => renderTaskResult(t, escapeHtml(t.name), t.desc ? escapeHtml(t.desc) : '')).join('');
+  if (append) resultsEl.insertAdjacentHTML("beforeend", html);
+  else resultsEl.innerHTML = html || `<div class="muted micro">No tasks match the current filters</div>`;
+
+  taskQueryNext = res.next;
+  const shown = resultsEl.querySelectorAll(".task-item").length;
+  document.getElementById("task-count").textContent = `${shown}${res.next ? '+' : ''} items`;
+  if (res.next) {
+    resultsEl.insertAdjacentHTML("beforeend", `<div class="load-more"><button id="task-load-more">Load more</button></div>`);
+  }
+}
+
+// Re-run whichever filter is active; shows the full list when none is
+async function refreshTaskResults() {
+  const filtering = taskSearchQuery.length > 0 || selectedTags.length > 0 ||
+    document.getElementById("task-status-filter").value !== "all" ||
+    document.getElementById("task-sort").value !== "newest";
+  document.getElementById("task-list").hidden = filtering;
+  document.getElementById("task-search-results").hidden = !filtering;
+  if (!filtering) {
+    taskSearchSeq++; // drop any response still in flight
+    document.getElementById("task-count").textContent = `${cachedTasks.length} items`;
+    return;
+  }
+  if (taskSearchQuery) await runTaskSearch();
+  else await runTaskQuery();
+}
+
+async function loadTagCloud() {
+  const cloud = await fetchJSON(`/api/tags?limit=${TAG_CLOUD_LIMIT}`);
+  const el = document.getElementById("tag-cloud");
+  const max = Math.max(1, ...cloud.map(t => t.count));
+  el.innerHTML = cloud.map(t => {
+    const active = selectedTags.some(s => s.toLowerCase() === t.name.toLowerCase());
+    const size = 11 + Math.round(5 * t.count / max);
+    return `<span class="tag-chip ${active ? 'active' : ''}" data-tag="${encodeURIComponent(t.name)}" style="font-size:${size}px" title="${t.open} open / ${t.count} total">${escapeHtml(t.name)} <small>${t.count}</small></span>`;
+  }).join('');
+}
+
+document.getElementById("task-search").addEventListener("input", (e) => {
+  clearTimeout(taskSearchTimer);
+  taskSearchTimer = setTimeout(() => {
+    taskSearchQuery = e.target.value.trim();
+    if (taskSearchQuery && selectedTags.length) {
+      selectedTags = [];
+      document.querySelectorAll("#tag-cloud .tag-chip.active").forEach(c => c.classList.remove("active"));
+    }
+    refreshTaskResults().catch(err => console.error("Task search failed:", err));
+  }, TASK_SEARCH_DEBOUNCE_MS);
+});
+
+document.getElementById("tag-cloud").addEventListener("click", (e) => {
+  const chip = e.target.closest(".tag-chip");
+  if (!chip) return;
+  const tag = decodeURIComponent(chip.dataset.tag);
+  const idx = selectedTags.findIndex(s => s.toLowerCase() === tag.toLowerCase());
+  if (idx >= 0) selectedTags.splice(idx, 1); else selectedTags.push(tag);
+  chip.classList.toggle("active", idx < 0);
+  if (taskSearchQuery) {
+    taskSearchQuery = "";
+    document.getElementById("task-search").value = "";
+  }
+  refreshTaskResults().catch(err => console.error("Tag filter failed:", err));
+});
+
+for (const id of ["task-status-filter", "task-sort"]) {
+  document.getElementById(id).addEventListener("change", () => {
+    refreshTaskResults().catch(err => console.error("Task filter failed:", err));
+  });
+}
+
+document.getElementById("task-search-results").addEventListener("click", (e) => {
+  if (e.target.id !== "task-load-more") return;
+  e.target.disabled = true;
+  runTaskQuery(true).catch(err => {
+    e.target.disabled = false;
+    console.error("Loading more tasks failed:", err);
+  });
+});
+
 function escapeHtml(text) {
   const div = document.createElement('div');
   div.textContent = text;
@@ -733,6 +895,8 @@ async function load() {
       toggleReminders(e.target.checked);
     });
 
+    await loadTagCloud();
+    await refreshTaskResults();
     await loadXPAndAchievements();
     await updatePomoState();
     await loadStatsSummary();
@@ -1218,23 +1382,20 @@ document.body.addEventListener("click", async (e) => {
       await snoozeReminder(parseInt(id, 10), 5);
       pendingReminderQueue = pendingReminderQueue.filter(rid => rid !== parseInt(id, 10));
     } else if (action === "pomo-work") {
-      await post("/api/pomodoro/start");
-      startPomoTimer(25, "Work Session");
+      applyPomoState(await post("/api/pomodoro/start"));
     } else if (action === "pomo-break") {
-      await post("/api/pomodoro/break");
-      startPomoTimer(5, "Short Break");
+      applyPomoState(await post("/api/pomodoro/break"));
     } else if (action === "pomo-long") {
-      await post("/api/pomodoro/longbreak");
-      startPomoTimer(15, "Long Break");
+      applyPomoState(await post("/api/pomodoro/longbreak"));
     } else if (action === "pomo-pause") {
-      pausePomoTimer();
+      applyPomoState(await post("/api/pomodoro/pause"));
     } else if (action === "pomo-resume") {
-      resumePomoTimer();
+      applyPomoState(await post("/api/pomodoro/resume"));
     } else if (action === "pomo-abandon") {
       if (confirm("Are you sure you want to abandon this Pomodoro session? This session will not be counted.")) {
         // First stop the backend pomodoro session
         try {
-          await post("/api/pomodoro/stop");
+          await post("/api/pomodoro/stop?reason=abandoned");
         } catch (e) {
           console.warn("Failed to stop backend pomodoro:", e);
         }
@@ -1258,57 +1419,94 @@ document.body.addEventListener("click", async (e) => {
 });
 
 // Pomodoro Timer Functions
-function startPomoTimer(minutes, mode) {
-  stopPomoTimer();
+// The server owns the deadline; the page only renders the countdown from the
+// latest state, so reloading or reconnecting resumes exactly where it was.
+const POMO_PHASE_LABELS = {
+  work: "Work Session",
+  short_break: "Short Break",
+  long_break: "Long Break"
+};
+
+function applyPomoState(state) {
+  if (!state || state.phase === undefined) return;
+  pomoCycles = state.cycles || 0;
+  if (state.phase === "idle") {
+    if (pomoTimer || pomoPaused) stopPomoTimer();
+    return;
+  }
+
+  const mode = POMO_PHASE_LABELS[state.phase] || state.phase;
+  const modeChanged = mode !== pomoMode;
   pomoMode = mode;
-  pomoPaused = false;
-  pomoCompletionPending = false; // Reset completion flag
-  pomoTotalMs = minutes * 60 * 1000;
-  pomoEndTime = Date.now() + pomoTotalMs;
-  
-  const timerEl = document.getElementById("pomo-timer");
+  pomoTotalMs = Math.max(1, state.phaseSeconds * 1000);
+  pomoRemainingMs = state.remainingMs;
+  pomoEndTime = Date.now() + state.remainingMs;
+  if (modeChanged || state.paused !== pomoPaused) pomoCompletionPending = false;
+  pomoPaused = state.paused;
+
   const modeEl = document.getElementById("pomo-mode");
-  const progressBar = document.getElementById("pomo-progress-bar");
   const statusEl = document.getElementById("pomo-status");
-  
-  if (modeEl) modeEl.textContent = mode;
-  if (statusEl) statusEl.textContent = `${mode} started - ${minutes} minutes`;
-  
-  updatePomoPauseButtons(true);
-  
-  pomoTimer = setInterval(() => {
-    const remaining = Math.max(0, pomoEndTime - Date.now());
-    const mins = Math.floor(remaining / 60000);
-    const secs = Math.floor((remaining % 60000) / 1000);
-    
-    if (timerEl) timerEl.textContent = `${pad(mins)}:${pad(secs)}`;
-    
-    const progress = ((pomoTotalMs - remaining) / pomoTotalMs) * 100;
-    if (progressBar) progressBar.style.width = `${progress}%`;
-    
-    if (remaining <= 0 && !pomoCompletionPending) {
-      pomoCompletionPending = true; // Prevent duplicate handling
-      handlePomodoroCompletion(mode, timerEl, modeEl, statusEl);
-    }
-  }, 1000);
+  if (pomoPaused) {
+    if (modeEl) modeEl.textContent = "⏸️ " + pomoMode + " (Paused)";
+    if (statusEl) statusEl.textContent = `${pomoMode} paused`;
+  } else {
+    if (modeEl) modeEl.textContent = pomoMode;
+    if (statusEl && modeChanged) statusEl.textContent = `${pomoMode} started - ${Math.round(state.phaseSeconds / 60)} minutes`;
+  }
+  updatePomoPauseButtons(!pomoPaused);
+
+  renderPomoTimer();
+  if (!pomoTimer) pomoTimer = setInterval(renderPomoTimer, 1000);
+}
+
+function renderPomoTimer() {
+  const timerEl = document.getElementById("pomo-timer");
+  const progressBar = document.getElementById("pomo-progress-bar");
+  const remaining = pomoPaused ? pomoRemainingMs : Math.max(0, pomoEndTime - Date.now());
+  const mins = Math.floor(remaining / 60000);
+  const secs = Math.floor((remaining % 60000) / 1000);
+
+  if (timerEl) timerEl.textContent = `${pad(mins)}:${pad(secs)}`;
+
+  const progress = ((pomoTotalMs - remaining) / pomoTotalMs) * 100;
+  if (progressBar) progressBar.style.width = `${progress}%`;
+
+  if (!pomoPaused && remaining <= 0 && !pomoCompletionPending) {
+    pomoCompletionPending = true; // Prevent duplicate handling
+    const modeEl = document.getElementById("pomo-mode");
+    const statusEl = document.getElementById("pomo-status");
+    handlePomodoroCompletion(pomoMode, timerEl, modeEl, statusEl);
+  }
 }
 
 // Separate async function to handle completion
 async function handlePomodoroCompletion(mode, timerEl, modeEl, statusEl) {
+  // Give the server a moment to pass its own deadline, then take its word for what happened
+  const cyclesBefore = pomoCycles;
+  let state = null;
+  try {
+    await new Promise((resolve) => setTimeout(resolve, 500));
+    state = await fetchJSON("/api/pomodoro/state");
+  } catch (e) {
+    console.warn("Failed to read pomodoro state:", e);
+  }
+  if (state && state.phase !== "idle" && POMO_PHASE_LABELS[state.phase] === mode && state.remainingMs > 0) {
+    applyPomoState(state); // Not finished yet on the server (clock skew or resumed elsewhere)
+    return;
+  }
+
   stopPomoTimer();
   if (timerEl) timerEl.textContent = "00:00";
   if (modeEl) modeEl.textContent = "✅ " + mode + " Complete!";
   if (statusEl) statusEl.textContent = mode + " completed!";
   
-  // Award XP for completed work session
-  if (mode === "Work Session") {
-    try {
-      await post("/api/pomodoro/complete");
-      showXPCelebration(5, 'Pomodoro completed!');
-    } catch (e) {
-      console.warn("Failed to record pomodoro completion:", e);
-    }
+  // The server awarded XP when the work phase expired; only celebrate what it reports
+  if (mode === "Work Session" && state && state.cycles > cyclesBefore) {
+    showXPCelebration(5, 'Pomodoro completed!');
+    loadXPAndAchievements();
   }
+  // With auto start the next phase is already running on the server
+  if (state) applyPomoState(state);
   
   // Play notification sound or show alert
   try {
@@ -1323,57 +1521,6 @@ async function handlePomodoroCompletion(mode, timerEl, modeEl, statusEl) {
   }
 }
 
-function pausePomoTimer() {
-  if (!pomoTimer || pomoPaused) return;
-  
-  clearInterval(pomoTimer);
-  pomoTimer = null;
-  pomoPaused = true;
-  pomoRemainingMs = Math.max(0, pomoEndTime - Date.now());
-  
-  const modeEl = document.getElementById("pomo-mode");
-  const statusEl = document.getElementById("pomo-status");
-  
-  if (modeEl) modeEl.textContent = "⏸️ " + pomoMode + " (Paused)";
-  if (statusEl) statusEl.textContent = `${pomoMode} paused`;
-  
-  updatePomoPauseButtons(false);
-}
-
-function resumePomoTimer() {
-  if (!pomoPaused || pomoRemainingMs <= 0) return;
-  
-  pomoPaused = false;
-  pomoCompletionPending = false; // Reset completion flag
-  pomoEndTime = Date.now() + pomoRemainingMs;
-  
-  const timerEl = document.getElementById("pomo-timer");
-  const modeEl = document.getElementById("pomo-mode");
-  const progressBar = document.getElementById("pomo-progress-bar");
-  const statusEl = document.getElementById("pomo-status");
-  
-  if (modeEl) modeEl.textContent = pomoMode;
-  if (statusEl) statusEl.textContent = `${pomoMode} resumed`;
-  
-  updatePomoPauseButtons(true);
-  
-  pomoTimer = setInterval(() => {
-    const remaining = Math.max(0, pomoEndTime - Date.now());
-    const mins = Math.floor(remaining / 60000);
-    const secs = Math.floor((remaining % 60000) / 1000);
-    
-    if (timerEl) timerEl.textContent = `${pad(mins)}:${pad(secs)}`;
-    
-    const progress = ((pomoTotalMs - remaining) / pomoTotalMs) * 100;
-    if (progressBar) progressBar.style.width = `${progress}%`;
-    
-    if (remaining <= 0 && !pomoCompletionPending) {
-      pomoCompletionPending = true; // Prevent duplicate handling
-      handlePomodoroCompletion(pomoMode, timerEl, modeEl, statusEl);
-    }
-  }, 1000);
-}
-
 function updatePomoPauseButtons(showPause) {
   const pauseBtn = document.getElementById("pomo-pause-btn");
   const resumeBtn = document.getElementById("pomo-resume-btn");
@@ -1457,8 +1604,10 @@ async function updatePomoState() {
     const statusEl = document.getElementById("pomo-status");
     const totalCyclesEl = document.getElementById("pomo-total-cycles");
     
-    if (statusEl && !pomoTimer) {
-      statusEl.textContent = `Running: ${state.running ? "Yes" : "No"} · Cycles: ${state.cycles}`;
+    applyPomoState(state);
+    if (statusEl && state.phase === "idle") {
+      const next = POMO_PHASE_LABELS[state.nextPhase] || "Work Session";
+      statusEl.textContent = `Next: ${next} · ${state.completedInCycle}/${state.pomodorosUntilLongBreak} until long break · Cycles: ${state.cycles}`;
     }
     if (totalCyclesEl) {
       totalCyclesEl.textContent = state.cycles || 0;
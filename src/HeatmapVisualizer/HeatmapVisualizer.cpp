@@ -1,63 +1,41 @@
 #include "HeatmapVisualizer/HeatmapVisualizer.h"
+#include "statistics/StreakTracker.h"
+#include "database/DatabaseManager.h"
 #include <iostream>
+#include <algorithm>
+#include <climits>
 #include <sstream>
 #include <ctime>
 #include <iomanip>
 
-HeatmapVisualizer::HeatmapVisualizer() {
-    dbPath = "task_manager.db";
-    db = nullptr;
+namespace {
+    const char* SELECT_DAILY_COMPLETIONS_SQL =
+        "SELECT completed_day, COUNT(*) FROM tasks "
+        "WHERE completed = 1 AND deleted = 0 AND completed_day IS NOT NULL "
+        "GROUP BY completed_day ORDER BY completed_day;";
 }
 
-HeatmapVisualizer::HeatmapVisualizer(string dbPath) {
-    this->dbPath = dbPath;
-    db = nullptr;
+HeatmapVisualizer::HeatmapVisualizer()
+    : HeatmapVisualizer("task_manager.db") {
 }
 
-HeatmapVisualizer::~HeatmapVisualizer() {
-    closeDatabase();
+HeatmapVisualizer::HeatmapVisualizer(string dbPath)
+    : dbPath(dbPath), baseDay(0), cachedToday(0), cachedVersion(0),
+      cacheValid(false), totalCompleted(0), detached(false) {
 }
 
-bool HeatmapVisualizer::openDatabase() {
-    int result = sqlite3_open(dbPath.c_str(), &db);
-    if (result != SQLITE_OK) {
-        cerr << "Cannot open database: " << sqlite3_errmsg(db) << endl;
-        return false;
-    }
-    return true;
-}
-
-void HeatmapVisualizer::closeDatabase() {
-    if (db != nullptr) {
-        sqlite3_close(db);
-        db = nullptr;
-    }
+HeatmapVisualizer::~HeatmapVisualizer() {
+    // 连接由 DatabaseManager 统一管理
 }
 
 bool HeatmapVisualizer::initialize() {
-    if (!openDatabase()) return false;
-    
-    const char* checkSQL = 
-        "SELECT name FROM sqlite_master WHERE type='table' AND name='tasks';";
-    
-    sqlite3_stmt* stmt;
-    int result = sqlite3_prepare_v2(db, checkSQL, -1, &stmt, nullptr);
-    
-    if (result != SQLITE_OK) {
-        cerr << "Failed to check tasks table" << endl;
-        closeDatabase();
+    auto& dbManager = DatabaseManager::getInstance();
+    if (!dbManager.isOpen() && !dbManager.initialize(dbPath)) {
+        cerr << "Cannot open database: " << dbPath << endl;
         return false;
     }
     
-    bool tableExists = false;
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        tableExists = true;
-    }
-    
-    sqlite3_finalize(stmt);
-    closeDatabase();
-    
-    if (!tableExists) {
+    if (!dbManager.tableExists("tasks")) {
         cerr << "Warning: tasks table does not exist" << endl;
         return false;
     }
@@ -65,77 +43,134 @@ bool HeatmapVisualizer::initialize() {
     return true;
 }
 
-map<string, int> HeatmapVisualizer::getTaskDataFromDB(int days) {
-    map<string, int> taskData;
-    
-    if (!openDatabase()) return taskData;
-    
-    stringstream sql;
-    sql << "SELECT DATE(completed_date) as date, COUNT(*) as count "
-        << "FROM tasks "
-        << "WHERE completed = 1 "
-        << "AND completed_date IS NOT NULL "
-        << "AND completed_date != '' "
-        << "AND DATE(completed_date) >= DATE('now', '-" << days << " days') "
-        << "GROUP BY DATE(completed_date);";
-    
-    sqlite3_stmt* stmt;
-    int result = sqlite3_prepare_v2(db, sql.str().c_str(), -1, &stmt, nullptr);
-    
-    if (result != SQLITE_OK) {
-        closeDatabase();
-        return taskData;
-    }
+void HeatmapVisualizer::refreshCache() const {
+    if (detached) return;
+    
+    auto& dbManager = DatabaseManager::getInstance();
+    uint64_t version = dbManager.getTableVersion("tasks");
+    int today = StreakTracker::today();
+    
+    if (cacheValid && version == cachedVersion && today == cachedToday) return;
     
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        const char* dateStr = (const char*)sqlite3_column_text(stmt, 0);
-        int count = sqlite3_column_int(stmt, 1);
-        if (dateStr != nullptr) {
-            taskData[string(dateStr)] = count;
+    dayGrid.clear();
+    renderCache.clear();
+    renderOrder.clear();
+    totalCompleted = 0;
+    baseDay = today;
+    
+    if (dbManager.isOpen()) {
+        ReadConnectionLease conn = dbManager.acquireReadConnection();
+        sqlite3_stmt* stmt = conn ? conn.prepare(SELECT_DAILY_COMPLETIONS_SQL) : nullptr;
+        
+        if (stmt) {
+            // 结果按日期升序，第一行即最早的完成日期
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                int day = sqlite3_column_int(stmt, 0);
+                int count = sqlite3_column_int(stmt, 1);
+                
+                if (dayGrid.empty()) baseDay = min(day, today);
+                if (day < baseDay) continue;
+                
+                size_t index = static_cast<size_t>(day - baseDay);
+                if (index >= dayGrid.size()) dayGrid.resize(index + 1, 0);
+                dayGrid[index] = static_cast<uint16_t>(min(count, 0xFFFF));
+                totalCompleted += count;
+            }
+            sqlite3_reset(stmt);
         }
     }
     
-    sqlite3_finalize(stmt);
-    closeDatabase();
+    if (dayGrid.size() < static_cast<size_t>(today - baseDay + 1)) {
+        dayGrid.resize(static_cast<size_t>(today - baseDay + 1), 0);
+    }
+    computeIntensity();
     
-    return taskData;
+    cachedVersion = version;
+    cachedToday = today;
+    cacheValid = true;
 }
 
-string HeatmapVisualizer::getColorBlock(int count) {
-    if (count == 0) return "░";
-    if (count <= 3) return "▒";
-    if (count <= 6) return "▓";
-    return "█";
+void HeatmapVisualizer::computeIntensity() const {
+    // 档位: 0 = 无, 1 = 1-3, 2 = 4-6, 3 = 7+；无分支写法便于编译器向量化
+    const size_t n = dayGrid.size();
+    intensity.resize(n);
+    const uint16_t* counts = dayGrid.data();
+    uint8_t* levels = intensity.data();
+    for (size_t i = 0; i < n; ++i) {
+        uint16_t c = counts[i];
+        levels[i] = static_cast<uint8_t>((c > 0) + (c > 3) + (c > 6));
+    }
 }
 
-int HeatmapVisualizer::getTaskCount(string date) {
-    map<string, int> taskData = getTaskDataFromDB(365);
-    
-    if (taskData.find(date) != taskData.end()) {
-        return taskData[date];
+int HeatmapVisualizer::currentDay() const {
+    return detached ? cachedToday : StreakTracker::today();
+}
+
+int HeatmapVisualizer::countForDay(int day) {
+    refreshCache();
+    if (day < baseDay) return 0;
+    size_t index = static_cast<size_t>(day - baseDay);
+    return index < dayGrid.size() ? dayGrid[index] : 0;
+}
+
+int HeatmapVisualizer::levelForDay(int day) {
+    refreshCache();
+    if (day < baseDay) return 0;
+    size_t index = static_cast<size_t>(day - baseDay);
+    return index < intensity.size() ? intensity[index] : 0;
+}
+
+const string* HeatmapVisualizer::findRendered(const string& key) {
+    refreshCache();
+    auto it = renderCache.find(key);
+    if (it == renderCache.end()) return nullptr;
+    renderOrder.splice(renderOrder.begin(), renderOrder, it->second);
+    return &it->second->second;
+}
+
+const string& HeatmapVisualizer::storeRendered(const string& key, string rendered) {
+    auto it = renderCache.find(key);
+    if (it != renderCache.end()) {
+        renderOrder.erase(it->second);
+        renderCache.erase(it);
     }
-    return 0;
+    if (renderCache.size() >= MAX_RENDERED) {
+        renderCache.erase(renderOrder.back().first);
+        renderOrder.pop_back();
+    }
+    renderOrder.emplace_front(key, std::move(rendered));
+    renderCache[key] = renderOrder.begin();
+    return renderOrder.front().second;
 }
 
-vector<string> HeatmapVisualizer::generateDateRange(int days) {
-    vector<string> dates;
-    time_t now = time(0);
-    
-    for (int i = days - 1; i >= 0; i--) {
-        time_t targetTime = now - (i * 24 * 60 * 60);
-        tm* ltm = localtime(&targetTime);
-        
-        stringstream ss;
-        ss << (1900 + ltm->tm_year) << "-"
-           << setfill('0') << setw(2) << (1 + ltm->tm_mon) << "-"
-           << setfill('0') << setw(2) << ltm->tm_mday;
-        dates.push_back(ss.str());
+map<string, int> HeatmapVisualizer::getCompletionData(int days) {
+    map<string, int> data;
+    int today = currentDay();
+    
+    for (int day = today - days + 1; day <= today; ++day) {
+        int count = countForDay(day);
+        if (count > 0) {
+            data[StreakTracker::dateFromDay(day)] = count;
+        }
     }
     
-    return dates;
+    return data;
+}
+
+const string& HeatmapVisualizer::getColorBlock(int level) {
+    static const string blocks[] = {"░", "▒", "▓", "█"};
+    return blocks[level & 3];
+}
+
+int HeatmapVisualizer::getTaskCount(string date) {
+    int day = StreakTracker::dayFromDate(date);
+    return day == INT_MIN ? 0 : countForDay(day);
 }
 
 string HeatmapVisualizer::generateHeatmap(int days) {
+    const string key = "heatmap:" + to_string(days);
+    if (const string* cached = findRendered(key)) return *cached;
+    
     stringstream output;
     
     output << "\n";
@@ -143,12 +178,15 @@ string HeatmapVisualizer::generateHeatmap(int days) {
     output << "         Task Completion Heatmap (" << days << " days)\n";
     output << "===================================================\n\n";
     
-    map<string, int> taskData = getTaskDataFromDB(days);
-    vector<string> dates = generateDateRange(days);
+    int firstDay = currentDay() - days + 1;
+    bool hasData = false;
+    for (int day = max(firstDay, baseDay); day <= cachedToday && !hasData; ++day) {
+        hasData = levelForDay(day) > 0;
+    }
     
-    if (taskData.empty()) {
+    if (!hasData) {
         output << "No completed tasks found.\n\n";
-        return output.str();
+        return storeRendered(key, output.str());
     }
     
     output << "      ";
@@ -163,14 +201,10 @@ string HeatmapVisualizer::generateHeatmap(int days) {
         output << weekdays[day] << "   ";
         
         for (int week = 0; week < days/7; week++) {
-            int rawIndex = week * 7 + day;
-            if (rawIndex >= 0) {
-                size_t index = static_cast<size_t>(rawIndex);
-                if (index < dates.size()) {
-                    int count = (taskData.find(dates[index]) != taskData.end()) 
-                                ? taskData[dates[index]] : 0;
-                    output << getColorBlock(count) << getColorBlock(count) << "  ";
-                }
+            int index = week * 7 + day;
+            if (index < days) {
+                const string& block = getColorBlock(levelForDay(firstDay + index));
+                output << block << block << "  ";
             }
         }
         output << "\n";
@@ -190,10 +224,13 @@ string HeatmapVisualizer::generateHeatmap(int days) {
     output << "Current streak: " << getCurrentStreak() << " days\n";
     output << "--------------------------------------------------\n\n";
     
-    return output.str();
+    return storeRendered(key, output.str());
 }
 
 string HeatmapVisualizer::generateMonthView(string month) {
+    const string key = "month:" + month;
+    if (const string* cached = findRendered(key)) return *cached;
+    
     stringstream output;
     
     output << "\n";
@@ -203,26 +240,25 @@ string HeatmapVisualizer::generateMonthView(string month) {
     
     output << "Mon Tue Wed Thu Fri Sat Sun\n";
     
-    map<string, int> taskData = getTaskDataFromDB(365);
+    int firstDay = StreakTracker::dayFromDate(month + "-01");
     
     for (int week = 0; week < 4; week++) {
-        for (int day = 1; day <= 7; day++) {
-            int dayNum = week * 7 + day;
-            stringstream dateStr;
-            dateStr << month << "-" << setfill('0') << setw(2) << dayNum;
-            
-            int count = (taskData.find(dateStr.str()) != taskData.end()) 
-                        ? taskData[dateStr.str()] : 0;
-            output << " " << getColorBlock(count) << getColorBlock(count) << " ";
+        for (int day = 0; day < 7; day++) {
+            int level = firstDay == INT_MIN ? 0 : levelForDay(firstDay + week * 7 + day);
+            const string& block = getColorBlock(level);
+            output << " " << block << block << " ";
         }
         output << "\n";
     }
     
     output << "\n";
-    return output.str();
+    return storeRendered(key, output.str());
 }
 
 string HeatmapVisualizer::generateWeekView(string startDate) {
+    const string key = "week:" + startDate;
+    if (const string* cached = findRendered(key)) return *cached;
+    
     stringstream output;
     
     output << "\n";
@@ -231,72 +267,67 @@ string HeatmapVisualizer::generateWeekView(string startDate) {
     output << "=======================================\n\n";
     
     string weekdays[] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
-    map<string, int> taskData = getTaskDataFromDB(365);
+    
+    // 与原实现一致：从所在月的 1 号起连续 7 天
+    int firstDay = StreakTracker::dayFromDate(startDate.substr(0, 8) + "01");
     
     for (int i = 0; i < 7; i++) {
         output << weekdays[i] << ": ";
         
-        stringstream dateStr;
-        dateStr << startDate.substr(0, 8) << setfill('0') << setw(2) << (i + 1);
-        
-        int count = (taskData.find(dateStr.str()) != taskData.end()) 
-                    ? taskData[dateStr.str()] : 0;
+        int count = firstDay == INT_MIN ? 0 : countForDay(firstDay + i);
+        const string& block = getColorBlock(firstDay == INT_MIN ? 0 : levelForDay(firstDay + i));
         
-        output << getColorBlock(count) << getColorBlock(count);
+        output << block << block;
         output << " (" << count << " tasks)\n";
     }
     
     output << "\n";
-    return output.str();
+    return storeRendered(key, output.str());
 }
 
 int HeatmapVisualizer::getTotalTasks() {
-    if (!openDatabase()) return 0;
-    
-    const char* sql = "SELECT COUNT(*) FROM tasks WHERE completed = 1 AND completed_date IS NOT NULL;";
-    sqlite3_stmt* stmt;
-    
-    sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    int count = 0;
-    
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        count = sqlite3_column_int(stmt, 0);
-    }
-    
-    sqlite3_finalize(stmt);
-    closeDatabase();
-    
-    return count;
+    refreshCache();
+    return totalCompleted;
 }
 
 string HeatmapVisualizer::getMostActiveDay() {
-    if (!openDatabase()) return "None";
-    
-    const char* sql = 
-        "SELECT DATE(completed_date) as date, COUNT(*) as count "
-        "FROM tasks WHERE completed = 1 AND completed_date IS NOT NULL "
-        "GROUP BY DATE(completed_date) "
-        "ORDER BY count DESC LIMIT 1;";
-    
-    sqlite3_stmt* stmt;
-    sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    
-    string result = "None";
-    
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        const char* dateStr = (const char*)sqlite3_column_text(stmt, 0);
-        int count = sqlite3_column_int(stmt, 1);
-        if (dateStr != nullptr) {
-            result = string(dateStr) + " (" + to_string(count) + " tasks)";
-        }
-    }
+    refreshCache();
     
-    sqlite3_finalize(stmt);
-    closeDatabase();
+    auto best = max_element(dayGrid.begin(), dayGrid.end());
+    if (best == dayGrid.end() || *best == 0) return "None";
     
-    return result;
+    int day = baseDay + static_cast<int>(best - dayGrid.begin());
+    return StreakTracker::dateFromDay(day) + " (" + to_string(*best) + " tasks)";
 }
 
 int HeatmapVisualizer::getCurrentStreak() {
-    return 7;
-}
\ No newline at end of file
+    return StreakTracker::getInstance().getCurrentStreak();
+}
+
+// === 快照 ===
+
+int HeatmapVisualizer::getBaseDay() const {
+    refreshCache();
+    return baseDay;
+}
+
+const vector<uint16_t>& HeatmapVisualizer::getDayGrid() const {
+    refreshCache();
+    return dayGrid;
+}
+
+void HeatmapVisualizer::loadSnapshot(int snapshotBaseDay, const uint16_t* counts, size_t dayCount) {
+    detached = true;
+    baseDay = snapshotBaseDay;
+    dayGrid.assign(counts, counts + dayCount);
+    if (dayGrid.empty()) dayGrid.push_back(0);
+    
+    totalCompleted = 0;
+    for (uint16_t c : dayGrid) totalCompleted += c;
+    computeIntensity();
+    
+    cachedToday = baseDay + static_cast<int>(dayGrid.size()) - 1;
+    cacheValid = true;
+    renderCache.clear();
+    renderOrder.clear();
+}
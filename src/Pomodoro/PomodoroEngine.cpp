@@ -0,0 +1,486 @@
+#include "Pomodoro/PomodoroEngine.h"
+#include "Pomodoro/PomodoroSessionLog.h"
+#include "database/DatabaseManager.h"
+#include "database/DAO/TaskDAO.h"
+#include "gamification/EventBus.h"
+#include "gamification/XPSystem.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+// ==================== 阶段与配置 ====================
+
+const char* pomodoroPhaseName(PomodoroPhase phase) {
+    switch (phase) {
+        case PomodoroPhase::Work: return "work";
+        case PomodoroPhase::ShortBreak: return "short_break";
+        case PomodoroPhase::LongBreak: return "long_break";
+        case PomodoroPhase::Idle:
+        default: return "idle";
+    }
+}
+
+bool parsePomodoroPhase(const std::string& name, PomodoroPhase& phase) {
+    if (name == "work") phase = PomodoroPhase::Work;
+    else if (name == "short_break" || name == "break") phase = PomodoroPhase::ShortBreak;
+    else if (name == "long_break" || name == "longbreak") phase = PomodoroPhase::LongBreak;
+    else if (name == "idle" || name == "next") phase = PomodoroPhase::Idle;
+    else return false;
+    return true;
+}
+
+int PomodoroConfig::minutesOf(PomodoroPhase phase) const {
+    switch (phase) {
+        case PomodoroPhase::Work: return workMinutes;
+        case PomodoroPhase::ShortBreak: return shortBreakMinutes;
+        case PomodoroPhase::LongBreak: return longBreakMinutes;
+        case PomodoroPhase::Idle:
+        default: return 0;
+    }
+}
+
+std::int64_t PomodoroState::remainingMs(Clock::time_point now) const {
+    if (!isActive()) {
+        return 0;
+    }
+    if (paused) {
+        return pausedRemainingMs;
+    }
+    if (deadline <= now) {
+        return 0;
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+}
+
+int PomodoroState::remainingSeconds() const {
+    if (!isActive()) {
+        return -1;
+    }
+    return static_cast<int>((remainingMs() + 999) / 1000);
+}
+
+// ==================== PomodoroEngine ====================
+
+namespace {
+    static constexpr const char* SQL_LOAD_SETTINGS =
+        "SELECT pomodoro_duration, short_break_duration, long_break_duration, "
+        "pomodoros_until_long_break, auto_start_pomodoros "
+        "FROM user_settings WHERE user_id = ? ORDER BY id DESC LIMIT 1";
+
+    int positiveOr(int value, int fallback) {
+        return value > 0 ? value : fallback;
+    }
+}
+
+void PomodoroEngine::Aftermath::run() {
+    timer.cancel();
+    if (hasRecord) {
+        PomodoroSessionLog::getInstance().append(record);
+    }
+    if (onFinish) {
+        onFinish(completed);
+    }
+}
+
+PomodoroEngine& PomodoroEngine::getInstance() {
+    static PomodoroEngine instance;
+    return instance;
+}
+
+// 先构造计时服务和会话写入器，保证它们晚于引擎析构
+PomodoroEngine::PomodoroEngine() {
+    TimerService::getInstance();
+    PomodoroSessionLog::getInstance();
+}
+
+PomodoroEngine::~PomodoroEngine() {
+    shutdown();
+}
+
+PomodoroConfig PomodoroEngine::loadConfig(int userId) {
+    PomodoroConfig config;
+    DatabaseManager& db = DatabaseManager::getInstance();
+    if (!db.isOpen()) {
+        return config;
+    }
+
+    ReadConnectionLease conn = db.acquireReadConnection();
+    if (!conn) {
+        return config;
+    }
+    sqlite3_stmt* stmt = conn.prepare(SQL_LOAD_SETTINGS);
+    if (!stmt) {
+        return config;
+    }
+    sqlite3_bind_int(stmt, 1, userId);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        const PomodoroConfig defaults;
+        config.workMinutes = positiveOr(sqlite3_column_int(stmt, 0), defaults.workMinutes);
+        config.shortBreakMinutes = positiveOr(sqlite3_column_int(stmt, 1), defaults.shortBreakMinutes);
+        config.longBreakMinutes = positiveOr(sqlite3_column_int(stmt, 2), defaults.longBreakMinutes);
+        config.pomodorosUntilLongBreak = positiveOr(sqlite3_column_int(stmt, 3), defaults.pomodorosUntilLongBreak);
+        config.autoStart = sqlite3_column_int(stmt, 4) != 0;
+    }
+    sqlite3_reset(stmt);
+    return config;
+}
+
+PomodoroConfig PomodoroEngine::configFor(int userId) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = userConfigs.find(userId);
+        if (it != userConfigs.end()) {
+            return it->second;
+        }
+    }
+    // 读库不持有引擎的锁，计时回调不会被查询阻塞
+    PomodoroConfig config = loadConfig(userId);
+    std::lock_guard<std::mutex> lock(mutex);
+    return userConfigs.emplace(userId, config).first->second;
+}
+
+PomodoroEngine::Session& PomodoroEngine::sessionFor(const Key& key, const PomodoroConfig& config) {
+    auto it = sessions.find(key);
+    if (it != sessions.end()) {
+        return it->second;
+    }
+    PomodoroState state;
+    state.userId = key.first;
+    state.sessionId = key.second;
+    state.config = config;
+    Session& session = sessions[key];
+    session.state = std::make_shared<const PomodoroState>(std::move(state));
+    return session;
+}
+
+void PomodoroEngine::publish(Session& session, PomodoroState state) {
+    state.revision = session.state->revision + 1;
+    session.state = std::make_shared<const PomodoroState>(std::move(state));
+}
+
+void PomodoroEngine::armTimer(const Key& key, Session& session, Clock::duration remaining) {
+    const std::uint64_t generation = ++session.generation;
+    // 取消时不做任何事：停止、暂停和替换都由引擎自己在锁外收尾
+    session.timer = TimerService::getInstance().start(
+        remaining,
+        session.onTick,
+        [this, key, generation](bool completed) {
+            if (completed) {
+                onDeadline(key, generation);
+            }
+        });
+}
+
+void PomodoroEngine::beginPhase(const Key& key, Session& session, PomodoroPhase phase,
+                                TickCallback onTick, FinishCallback onFinish, Aftermath& previous) {
+    if (session.state->isActive()) {
+        endPhase(session, false, "replaced", previous);
+    }
+
+    PomodoroState state = *session.state;
+    if (!session.configOverridden) {
+        auto it = userConfigs.find(key.first);
+        if (it != userConfigs.end()) {
+            state.config = it->second;
+        }
+    }
+    state.phase = phase == PomodoroPhase::Idle ? state.nextPhase : phase;
+    state.paused = false;
+    state.pausedRemainingMs = 0;
+    state.phaseSeconds = state.config.minutesOf(state.phase) * 60;
+
+    const auto now = Clock::now();
+    const Clock::duration length = std::chrono::seconds(state.phaseSeconds);
+    state.deadline = now + length;
+
+    session.onTick = std::move(onTick);
+    session.onFinish = std::move(onFinish);
+    if (state.phase == PomodoroPhase::Work) {
+        // 专注时长用单调时钟累计，不受系统改时影响
+        session.record = PomodoroSession();
+        session.record.taskId = state.taskId;
+        session.record.startAt = Timestamp::now();
+        session.record.plannedMinutes = state.config.workMinutes;
+        session.focused = Clock::duration::zero();
+        session.runningSince = now;
+    }
+
+    publish(session, std::move(state));
+    armTimer(key, session, length);
+}
+
+void PomodoroEngine::endPhase(Session& session, bool completed, const std::string& reason, Aftermath& out) {
+    PomodoroState state = *session.state;
+    const PomodoroPhase finished = state.phase;
+    const auto now = Clock::now();
+
+    out.timer = session.timer;
+    session.timer = TimerHandle();
+    ++session.generation;
+    out.onFinish = std::move(session.onFinish);
+    out.completed = completed;
+    session.onFinish = nullptr;
+    session.onTick = nullptr;
+
+    if (finished == PomodoroPhase::Work) {
+        if (!state.paused) {
+            session.focused += now - session.runningSince;
+        }
+        PomodoroSession& record = session.record;
+        record.endAt = Timestamp::now();
+        record.focusSeconds = static_cast<int>(
+            std::chrono::duration_cast<std::chrono::seconds>(session.focused).count());
+        record.completed = completed;
+        record.interrupted = !completed;
+        record.interruptionReason = completed ? "" : reason;
+        out.record = record;
+        out.hasRecord = true;
+    }
+
+    // 状态转移：完成的工作时段计数，攒满一轮进入长休息；长休息结束（或被跳过）后重新计数
+    PomodoroPhase next = PomodoroPhase::Work;
+    if (finished == PomodoroPhase::Work && completed) {
+        ++state.completedInCycle;
+        ++state.completedTotal;
+        next = state.completedInCycle >= state.config.pomodorosUntilLongBreak
+            ? PomodoroPhase::LongBreak : PomodoroPhase::ShortBreak;
+    } else if (finished == PomodoroPhase::LongBreak) {
+        state.completedInCycle = 0;
+    }
+
+    state.phase = PomodoroPhase::Idle;
+    state.nextPhase = next;
+    state.lastPhaseCompleted = completed;
+    state.phaseSeconds = 0;
+    state.paused = false;
+    state.pausedRemainingMs = 0;
+    publish(session, std::move(state));
+}
+
+void PomodoroEngine::onDeadline(const Key& key, std::uint64_t generation) {
+    Aftermath done;
+    Aftermath replaced;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = sessions.find(key);
+        // 计时器到期与停止、暂停同时发生时，先拿到锁的一方生效
+        if (it == sessions.end() || it->second.generation != generation) {
+            return;
+        }
+        Session& session = it->second;
+        endPhase(session, true, "", done);
+        done.timer = TimerHandle();     // 已经到期
+        if (session.state->config.autoStart) {
+            beginPhase(key, session, PomodoroPhase::Idle, nullptr, nullptr, replaced);
+        }
+    }
+    // 只有到期完成的工作时段带记录。先把会话交给写入队列再发奖励，成就按 pomodoro_sessions
+    // 重新统计时不会漏掉已发布的完成事件；onFinish 的调用方随后就能读到新的经验值
+    if (done.hasRecord) {
+        PomodoroSessionLog::getInstance().append(done.record);
+        done.hasRecord = false;
+        rewardCompletedWork(key.first, done.record.taskId);
+    }
+    done.run();
+}
+
+void PomodoroEngine::rewardCompletedWork(int userId, int taskId) {
+    if (!DatabaseManager::getInstance().isOpen()) {
+        return;
+    }
+    std::call_once(rewardsInit, [this] {
+        xpSystem = std::make_unique<XPSystem>();
+        taskDAO = std::make_unique<TaskDAOImpl>();
+    });
+
+    xpSystem->awardXP(xpSystem->getXPForPomodoro(), "complete pomodoro");
+    if (taskId > 0 && !taskDAO->incrementPomodoro(taskId)) {
+        std::cerr << "番茄钟完成，但更新任务 " << taskId << " 的番茄数失败" << std::endl;
+    }
+    EventBus::getInstance().publish({GameEventType::PomodoroCompleted, userId, 1});
+}
+
+PomodoroStatePtr PomodoroEngine::getState(int userId, const std::string& sessionId) {
+    const PomodoroConfig config = configFor(userId);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = sessions.find({userId, sessionId});
+    if (it != sessions.end()) {
+        return it->second.state;
+    }
+    // 只读查询不创建会话
+    PomodoroState state;
+    state.userId = userId;
+    state.sessionId = sessionId;
+    state.config = config;
+    return std::make_shared<const PomodoroState>(std::move(state));
+}
+
+PomodoroStatePtr PomodoroEngine::start(int userId, const std::string& sessionId, PomodoroPhase phase,
+                                       TickCallback onTick, FinishCallback onFinish) {
+    const PomodoroConfig config = configFor(userId);
+    const Key key(userId, sessionId);
+    Aftermath previous;
+    PomodoroStatePtr state;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Session& session = sessionFor(key, config);
+        beginPhase(key, session, phase, std::move(onTick), std::move(onFinish), previous);
+        state = session.state;
+    }
+    // 被替换的阶段以“中断”结束；它的计时器回调因 generation 不同不会改动新阶段
+    previous.run();
+    return state;
+}
+
+PomodoroStatePtr PomodoroEngine::stop(int userId, const std::string& sessionId, const std::string& reason) {
+    Aftermath stopped;
+    PomodoroStatePtr state;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = sessions.find({userId, sessionId});
+        if (it != sessions.end()) {
+            if (it->second.state->isActive()) {
+                endPhase(it->second, false, reason.empty() ? "stopped" : reason, stopped);
+            }
+            state = it->second.state;
+        }
+    }
+    if (!state) {
+        return getState(userId, sessionId);
+    }
+    // 取消计时器会等待正在执行的回调返回，不能持有 mutex
+    stopped.run();
+    return state;
+}
+
+PomodoroStatePtr PomodoroEngine::pause(int userId, const std::string& sessionId) {
+    TimerHandle timer;
+    PomodoroStatePtr state;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = sessions.find({userId, sessionId});
+        if (it != sessions.end()) {
+            Session& session = it->second;
+            if (session.state->isRunning()) {
+                const auto now = Clock::now();
+                PomodoroState next = *session.state;
+                next.pausedRemainingMs = next.remainingMs(now);
+                next.paused = true;
+                if (next.phase == PomodoroPhase::Work) {
+                    session.focused += now - session.runningSince;
+                }
+                timer = session.timer;
+                session.timer = TimerHandle();
+                ++session.generation;
+                publish(session, std::move(next));
+            }
+            state = session.state;
+        }
+    }
+    timer.cancel();
+    return state ? state : getState(userId, sessionId);
+}
+
+PomodoroStatePtr PomodoroEngine::resume(int userId, const std::string& sessionId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = sessions.find({userId, sessionId});
+    if (it == sessions.end()) {
+        PomodoroState state;
+        state.userId = userId;
+        state.sessionId = sessionId;
+        return std::make_shared<const PomodoroState>(std::move(state));
+    }
+    Session& session = it->second;
+    if (session.state->isActive() && session.state->paused) {
+        const auto now = Clock::now();
+        const Clock::duration remaining = std::chrono::milliseconds(session.state->pausedRemainingMs);
+        PomodoroState next = *session.state;
+        next.paused = false;
+        next.pausedRemainingMs = 0;
+        next.deadline = now + remaining;
+        session.runningSince = now;
+        publish(session, std::move(next));
+        armTimer(it->first, session, remaining);
+    }
+    return session.state;
+}
+
+PomodoroStatePtr PomodoroEngine::setTaskId(int userId, const std::string& sessionId, int taskId) {
+    const PomodoroConfig config = configFor(userId);
+    std::lock_guard<std::mutex> lock(mutex);
+    Session& session = sessionFor({userId, sessionId}, config);
+    PomodoroState state = *session.state;
+    state.taskId = taskId > 0 ? taskId : -1;
+    publish(session, std::move(state));
+    return session.state;
+}
+
+PomodoroStatePtr PomodoroEngine::setConfig(int userId, const std::string& sessionId, const PomodoroConfig& config) {
+    const PomodoroConfig userConfig = configFor(userId);
+    std::lock_guard<std::mutex> lock(mutex);
+    Session& session = sessionFor({userId, sessionId}, userConfig);
+    PomodoroState state = *session.state;
+    state.config = config;
+    session.configOverridden = true;
+    publish(session, std::move(state));
+    return session.state;
+}
+
+void PomodoroEngine::reloadConfig(int userId) {
+    const PomodoroConfig config = loadConfig(userId);
+    std::lock_guard<std::mutex> lock(mutex);
+    userConfigs[userId] = config;
+    // 空闲会话立即显示新配置，正在进行的阶段保持原时长
+    for (auto& [key, session] : sessions) {
+        if (key.first == userId && !session.configOverridden && !session.state->isActive()) {
+            PomodoroState state = *session.state;
+            state.config = config;
+            publish(session, std::move(state));
+        }
+    }
+}
+
+PomodoroStatePtr PomodoroEngine::resetCounters(int userId, const std::string& sessionId) {
+    const PomodoroConfig config = configFor(userId);
+    std::lock_guard<std::mutex> lock(mutex);
+    Session& session = sessionFor({userId, sessionId}, config);
+    PomodoroState state = *session.state;
+    state.completedInCycle = 0;
+    state.completedTotal = 0;
+    if (!state.isActive()) {
+        state.nextPhase = PomodoroPhase::Work;
+    }
+    publish(session, std::move(state));
+    return session.state;
+}
+
+bool PomodoroEngine::removeSession(int userId, const std::string& sessionId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = sessions.find({userId, sessionId});
+    if (it == sessions.end() || it->second.state->isActive()) {
+        return false;
+    }
+    sessions.erase(it);
+    return true;
+}
+
+size_t PomodoroEngine::sessionCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return sessions.size();
+}
+
+void PomodoroEngine::shutdown(const std::string& reason) {
+    std::vector<Aftermath> stopped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& [key, session] : sessions) {
+            if (session.state->isActive()) {
+                stopped.emplace_back();
+                endPhase(session, false, reason, stopped.back());
+            }
+        }
+    }
+    for (auto& aftermath : stopped) {
+        aftermath.run();
+    }
+}
@@ -0,0 +1,116 @@
+#include "Pomodoro/PomodoroSessionLog.h"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+PomodoroSessionLog& PomodoroSessionLog::getInstance() {
+    static PomodoroSessionLog instance;
+    return instance;
+}
+
+// DAO 在构造时取得 DatabaseManager 单例，保证数据库晚于本对象析构
+PomodoroSessionLog::PomodoroSessionLog() : sessionDAO(createPomodoroSessionDAO()) {}
+
+PomodoroSessionLog::~PomodoroSessionLog() {
+    shutdown();
+}
+
+void PomodoroSessionLog::ensureStarted() {
+    if (running) {
+        return;
+    }
+    running = true;
+    worker = std::thread(&PomodoroSessionLog::runLoop, this);
+}
+
+void PomodoroSessionLog::append(const PomodoroSession& session) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ensureStarted();
+        pending.push_back(session);
+        ++appendedCount;
+    }
+    wakeup.notify_one();
+}
+
+bool PomodoroSessionLog::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!running) {
+        return pending.empty();
+    }
+
+    const std::uint64_t target = appendedCount;
+    const std::uint64_t failuresBefore = failedWrites;
+    flushRequested = true;
+    wakeup.notify_one();
+    written.wait(lock, [&] {
+        return writtenCount >= target || failedWrites != failuresBefore || !running;
+    });
+    return writtenCount >= target;
+}
+
+size_t PomodoroSessionLog::pendingCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<size_t>(appendedCount - writtenCount);
+}
+
+void PomodoroSessionLog::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wakeup.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void PomodoroSessionLog::runLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    std::vector<PomodoroSession> batch;
+
+    while (true) {
+        wakeup.wait(lock, [this] { return !pending.empty() || !running; });
+        if (pending.empty()) {
+            break;      // 已停止且队列写完
+        }
+
+        // 攒批：等到 LINGER 到期、批次写满、有人等待 flush 或停止
+        if (running && !flushRequested && pending.size() < MAX_BATCH) {
+            wakeup.wait_for(lock, LINGER, [this] {
+                return !running || flushRequested || pending.size() >= MAX_BATCH;
+            });
+        }
+
+        const size_t count = std::min(pending.size(), MAX_BATCH);
+        batch.assign(std::make_move_iterator(pending.begin()),
+                     std::make_move_iterator(pending.begin() + static_cast<std::ptrdiff_t>(count)));
+        pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(count));
+        if (pending.empty()) {
+            flushRequested = false;
+        }
+
+        // 写库期间不持有锁，计时线程可以继续追加
+        lock.unlock();
+        const bool ok = sessionDAO->appendSessions(batch);
+        lock.lock();
+
+        if (ok) {
+            writtenCount += count;
+            written.notify_all();
+            continue;
+        }
+
+        // 放回队首保持追加顺序，稍后重试
+        pending.insert(pending.begin(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+        ++failedWrites;
+        flushRequested = false;     // 本次 flush 已以失败返回，不再立即重试
+        written.notify_all();
+        if (!running) {
+            std::cerr << "番茄钟记录写入失败，" << pending.size() << " 条记录未能保存" << std::endl;
+            break;
+        }
+        std::cerr << "番茄钟记录写入失败，" << count << " 条记录将稍后重试" << std::endl;
+        wakeup.wait_for(lock, RETRY_INTERVAL, [this] { return !running || flushRequested; });
+    }
+}
@@ -0,0 +1,188 @@
+#include "Pomodoro/TimerService.h"
+#include <algorithm>
+
+// ==================== TimerHandle ====================
+
+bool TimerHandle::cancel() const {
+    return valid() && TimerService::getInstance().cancel(*this);
+}
+
+int TimerHandle::remainingSeconds() const {
+    return valid() ? TimerService::getInstance().remainingSeconds(*this) : -1;
+}
+
+// ==================== TimerService ====================
+
+TimerService& TimerService::getInstance() {
+    static TimerService instance;
+    return instance;
+}
+
+TimerService::~TimerService() {
+    shutdown();
+}
+
+int TimerService::secondsUntil(Clock::time_point deadline, Clock::time_point now) {
+    if (deadline <= now) {
+        return 0;
+    }
+    return static_cast<int>(std::chrono::ceil<std::chrono::seconds>(deadline - now).count());
+}
+
+void TimerService::ensureStarted() {
+    if (running) {
+        return;
+    }
+    running = true;
+    worker = std::thread(&TimerService::runLoop, this);
+    workerId = worker.get_id();
+}
+
+TimerHandle TimerService::start(Clock::duration duration,
+                                TickCallback onTick,
+                                DoneCallback onDone,
+                                std::chrono::seconds tickInterval) {
+    const auto now = Clock::now();
+    Timer timer;
+    timer.deadline = now + std::max(duration, Clock::duration::zero());
+    // 订阅 tick 时第一次 tick 立即触发，之后按 now + k * tickInterval 对齐
+    const bool ticking = onTick && tickInterval.count() > 0;
+    timer.nextTick = ticking ? now : timer.deadline;
+    timer.tickInterval = ticking ? Clock::duration(tickInterval) : Clock::duration::zero();
+    timer.onTick = ticking ? std::move(onTick) : nullptr;
+    timer.onDone = std::move(onDone);
+
+    std::uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ensureStarted();
+        id = nextId++;
+        queue.push({timer.nextTick, id});
+        timers.emplace(id, std::move(timer));
+    }
+    wakeup.notify_one();
+    return TimerHandle(id);
+}
+
+bool TimerService::cancel(const TimerHandle& handle) {
+    DoneCallback onDone;
+    bool found = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto it = timers.find(handle.id);
+        if (it != timers.end()) {
+            onDone = std::move(it->second.onDone);
+            timers.erase(it);
+            found = true;
+            compactQueue();
+        }
+        // 在该计时器自己的回调里取消时不能等待自己
+        if (std::this_thread::get_id() != workerId) {
+            callbackDone.wait(lock, [this, &handle] { return callbackTimerId != handle.id; });
+        }
+    }
+    if (found && onDone) {
+        onDone(false);
+    }
+    return found;
+}
+
+int TimerService::remainingSeconds(const TimerHandle& handle) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = timers.find(handle.id);
+    return it == timers.end() ? -1 : secondsUntil(it->second.deadline, Clock::now());
+}
+
+bool TimerService::isActive(const TimerHandle& handle) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return timers.count(handle.id) > 0;
+}
+
+size_t TimerService::activeCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return timers.size();
+}
+
+void TimerService::compactQueue() {
+    // 大量取消后堆里积压的失效条目超过有效计时器两倍时，按有效计时器重建
+    if (queue.size() <= timers.size() * 2 + 64) {
+        return;
+    }
+    std::vector<Wakeup> entries;
+    entries.reserve(timers.size());
+    for (const auto& [id, timer] : timers) {
+        entries.push_back({std::min(timer.nextTick, timer.deadline), id});
+    }
+    queue = decltype(queue)(std::greater<Wakeup>(), std::move(entries));
+}
+
+void TimerService::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+        timers.clear();
+        queue = decltype(queue)();
+    }
+    wakeup.notify_all();
+    if (worker.joinable()) {
+        if (std::this_thread::get_id() == workerId) {
+            worker.detach();
+        } else {
+            worker.join();
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    workerId = std::thread::id();
+}
+
+void TimerService::runLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (running) {
+        if (queue.empty()) {
+            wakeup.wait(lock);
+            continue;
+        }
+
+        const Wakeup next = queue.top();
+        auto now = Clock::now();
+        if (next.when > now) {
+            // 新的计时器和停止会提前唤醒；被取消的条目到时间后出堆丢弃
+            wakeup.wait_until(lock, next.when);
+            continue;
+        }
+        queue.pop();
+
+        auto it = timers.find(next.timerId);
+        if (it == timers.end()) {
+            continue;   // 已取消
+        }
+
+        Timer& timer = it->second;
+        callbackTimerId = next.timerId;
+        if (now >= timer.deadline) {
+            DoneCallback onDone = std::move(timer.onDone);
+            timers.erase(it);
+            lock.unlock();
+            if (onDone) {
+                onDone(true);
+            }
+            lock.lock();
+        } else {
+            const int remaining = secondsUntil(timer.deadline, now);
+            // 按绝对时间推进到下一个 tick；调度线程被拖慢时跳过错过的 tick，不补发
+            do {
+                timer.nextTick += timer.tickInterval;
+            } while (timer.nextTick <= now);
+            queue.push({std::min(timer.nextTick, timer.deadline), next.timerId});
+
+            // 回调期间计时器可能被取消并从表中删除，使用副本
+            TickCallback onTick = timer.onTick;
+            lock.unlock();
+            onTick(remaining);
+            lock.lock();
+        }
+        callbackTimerId = 0;
+        callbackDone.notify_all();
+    }
+}
@@ -1,125 +1,139 @@
 #include "Pomodoro/pomodoro.h"
 #include <iostream>
-#include <thread>
-#include <chrono>
 #include <functional>
+#include <future>
 
-Pomodoro::Pomodoro(int work, int brk, int longBrk)
-    : workDuration(work), breakDuration(brk), longBreakDuration(longBrk), 
-      cycleCount(0), isRunning(false), shouldStop(false) {}
+Pomodoro::Pomodoro(int userId, std::string sessionId)
+    : userId(userId), sessionId(std::move(sessionId)) {
+    // 先构造引擎，保证它晚于静态的 Pomodoro 析构
+    PomodoroEngine::getInstance();
+}
+
+Pomodoro::~Pomodoro() {
+    // 取消会等待正在执行的回调返回，之后回调不会再访问 this
+    stop("shutdown");
+}
+
+bool Pomodoro::start(Phase phase, std::function<void(int)> onTick, std::function<void(bool)> onFinish) {
+    PomodoroStatePtr state = PomodoroEngine::getInstance().start(
+        userId, sessionId, phase, std::move(onTick), std::move(onFinish));
+    return state->isRunning();
+}
+
+bool Pomodoro::runCountdown(Phase phase, std::function<void(int)> callback) {
+    std::promise<bool> finished;
+    std::future<bool> result = finished.get_future();
+    if (!start(phase, std::move(callback), [&finished](bool completed) { finished.set_value(completed); })) {
+        return false;
+    }
+    return result.get();
+}
 
 void Pomodoro::startWork() {
-    std::cout << "Work session started for " << workDuration << " minutes." << std::endl;
-    std::this_thread::sleep_for(std::chrono::minutes(workDuration));
-    cycleCount++;
-    std::cout << "Work session completed!" << std::endl;
+    std::cout << "Work session started for " << getWorkDuration() << " minutes." << std::endl;
+    if (runCountdown(Phase::Work, nullptr)) {
+        std::cout << "Work session completed!" << std::endl;
+    }
 }
 
 void Pomodoro::startBreak() {
-    std::cout << "Break started for " << breakDuration << " minutes." << std::endl;
-    std::this_thread::sleep_for(std::chrono::minutes(breakDuration));
-    std::cout << "Break finished!" << std::endl;
+    std::cout << "Break started for " << getBreakDuration() << " minutes." << std::endl;
+    if (runCountdown(Phase::ShortBreak, nullptr)) {
+        std::cout << "Break finished!" << std::endl;
+    }
 }
 
 void Pomodoro::startLongBreak() {
-    std::cout << "Long break started for " << longBreakDuration << " minutes." << std::endl;
-    std::this_thread::sleep_for(std::chrono::minutes(longBreakDuration));
-    std::cout << "Long break finished!" << std::endl;
+    std::cout << "Long break started for " << getLongBreakDuration() << " minutes." << std::endl;
+    if (runCountdown(Phase::LongBreak, nullptr)) {
+        std::cout << "Long break finished!" << std::endl;
+    }
 }
 
 bool Pomodoro::startWorkWithCountdown(std::function<void(int)> callback) {
-    isRunning = true;
-    shouldStop = false;
-    int totalSeconds = workDuration * 60;
-    
-    for (int remaining = totalSeconds; remaining > 0 && !shouldStop; --remaining) {
-        if (callback) {
-            callback(remaining);
-        }
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    }
-    
-    if (!shouldStop) {
-        cycleCount++;
-    }
-    isRunning = false;
-    return !shouldStop;
+    return runCountdown(Phase::Work, std::move(callback));
 }
 
 bool Pomodoro::startBreakWithCountdown(std::function<void(int)> callback) {
-    isRunning = true;
-    shouldStop = false;
-    int totalSeconds = breakDuration * 60;
-    
-    for (int remaining = totalSeconds; remaining > 0 && !shouldStop; --remaining) {
-        if (callback) {
-            callback(remaining);
-        }
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    }
-    
-    isRunning = false;
-    return !shouldStop;
+    return runCountdown(Phase::ShortBreak, std::move(callback));
 }
 
 bool Pomodoro::startLongBreakWithCountdown(std::function<void(int)> callback) {
-    isRunning = true;
-    shouldStop = false;
-    int totalSeconds = longBreakDuration * 60;
-    
-    for (int remaining = totalSeconds; remaining > 0 && !shouldStop; --remaining) {
-        if (callback) {
-            callback(remaining);
-        }
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    }
-    
-    isRunning = false;
-    return !shouldStop;
+    return runCountdown(Phase::LongBreak, std::move(callback));
+}
+
+void Pomodoro::stop(const std::string& reason) {
+    PomodoroEngine::getInstance().stop(userId, sessionId, reason);
+}
+
+void Pomodoro::pause() {
+    PomodoroEngine::getInstance().pause(userId, sessionId);
+}
+
+void Pomodoro::resume() {
+    PomodoroEngine::getInstance().resume(userId, sessionId);
 }
 
-void Pomodoro::stop() {
-    shouldStop = true;
+PomodoroStatePtr Pomodoro::getState() const {
+    return PomodoroEngine::getInstance().getState(userId, sessionId);
 }
 
 bool Pomodoro::getIsRunning() const {
-    return isRunning;
+    return getState()->isRunning();
+}
+
+int Pomodoro::getRemainingSeconds() const {
+    return getState()->remainingSeconds();
+}
+
+Pomodoro::Phase Pomodoro::getActivePhase() const {
+    return getState()->phase;
 }
 
 int Pomodoro::getCycleCount() const {
-    return cycleCount;
+    return getState()->completedTotal;
 }
 
 int Pomodoro::getWorkDuration() const {
-    return workDuration;
+    return getState()->config.workMinutes;
 }
 
 int Pomodoro::getBreakDuration() const {
-    return breakDuration;
+    return getState()->config.shortBreakMinutes;
 }
 
 int Pomodoro::getLongBreakDuration() const {
-    return longBreakDuration;
+    return getState()->config.longBreakMinutes;
 }
 
 void Pomodoro::setWorkDuration(int minutes) {
     if (minutes > 0 && minutes <= 120) {
-        workDuration = minutes;
+        PomodoroConfig config = getState()->config;
+        config.workMinutes = minutes;
+        PomodoroEngine::getInstance().setConfig(userId, sessionId, config);
     }
 }
 
 void Pomodoro::setBreakDuration(int minutes) {
     if (minutes > 0 && minutes <= 60) {
-        breakDuration = minutes;
+        PomodoroConfig config = getState()->config;
+        config.shortBreakMinutes = minutes;
+        PomodoroEngine::getInstance().setConfig(userId, sessionId, config);
     }
 }
 
 void Pomodoro::setLongBreakDuration(int minutes) {
     if (minutes > 0 && minutes <= 60) {
-        longBreakDuration = minutes;
+        PomodoroConfig config = getState()->config;
+        config.longBreakMinutes = minutes;
+        PomodoroEngine::getInstance().setConfig(userId, sessionId, config);
     }
 }
 
+void Pomodoro::setTaskId(int id) {
+    PomodoroEngine::getInstance().setTaskId(userId, sessionId, id);
+}
+
 void Pomodoro::resetCycleCount() {
-    cycleCount = 0;
+    PomodoroEngine::getInstance().resetCounters(userId, sessionId);
 }
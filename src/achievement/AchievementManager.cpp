@@ -4,21 +4,84 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <fstream>
+#include <map>
+#include <cstdio>
+#include <filesystem>
 #include <sqlite3.h>
 #include "database/DatabaseManager.h"
+#include "Pomodoro/PomodoroSessionLog.h"
 
 // 构造函数接收 AchievementDAO 和用户ID
 AchievementManager::AchievementManager(std::unique_ptr<AchievementDAO> dao, int userId)
     : achievementDAO(std::move(dao)),
       statisticsAnalyzer(std::make_unique<StatisticsAnalyzer>()),
       currentUserId(userId) {
+    // 日志放在数据库旁边，与启动时的工作目录无关
+    auto& dbManager = DatabaseManager::getInstance();
+    if (dbManager.isOpen()) {
+        journalPath = (std::filesystem::path(dbManager.getDatabasePath()).parent_path()
+                       / "achievement_progress.journal").string();
+    }
     initialize();
+    subscribeEvents();
+
+    flusherRunning = true;
+    flusher = std::thread(&AchievementManager::runFlusher, this);
+}
+
+AchievementManager::~AchievementManager() {
+    auto& bus = EventBus::getInstance();
+    for (auto id : subscriptions) {
+        bus.unsubscribe(id);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(flusherMutex);
+        flusherRunning = false;
+    }
+    flusherWakeup.notify_one();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    flushPendingProgress();
+}
+
+void AchievementManager::runFlusher() {
+    std::unique_lock<std::mutex> lock(flusherMutex);
+    while (!flusherWakeup.wait_for(lock, FLUSH_INTERVAL, [this] { return !flusherRunning; })) {
+        lock.unlock();
+        {
+            std::lock_guard<std::recursive_mutex> state(stateMutex);
+            if (progressStale || !dirtyProgress.empty()) {
+                flushPendingProgress();
+            }
+        }
+        lock.lock();
+    }
+}
+
+void AchievementManager::subscribeEvents() {
+    auto& bus = EventBus::getInstance();
+    auto handler = [this](const GameEvent& event) { onGameEvent(event); };
+    for (auto type : {GameEventType::TaskCompleted, GameEventType::TaskReopened,
+                      GameEventType::PomodoroCompleted, GameEventType::StreakChanged}) {
+        subscriptions.push_back(bus.subscribe(type, handler));
+    }
 }
 
 void AchievementManager::initialize() {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     std::cout << "成就系统初始化 (用户ID: " << currentUserId << ")\n";
     
+    journalNeedsReplay = !replayJournal();
+
     if (loadAchievementDefinitions() && loadUserAchievements()) {
+        if (DatabaseManager::getInstance().isOpen()) {
+            // 崩溃前未写回的指标进度由数据库重新统计得到，立即落盘
+            seedMetrics();
+            flushPendingProgress();
+        }
         std::cout << "成就系统初始化完成，加载了 " 
                   << achievementDefinitions.size() << " 个成就定义\n";
     } else {
@@ -27,6 +90,7 @@ void AchievementManager::initialize() {
 }
 
 bool AchievementManager::loadAchievementDefinitions() {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     if (!achievementDAO) {
         std::cerr << "AchievementDAO 未初始化\n";
         return false;
@@ -42,6 +106,7 @@ bool AchievementManager::loadAchievementDefinitions() {
         }
 
         std::cout << "从数据库加载了 " << achievementDefinitions.size() << " 个成就定义\n";
+        rebuildAchievementIndex();
         return true;
     } catch (const std::exception& e) {
         std::cerr << "加载成就定义失败: " << e.what() << "\n";
@@ -50,6 +115,7 @@ bool AchievementManager::loadAchievementDefinitions() {
 }
 
 bool AchievementManager::loadUserAchievements() {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     if (!achievementDAO) {
         std::cerr << "AchievementDAO 未初始化\n";
         return false;
@@ -70,46 +136,236 @@ bool AchievementManager::loadUserAchievements() {
 }
 
 void AchievementManager::checkAllAchievements() {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     std::cout << "=== 开始检查所有成就 (用户ID: " << currentUserId << ") ===\n";
     
-    // Get current stats
-    const int completedTasks = getCompletedTaskCount();
-    const int currentStreak = getCurrentStreak();
-    const int totalPomodoros = getTotalPomodoroCount();
+    // 重新从数据库统计指标，纠正事件无法覆盖的变化（例如外部修改数据库、项目完成）
+    seedMetrics();
     
-    // Check all task completion achievements
-    const std::vector<std::string> taskAchievements = {
-        "task_1", "task_5", "task_10", "task_25", "task_50", "task_100", "task_200"
-    };
-    for (const auto& achId : taskAchievements) {
-        checkProgressAchievement(achId, completedTasks);
+    std::cout << "=== 成就检查完成 ===\n\n";
+}
+
+// === 事件驱动的成就评估 ===
+
+void AchievementManager::rebuildAchievementIndex() {
+    std::vector<std::string> newMetrics;
+    for (auto& [key, index] : metricIndex) {
+        index.entries.clear();
+        index.unlockedPrefix = 0;
     }
-    
-    // Check all streak achievements
-    const std::vector<std::string> streakAchievements = {
-        "streak_1", "streak_5", "streak_10", "streak_25", "streak_50", "streak_100", "streak_200"
-    };
-    for (const auto& achId : streakAchievements) {
-        checkProgressAchievement(achId, currentStreak);
+
+    for (const auto& definition : achievementDefinitions) {
+        CompiledRule rule;
+        std::string error;
+        auto result = AchievementRules::compile(definition.unlock_condition, definition.target_value, rule, &error);
+        if (result == RuleParseResult::Invalid) {
+            std::cerr << "成就规则无效 (" << definition.name << "): " << error << "\n";
+        }
+        if (result != RuleParseResult::Compiled) {
+            continue;
+        }
+
+        auto userIt = userAchievements.find(definition.unlock_condition);
+        Achievement* userEntry = userIt != userAchievements.end() ? &userIt->second : nullptr;
+
+        auto [indexIt, inserted] = metricIndex.try_emplace(rule.metric.canonical);
+        if (inserted) {
+            newMetrics.push_back(rule.metric.canonical);
+        }
+        auto& index = indexIt->second;
+        index.metric = rule.metric;
+        index.entries.push_back({rule.threshold, definition.unlock_condition, userEntry});
     }
-    
-    // Check all pomodoro achievements
-    const std::vector<std::string> pomodoroAchievements = {
-        "pomodoro_1", "pomodoro_5", "pomodoro_10", "pomodoro_25", "pomodoro_50", "pomodoro_100", "pomodoro_200"
-    };
-    for (const auto& achId : pomodoroAchievements) {
-        checkProgressAchievement(achId, totalPomodoros);
+
+    for (auto it = metricIndex.begin(); it != metricIndex.end();) {
+        auto& index = it->second;
+        if (index.entries.empty()) {
+            it = metricIndex.erase(it);
+            continue;
+        }
+
+        std::stable_sort(index.entries.begin(), index.entries.end(),
+            [](const ThresholdEntry& a, const ThresholdEntry& b) { return a.threshold < b.threshold; });
+        while (index.unlockedPrefix < index.entries.size()) {
+            const auto* entry = index.entries[index.unlockedPrefix].userEntry;
+            if (!entry || !entry->unlocked) break;
+            ++index.unlockedPrefix;
+        }
+        // 缓存从 DAO 重新加载后，未解锁成就的进度以内存中的指标值为准
+        index.progressStale = metricsSeeded;
+        progressStale = progressStale || metricsSeeded;
+        ++it;
+    }
+
+    if (!metricsSeeded) {
+        return;
+    }
+
+    // 运行中新增规则引入的指标没有基准值，立即从数据库统计，否则会从 0 开始累加并覆盖已有进度；
+    // 已有指标上新增的规则若当前值已达阈值，也要立即解锁，不必等下一次事件。
+    // advanceMetric 可能解锁成就并重入本函数，届时这些指标已在索引中，不会重复统计
+    std::vector<std::string> reached;
+    for (const auto& [key, index] : metricIndex) {
+        if (std::find(newMetrics.begin(), newMetrics.end(), key) == newMetrics.end() &&
+            index.unlockedPrefix < index.entries.size() &&
+            index.entries[index.unlockedPrefix].threshold <= index.value) {
+            reached.push_back(key);
+        }
+    }
+    for (const auto& key : newMetrics) {
+        auto it = metricIndex.find(key);
+        if (it != metricIndex.end()) {
+            advanceMetric(it->second, queryMetric(it->second.metric));
+        }
+    }
+    for (const auto& key : reached) {
+        auto it = metricIndex.find(key);
+        if (it != metricIndex.end()) {
+            advanceMetric(it->second, it->second.value);
+        }
+    }
+}
+
+int AchievementManager::queryMetric(const MetricKey& metric) const {
+    switch (metric.source) {
+        case MetricSource::Streak:
+            return getCurrentStreak();
+        case MetricSource::TasksCompleted:
+            if (metric.filters.empty()) return getCompletedTaskCount();
+            break;
+        case MetricSource::Pomodoros:
+            return getTotalPomodoroCount();
+        case MetricSource::ProjectsCompleted:
+            break;
+    }
+
+    ReadConnectionLease conn = DatabaseManager::getInstance().acquireReadConnection();
+    if (!conn) return 0;
+
+    sqlite3_stmt* stmt = conn.prepare(AchievementRules::countSql(metric));
+    if (!stmt) return 0;
+
+    int bindIndex = 1;
+    for (const auto& filter : metric.filters) {
+        sqlite3_bind_int(stmt, bindIndex++, filter.value);
+    }
+    int value = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : 0;
+    sqlite3_reset(stmt);
+    return value;
+}
+
+void AchievementManager::seedMetrics() {
+    metricsSeeded = true;
+    for (auto& [key, index] : metricIndex) {
+        advanceMetric(index, queryMetric(index.metric));
+    }
+}
+
+void AchievementManager::onGameEvent(const GameEvent& event) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
+    if (event.userId != currentUserId) {
+        return;
+    }
+
+    // 首次事件时从数据库读取基准值；此时数据库已包含本次变化，无需再叠加增量
+    if (!metricsSeeded) {
+        seedMetrics();
+        return;
+    }
+
+    switch (event.type) {
+        case GameEventType::TaskCompleted:
+        case GameEventType::TaskReopened: {
+            const int delta = event.type == GameEventType::TaskCompleted ? event.value : -event.value;
+            // 只有无过滤、同优先级、同项目这几个指标键可能受影响，与成就总数无关
+            for (const auto& key : AchievementRules::taskMetricKeys(event.priority, event.projectId)) {
+                advanceMetric(key, delta, false);
+            }
+            break;
+        }
+        case GameEventType::PomodoroCompleted:
+            advanceMetric(AchievementRules::canonicalKey(MetricSource::Pomodoros, {}), event.value, false);
+            break;
+        case GameEventType::StreakChanged:
+            advanceMetric(AchievementRules::canonicalKey(MetricSource::Streak, {}), event.value, true);
+            break;
+        case GameEventType::LevelUp:
+            break;
+    }
+}
+
+void AchievementManager::advanceMetric(const std::string& metricKey, int delta, bool absolute) {
+    auto it = metricIndex.find(metricKey);
+    if (it == metricIndex.end()) {
+        return;
+    }
+    advanceMetric(it->second, absolute ? delta : std::max(0, it->second.value + delta));
+}
+
+void AchievementManager::advanceMetric(MetricIndex& index, int newValue) {
+    index.value = newValue;
+
+    // 阈值升序排列，从已解锁前缀之后开始，只需检查达到阈值的那几项；
+    // 没有新解锁时是 O(1)，与该指标下的成就数量无关
+    std::vector<std::string> newlyReached;
+    for (size_t i = index.unlockedPrefix; i < index.entries.size() && index.entries[i].threshold <= newValue; ++i) {
+        const auto& entry = index.entries[i];
+        if (!entry.userEntry || !entry.userEntry->unlocked) {
+            newlyReached.push_back(entry.key);
+        }
+    }
+
+    // 未解锁成就的进度延迟到读取或写回时再同步
+    index.progressStale = true;
+    progressStale = true;
+
+    // 解锁可能触发索引重建，因此在遍历结束后再执行
+    for (const auto& key : newlyReached) {
+        unlockAchievement(key);
+    }
+
+    while (index.unlockedPrefix < index.entries.size()) {
+        const auto* entry = index.entries[index.unlockedPrefix].userEntry;
+        if (!entry || !entry->unlocked) break;
+        ++index.unlockedPrefix;
+    }
+}
+
+void AchievementManager::materializeProgress() {
+    if (!progressStale) {
+        return;
+    }
+    progressStale = false;
+
+    for (auto& [key, index] : metricIndex) {
+        if (!index.progressStale) continue;
+        index.progressStale = false;
+
+        for (size_t i = index.unlockedPrefix; i < index.entries.size(); ++i) {
+            auto& entry = index.entries[i];
+            if (entry.userEntry && !entry.userEntry->unlocked) {
+                setProgress(*entry.userEntry, entry.key, std::min(entry.threshold, std::max(0, index.value)));
+            }
+        }
+    }
+}
+
+void AchievementManager::syncCacheEntry(const std::string& key) {
+    // 该成就已直接写入数据库，待写回的旧进度作废
+    dirtyProgress.erase(key);
+
+    // DAO 内存中已有最新记录，直接复制，避免重新查询全部用户成就
+    if (const Achievement* stored = achievementDAO->getUserAchievement(currentUserId, key)) {
+        const bool indexed = userAchievements.count(key) > 0;
+        userAchievements[key] = *stored;
+        if (!indexed) {
+            rebuildAchievementIndex();
+        }
     }
-    
-    // Project achievements (project_1, project_5, etc.) are currently defined but require
-    // a getCompletedProjectCount() method to be implemented in StatisticsAnalyzer.
-    // The achievements are marked with category "special" and will be available for
-    // manual tracking or future automatic tracking when project completion is implemented.
-    
-    std::cout << "=== 成就检查完成 ===\n\n";
 }
 
 void AchievementManager::checkProgressAchievement(const std::string& achievementId, int currentValue) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     const auto* definition = findAchievementDefinition(achievementId);
     if (!definition) {
         // Achievement definition doesn't exist, skip silently
@@ -126,12 +382,143 @@ void AchievementManager::checkProgressAchievement(const std::string& achievement
         return;
     }
 
-    if (achievementDAO->updateAchievementProgress(currentUserId, achievementId, progressValue)) {
-        loadUserAchievements();
-        if (progressValue >= definition->target_value) {
-            unlockAchievement(achievementId);
+    if (progressValue >= definition->target_value) {
+        unlockAchievement(achievementId);
+    } else if (auto* achievement = findUserAchievement(achievementId)) {
+        setProgress(*achievement, achievementId, progressValue);
+    }
+}
+
+// === 进度写回 ===
+
+void AchievementManager::setProgress(Achievement& achievement, const std::string& key, int progress) {
+    if (achievement.progress == progress) {
+        return;
+    }
+    achievement.progress = progress;
+    dirtyProgress[key] = progress;
+    appendJournal(key, progress);
+}
+
+void AchievementManager::appendJournal(const std::string& key, int progress) {
+    if (journalPath.empty()) {
+        return;
+    }
+    if (!journalOut.is_open()) {
+        journalOut.open(journalPath, std::ios::app);
+        if (!journalOut.is_open()) {
+            std::cerr << "无法打开成就进度日志: " << journalPath << "\n";
+            return;
+        }
+    }
+    // 每行 "用户ID\t成就键\t进度"，成就键可能含空格（如 "streak >= 7"）
+    journalOut << currentUserId << '\t' << key << '\t' << progress << '\n';
+    journalOut.flush();
+}
+
+bool AchievementManager::flushPendingProgress() {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
+    materializeProgress();
+    if (!achievementDAO) {
+        return true;
+    }
+    // 启动时没能重放的日志先补写，再写本批（本批更新，覆盖日志中的旧值）
+    if (journalNeedsReplay) {
+        journalNeedsReplay = !replayJournal();
+    }
+    if (dirtyProgress.empty()) {
+        return true;
+    }
+
+    std::vector<std::pair<std::string, int>> batch(dirtyProgress.begin(), dirtyProgress.end());
+    if (!achievementDAO->saveProgressBatch(currentUserId, batch)) {
+        // 保留脏数据（以及日志），下次再试
+        std::cerr << "成就进度写回失败，" << batch.size() << " 条记录将稍后重试\n";
+        return false;
+    }
+
+    dirtyProgress.clear();
+    if (journalOut.is_open()) {
+        journalOut.close();
+    }
+    if (!journalNeedsReplay && !journalPath.empty()) {
+        std::remove(journalPath.c_str());
+    }
+    return true;
+}
+
+bool AchievementManager::replayJournal() {
+    if (journalPath.empty() || !achievementDAO) {
+        return true;
+    }
+    std::ifstream journal(journalPath);
+    if (!journal.is_open()) {
+        return true;
+    }
+
+    // 同一成就以最后一行为准
+    std::map<int, std::map<std::string, int>> latest;
+    bool parsed = true;
+    std::string line;
+    while (std::getline(journal, line)) {
+        if (line.empty()) continue;
+        std::istringstream fields(line);
+        std::string userText, key, progressText;
+        if (!std::getline(fields, userText, '\t') || !std::getline(fields, key, '\t') ||
+            !std::getline(fields, progressText) || key.empty()) {
+            parsed = false;
+            continue;
+        }
+        try {
+            size_t userEnd = 0, progressEnd = 0;
+            int userId = std::stoi(userText, &userEnd);
+            int progress = std::stoi(progressText, &progressEnd);
+            if (userEnd != userText.size() || progressEnd != progressText.size()) {
+                parsed = false;
+                continue;
+            }
+            latest[userId][key] = progress;
+        } catch (const std::exception&) {
+            parsed = false;
         }
     }
+    journal.close();
+
+    bool saved = true;
+    for (const auto& [user, entries] : latest) {
+        std::vector<std::pair<std::string, int>> batch(entries.begin(), entries.end());
+        saved = achievementDAO->saveProgressBatch(user, batch) && saved;
+    }
+    if (!saved) {
+        // 文件保留，下次写回前再重放
+        std::cerr << "成就进度日志重放失败，保留日志稍后重试: " << journalPath << "\n";
+        return false;
+    }
+    if (!parsed) {
+        if (journalOut.is_open()) {
+            journalOut.close();
+        }
+        // 可解析的行已写入；整个文件移到一旁留待人工检查，避免每次写回都重放旧值
+        const std::string badPath = journalPath + ".bad";
+        std::remove(badPath.c_str());
+        std::rename(journalPath.c_str(), badPath.c_str());
+        std::cerr << "成就进度日志含无法解析的行，已另存为: " << badPath << "\n";
+    } else if (!journalOut.is_open()) {
+        // 日志中还有本进程记入、尚未写回的行时留给 flushPendingProgress 删除
+        std::remove(journalPath.c_str());
+    }
+    if (!latest.empty()) {
+        std::cout << "已从日志恢复未写回的成就进度\n";
+    }
+    return true;
+}
+
+void AchievementManager::setJournalPath(const std::string& path) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
+    if (journalOut.is_open()) {
+        journalOut.close();
+    }
+    journalPath = path;
 }
 
 void AchievementManager::checkFirstTaskAchievement() {
@@ -152,6 +539,7 @@ void AchievementManager::checkPomodoroMasterAchievement() {
 }
 
 void AchievementManager::unlockAchievement(const std::string& achievementId) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     if (!achievementDAO) {
         std::cerr << "AchievementDAO 未初始化\n";
         return;
@@ -165,8 +553,9 @@ void AchievementManager::unlockAchievement(const std::string& achievementId) {
         }
 
         if (achievementDAO->unlockAchievement(currentUserId, achievementId)) {
-            // 重新加载用户成就以更新缓存
-            loadUserAchievements();
+            syncCacheEntry(achievementId);
+            // 解锁是低频事件，顺带把积累的进度一起写回
+            flushPendingProgress();
 
             std::cout << "🎉 成就解锁: " << definition->name << "!\n";
             std::cout << "   " << definition->description << "\n";
@@ -180,6 +569,7 @@ void AchievementManager::unlockAchievement(const std::string& achievementId) {
 }
 
 void AchievementManager::updateAchievementProgress(const std::string& achievementId, int progress) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     if (!achievementDAO) {
         std::cerr << "AchievementDAO 未初始化\n";
         return;
@@ -187,7 +577,7 @@ void AchievementManager::updateAchievementProgress(const std::string& achievemen
     
     try {
         if (achievementDAO->updateAchievementProgress(currentUserId, achievementId, progress)) {
-            loadUserAchievements();
+            syncCacheEntry(achievementId);
         }
     } catch (const std::exception& e) {
         std::cerr << "更新成就进度失败: " << e.what() << "\n";
@@ -195,6 +585,7 @@ void AchievementManager::updateAchievementProgress(const std::string& achievemen
 }
 
 void AchievementManager::updateAchievementProgress(int userId, int achievementId, int newValue) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     if (!achievementDAO) {
         std::cerr << "AchievementDAO 未初始化\n";
         return;
@@ -209,7 +600,7 @@ void AchievementManager::updateAchievementProgress(int userId, int achievementId
 
         if (achievementDAO->updateAchievementProgress(userId, key, newValue)) {
             if (userId == currentUserId) {
-                loadUserAchievements();
+                syncCacheEntry(key);
             }
         }
     } catch (const std::exception& e) {
@@ -220,6 +611,7 @@ void AchievementManager::updateAchievementProgress(int userId, int achievementId
 }
 
 void AchievementManager::incrementAchievementProgress(int userId, int achievementId, int increment) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     if (!achievementDAO) {
         std::cerr << "AchievementDAO 未初始化\n";
         return;
@@ -254,6 +646,7 @@ void AchievementManager::incrementAchievementProgress(int userId, int achievemen
 }
 
 void AchievementManager::displayUnlockedAchievements() {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     std::cout << "=== 已解锁成就 ===\n";
 
     int unlockedCount = 0;
@@ -279,6 +672,8 @@ void AchievementManager::displayUnlockedAchievements() {
 }
 
 void AchievementManager::displayAllAchievements() {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
+    materializeProgress();
     std::cout << "=== 所有成就 (" << achievementDefinitions.size() << "个) ===\n";
     
     for (const auto& definition : achievementDefinitions) {
@@ -296,6 +691,8 @@ void AchievementManager::displayAllAchievements() {
 }
 
 void AchievementManager::displayAchievementStatistics() {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
+    materializeProgress();
     AchievementStats stats;
     stats.totalAchievements = static_cast<int>(achievementDefinitions.size());
 
@@ -398,10 +795,8 @@ int AchievementManager::getDailyTaskCount(const std::string& date) const {
     }
 
     // 解析日期字符串，格式: YYYY-MM-DD
-    std::tm tm = {};
-    std::istringstream ss(date);
-    ss >> std::get_time(&tm, "%Y-%m-%d");
-    if (ss.fail()) {
+    DayNumber day;
+    if (!DayNumber::parse(date, day)) {
         std::cerr << "无法解析日期: " << date << "\n";
         return 0;
     }
@@ -415,11 +810,11 @@ int AchievementManager::getDailyTaskCount(const std::string& date) const {
     sqlite3* db = dbManager.getRawConnection();
     sqlite3_stmt* stmt = nullptr;
     const std::string sql =
-        "SELECT COUNT(*) FROM tasks WHERE completed = 1 AND DATE(completed_date) = ?;";
+        "SELECT COUNT(*) FROM tasks WHERE completed = 1 AND deleted = 0 AND completed_day = ?;";
 
     int count = 0;
     if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, date.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 1, day.value);
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             count = sqlite3_column_int(stmt, 0);
         }
@@ -433,18 +828,25 @@ int AchievementManager::getTotalPomodoroCount() const {
     if (!statisticsAnalyzer) {
         return 0;
     }
+    // 引擎先把会话交给写入队列再发布 PomodoroCompleted，落库后计数才包含已发布的事件
+    PomodoroSessionLog::getInstance().flush();
     return statisticsAnalyzer->getTotalPomodoros();
 }
 
 void AchievementManager::setStatisticsAnalyzer(std::unique_ptr<StatisticsAnalyzer> customAnalyzer) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     statisticsAnalyzer = std::move(customAnalyzer);
+    metricsSeeded = false;
 }
 
 
 void AchievementManager::setCurrentUserId(int userId) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
+    flushPendingProgress();
     currentUserId = userId;
-    // 切换用户时重新加载成就
+    // 切换用户时重新加载成就，指标在下一次事件时重新统计
     loadUserAchievements();
+    metricsSeeded = false;
 }
 
 int AchievementManager::getCurrentUserId() const {
@@ -452,6 +854,7 @@ int AchievementManager::getCurrentUserId() const {
 }
 
 std::vector<AchievementProgress> AchievementManager::getAchievementProgress(int userId) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     std::vector<AchievementProgress> result;
 
     if (!achievementDAO) {
@@ -460,6 +863,10 @@ std::vector<AchievementProgress> AchievementManager::getAchievementProgress(int
     }
 
     try {
+        // 先写回内存中的进度，保证数据库返回的是最新值
+        if (userId == currentUserId) {
+            flushPendingProgress();
+        }
         achievementDAO->loadUserAchievements(userId);
         auto entries = achievementDAO->getUserAchievements(userId);
 
@@ -500,6 +907,8 @@ const Achievement* AchievementManager::findAchievementDefinition(const std::stri
 }
 
 Achievement* AchievementManager::findUserAchievement(const std::string& key) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
+    materializeProgress();
     auto it = userAchievements.find(key);
     if (it != userAchievements.end()) {
         return &it->second;
@@ -526,6 +935,14 @@ void AchievementManager::refreshUserAchievementCache(const std::vector<Achieveme
     for (const auto& entry : entries) {
         userAchievements[entry.unlock_condition] = entry;
     }
+    // 尚未写回的进度以内存为准
+    for (const auto& [key, progress] : dirtyProgress) {
+        auto it = userAchievements.find(key);
+        if (it != userAchievements.end() && !it->second.unlocked) {
+            it->second.progress = progress;
+        }
+    }
+    rebuildAchievementIndex();
 }
 
 const Achievement* AchievementManager::getDefinitionById(int id) const {
@@ -545,6 +962,7 @@ bool AchievementManager::updateAchievementDefinition(int id,
                                                      const std::string& name,
                                                      const std::string& description,
                                                      int targetValue) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     if (!achievementDAO) {
         return false;
     }
@@ -562,6 +980,7 @@ int AchievementManager::createAchievementDefinition(const std::string& name,
                                                     int rewardXP,
                                                     const std::string& category,
                                                     const std::string& icon) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
     if (!achievementDAO) {
         return -1;
     }
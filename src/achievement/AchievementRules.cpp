@@ -0,0 +1,279 @@
+#include "achievement/AchievementRules.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <stdexcept>
+
+namespace {
+    // 简单的递归下降解析器，空白不敏感，关键字不区分大小写
+    class RuleParser {
+    public:
+        explicit RuleParser(const std::string& text) : input(text) {}
+
+        bool parse(CompiledRule& rule, std::string& error) {
+            if (!parseMetric(rule.metric, error)) return false;
+
+            skipSpaces();
+            bool inclusive;
+            if (consume(">=")) {
+                inclusive = true;
+            } else if (consume(">")) {
+                inclusive = false;
+            } else {
+                error = "expected '>=' or '>'";
+                return false;
+            }
+
+            int value;
+            if (!readInt(value) || value < 0) {
+                error = "expected non-negative threshold";
+                return false;
+            }
+            if (!inclusive && value == INT_MAX) {
+                error = "threshold out of range";
+                return false;
+            }
+            rule.threshold = inclusive ? value : value + 1;
+
+            skipSpaces();
+            if (pos != input.size()) {
+                error = "unexpected trailing input";
+                return false;
+            }
+            return true;
+        }
+
+    private:
+        const std::string& input;
+        size_t pos = 0;
+
+        void skipSpaces() {
+            while (pos < input.size() && std::isspace(static_cast<unsigned char>(input[pos]))) ++pos;
+        }
+
+        bool consume(const char* literal) {
+            skipSpaces();
+            size_t i = 0;
+            while (literal[i]) {
+                if (pos + i >= input.size() ||
+                    std::tolower(static_cast<unsigned char>(input[pos + i])) != literal[i]) {
+                    return false;
+                }
+                ++i;
+            }
+            pos += i;
+            return true;
+        }
+
+        std::string readIdentifier() {
+            skipSpaces();
+            size_t start = pos;
+            while (pos < input.size()) {
+                char c = static_cast<char>(std::tolower(static_cast<unsigned char>(input[pos])));
+                if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '.') break;
+                ++pos;
+            }
+            std::string ident = input.substr(start, pos - start);
+            std::transform(ident.begin(), ident.end(), ident.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return ident;
+        }
+
+        bool readInt(int& value) {
+            skipSpaces();
+            size_t start = pos;
+            long long result = 0;
+            while (pos < input.size() && std::isdigit(static_cast<unsigned char>(input[pos]))) {
+                result = result * 10 + (input[pos] - '0');
+                if (result > INT_MAX) return false;
+                ++pos;
+            }
+            value = static_cast<int>(result);
+            return pos > start;
+        }
+
+        bool parseMetric(MetricKey& metric, std::string& error) {
+            std::string ident = readIdentifier();
+            if (ident == "streak") {
+                metric.source = MetricSource::Streak;
+                return true;
+            }
+            if (ident != "count" || !consume("(")) {
+                error = "expected 'streak' or 'count('";
+                return false;
+            }
+
+            std::string source = readIdentifier();
+            if (source == "tasks.completed") {
+                metric.source = MetricSource::TasksCompleted;
+            } else if (source == "pomodoros") {
+                metric.source = MetricSource::Pomodoros;
+            } else if (source == "projects.completed") {
+                metric.source = MetricSource::ProjectsCompleted;
+            } else {
+                error = "unknown source '" + source + "'";
+                return false;
+            }
+
+            size_t beforeWhere = pos;
+            if (readIdentifier() == "where") {
+                if (metric.source != MetricSource::TasksCompleted) {
+                    error = "filters are only supported on tasks.completed";
+                    return false;
+                }
+                do {
+                    MetricFilter filter;
+                    filter.field = readIdentifier();
+                    if (filter.field != "priority" && filter.field != "project_id") {
+                        error = "unknown filter field '" + filter.field + "'";
+                        return false;
+                    }
+                    if (!consume("=") || !readInt(filter.value)) {
+                        error = "expected '= <integer>' after " + filter.field;
+                        return false;
+                    }
+                    metric.filters.push_back(filter);
+                } while (readKeyword("and"));
+            } else {
+                pos = beforeWhere;
+            }
+
+            if (!consume(")")) {
+                error = "expected ')'";
+                return false;
+            }
+            return true;
+        }
+
+        bool readKeyword(const char* keyword) {
+            size_t before = pos;
+            if (readIdentifier() == keyword) return true;
+            pos = before;
+            return false;
+        }
+    };
+
+    bool isPlainIdentifier(const std::string& text) {
+        return !text.empty() && std::all_of(text.begin(), text.end(), [](unsigned char c) {
+            return std::isalnum(c) || c == '_';
+        });
+    }
+
+    // 旧版键：前缀 + 数字，例如 task_10
+    bool parseLegacyKey(const std::string& key, MetricSource& source) {
+        static const std::pair<const char*, MetricSource> prefixes[] = {
+            {"task_", MetricSource::TasksCompleted},
+            {"streak_", MetricSource::Streak},
+            {"pomodoro_", MetricSource::Pomodoros},
+            {"project_", MetricSource::ProjectsCompleted},
+        };
+        for (const auto& [prefix, metricSource] : prefixes) {
+            std::string p(prefix);
+            if (key.size() > p.size() && key.compare(0, p.size(), p) == 0 &&
+                std::all_of(key.begin() + static_cast<std::ptrdiff_t>(p.size()), key.end(),
+                            [](unsigned char c) { return std::isdigit(c); })) {
+                source = metricSource;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char* sourceName(MetricSource source) {
+        switch (source) {
+            case MetricSource::TasksCompleted:    return "tasks.completed";
+            case MetricSource::Pomodoros:         return "pomodoros";
+            case MetricSource::Streak:            return "streak";
+            case MetricSource::ProjectsCompleted: return "projects.completed";
+        }
+        return "";
+    }
+}
+
+RuleParseResult AchievementRules::compile(const std::string& condition, int targetValue,
+                                          CompiledRule& rule, std::string* error) {
+    rule = CompiledRule();
+
+    if (isPlainIdentifier(condition)) {
+        if (!parseLegacyKey(condition, rule.metric.source)) {
+            return RuleParseResult::Manual;
+        }
+        if (targetValue > 0) {
+            rule.threshold = targetValue;
+        } else {
+            try {
+                rule.threshold = std::stoi(condition.substr(condition.rfind('_') + 1));
+            } catch (const std::exception&) {
+                return RuleParseResult::Manual;
+            }
+        }
+        rule.metric.canonical = canonicalKey(rule.metric.source, rule.metric.filters);
+        return RuleParseResult::Compiled;
+    }
+
+    std::string message;
+    RuleParser parser(condition);
+    if (!parser.parse(rule, message)) {
+        if (error) *error = message;
+        return RuleParseResult::Invalid;
+    }
+
+    auto& filters = rule.metric.filters;
+    std::sort(filters.begin(), filters.end(),
+              [](const MetricFilter& a, const MetricFilter& b) { return a.field < b.field; });
+    for (size_t i = 1; i < filters.size(); ++i) {
+        if (filters[i].field == filters[i - 1].field) {
+            if (error) *error = "duplicate filter '" + filters[i].field + "'";
+            return RuleParseResult::Invalid;
+        }
+    }
+
+    rule.metric.canonical = canonicalKey(rule.metric.source, filters);
+    return RuleParseResult::Compiled;
+}
+
+std::string AchievementRules::canonicalKey(MetricSource source, const std::vector<MetricFilter>& filters) {
+    std::string key = sourceName(source);
+    if (!filters.empty()) {
+        key += '[';
+        for (size_t i = 0; i < filters.size(); ++i) {
+            if (i > 0) key += ',';
+            key += filters[i].field + "=" + std::to_string(filters[i].value);
+        }
+        key += ']';
+    }
+    return key;
+}
+
+std::vector<std::string> AchievementRules::taskMetricKeys(int priority, int projectId) {
+    const std::string base = sourceName(MetricSource::TasksCompleted);
+    const std::string byPriority = "priority=" + std::to_string(priority);
+    const std::string byProject = "project_id=" + std::to_string(projectId);
+
+    std::vector<std::string> keys{base, base + "[" + byPriority + "]"};
+    if (projectId >= 0) {
+        keys.push_back(base + "[" + byProject + "]");
+        keys.push_back(base + "[" + byPriority + "," + byProject + "]");
+    }
+    return keys;
+}
+
+std::string AchievementRules::countSql(const MetricKey& metric) {
+    switch (metric.source) {
+        case MetricSource::TasksCompleted: {
+            std::string sql = "SELECT COUNT(*) FROM tasks WHERE completed = 1 AND deleted = 0";
+            // 字段名在编译阶段已按白名单校验
+            for (const auto& filter : metric.filters) {
+                sql += " AND " + filter.field + " = ?";
+            }
+            return sql + ";";
+        }
+        case MetricSource::Pomodoros:
+            return "SELECT COUNT(*) FROM pomodoro_sessions WHERE completed = 1;";
+        case MetricSource::ProjectsCompleted:
+            return "SELECT COUNT(*) FROM projects WHERE progress >= 1.0 AND archived = 0;";
+        case MetricSource::Streak:
+            break;
+    }
+    return "";
+}
@@ -1,4 +1,7 @@
 #include "database/DAO/AchievementDAO.h"
+#include "database/DatabaseManager.h"
+#include "achievement/AchievementRules.h"
+#include <sqlite3.h>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -7,50 +10,299 @@
 #include <iomanip>
 #include <filesystem>
 
+// 定义列（achievements 表别名 a）
+#define DEFINITION_COLUMNS_STR "a.id, a.created_date, a.updated_date, a.name, a.description, a.icon, " \
+                               "a.unlock_condition, a.reward_xp, a.category, a.target_value "
 
-using namespace std;
+namespace {
+    // 旧版 CSV 的一行（定义文件与用户文件格式相同）
+    bool parseLegacyCsvLine(const std::string& line, Achievement& achievement) {
+        std::stringstream ss(line);
+        std::string id, unlocked_str, reward_xp_str, progress_str, target_value_str;
 
-AchievementDAO::AchievementDAO() : dataFilePath("./data/") {
-    std::filesystem::create_directories(dataFilePath);
-    initializeDefaultAchievements();
-}
+        getline(ss, id, ',');
+        getline(ss, achievement.created_date, ',');
+        getline(ss, achievement.updated_date, ',');
+        getline(ss, achievement.name, ',');
+        getline(ss, achievement.description, ',');
+        getline(ss, achievement.icon, ',');
+        getline(ss, achievement.unlock_condition, ',');
+        getline(ss, unlocked_str, ',');
+        getline(ss, achievement.unlocked_date, ',');
+        getline(ss, reward_xp_str, ',');
+        getline(ss, achievement.category, ',');
+        getline(ss, progress_str, ',');
+        getline(ss, target_value_str, ',');
 
-AchievementDAO::AchievementDAO(const std::string& basePath) : dataFilePath(basePath) {
-    if (!dataFilePath.empty() && dataFilePath.back() != '/') {
-        dataFilePath += '/';
+        try {
+            achievement.id = std::stoi(id);
+            achievement.unlocked = (unlocked_str == "1");
+            achievement.reward_xp = std::stoi(reward_xp_str);
+            achievement.progress = std::stoi(progress_str);
+            achievement.target_value = std::stoi(target_value_str);
+        } catch (const std::exception&) {
+            return false;
+        }
+        return !achievement.unlock_condition.empty();
     }
 
-    std::filesystem::create_directories(dataFilePath);
-    initializeDefaultAchievements();
+    std::string columnText(sqlite3_stmt* stmt, int col) {
+        const unsigned char* text = sqlite3_column_text(stmt, col);
+        return text ? reinterpret_cast<const char*>(text) : "";
+    }
 }
 
-std::string AchievementDAO::getDefinitionFilePath() const {
-    return dataFilePath + "achievement_definitions.csv";
-}
+class SQLiteAchievementDAO : public AchievementDAO {
+private:
+    DatabaseManager& dbManager;
+    std::string dbPath;
+
+    std::vector<Achievement> achievementDefinitions;
+    std::vector<Achievement> userAchievements;   // 最近一次加载的用户成就
+    int loadedUserId = -1;
+
+    // SQL 语句常量（与 DatabaseManager::createAchievementTable 保持一致）
+    static constexpr const char* SELECT_DEFINITIONS_SQL =
+        "SELECT " DEFINITION_COLUMNS_STR "FROM achievements a ORDER BY a.id;";
+
+    static constexpr const char* SELECT_USER_ACHIEVEMENTS_SQL =
+        "SELECT " DEFINITION_COLUMNS_STR ", COALESCE(ua.progress, 0), ua.unlocked_at "
+        "FROM achievements a "
+        "LEFT JOIN user_achievements ua ON ua.user_id = ? AND ua.achievement_key = a.unlock_condition "
+        "ORDER BY a.id;";
+
+    static constexpr const char* SELECT_RECENT_UNLOCKED_SQL =
+        "SELECT " DEFINITION_COLUMNS_STR ", ua.progress, ua.unlocked_at "
+        "FROM user_achievements ua "
+        "JOIN achievements a ON a.unlock_condition = ua.achievement_key "
+        "WHERE ua.user_id = ? AND ua.unlocked_at IS NOT NULL "
+        "ORDER BY ua.unlocked_at DESC LIMIT ?;";
+
+    static constexpr const char* INSERT_DEFINITION_SQL =
+        "INSERT INTO achievements (name, description, icon, unlock_condition, reward_xp, category, target_value) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?);";
+
+    static constexpr const char* IMPORT_DEFINITION_SQL =
+        "INSERT INTO achievements (name, description, icon, unlock_condition, reward_xp, category, target_value) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?) ON CONFLICT(unlock_condition) DO NOTHING;";
+
+    static constexpr const char* SAVE_DEFINITION_SQL =
+        "UPDATE achievements SET name = ?, description = ?, icon = ?, reward_xp = ?, category = ?, "
+        "target_value = ?, updated_date = datetime('now') WHERE id = ?;";
+
+    static constexpr const char* UPDATE_DEFINITION_SQL =
+        "UPDATE achievements SET name = COALESCE(NULLIF(?1, ''), name), "
+        "description = COALESCE(NULLIF(?2, ''), description), "
+        "target_value = CASE WHEN ?3 > 0 THEN ?3 ELSE target_value END, "
+        "updated_date = datetime('now') WHERE id = ?4;";
+
+    // 已解锁的记录不再更新进度
+    static constexpr const char* UPSERT_PROGRESS_SQL =
+        "INSERT INTO user_achievements (user_id, achievement_key, progress, updated_date) "
+        "VALUES (?, ?, ?, datetime('now')) "
+        "ON CONFLICT(user_id, achievement_key) DO UPDATE SET "
+        "progress = excluded.progress, updated_date = excluded.updated_date "
+        "WHERE user_achievements.unlocked_at IS NULL;";
+
+    static constexpr const char* UPSERT_UNLOCK_SQL =
+        "INSERT INTO user_achievements (user_id, achievement_key, progress, unlocked_at, updated_date) "
+        "VALUES (?, ?, ?, ?, datetime('now')) "
+        "ON CONFLICT(user_id, achievement_key) DO UPDATE SET "
+        "progress = excluded.progress, unlocked_at = excluded.unlocked_at, updated_date = excluded.updated_date "
+        "WHERE user_achievements.unlocked_at IS NULL;";
+
+    static constexpr const char* SAVE_USER_ACHIEVEMENT_SQL =
+        "INSERT INTO user_achievements (user_id, achievement_key, progress, unlocked_at, updated_date) "
+        "VALUES (?, ?, ?, ?, datetime('now')) "
+        "ON CONFLICT(user_id, achievement_key) DO UPDATE SET "
+        "progress = excluded.progress, unlocked_at = excluded.unlocked_at, updated_date = excluded.updated_date;";
+
+    // CSV 导入：保留较大的进度和最早的解锁时间
+    static constexpr const char* IMPORT_USER_ACHIEVEMENT_SQL =
+        "INSERT INTO user_achievements (user_id, achievement_key, progress, unlocked_at, updated_date) "
+        "VALUES (?, ?, ?, ?, datetime('now')) "
+        "ON CONFLICT(user_id, achievement_key) DO UPDATE SET "
+        "progress = MAX(user_achievements.progress, excluded.progress), "
+        "unlocked_at = COALESCE(user_achievements.unlocked_at, excluded.unlocked_at);";
+
+    static constexpr const char* DELETE_USER_ACHIEVEMENTS_SQL =
+        "DELETE FROM user_achievements WHERE user_id = ?;";
+
+    static constexpr const char* COUNT_UNLOCKED_SQL =
+        "SELECT COUNT(*) FROM user_achievements WHERE user_id = ? AND unlocked_at IS NOT NULL;";
+
+    static constexpr const char* TOTAL_XP_SQL =
+        "SELECT COALESCE(SUM(a.reward_xp), 0) FROM user_achievements ua "
+        "JOIN achievements a ON a.unlock_condition = ua.achievement_key "
+        "WHERE ua.user_id = ? AND ua.unlocked_at IS NOT NULL;";
+
+    sqlite3* getDb() const {
+        if (!dbManager.isOpen()) {
+            dbManager.initialize(dbPath.empty() ? "task_manager.db" : dbPath);
+        }
+        return dbManager.getRawConnection();
+    }
 
-std::string AchievementDAO::getUserAchievementFilePath(int userId) const {
-    return dataFilePath + "user_achievements_" + std::to_string(userId) + ".csv";
-}
+    bool ensureTable() {
+        return dbManager.tableExists("user_achievements") || dbManager.createTables();
+    }
 
-bool AchievementDAO::fileExists(const std::string& filename) const {
-    std::ifstream file(filename);
-    return file.good();
-}
+    // 在主连接上执行缓存的预编译语句；onRow 对每一行调用
+    template <typename Binder, typename RowHandler>
+    bool runStatement(const char* sql, Binder bind, RowHandler onRow) const {
+        sqlite3* db = getDb();
+        if (!db) return false;
+
+        sqlite3_stmt* stmt = dbManager.getPreparedStatement(sql);
+        if (!stmt) {
+            std::cerr << "准备成就语句失败: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+
+        bind(stmt);
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            onRow(stmt);
+        }
 
-bool AchievementDAO::writeFile(const std::string& filename, const std::string& content) {
-    std::ofstream file(filename, std::ios::trunc);
-    if (!file.is_open()) {
-        return false;
+        bool ok = rc == SQLITE_DONE;
+        if (!ok) {
+            std::cerr << "执行成就语句失败: " << sqlite3_errmsg(db) << std::endl;
+        }
+        sqlite3_reset(stmt);
+        return ok;
     }
-    file << content;
-    return true;
-}
 
-void AchievementDAO::initializeDefaultAchievements() {
-    // 如果已经有定义文件并且能加载成功，就不再初始化默认成就
-    if (!loadAchievementDefinitions()) {
-        const std::string now = getCurrentTimestamp();
+    template <typename Binder>
+    bool runStatement(const char* sql, Binder bind) {
+        return runStatement(sql, bind, [](sqlite3_stmt*) {});
+    }
+
+    int queryInt(const char* sql, int userId) const {
+        int value = 0;
+        runStatement(sql,
+            [userId](sqlite3_stmt* stmt) { sqlite3_bind_int(stmt, 1, userId); },
+            [&value](sqlite3_stmt* stmt) { value = sqlite3_column_int(stmt, 0); });
+        return value;
+    }
 
+    static Achievement extractDefinition(sqlite3_stmt* stmt) {
+        Achievement achievement;
+        achievement.id = sqlite3_column_int(stmt, 0);
+        achievement.created_date = columnText(stmt, 1);
+        achievement.updated_date = columnText(stmt, 2);
+        achievement.name = columnText(stmt, 3);
+        achievement.description = columnText(stmt, 4);
+        achievement.icon = columnText(stmt, 5);
+        achievement.unlock_condition = columnText(stmt, 6);
+        achievement.reward_xp = sqlite3_column_int(stmt, 7);
+        achievement.category = columnText(stmt, 8);
+        achievement.target_value = sqlite3_column_int(stmt, 9);
+        return achievement;
+    }
+
+    // 定义列之后紧跟 progress, unlocked_at
+    static Achievement extractUserAchievement(sqlite3_stmt* stmt) {
+        Achievement achievement = extractDefinition(stmt);
+        achievement.progress = sqlite3_column_int(stmt, 10);
+        achievement.unlocked = sqlite3_column_type(stmt, 11) != SQLITE_NULL;
+        achievement.unlocked_date = columnText(stmt, 11);
+        return achievement;
+    }
+
+    static void bindText(sqlite3_stmt* stmt, int index, const std::string& value) {
+        sqlite3_bind_text(stmt, index, value.c_str(), -1, SQLITE_TRANSIENT);
+    }
+
+    static void bindUnlockedAt(sqlite3_stmt* stmt, int index, const Achievement& achievement) {
+        if (achievement.unlocked) {
+            bindText(stmt, index, achievement.unlocked_date.empty() ? getCurrentTimestamp() : achievement.unlocked_date);
+        } else {
+            sqlite3_bind_null(stmt, index);
+        }
+    }
+
+    bool insertDefinition(const char* sql, const Achievement& achievement) {
+        return runStatement(sql, [&](sqlite3_stmt* stmt) {
+            bindText(stmt, 1, achievement.name);
+            bindText(stmt, 2, achievement.description);
+            bindText(stmt, 3, achievement.icon);
+            bindText(stmt, 4, achievement.unlock_condition);
+            sqlite3_bind_int(stmt, 5, achievement.reward_xp);
+            bindText(stmt, 6, achievement.category);
+            sqlite3_bind_int(stmt, 7, achievement.target_value);
+        });
+    }
+
+    bool importDefinitionFile(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file.is_open()) return false;
+
+        std::string line;
+        getline(file, line); // 跳过标题行
+
+        bool ok = true;
+        while (ok && getline(file, line)) {
+            Achievement achievement;
+            if (line.empty() || !parseLegacyCsvLine(line, achievement)) continue;
+            ok = insertDefinition(IMPORT_DEFINITION_SQL, achievement);
+        }
+        return ok;
+    }
+
+    bool importUserFile(const std::string& filename, int userId) {
+        std::ifstream file(filename);
+        if (!file.is_open()) return false;
+
+        std::string line;
+        getline(file, line); // 跳过标题行
+
+        bool ok = true;
+        while (ok && getline(file, line)) {
+            Achievement achievement;
+            if (line.empty() || !parseLegacyCsvLine(line, achievement)) continue;
+            if (!achievement.unlocked && achievement.progress <= 0) continue;
+
+            ok = runStatement(IMPORT_USER_ACHIEVEMENT_SQL, [&](sqlite3_stmt* stmt) {
+                sqlite3_bind_int(stmt, 1, userId);
+                bindText(stmt, 2, achievement.unlock_condition);
+                sqlite3_bind_int(stmt, 3, achievement.progress);
+                bindUnlockedAt(stmt, 4, achievement);
+            });
+        }
+        return ok;
+    }
+
+    Achievement* findLoaded(const std::string& achievementKey) {
+        for (auto& achievement : userAchievements) {
+            if (achievement.unlock_condition == achievementKey) {
+                return &achievement;
+            }
+        }
+        return nullptr;
+    }
+
+public:
+    explicit SQLiteAchievementDAO(const std::string& legacyDataPath = "./data/",
+                                  const std::string& databasePath = "task_manager.db")
+        : dbManager(DatabaseManager::getInstance()), dbPath(databasePath) {
+        getDb();
+        ensureTable();
+        if (!legacyDataPath.empty() && std::filesystem::is_directory(legacyDataPath)) {
+            importFromCSV(legacyDataPath);
+        }
+        initializeDefaultAchievements();
+    }
+
+    ~SQLiteAchievementDAO() override = default;
+
+    void initializeDefaultAchievements() override {
+        // 已有定义（包括从 CSV 迁移来的）时不再初始化默认成就
+        if (loadAchievementDefinitions()) {
+            return;
+        }
+
+        std::vector<Achievement> defaults;
         auto addDefinition = [&](const std::string& name,
                                  const std::string& description,
                                  const std::string& icon,
@@ -59,20 +311,14 @@ void AchievementDAO::initializeDefaultAchievements() {
                                  const std::string& category,
                                  int targetValue) {
             Achievement achievement;
-            achievement.id = generateAchievementId();
-            achievement.created_date = now;
-            achievement.updated_date = now;
             achievement.name = name;
             achievement.description = description;
             achievement.icon = icon;
             achievement.unlock_condition = unlockKey;
-            achievement.unlocked = false;
-            achievement.unlocked_date.clear();
             achievement.reward_xp = rewardXP;
             achievement.category = category;
-            achievement.progress = 0;
             achievement.target_value = targetValue;
-            achievementDefinitions.push_back(achievement);
+            defaults.push_back(achievement);
         };
 
         // === Task Completion Achievements (1→5→10→25→50→100→200) ===
@@ -112,364 +358,339 @@ void AchievementDAO::initializeDefaultAchievements() {
         addDefinition("Pomodoro Master", "Complete 100 Pomodoro sessions", "🎯", "pomodoro_100", 1000, "time", 100);
         addDefinition("Pomodoro Legend", "Complete 200 Pomodoro sessions", "👑", "pomodoro_200", 2000, "time", 200);
 
-        saveAchievementDefinitions();
-    }
-}
+        if (dbManager.beginTransaction()) {
+            bool ok = true;
+            for (const auto& achievement : defaults) {
+                ok = ok && insertDefinition(IMPORT_DEFINITION_SQL, achievement);
+            }
+            if (ok) {
+                dbManager.commitTransaction();
+            } else {
+                dbManager.rollbackTransaction();
+            }
+        }
 
-bool AchievementDAO::loadAchievementDefinitions() {
-    ifstream file(getDefinitionFilePath());
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    achievementDefinitions.clear();
-    string line;
-    getline(file, line); // 跳过标题行
-    
-    while (getline(file, line)) {
-        if (line.empty()) continue;
-        
-        stringstream ss(line);
-        string id, created_date, updated_date, name, description, icon;
-        string unlock_condition, unlocked_str, unlocked_date, reward_xp_str;
-        string category, progress_str, target_value_str;
-        
-        getline(ss, id, ',');
-        getline(ss, created_date, ',');
-        getline(ss, updated_date, ',');
-        getline(ss, name, ',');
-        getline(ss, description, ',');
-        getline(ss, icon, ',');
-        getline(ss, unlock_condition, ',');
-        getline(ss, unlocked_str, ',');
-        getline(ss, unlocked_date, ',');
-        getline(ss, reward_xp_str, ',');
-        getline(ss, category, ',');
-        getline(ss, progress_str, ',');
-        getline(ss, target_value_str, ',');
-        
-        Achievement achievement;
-        achievement.id = stoi(id);
-        achievement.created_date = created_date;
-        achievement.updated_date = updated_date;
-        achievement.name = name;
-        achievement.description = description;
-        achievement.icon = icon;
-        achievement.unlock_condition = unlock_condition;
-        achievement.unlocked = (unlocked_str == "1");
-        achievement.unlocked_date = unlocked_date;
-        achievement.reward_xp = stoi(reward_xp_str);
-        achievement.category = category;
-        achievement.progress = stoi(progress_str);
-        achievement.target_value = stoi(target_value_str);
-        
-        achievementDefinitions.push_back(achievement);
-        nextAchievementId = std::max(nextAchievementId, achievement.id + 1);
+        loadAchievementDefinitions();
     }
-    
-    file.close();
-    return true;
-}
 
-bool AchievementDAO::saveAchievementDefinitions() {
-    ofstream file(getDefinitionFilePath());
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    file << "id,created_date,updated_date,name,description,icon,unlock_condition,"
-            "unlocked,unlocked_date,reward_xp,category,progress,target_value\n";
-    
-    for (const auto& achievement : achievementDefinitions) {
-        file << achievement.id << ","
-             << achievement.created_date << ","
-             << achievement.updated_date << ","
-             << achievement.name << ","
-             << achievement.description << ","
-             << achievement.icon << ","
-             << achievement.unlock_condition << ","
-             << (achievement.unlocked ? "1" : "0") << ","
-             << achievement.unlocked_date << ","
-             << achievement.reward_xp << ","
-             << achievement.category << ","
-             << achievement.progress << ","
-             << achievement.target_value << "\n";
-    }
-    
-    file.close();
-    return true;
-}
+    bool loadAchievementDefinitions() override {
+        std::vector<Achievement> definitions;
+        bool ok = runStatement(SELECT_DEFINITIONS_SQL, [](sqlite3_stmt*) {},
+            [&definitions](sqlite3_stmt* stmt) { definitions.push_back(extractDefinition(stmt)); });
+        if (!ok) return false;
 
-bool AchievementDAO::updateAchievementDefinition(int id,
-                                                 const std::string& name,
-                                                 const std::string& description,
-                                                 int targetValue) {
-    for (auto& achievement : achievementDefinitions) {
-        if (achievement.id == id) {
-            if (!name.empty()) achievement.name = name;
-            if (!description.empty()) achievement.description = description;
-            if (targetValue > 0) achievement.target_value = targetValue;
-            achievement.updated_date = getCurrentTimestamp();
-            return saveAchievementDefinitions();
-        }
+        achievementDefinitions = std::move(definitions);
+        return !achievementDefinitions.empty();
     }
-    return false;
-}
 
-int AchievementDAO::createAchievementDefinition(const std::string& name,
-                                                const std::string& description,
-                                                const std::string& unlockCondition,
-                                                int targetValue,
-                                                int rewardXP,
-                                                const std::string& category,
-                                                const std::string& icon) {
-    const std::string now = getCurrentTimestamp();
-    
-    Achievement achievement;
-    achievement.id = generateAchievementId();
-    achievement.created_date = now;
-    achievement.updated_date = now;
-    achievement.name = name;
-    achievement.description = description;
-    achievement.icon = icon;
-    achievement.unlock_condition = unlockCondition;
-    achievement.unlocked = false;
-    achievement.unlocked_date.clear();
-    achievement.reward_xp = rewardXP;
-    achievement.category = category;
-    achievement.progress = 0;
-    achievement.target_value = targetValue;
-    
-    achievementDefinitions.push_back(achievement);
-    
-    if (saveAchievementDefinitions()) {
-        return achievement.id;
+    bool saveAchievementDefinitions() override {
+        if (!dbManager.beginTransaction()) {
+            return false;
+        }
+        for (const auto& achievement : achievementDefinitions) {
+            bool ok = runStatement(SAVE_DEFINITION_SQL, [&](sqlite3_stmt* stmt) {
+                bindText(stmt, 1, achievement.name);
+                bindText(stmt, 2, achievement.description);
+                bindText(stmt, 3, achievement.icon);
+                sqlite3_bind_int(stmt, 4, achievement.reward_xp);
+                bindText(stmt, 5, achievement.category);
+                sqlite3_bind_int(stmt, 6, achievement.target_value);
+                sqlite3_bind_int(stmt, 7, achievement.id);
+            });
+            if (!ok) {
+                dbManager.rollbackTransaction();
+                return false;
+            }
+        }
+        return dbManager.commitTransaction();
     }
-    return -1;
-}
 
-vector<Achievement> AchievementDAO::getAllAchievementDefinitions() const {
-    return achievementDefinitions;
-}
-
-Achievement AchievementDAO::getAchievementDefinition(const string& achievementKey) const {
-    for (const auto& achievement : achievementDefinitions) {
-        if (achievement.unlock_condition == achievementKey) {
-            return achievement;
-        }
+    std::vector<Achievement> getAllAchievementDefinitions() const override {
+        return achievementDefinitions;
     }
-    return Achievement();
-}
 
-bool AchievementDAO::loadUserAchievements(int userId) {
-    ifstream file(getUserAchievementFilePath(userId));
-    if (!file.is_open()) {
-        // 如果用户文件不存在，基于成就定义生成初始成就数据
-        if (achievementDefinitions.empty()) {
-            // 尝试先加载定义，如果仍然为空则初始化默认定义
-            loadAchievementDefinitions();
-            if (achievementDefinitions.empty()) {
-                initializeDefaultAchievements();
+    Achievement getAchievementDefinition(const std::string& achievementKey) const override {
+        for (const auto& achievement : achievementDefinitions) {
+            if (achievement.unlock_condition == achievementKey) {
+                return achievement;
             }
         }
+        return Achievement();
+    }
 
-        const std::string now = getCurrentTimestamp();
-        userAchievements.clear();
-        for (const auto& definition : achievementDefinitions) {
-            Achievement userEntry = definition;
-            userEntry.id = generateAchievementId();
-            userEntry.created_date = now;
-            userEntry.updated_date = now;
-            userEntry.unlocked = false;
-            userEntry.unlocked_date.clear();
-            userEntry.progress = 0;
-            userAchievements.push_back(userEntry);
-        }
-
-        return saveUserAchievements(userId);
-    }
-    
-    userAchievements.clear();
-    string line;
-    getline(file, line); // 跳过标题行
-    
-    while (getline(file, line)) {
-        if (line.empty()) continue;
-        
-        stringstream ss(line);
-        string id, created_date, updated_date, name, description, icon;
-        string unlock_condition, unlocked_str, unlocked_date, reward_xp_str;
-        string category, progress_str, target_value_str;
-        
-        getline(ss, id, ',');
-        getline(ss, created_date, ',');
-        getline(ss, updated_date, ',');
-        getline(ss, name, ',');
-        getline(ss, description, ',');
-        getline(ss, icon, ',');
-        getline(ss, unlock_condition, ',');
-        getline(ss, unlocked_str, ',');
-        getline(ss, unlocked_date, ',');
-        getline(ss, reward_xp_str, ',');
-        getline(ss, category, ',');
-        getline(ss, progress_str, ',');
-        getline(ss, target_value_str, ',');
-        
-        Achievement achievement;
-        achievement.id = stoi(id);
-        achievement.created_date = created_date;
-        achievement.updated_date = updated_date;
-        achievement.name = name;
-        achievement.description = description;
-        achievement.icon = icon;
-        achievement.unlock_condition = unlock_condition;
-        achievement.unlocked = (unlocked_str == "1");
-        achievement.unlocked_date = unlocked_date;
-        achievement.reward_xp = stoi(reward_xp_str);
-        achievement.category = category;
-        achievement.progress = stoi(progress_str);
-        achievement.target_value = stoi(target_value_str);
-        
-        userAchievements.push_back(achievement);
-        nextAchievementId = std::max(nextAchievementId, achievement.id + 1);
-    }
-    
-    file.close();
-    return true;
-}
+    bool loadUserAchievements(int userId) override {
+        std::vector<Achievement> entries;
+        bool ok = runStatement(SELECT_USER_ACHIEVEMENTS_SQL,
+            [userId](sqlite3_stmt* stmt) { sqlite3_bind_int(stmt, 1, userId); },
+            [&entries](sqlite3_stmt* stmt) { entries.push_back(extractUserAchievement(stmt)); });
+        if (!ok) return false;
 
-bool AchievementDAO::saveUserAchievements(int userId) {
-    ofstream file(getUserAchievementFilePath(userId));
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    file << "id,created_date,updated_date,name,description,icon,unlock_condition,"
-            "unlocked,unlocked_date,reward_xp,category,progress,target_value\n";
-    
-    for (const auto& achievement : userAchievements) {
-        file << achievement.id << ","
-             << achievement.created_date << ","
-             << achievement.updated_date << ","
-             << achievement.name << ","
-             << achievement.description << ","
-             << achievement.icon << ","
-             << achievement.unlock_condition << ","
-             << (achievement.unlocked ? "1" : "0") << ","
-             << achievement.unlocked_date << ","
-             << achievement.reward_xp << ","
-             << achievement.category << ","
-             << achievement.progress << ","
-             << achievement.target_value << "\n";
-    }
-    
-    file.close();
-    return true;
-}
+        userAchievements = std::move(entries);
+        loadedUserId = userId;
+        return true;
+    }
 
-vector<Achievement> AchievementDAO::getUserAchievements(int userId) const {
-    (void)userId; // 当前实现中依赖先调用 loadUserAchievements(userId)
-    return userAchievements;
-}
+    bool saveUserAchievements(int userId) override {
+        if (userId != loadedUserId) {
+            return false;
+        }
 
-Achievement* AchievementDAO::getUserAchievement(int userId, const string& achievementKey) {
-    (void)userId; // 实际上依赖于调用者先 loadUserAchievements(userId)
-    for (auto& achievement : userAchievements) {
-        if (achievement.unlock_condition == achievementKey) {
-            return &achievement;
+        if (!dbManager.beginTransaction()) {
+            return false;
         }
+        for (const auto& achievement : userAchievements) {
+            bool ok = runStatement(SAVE_USER_ACHIEVEMENT_SQL, [&](sqlite3_stmt* stmt) {
+                sqlite3_bind_int(stmt, 1, userId);
+                bindText(stmt, 2, achievement.unlock_condition);
+                sqlite3_bind_int(stmt, 3, achievement.progress);
+                bindUnlockedAt(stmt, 4, achievement);
+            });
+            if (!ok) {
+                dbManager.rollbackTransaction();
+                return false;
+            }
+        }
+        return dbManager.commitTransaction();
     }
-    
-    Achievement definition = getAchievementDefinition(achievementKey);
-    if (definition.id == 0) {
-        return nullptr;
+
+    std::vector<Achievement> getUserAchievements(int userId) const override {
+        (void)userId; // 依赖调用者先 loadUserAchievements(userId)
+        return userAchievements;
+    }
+
+    Achievement* getUserAchievement(int userId, const std::string& achievementKey) override {
+        if (userId != loadedUserId && !loadUserAchievements(userId)) {
+            return nullptr;
+        }
+        return findLoaded(achievementKey);
     }
-    
-    Achievement newAchievement = definition;
-    newAchievement.id = generateAchievementId();
-    newAchievement.created_date = getCurrentTimestamp();
-    newAchievement.updated_date = getCurrentTimestamp();
-    newAchievement.unlocked = false;
-    newAchievement.unlocked_date = "";
-    newAchievement.progress = 0;
-    
-    userAchievements.push_back(newAchievement);
-    return &userAchievements.back();
-}
 
-bool AchievementDAO::unlockAchievement(int userId, const string& achievementKey) {
-    Achievement* achievement = getUserAchievement(userId, achievementKey);
-    if (achievement && !achievement->unlocked) {
+    bool unlockAchievement(int userId, const std::string& achievementKey) override {
+        Achievement* achievement = getUserAchievement(userId, achievementKey);
+        if (!achievement || achievement->unlocked) {
+            return false;
+        }
+
+        const std::string now = getCurrentTimestamp();
+        bool ok = runStatement(UPSERT_UNLOCK_SQL, [&](sqlite3_stmt* stmt) {
+            sqlite3_bind_int(stmt, 1, userId);
+            bindText(stmt, 2, achievementKey);
+            sqlite3_bind_int(stmt, 3, achievement->target_value);
+            bindText(stmt, 4, now);
+        });
+        if (!ok) return false;
+
         achievement->unlocked = true;
         achievement->progress = achievement->target_value;
-        achievement->unlocked_date = getCurrentTimestamp();
-        achievement->updated_date = getCurrentTimestamp();
-        return saveUserAchievements(userId);
+        achievement->unlocked_date = now;
+        achievement->updated_date = now;
+        return true;
     }
-    return false;
-}
 
-bool AchievementDAO::updateAchievementProgress(int userId, const string& achievementKey, int progress) {
-    Achievement* achievement = getUserAchievement(userId, achievementKey);
-    if (achievement && !achievement->unlocked) {
-        achievement->progress = progress;
-        achievement->updated_date = getCurrentTimestamp();
-        
+    bool updateAchievementProgress(int userId, const std::string& achievementKey, int progress) override {
+        Achievement* achievement = getUserAchievement(userId, achievementKey);
+        if (!achievement || achievement->unlocked) {
+            return false;
+        }
+
         if (progress >= achievement->target_value) {
             return unlockAchievement(userId, achievementKey);
         }
-        
-        return saveUserAchievements(userId);
+
+        bool ok = runStatement(UPSERT_PROGRESS_SQL, [&](sqlite3_stmt* stmt) {
+            sqlite3_bind_int(stmt, 1, userId);
+            bindText(stmt, 2, achievementKey);
+            sqlite3_bind_int(stmt, 3, progress);
+        });
+        if (!ok) return false;
+
+        achievement->progress = progress;
+        achievement->updated_date = getCurrentTimestamp();
+        return true;
     }
-    return false;
-}
 
-bool AchievementDAO::resetUserAchievements(int userId) {
-    userAchievements.clear();
-    return saveUserAchievements(userId);
-}
+    bool saveProgressBatch(int userId, const std::vector<std::pair<std::string, int>>& progress) override {
+        if (progress.empty()) {
+            return true;
+        }
+
+        if (!dbManager.beginTransaction()) {
+            return false;
+        }
+        for (const auto& [key, value] : progress) {
+            bool ok = runStatement(UPSERT_PROGRESS_SQL, [&](sqlite3_stmt* stmt) {
+                sqlite3_bind_int(stmt, 1, userId);
+                bindText(stmt, 2, key);
+                sqlite3_bind_int(stmt, 3, value);
+            });
+            if (!ok) {
+                dbManager.rollbackTransaction();
+                return false;
+            }
+        }
+        if (!dbManager.commitTransaction()) {
+            return false;
+        }
+
+        if (userId == loadedUserId) {
+            for (const auto& [key, value] : progress) {
+                Achievement* achievement = findLoaded(key);
+                if (achievement && !achievement->unlocked) {
+                    achievement->progress = value;
+                }
+            }
+        }
+        return true;
+    }
 
-int AchievementDAO::getUnlockedAchievementCount(int userId) const {
-    (void)userId; // 依赖调用者先 loadUserAchievements(userId)
-    int count = 0;
-    for (const auto& achievement : userAchievements) {
-        if (achievement.unlocked) count++;
+    bool resetUserAchievements(int userId) override {
+        bool ok = runStatement(DELETE_USER_ACHIEVEMENTS_SQL,
+            [userId](sqlite3_stmt* stmt) { sqlite3_bind_int(stmt, 1, userId); });
+        if (ok && userId == loadedUserId) {
+            loadUserAchievements(userId);
+        }
+        return ok;
     }
-    return count;
-}
 
-int AchievementDAO::getTotalXP(int userId) const {
-    (void)userId; // 依赖调用者先 loadUserAchievements(userId)
-    int totalXP = 0;
-    for (const auto& achievement : userAchievements) {
-        if (achievement.unlocked) totalXP += achievement.reward_xp;
+    int getUnlockedAchievementCount(int userId) const override {
+        return queryInt(COUNT_UNLOCKED_SQL, userId);
     }
-    return totalXP;
-}
 
-std::vector<Achievement> AchievementDAO::getRecentlyUnlockedAchievements(int userId, int count) const {
-    (void)userId; // 同样依赖之前已 loadUserAchievements(userId)
-    std::vector<Achievement> unlocked;
-    for (const auto& achievement : userAchievements) {
-        if (achievement.unlocked) {
-            unlocked.push_back(achievement);
+    int getTotalXP(int userId) const override {
+        return queryInt(TOTAL_XP_SQL, userId);
+    }
+
+    std::vector<Achievement> getRecentlyUnlockedAchievements(int userId, int count) const override {
+        std::vector<Achievement> unlocked;
+        runStatement(SELECT_RECENT_UNLOCKED_SQL,
+            [userId, count](sqlite3_stmt* stmt) {
+                sqlite3_bind_int(stmt, 1, userId);
+                sqlite3_bind_int(stmt, 2, count > 0 ? count : -1);   // LIMIT -1 表示不限
+            },
+            [&unlocked](sqlite3_stmt* stmt) { unlocked.push_back(extractUserAchievement(stmt)); });
+        return unlocked;
+    }
+
+    bool updateAchievementDefinition(int id,
+                                     const std::string& name,
+                                     const std::string& description,
+                                     int targetValue) override {
+        bool ok = runStatement(UPDATE_DEFINITION_SQL, [&](sqlite3_stmt* stmt) {
+            bindText(stmt, 1, name);
+            bindText(stmt, 2, description);
+            sqlite3_bind_int(stmt, 3, targetValue);
+            sqlite3_bind_int(stmt, 4, id);
+        });
+        if (!ok || sqlite3_changes(getDb()) == 0) {
+            return false;
         }
+
+        auto apply = [&](Achievement& achievement) {
+            if (achievement.id != id) return;
+            if (!name.empty()) achievement.name = name;
+            if (!description.empty()) achievement.description = description;
+            if (targetValue > 0) achievement.target_value = targetValue;
+            achievement.updated_date = getCurrentTimestamp();
+        };
+        std::for_each(achievementDefinitions.begin(), achievementDefinitions.end(), apply);
+        std::for_each(userAchievements.begin(), userAchievements.end(), apply);
+        return true;
     }
 
-    std::sort(unlocked.begin(), unlocked.end(),
-              [](const Achievement& a, const Achievement& b) {
-                  return a.unlocked_date > b.unlocked_date; // 依赖时间字符串格式可比较
-              });
+    int createAchievementDefinition(const std::string& name,
+                                    const std::string& description,
+                                    const std::string& unlockCondition,
+                                    int targetValue,
+                                    int rewardXP,
+                                    const std::string& category,
+                                    const std::string& icon) override {
+        // 规则在写入前编译一次：语法错误直接拒绝，DSL 规则的阈值以规则本身为准
+        CompiledRule rule;
+        std::string error;
+        auto result = AchievementRules::compile(unlockCondition, targetValue, rule, &error);
+        if (result == RuleParseResult::Invalid) {
+            std::cerr << "成就规则无效 (" << unlockCondition << "): " << error << std::endl;
+            return -1;
+        }
+        if (result == RuleParseResult::Compiled) {
+            targetValue = rule.threshold;
+        }
+
+        Achievement achievement;
+        achievement.name = name;
+        achievement.description = description;
+        achievement.icon = icon;
+        achievement.unlock_condition = unlockCondition;
+        achievement.reward_xp = rewardXP;
+        achievement.category = category;
+        achievement.target_value = targetValue;
 
-    if (count > 0 && static_cast<int>(unlocked.size()) > count) {
-        unlocked.resize(count);
+        if (!insertDefinition(INSERT_DEFINITION_SQL, achievement)) {
+            return -1;
+        }
+
+        achievement.id = static_cast<int>(sqlite3_last_insert_rowid(getDb()));
+        achievement.created_date = achievement.updated_date = getCurrentTimestamp();
+        achievementDefinitions.push_back(achievement);
+        if (loadedUserId >= 0) {
+            userAchievements.push_back(achievement);
+        }
+        return achievement.id;
     }
-    return unlocked;
-}
 
-bool AchievementDAO::userAchievementFileExists(int userId) const {
-    return fileExists(getUserAchievementFilePath(userId));
-}
+    bool importFromCSV(const std::string& directory) override {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        if (!fs::is_directory(directory, ec)) {
+            return false;
+        }
+
+        const fs::path definitionFile = fs::path(directory) / "achievement_definitions.csv";
+        std::vector<std::pair<fs::path, int>> userFiles;
+        for (const auto& entry : fs::directory_iterator(directory, ec)) {
+            const std::string filename = entry.path().filename().string();
+            if (entry.path().extension() != ".csv" || filename.rfind("user_achievements_", 0) != 0) {
+                continue;
+            }
+            try {
+                userFiles.emplace_back(entry.path(), std::stoi(filename.substr(18)));
+            } catch (const std::exception&) {
+                std::cerr << "跳过无法识别的成就文件: " << filename << std::endl;
+            }
+        }
+
+        const bool hasDefinitions = fs::exists(definitionFile, ec);
+        if (!hasDefinitions && userFiles.empty()) {
+            return false;
+        }
+
+        // 先导入定义，用户进度通过 unlock_condition 关联到定义
+        if (!dbManager.beginTransaction()) {
+            return false;
+        }
+        bool ok = !hasDefinitions || importDefinitionFile(definitionFile.string());
+        for (const auto& [path, userId] : userFiles) {
+            ok = ok && importUserFile(path.string(), userId);
+        }
+        if (!ok) {
+            dbManager.rollbackTransaction();
+        }
+        if (!ok || !dbManager.commitTransaction()) {
+            std::cerr << "导入成就 CSV 失败: " << directory << std::endl;
+            return false;
+        }
+
+        auto markImported = [&ec](const fs::path& path) {
+            fs::rename(path, path.string() + ".imported", ec);
+        };
+        if (hasDefinitions) markImported(definitionFile);
+        for (const auto& file : userFiles) markImported(file.first);
+
+        std::cout << "已从 CSV 迁移成就数据（" << userFiles.size() << " 个用户文件）" << std::endl;
+        loadAchievementDefinitions();
+        return true;
+    }
+};
 
 std::string AchievementDAO::getCurrentTimestamp() {
     std::time_t now = std::time(nullptr);
@@ -484,6 +705,6 @@ std::string AchievementDAO::getCurrentTimestamp() {
     return oss.str();
 }
 
-int AchievementDAO::generateAchievementId() {
-    return nextAchievementId++;
+std::unique_ptr<AchievementDAO> createAchievementDAO(const std::string& legacyDataPath, const std::string& dbPath) {
+    return std::make_unique<SQLiteAchievementDAO>(legacyDataPath, dbPath);
 }
@@ -1 +1,395 @@
+#include "database/DAO/ExperienceDAO.h"
+#include "database/DatabaseManager.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <iostream>
+#include <mutex>
 
+namespace {
+    // 本文件的预编译语句缓存在主连接上，所有 ExperienceDAO 实例共用；
+    // 同一条语句不能被多个线程同时 step，因此在进程内串行化
+    std::mutex experienceMutex;
+
+    std::string columnText(sqlite3_stmt* stmt, int col) {
+        const unsigned char* text = sqlite3_column_text(stmt, col);
+        return text ? reinterpret_cast<const char*>(text) : "";
+    }
+
+    ExperienceRecord extractRecord(sqlite3_stmt* stmt) {
+        ExperienceRecord record;
+        record.id = sqlite3_column_int(stmt, 0);
+        record.userId = sqlite3_column_int(stmt, 1);
+        record.amount = sqlite3_column_int(stmt, 2);
+        record.source = columnText(stmt, 3);
+        record.description = columnText(stmt, 4);
+        record.timestamp = columnText(stmt, 5);
+        return record;
+    }
+}
+
+class SQLiteExperienceDAO : public ExperienceDAO {
+private:
+    DatabaseManager& dbManager;
+    std::vector<LevelDefinition> levels;   // 按等级升序
+
+    // SQL 语句常量（与 DatabaseManager::createUserStatsTable / createExperienceLedgerTable 保持一致）
+    static constexpr const char* ADD_XP_SQL =
+        "UPDATE user_stats SET total_xp = total_xp + ?, updated_date = datetime('now') "
+        "WHERE id = ? RETURNING total_xp, level;";
+    static constexpr const char* DEDUCT_XP_SQL =
+        "UPDATE user_stats SET total_xp = MAX(0, total_xp - ?), updated_date = datetime('now') "
+        "WHERE id = ? RETURNING total_xp, level;";
+    // 只允许升级：并发奖励以任意顺序提交时，等级也不会被较小的值覆盖
+    static constexpr const char* RAISE_LEVEL_SQL =
+        "UPDATE user_stats SET level = MAX(level, ?) WHERE id = ?;";
+    static constexpr const char* SET_LEVEL_SQL =
+        "UPDATE user_stats SET level = ? WHERE id = ?;";
+    static constexpr const char* INSERT_LEDGER_SQL =
+        "INSERT INTO xp_ledger (user_id, amount, source, description) VALUES (?, ?, ?, ?);";
+    static constexpr const char* INSERT_RECORD_SQL =
+        "INSERT INTO xp_ledger (user_id, amount, source, description, created_date) "
+        "VALUES (?, ?, ?, ?, COALESCE(NULLIF(?, ''), datetime('now')));";
+    static constexpr const char* SELECT_XP_SQL =
+        "SELECT total_xp FROM user_stats WHERE id = ?;";
+    static constexpr const char* SELECT_LEVEL_SQL =
+        "SELECT level FROM user_stats WHERE id = ?;";
+
+    static constexpr const char* SELECT_HISTORY_SQL =
+        "SELECT id, user_id, amount, source, description, created_date FROM xp_ledger "
+        "WHERE user_id = ? ORDER BY id DESC LIMIT ?;";
+    static constexpr const char* SELECT_RECENT_HISTORY_SQL =
+        "SELECT id, user_id, amount, source, description, created_date FROM xp_ledger "
+        "WHERE user_id = ? AND created_date >= datetime('now', ?) ORDER BY id DESC;";
+    static constexpr const char* TOTAL_EARNED_SQL =
+        "SELECT COALESCE(SUM(amount), 0) FROM xp_ledger WHERE user_id = ? AND amount > 0;";
+    static constexpr const char* EARNED_TODAY_SQL =
+        "SELECT COALESCE(SUM(amount), 0) FROM xp_ledger "
+        "WHERE user_id = ? AND amount > 0 AND created_date >= date('now');";
+    // 本周一 00:00 起（先回退 6 天再前进到周一，今天是周一时得到今天）
+    static constexpr const char* EARNED_THIS_WEEK_SQL =
+        "SELECT COALESCE(SUM(amount), 0) FROM xp_ledger "
+        "WHERE user_id = ? AND amount > 0 AND created_date >= date('now', '-6 days', 'weekday 1');";
+    static constexpr const char* EARNED_BY_SOURCE_SQL =
+        "SELECT source, SUM(amount) FROM xp_ledger WHERE user_id = ? AND amount > 0 GROUP BY source;";
+
+    static constexpr const char* XP_LEADERBOARD_SQL =
+        "SELECT id, total_xp, level FROM user_stats ORDER BY total_xp DESC, id LIMIT ?;";
+    static constexpr const char* LEVEL_LEADERBOARD_SQL =
+        "SELECT id, total_xp, level FROM user_stats ORDER BY level DESC, total_xp DESC, id LIMIT ?;";
+    static constexpr const char* RANK_BY_XP_SQL =
+        "SELECT COUNT(*) + 1 FROM user_stats WHERE total_xp > (SELECT total_xp FROM user_stats WHERE id = ?);";
+    static constexpr const char* RANK_BY_LEVEL_SQL =
+        "SELECT COUNT(*) + 1 FROM user_stats WHERE level > (SELECT level FROM user_stats WHERE id = ?);";
+
+    // 在主连接上执行缓存的预编译语句；调用方需持有 experienceMutex
+    template <typename Binder, typename RowHandler>
+    bool runStatement(const char* sql, Binder bind, RowHandler onRow) {
+        sqlite3* db = dbManager.getRawConnection();
+        if (!db) return false;
+
+        sqlite3_stmt* stmt = dbManager.getPreparedStatement(sql);
+        if (!stmt) {
+            std::cerr << "准备经验值语句失败: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+
+        bind(stmt);
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            onRow(stmt);
+        }
+
+        bool ok = rc == SQLITE_DONE;
+        if (!ok) {
+            std::cerr << "执行经验值语句失败: " << sqlite3_errmsg(db) << std::endl;
+        }
+        sqlite3_reset(stmt);
+        return ok;
+    }
+
+    template <typename Binder>
+    bool runStatement(const char* sql, Binder bind) {
+        return runStatement(sql, bind, [](sqlite3_stmt*) {});
+    }
+
+    int queryInt(const char* sql, int userId, int fallback = 0) {
+        int value = fallback;
+        runStatement(sql,
+            [userId](sqlite3_stmt* stmt) { sqlite3_bind_int(stmt, 1, userId); },
+            [&value](sqlite3_stmt* stmt) { value = sqlite3_column_int(stmt, 0); });
+        return value;
+    }
+
+    std::vector<ExperienceRecord> queryRecords(const char* sql, int userId, const std::string& arg, int limit) {
+        std::vector<ExperienceRecord> records;
+        runStatement(sql,
+            [&](sqlite3_stmt* stmt) {
+                sqlite3_bind_int(stmt, 1, userId);
+                if (limit >= 0) {
+                    sqlite3_bind_int(stmt, 2, limit);
+                } else {
+                    sqlite3_bind_text(stmt, 2, arg.c_str(), -1, SQLITE_TRANSIENT);
+                }
+            },
+            [&records](sqlite3_stmt* stmt) { records.push_back(extractRecord(stmt)); });
+        return records;
+    }
+
+    std::vector<UserRanking> queryLeaderboard(const char* sql, int limit) {
+        std::vector<UserRanking> rankings;
+        runStatement(sql,
+            [limit](sqlite3_stmt* stmt) { sqlite3_bind_int(stmt, 1, limit); },
+            [&rankings](sqlite3_stmt* stmt) {
+                UserRanking ranking;
+                ranking.rank = static_cast<int>(rankings.size()) + 1;
+                ranking.userId = sqlite3_column_int(stmt, 0);
+                ranking.username = "User " + std::to_string(ranking.userId);
+                ranking.totalXP = sqlite3_column_int(stmt, 1);
+                ranking.level = sqlite3_column_int(stmt, 2);
+                rankings.push_back(ranking);
+            });
+        return rankings;
+    }
+
+    int levelForXP(int totalXP) const {
+        int level = 1;
+        for (const auto& definition : levels) {
+            if (totalXP < definition.requiredXP) break;
+            level = definition.level;
+        }
+        return level;
+    }
+
+    // 累加（或扣除）经验值、追加流水并更新等级；调用方需持有 experienceMutex
+    bool applyExperience(const char* updateSql, int userId, int amount, int ledgerAmount,
+                         const std::string& source, const std::string& description, ExperienceAward& award) {
+        if (!dbManager.isOpen()) return false;
+
+        // 使用保存点而非 BEGIN：调用方已在事务中时会嵌套进去，否则自成一个事务
+        auto writeLock = dbManager.lockWrites();
+        if (!dbManager.execute("SAVEPOINT xp_award;")) {
+            return false;
+        }
+
+        bool found = false;
+        bool updated = runStatement(updateSql,
+            [&](sqlite3_stmt* stmt) {
+                sqlite3_bind_int(stmt, 1, amount);
+                sqlite3_bind_int(stmt, 2, userId);
+            },
+            [&](sqlite3_stmt* stmt) {
+                award.totalXP = sqlite3_column_int(stmt, 0);
+                award.previousLevel = sqlite3_column_int(stmt, 1);
+                found = true;
+            });
+        if (updated && !found) {
+            std::cerr << "用户 " << userId << " 的统计记录不存在，经验值未发放" << std::endl;
+        }
+        bool ok = updated && found;
+
+        if (ok) {
+            ok = runStatement(INSERT_LEDGER_SQL, [&](sqlite3_stmt* stmt) {
+                sqlite3_bind_int(stmt, 1, userId);
+                sqlite3_bind_int(stmt, 2, ledgerAmount);
+                sqlite3_bind_text(stmt, 3, source.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(stmt, 4, description.c_str(), -1, SQLITE_TRANSIENT);
+            });
+        }
+
+        if (ok) {
+            award.newLevel = levelForXP(award.totalXP);
+            if (award.newLevel != award.previousLevel) {
+                const char* levelSql = ledgerAmount >= 0 ? RAISE_LEVEL_SQL : SET_LEVEL_SQL;
+                ok = runStatement(levelSql, [&](sqlite3_stmt* stmt) {
+                    sqlite3_bind_int(stmt, 1, award.newLevel);
+                    sqlite3_bind_int(stmt, 2, userId);
+                });
+            }
+        }
+
+        if (!ok) {
+            dbManager.execute("ROLLBACK TO xp_award;");
+            dbManager.execute("RELEASE xp_award;");
+            return false;
+        }
+        return dbManager.execute("RELEASE xp_award;");
+    }
+
+public:
+    explicit SQLiteExperienceDAO(const std::vector<LevelDefinition>& levelDefinitions)
+        : dbManager(DatabaseManager::getInstance()), levels(levelDefinitions) {
+        std::sort(levels.begin(), levels.end(),
+                  [](const LevelDefinition& a, const LevelDefinition& b) { return a.level < b.level; });
+    }
+
+    // === 经验值管理 ===
+
+    bool awardExperience(int userId, int amount, const std::string& source, const std::string& description) override {
+        ExperienceAward award;
+        return addExperienceAtomic(userId, amount, source, description, award);
+    }
+
+    bool addExperienceAtomic(int userId, int amount, const std::string& source,
+                             const std::string& description, ExperienceAward& award) override {
+        if (amount <= 0) return false;
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        return applyExperience(ADD_XP_SQL, userId, amount, amount, source, description, award);
+    }
+
+    bool deductExperience(int userId, int amount, const std::string& reason) override {
+        if (amount <= 0) return false;
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        ExperienceAward award;
+        return applyExperience(DEDUCT_XP_SQL, userId, amount, -amount, "deduction", reason, award);
+    }
+
+    // === 等级管理 ===
+
+    bool levelUpUser(int userId) override {
+        // 补足到下一级所需的经验值，保持 total_xp 与等级一致
+        UserLevelInfo info = getLevelInfo(userId);
+        if (levels.empty() || info.currentLevel >= levels.back().level) {
+            return false;
+        }
+        int missing = info.xpForNextLevel - info.totalXP;
+        if (missing <= 0) {
+            std::lock_guard<std::mutex> lock(experienceMutex);
+            return runStatement(RAISE_LEVEL_SQL, [&](sqlite3_stmt* stmt) {
+                sqlite3_bind_int(stmt, 1, levelForXP(info.totalXP));
+                sqlite3_bind_int(stmt, 2, userId);
+            });
+        }
+        return awardExperience(userId, missing, "level_up", "等级提升");
+    }
+
+    // === 查询操作 ===
+
+    int getCurrentExperience(int userId) override {
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        return queryInt(SELECT_XP_SQL, userId);
+    }
+
+    int getCurrentLevel(int userId) override {
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        return queryInt(SELECT_LEVEL_SQL, userId, 1);
+    }
+
+    UserLevelInfo getLevelInfo(int userId) override {
+        UserLevelInfo info;
+        info.userId = userId;
+        info.totalXP = getCurrentExperience(userId);
+        info.currentLevel = levelForXP(info.totalXP);
+
+        LevelDefinition current = getLevelDefinition(info.currentLevel);
+        LevelDefinition next = getLevelDefinition(info.currentLevel + 1);
+        info.xpForCurrentLevel = current.requiredXP;
+        if (next.level == info.currentLevel + 1) {
+            info.xpForNextLevel = next.requiredXP;
+            int span = next.requiredXP - current.requiredXP;
+            info.progressToNextLevel = span > 0
+                ? static_cast<double>(info.totalXP - current.requiredXP) / span
+                : 1.0;
+        } else {
+            // 已满级
+            info.xpForNextLevel = current.requiredXP;
+            info.progressToNextLevel = 1.0;
+        }
+        return info;
+    }
+
+    LevelDefinition getLevelDefinition(int level) override {
+        for (const auto& definition : levels) {
+            if (definition.level == level) return definition;
+        }
+        return levels.empty() ? LevelDefinition() : levels.back();
+    }
+
+    // === 历史记录 ===
+
+    bool addExperienceRecord(const ExperienceRecord& record) override {
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        return runStatement(INSERT_RECORD_SQL, [&](sqlite3_stmt* stmt) {
+            sqlite3_bind_int(stmt, 1, record.userId);
+            sqlite3_bind_int(stmt, 2, record.amount);
+            sqlite3_bind_text(stmt, 3, record.source.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, 4, record.description.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, 5, record.timestamp.c_str(), -1, SQLITE_TRANSIENT);
+        });
+    }
+
+    std::vector<ExperienceRecord> getExperienceHistory(int userId, int limit) override {
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        return queryRecords(SELECT_HISTORY_SQL, userId, "", std::max(0, limit));
+    }
+
+    std::vector<ExperienceRecord> getRecentExperienceHistory(int userId, int hours) override {
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        return queryRecords(SELECT_RECENT_HISTORY_SQL, userId, "-" + std::to_string(hours) + " hours", -1);
+    }
+
+    // === 统计查询 ===
+
+    int getTotalExperienceEarned(int userId) override {
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        return queryInt(TOTAL_EARNED_SQL, userId);
+    }
+
+    int getExperienceEarnedToday(int userId) override {
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        return queryInt(EARNED_TODAY_SQL, userId);
+    }
+
+    int getExperienceEarnedThisWeek(int userId) override {
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        return queryInt(EARNED_THIS_WEEK_SQL, userId);
+    }
+
+    std::map<std::string, int> getExperienceBySource(int userId) override {
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        std::map<std::string, int> bySource;
+        runStatement(EARNED_BY_SOURCE_SQL,
+            [userId](sqlite3_stmt* stmt) { sqlite3_bind_int(stmt, 1, userId); },
+            [&bySource](sqlite3_stmt* stmt) { bySource[columnText(stmt, 0)] = sqlite3_column_int(stmt, 1); });
+        return bySource;
+    }
+
+    // === 排行榜 ===
+
+    std::vector<UserRanking> getExperienceLeaderboard(int limit) override {
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        return queryLeaderboard(XP_LEADERBOARD_SQL, limit);
+    }
+
+    std::vector<UserRanking> getLevelLeaderboard(int limit) override {
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        return queryLeaderboard(LEVEL_LEADERBOARD_SQL, limit);
+    }
+
+    int getUserRankByExperience(int userId) override {
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        return queryInt(RANK_BY_XP_SQL, userId);
+    }
+
+    int getUserRankByLevel(int userId) override {
+        std::lock_guard<std::mutex> lock(experienceMutex);
+        return queryInt(RANK_BY_LEVEL_SQL, userId);
+    }
+
+    // === 等级定义管理 ===
+
+    std::vector<LevelDefinition> getAllLevelDefinitions() override {
+        return levels;
+    }
+
+    bool updateLevelDefinition(const LevelDefinition& definition) override {
+        auto it = std::find_if(levels.begin(), levels.end(),
+                               [&](const LevelDefinition& d) { return d.level == definition.level; });
+        if (it == levels.end()) return false;
+        *it = definition;
+        return true;
+    }
+};
+
+std::unique_ptr<ExperienceDAO> createExperienceDAO(const std::vector<LevelDefinition>& levels) {
+    return std::make_unique<SQLiteExperienceDAO>(levels);
+}
@@ -1,35 +1,77 @@
-#include "HeatmapVisualizerDAO.h"
+#include "database/DAO/HeatmapVisualizerDao.h"
+#include "statistics/StreakTracker.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <iomanip>
 #include <ctime>
+#include <climits>
+#include <cstring>
 #include <filesystem>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
-// 声明友元访问器类来访问私有数据
-class HeatmapDataAccessor {
-public:
-    static const map<string, int>& getTaskData(const HeatmapVisualizer& visualizer) {
-        // 由于taskData是private，我们需要修改HeatmapVisualizer来提供访问接口
-        // 这里我们假设已经添加了getTaskData方法到HeatmapVisualizer类中
-        // 如果没有，需要在HeatmapVisualizer.h中添加：
-        // const map<string, int>& getTaskData() const { return taskData; }
-        return visualizer.getTaskData();
-    }
-    
-    static void setTaskData(HeatmapVisualizer& visualizer, const map<string, int>& newData) {
-        // 清空现有数据
-        // 这里需要HeatmapVisualizer提供清除数据的方法
-        visualizer.clearTaskData();
-        
-        // 添加新数据
-        for (const auto& pair : newData) {
-            visualizer.addTaskData(pair.first, pair.second);
+namespace {
+    const char HEATMAP_MAGIC[4] = {'H', 'M', 'A', 'P'};
+    const uint16_t HEATMAP_FORMAT_VERSION = 1;
+
+    static_assert(sizeof(HeatmapFileHeader) == 24, "heatmap header layout must stay fixed");
+
+    // 只读映射整个文件；Windows 下退化为一次性读入内存
+    class MappedFile {
+    public:
+        explicit MappedFile(const string& filename) {
+#ifdef _WIN32
+            ifstream file(filename, ios::binary);
+            if (file) {
+                buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+                data = buffer.data();
+                size = buffer.size();
+            }
+#else
+            int fd = open(filename.c_str(), O_RDONLY);
+            if (fd < 0) return;
+
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0) {
+                void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    data = static_cast<const char*>(mapped);
+                    size = static_cast<size_t>(st.st_size);
+                }
+            }
+            close(fd);
+#endif
         }
-    }
-};
+
+        ~MappedFile() {
+#ifndef _WIN32
+            if (data) munmap(const_cast<char*>(data), size);
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data = nullptr;
+        size_t size = 0;
+
+    private:
+#ifdef _WIN32
+        vector<char> buffer;
+#endif
+    };
+}
 
 HeatmapVisualizerDAO::HeatmapVisualizerDAO() : dataFilePath("heatmap_data/") {
     // 确保数据目录存在
@@ -44,42 +86,118 @@ HeatmapVisualizerDAO::HeatmapVisualizerDAO(const string& filePath) : dataFilePat
     filesystem::create_directories(dataFilePath);
 }
 
+string HeatmapVisualizerDAO::snapshotPath(const string& identifier) const {
+    return dataFilePath + "heatmap_" + identifier + ".hmap";
+}
+
+string HeatmapVisualizerDAO::legacyPath(const string& identifier) const {
+    return dataFilePath + "heatmap_" + identifier + ".dat";
+}
+
 bool HeatmapVisualizerDAO::saveHeatmapData(const HeatmapVisualizer& visualizer, const string& identifier) {
-    // 获取任务数据 - 需要HeatmapVisualizer提供getTaskData()方法
-    const map<string, int>& taskData = HeatmapDataAccessor::getTaskData(visualizer);
-    
-    string filename = dataFilePath + "heatmap_" + identifier + ".dat";
-    string serializedData = serializeTaskData(taskData);
-    
-    return writeFile(filename, serializedData);
+    return writeSnapshot(snapshotPath(identifier), visualizer.getBaseDay(), visualizer.getDayGrid());
 }
 
 bool HeatmapVisualizerDAO::loadHeatmapData(HeatmapVisualizer& visualizer, const string& identifier) {
-    string filename = dataFilePath + "heatmap_" + identifier + ".dat";
+    string filename = snapshotPath(identifier);
+    if (fileExists(filename)) {
+        return readSnapshot(filename, visualizer);
+    }
     
-    if (!fileExists(filename)) {
+    // 兼容旧版文本快照：读取后转存为二进制格式
+    string legacy = legacyPath(identifier);
+    if (!fileExists(legacy)) {
         return false;
     }
     
-    string fileContent = readFile(filename);
-    if (fileContent.empty()) {
+    map<string, int> taskData = deserializeTaskData(readFile(legacy));
+    if (taskData.empty()) {
         return false;
     }
     
-    map<string, int> taskData = deserializeTaskData(fileContent);
+    loadFromDateCounts(visualizer, taskData);
+    if (saveHeatmapData(visualizer, identifier)) {
+        filesystem::remove(legacy);
+    }
+    return true;
+}
+
+bool HeatmapVisualizerDAO::writeSnapshot(const string& filename, int baseDay, const vector<uint16_t>& counts) {
+    HeatmapFileHeader header{};
+    memcpy(header.magic, HEATMAP_MAGIC, sizeof(header.magic));
+    header.version = HEATMAP_FORMAT_VERSION;
+    header.baseDay = baseDay;
+    header.dayCount = static_cast<uint32_t>(counts.size());
+    for (uint16_t c : counts) header.totalCompleted += c;
     
-    // 将数据加载到visualizer中
-    HeatmapDataAccessor::setTaskData(visualizer, taskData);
+    // 先写临时文件再重命名，保证读取方不会看到写了一半的快照
+    string tempFile = filename + ".tmp";
+    {
+        ofstream file(tempFile, ios::binary | ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(counts.data()),
+                   static_cast<streamsize>(counts.size() * sizeof(uint16_t)));
+        if (!file) {
+            return false;
+        }
+    }
     
+    error_code ec;
+    filesystem::rename(tempFile, filename, ec);
+    if (ec) {
+        cerr << "Error saving heatmap snapshot: " << ec.message() << endl;
+        filesystem::remove(tempFile, ec);
+        return false;
+    }
     return true;
 }
 
-string HeatmapVisualizerDAO::serializeTaskData(const map<string, int>& taskData) {
-    ostringstream oss;
+bool HeatmapVisualizerDAO::readSnapshot(const string& filename, HeatmapVisualizer& visualizer) {
+    MappedFile file(filename);
+    if (!file.data || file.size < sizeof(HeatmapFileHeader)) {
+        return false;
+    }
+    
+    HeatmapFileHeader header;
+    memcpy(&header, file.data, sizeof(header));
+    
+    if (memcmp(header.magic, HEATMAP_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != HEATMAP_FORMAT_VERSION ||
+        file.size < sizeof(header) + static_cast<size_t>(header.dayCount) * sizeof(uint16_t)) {
+        cerr << "Invalid heatmap snapshot: " << filename << endl;
+        return false;
+    }
+    
+    // 头部 24 字节，计数数组天然 2 字节对齐，可直接作为 uint16_t 数组使用
+    const uint16_t* counts = reinterpret_cast<const uint16_t*>(file.data + sizeof(header));
+    visualizer.loadSnapshot(header.baseDay, counts, header.dayCount);
+    return true;
+}
+
+void HeatmapVisualizerDAO::loadFromDateCounts(HeatmapVisualizer& visualizer, const map<string, int>& taskData) {
+    int firstDay = INT_MAX, lastDay = INT_MIN;
+    map<int, int> byDay;
     for (const auto& pair : taskData) {
-        oss << pair.first << ":" << pair.second << "\n";
+        int day = StreakTracker::dayFromDate(pair.first);
+        if (day == INT_MIN) continue;
+        byDay[day] += pair.second;
+        firstDay = min(firstDay, day);
+        lastDay = max(lastDay, day);
     }
-    return oss.str();
+    
+    if (byDay.empty()) {
+        visualizer.loadSnapshot(StreakTracker::today(), nullptr, 0);
+        return;
+    }
+    
+    vector<uint16_t> counts(static_cast<size_t>(lastDay - firstDay + 1), 0);
+    for (const auto& [day, count] : byDay) {
+        counts[static_cast<size_t>(day - firstDay)] = static_cast<uint16_t>(min(max(count, 0), 0xFFFF));
+    }
+    visualizer.loadSnapshot(firstDay, counts.data(), counts.size());
 }
 
 map<string, int> HeatmapVisualizerDAO::deserializeTaskData(const string& data) {
@@ -119,17 +237,6 @@ string HeatmapVisualizerDAO::readFile(const string& filename) {
     return buffer.str();
 }
 
-bool HeatmapVisualizerDAO::writeFile(const string& filename, const string& content) {
-    ofstream file(filename);
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    file << content;
-    file.close();
-    return true;
-}
-
 bool HeatmapVisualizerDAO::saveMultipleVisualizers(const vector<HeatmapVisualizer>& visualizers, 
                                                   const vector<string>& identifiers) {
     if (visualizers.size() != identifiers.size()) {
@@ -148,6 +255,7 @@ bool HeatmapVisualizerDAO::saveMultipleVisualizers(const vector<HeatmapVisualize
 
 vector<HeatmapVisualizer> HeatmapVisualizerDAO::loadMultipleVisualizers(const vector<string>& identifiers) {
     vector<HeatmapVisualizer> visualizers;
+    visualizers.reserve(identifiers.size());
     
     for (const auto& identifier : identifiers) {
         HeatmapVisualizer visualizer;
@@ -166,9 +274,14 @@ vector<string> HeatmapVisualizerDAO::getAllSavedIdentifiers() {
         for (const auto& entry : filesystem::directory_iterator(dataFilePath)) {
             if (entry.is_regular_file()) {
                 string filename = entry.path().filename().string();
-                if (filename.find("heatmap_") == 0 && filename.find(".dat") != string::npos) {
-                    string identifier = filename.substr(8, filename.length() - 12);
-                    identifiers.push_back(identifier);
+                if (filename.find("heatmap_") != 0) continue;
+                
+                string extension = entry.path().extension().string();
+                if (extension == ".hmap" || extension == ".dat") {
+                    string identifier = filename.substr(8, filename.length() - 8 - extension.length());
+                    if (find(identifiers.begin(), identifiers.end(), identifier) == identifiers.end()) {
+                        identifiers.push_back(identifier);
+                    }
                 }
             }
         }
@@ -180,20 +293,21 @@ vector<string> HeatmapVisualizerDAO::getAllSavedIdentifiers() {
 }
 
 bool HeatmapVisualizerDAO::deleteHeatmapData(const string& identifier) {
-    string filename = dataFilePath + "heatmap_" + identifier + ".dat";
+    bool removed = false;
     try {
-        if (fileExists(filename)) {
-            return filesystem::remove(filename);
+        for (const string& filename : {snapshotPath(identifier), legacyPath(identifier)}) {
+            if (fileExists(filename)) {
+                removed = filesystem::remove(filename) || removed;
+            }
         }
     } catch (const filesystem::filesystem_error& e) {
         cerr << "Error deleting file: " << e.what() << endl;
     }
-    return false;
+    return removed;
 }
 
 bool HeatmapVisualizerDAO::heatmapDataExists(const string& identifier) {
-    string filename = dataFilePath + "heatmap_" + identifier + ".dat";
-    return fileExists(filename);
+    return fileExists(snapshotPath(identifier)) || fileExists(legacyPath(identifier));
 }
 
 bool HeatmapVisualizerDAO::exportToCSV(const HeatmapVisualizer& visualizer, const string& csvFilePath) {
@@ -204,10 +318,13 @@ bool HeatmapVisualizerDAO::exportToCSV(const HeatmapVisualizer& visualizer, cons
     
     csvFile << "Date,TasksCompleted" << endl;
     
-    // 获取任务数据并导出
-    const map<string, int>& taskData = HeatmapDataAccessor::getTaskData(visualizer);
-    for (const auto& pair : taskData) {
-        csvFile << pair.first << "," << pair.second << endl;
+    // 只导出有完成记录的日期
+    int baseDay = visualizer.getBaseDay();
+    const vector<uint16_t>& counts = visualizer.getDayGrid();
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] > 0) {
+            csvFile << StreakTracker::dateFromDay(baseDay + static_cast<int>(i)) << "," << counts[i] << "\n";
+        }
     }
     
     csvFile.close();
@@ -224,6 +341,7 @@ bool HeatmapVisualizerDAO::importFromCSV(HeatmapVisualizer& visualizer, const st
     // 跳过标题行
     getline(csvFile, line);
     
+    map<string, int> taskData;
     int importedCount = 0;
     while (getline(csvFile, line)) {
         size_t pos = line.find(',');
@@ -231,7 +349,7 @@ bool HeatmapVisualizerDAO::importFromCSV(HeatmapVisualizer& visualizer, const st
             string date = line.substr(0, pos);
             try {
                 int count = stoi(line.substr(pos + 1));
-                visualizer.addTaskData(date, count);
+                taskData[date] += count;
                 importedCount++;
             } catch (const exception& e) {
                 cerr << "Error parsing CSV line: " << line << " - " << e.what() << endl;
@@ -240,6 +358,9 @@ bool HeatmapVisualizerDAO::importFromCSV(HeatmapVisualizer& visualizer, const st
     }
     
     csvFile.close();
+    if (importedCount > 0) {
+        loadFromDateCounts(visualizer, taskData);
+    }
     cout << "Imported " << importedCount << " records from CSV." << endl;
     return importedCount > 0;
 }
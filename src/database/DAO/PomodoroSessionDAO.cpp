@@ -0,0 +1,72 @@
+#include "database/DAO/PomodoroSessionDAO.h"
+#include "database/DatabaseManager.h"
+#include <sqlite3.h>
+#include <iostream>
+
+class SQLitePomodoroSessionDAO : public PomodoroSessionDAO {
+private:
+    DatabaseManager& dbManager;
+
+    // 文本时间列与 datetime('now') 一致写 UTC；task_id 指向已删除的任务时写 NULL，避免外键失败拖垮整批
+    static constexpr const char* INSERT_SESSION_SQL =
+        "INSERT INTO pomodoro_sessions (task_id, start_time, end_time, duration, completed, interrupted, "
+        "interruption_reason, start_day, focus_seconds) "
+        "VALUES ((SELECT id FROM tasks WHERE id = ?1), datetime(?2, 'unixepoch'), datetime(?3, 'unixepoch'), "
+        "?4, ?5, ?6, ?7, ?8, ?9);";
+
+public:
+    SQLitePomodoroSessionDAO() : dbManager(DatabaseManager::getInstance()) {}
+
+    bool appendSessions(const std::vector<PomodoroSession>& sessions) override {
+        if (sessions.empty()) return true;
+
+        sqlite3* db = dbManager.getRawConnection();
+        if (!db) return false;
+
+        // 保存点：调用方已在事务中时嵌套进去，否则整批自成一个事务，只提交一次。
+        // 本方法在番茄钟记录线程上执行，整个保存点期间持有写事务锁，其他线程的写入不会混进这一批
+        auto writeLock = dbManager.lockWrites();
+        if (!dbManager.execute("SAVEPOINT pomodoro_append;")) {
+            return false;
+        }
+
+        sqlite3_stmt* stmt = nullptr;
+        bool ok = sqlite3_prepare_v2(db, INSERT_SESSION_SQL, -1, &stmt, nullptr) == SQLITE_OK;
+        for (size_t i = 0; ok && i < sessions.size(); ++i) {
+            const PomodoroSession& session = sessions[i];
+            if (session.taskId > 0) {
+                sqlite3_bind_int(stmt, 1, session.taskId);
+            } else {
+                sqlite3_bind_null(stmt, 1);
+            }
+            sqlite3_bind_int64(stmt, 2, session.startAt.seconds);
+            sqlite3_bind_int64(stmt, 3, session.endAt.seconds);
+            sqlite3_bind_int(stmt, 4, session.plannedMinutes);
+            sqlite3_bind_int(stmt, 5, session.completed ? 1 : 0);
+            sqlite3_bind_int(stmt, 6, session.interrupted ? 1 : 0);
+            if (session.interruptionReason.empty()) {
+                sqlite3_bind_null(stmt, 7);
+            } else {
+                sqlite3_bind_text(stmt, 7, session.interruptionReason.c_str(), -1, SQLITE_TRANSIENT);
+            }
+            sqlite3_bind_int(stmt, 8, session.startAt.utcDay().value);
+            sqlite3_bind_int(stmt, 9, session.focusSeconds);
+            ok = sqlite3_step(stmt) == SQLITE_DONE;
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+
+        if (!ok) {
+            std::cerr << "追加番茄钟记录失败: " << sqlite3_errmsg(db) << std::endl;
+            dbManager.execute("ROLLBACK TO pomodoro_append;");
+            dbManager.execute("RELEASE pomodoro_append;");
+            return false;
+        }
+        return dbManager.execute("RELEASE pomodoro_append;");
+    }
+};
+
+// 工厂函数
+std::unique_ptr<PomodoroSessionDAO> createPomodoroSessionDAO() {
+    return std::make_unique<SQLitePomodoroSessionDAO>();
+}
@@ -2,12 +2,10 @@
 #include "database/DatabaseManager.h"
 #include <sqlite3.h>
 #include <iostream>
-#include <sstream>
-#include <iomanip>
-#include <chrono>
+#include <algorithm>
 
 // 定义 SELECT 列常量（用于复用）
-#define SELECT_COLUMNS_STR "id, title, message, trigger_time, recurrence, triggered, task_id, enabled, last_triggered "
+#define SELECT_COLUMNS_STR "id, title, message, trigger_epoch, recurrence, triggered, task_id, enabled, last_triggered, anchor_epoch, recurrence_rule "
 
 class SQLiteReminderDAO : public ReminderDAO {
 private:
@@ -16,12 +14,12 @@ private:
 
     // SQL 语句常量（与 DatabaseManager::createReminderTable 保持一致）
     static constexpr const char* INSERT_REMINDER_SQL =
-        "INSERT INTO reminders (title, message, trigger_time, recurrence, triggered, task_id, enabled, last_triggered) "
-        "VALUES (?, ?, ?, ?, ?, ?, ?, ?);";
+        "INSERT INTO reminders (title, message, trigger_time, recurrence, triggered, task_id, enabled, last_triggered, "
+        "trigger_epoch, anchor_time, recurrence_rule, anchor_epoch) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
 
     static constexpr const char* UPDATE_REMINDER_SQL =
         "UPDATE reminders SET title=?, message=?, trigger_time=?, recurrence=?, triggered=?, task_id=?, enabled=?, "
-        "last_triggered=?, updated_date=datetime('now') WHERE id=?;";
+        "last_triggered=?, trigger_epoch=?, anchor_time=?, recurrence_rule=?, anchor_epoch=?, updated_date=datetime('now') WHERE id=?;";
 
     static constexpr const char* DELETE_REMINDER_SQL =
         "DELETE FROM reminders WHERE id=?;";
@@ -30,30 +28,32 @@ private:
         "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE id=?;";
 
     static constexpr const char* SELECT_ALL_SQL =
-        "SELECT " SELECT_COLUMNS_STR "FROM reminders ORDER BY trigger_time ASC;";
+        "SELECT " SELECT_COLUMNS_STR "FROM reminders ORDER BY trigger_epoch ASC;";
 
     static constexpr const char* SELECT_ACTIVE_SQL =
-        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE enabled = 1 AND triggered = 0 ORDER BY trigger_time ASC;";
+        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE enabled = 1 AND triggered = 0 ORDER BY trigger_epoch ASC;";
 
     static constexpr const char* SELECT_BY_TASK_SQL =
-        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE task_id=? AND enabled = 1 ORDER BY trigger_time ASC;";
+        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE task_id=? AND enabled = 1 ORDER BY trigger_epoch ASC;";
 
     static constexpr const char* SELECT_BY_RECURRENCE_SQL =
-        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE recurrence=? AND enabled = 1 ORDER BY trigger_time ASC;";
+        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE recurrence=? AND enabled = 1 ORDER BY trigger_epoch ASC;";
 
     static constexpr const char* SELECT_DUE_SQL =
-        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE trigger_time <= ? AND enabled = 1 AND triggered = 0 ORDER BY trigger_time ASC;";
+        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE trigger_epoch <= ? AND enabled = 1 AND triggered = 0 "
+        "ORDER BY trigger_epoch ASC;";
 
-    static constexpr const char* SELECT_DUE_TODAY_SQL =
-        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE date(trigger_time) = date('now') AND enabled = 1 AND triggered = 0 "
-        "ORDER BY trigger_time ASC;";
+    static constexpr const char* SELECT_PENDING_SCHEDULE_SQL =
+        "SELECT id, trigger_epoch FROM reminders WHERE enabled = 1 AND triggered = 0 "
+        "AND trigger_epoch >= ? AND trigger_epoch < ? ORDER BY trigger_epoch ASC;";
 
-    static constexpr const char* SELECT_DUE_WEEK_SQL =
-        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE date(trigger_time) BETWEEN date('now') AND date('now', '+6 days') "
-        "AND enabled = 1 AND triggered = 0 ORDER BY trigger_time ASC;";
+    // 今天/本周按本地零点换算成 epoch 区间，走 idx_reminders_pending_epoch
+    static constexpr const char* SELECT_PENDING_RANGE_SQL =
+        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE trigger_epoch >= ? AND trigger_epoch < ? "
+        "AND enabled = 1 AND triggered = 0 ORDER BY trigger_epoch ASC;";
 
     static constexpr const char* SELECT_BY_DATE_RANGE_SQL =
-        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE trigger_time BETWEEN ? AND ? AND enabled = 1 ORDER BY trigger_time ASC;";
+        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE trigger_epoch BETWEEN ? AND ? AND enabled = 1 ORDER BY trigger_epoch ASC;";
 
     static constexpr const char* MARK_TRIGGERED_SQL =
         "UPDATE reminders SET triggered = 1, last_triggered = datetime('now'), updated_date = datetime('now') WHERE id=?;";
@@ -61,11 +61,29 @@ private:
     static constexpr const char* MARK_COMPLETED_SQL =
         "UPDATE reminders SET triggered = 1, enabled = 0, last_triggered = datetime('now'), updated_date = datetime('now') WHERE id=?;";
 
+    // 改期同时移动重复规则的起点
     static constexpr const char* RESCHEDULE_SQL =
-        "UPDATE reminders SET trigger_time=?, triggered = 0, enabled = 1, updated_date = datetime('now') WHERE id=?;";
+        "UPDATE reminders SET trigger_time=?1, trigger_epoch=?2, anchor_time=?1, anchor_epoch=?2, triggered = 0, enabled = 1, "
+        "updated_date = datetime('now') WHERE id=?3;";
+
+    static constexpr const char* ADVANCE_RECURRING_SQL =
+        "UPDATE reminders SET trigger_time=?, trigger_epoch=?, triggered = 0, last_triggered = datetime('now'), "
+        "updated_date = datetime('now') WHERE id=? AND recurrence != 'once';";
+
+    // 批量标记的前缀，后接 "?, ?, ...);"
+    static constexpr const char* MARK_TRIGGERED_BATCH_PREFIX =
+        "UPDATE reminders SET triggered = 1, last_triggered = datetime('now'), updated_date = datetime('now') "
+        "WHERE triggered = 0 AND id IN (";
+
+    // 单条 IN 列表的最大 ID 数，低于 SQLite 默认的绑定变量上限
+    static constexpr size_t MAX_BATCH_IDS = 500;
+
+    static constexpr const char* SELECT_AGENDA_SQL =
+        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE enabled = 1 AND triggered = 0 AND trigger_epoch < ? "
+        "AND (recurrence != 'once' OR trigger_epoch >= ?) ORDER BY trigger_epoch ASC;";
 
     static constexpr const char* SELECT_RECURRING_SQL =
-        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE recurrence != 'once' AND enabled = 1 ORDER BY trigger_time ASC;";
+        "SELECT " SELECT_COLUMNS_STR "FROM reminders WHERE recurrence != 'once' AND enabled = 1 ORDER BY trigger_epoch ASC;";
 
     static constexpr const char* DELETE_EXPIRED_SQL =
         "DELETE FROM reminders WHERE triggered = 1 AND last_triggered < datetime('now', '-30 days');";
@@ -83,7 +101,8 @@ private:
         "SELECT COUNT(*) FROM reminders WHERE enabled = 0;";
 
     static constexpr const char* COUNT_OVERDUE_SQL =
-        "SELECT COUNT(*) FROM reminders WHERE trigger_time < datetime('now') AND enabled = 1 AND triggered = 0;";
+        "SELECT COUNT(*) FROM reminders WHERE trigger_epoch < CAST(strftime('%s', 'now') AS INTEGER) "
+        "AND enabled = 1 AND triggered = 0;";
 
     sqlite3* getDb() {
         if (!dbManager.isOpen()) {
@@ -96,19 +115,9 @@ private:
         return dbManager.createTables();
     }
 
-    static std::string timePointToString(const std::chrono::system_clock::time_point& tp) {
-        auto time_t = std::chrono::system_clock::to_time_t(tp);
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-        return ss.str();
-    }
-
-    static std::chrono::system_clock::time_point stringToTimePoint(const std::string& timeStr) {
-        std::tm tm = {};
-        std::stringstream ss(timeStr);
-        ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-        auto time_t = std::mktime(&tm);
-        return std::chrono::system_clock::from_time_t(time_t);
+    // 文本列只为旧版本与人工查看保留，读取时只用 epoch 列
+    static std::string toText(Timestamp ts) {
+        return ts.toLocalString();
     }
 
     static ReminderType toReminderType(const std::string& recurrence) {
@@ -124,19 +133,17 @@ private:
         reminder.title = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
         reminder.message = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
 
-        const std::string triggerTimeStr = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        reminder.trigger_time = triggerTimeStr;
-        reminder.triggerTime = stringToTimePoint(triggerTimeStr);
+        reminder.triggerAt = Timestamp(sqlite3_column_int64(stmt, 3));
 
         reminder.recurrence = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        reminder.recurrenceRule = reminder.recurrence;
+        const unsigned char* rule = sqlite3_column_text(stmt, 10);
+        reminder.recurrenceRule = rule ? reinterpret_cast<const char*>(rule) : reminder.recurrence;
         reminder.type = toReminderType(reminder.recurrence);
 
         reminder.triggered = sqlite3_column_int(stmt, 5) != 0;
         reminder.status = reminder.triggered ? ReminderStatus::TRIGGERED : ReminderStatus::PENDING;
 
         reminder.task_id = sqlite3_column_int(stmt, 6);
-        reminder.taskId = reminder.task_id;
 
         reminder.enabled = sqlite3_column_int(stmt, 7) != 0;
 
@@ -145,6 +152,9 @@ private:
             reminder.last_triggered = reinterpret_cast<const char*>(lastTriggered);
         }
 
+        reminder.anchorAt = sqlite3_column_type(stmt, 9) == SQLITE_NULL
+            ? reminder.triggerAt : Timestamp(sqlite3_column_int64(stmt, 9));
+
         return reminder;
     }
 
@@ -178,16 +188,20 @@ private:
         return count;
     }
 
-    std::chrono::system_clock::time_point calculateNextTrigger(const Reminder& reminder) {
-        auto nextTime = reminder.triggerTime;
-        if (reminder.recurrence == "daily") {
-            nextTime += std::chrono::hours(24);
-        } else if (reminder.recurrence == "weekly") {
-            nextTime += std::chrono::hours(24 * 7);
-        } else if (reminder.recurrence == "monthly") {
-            nextTime += std::chrono::hours(24 * 30);
+    std::vector<Reminder> getPendingInRange(Timestamp start, Timestamp end) {
+        sqlite3* db = getDb();
+        if (!db) return {};
+
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, SELECT_PENDING_RANGE_SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+            return {};
         }
-        return nextTime;
+
+        sqlite3_bind_int64(stmt, 1, start.seconds);
+        sqlite3_bind_int64(stmt, 2, end.seconds);
+        auto reminders = extractRemindersFromStatement(stmt);
+        sqlite3_finalize(stmt);
+        return reminders;
     }
 
 public:
@@ -213,21 +227,27 @@ public:
             return false;
         }
 
-        const std::string triggerTimeStr = timePointToString(reminder.triggerTime);
+        const std::string triggerTimeStr = toText(reminder.triggerAt);
+        const std::string anchorTimeStr = toText(reminder.anchorAt);
 
         sqlite3_bind_text(stmt, 1, reminder.title.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 2, reminder.message.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 3, triggerTimeStr.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 4, reminder.recurrence.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_int(stmt, 5, reminder.triggered ? 1 : 0);
-        // Handle task_id: bind NULL if taskId is 0 (no task linked)
-        if (reminder.taskId > 0) {
-            sqlite3_bind_int(stmt, 6, reminder.taskId);
+        // Handle task_id: bind NULL if task_id is 0 (no task linked)
+        if (reminder.task_id > 0) {
+            sqlite3_bind_int(stmt, 6, reminder.task_id);
         } else {
             sqlite3_bind_null(stmt, 6);
         }
         sqlite3_bind_int(stmt, 7, reminder.enabled ? 1 : 0);
         sqlite3_bind_text(stmt, 8, reminder.last_triggered.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 9, reminder.triggerAt.seconds);
+        sqlite3_bind_text(stmt, 10, anchorTimeStr.c_str(), -1, SQLITE_TRANSIENT);
+        const std::string& rule = reminder.recurrenceRule.empty() ? reminder.recurrence : reminder.recurrenceRule;
+        sqlite3_bind_text(stmt, 11, rule.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 12, reminder.anchorAt.seconds);
 
         int stepResult = sqlite3_step(stmt);
         const bool success = (stepResult == SQLITE_DONE);
@@ -252,22 +272,28 @@ public:
             return false;
         }
 
-        const std::string triggerTimeStr = timePointToString(reminder.triggerTime);
+        const std::string triggerTimeStr = toText(reminder.triggerAt);
+        const std::string anchorTimeStr = toText(reminder.anchorAt);
 
         sqlite3_bind_text(stmt, 1, reminder.title.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 2, reminder.message.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 3, triggerTimeStr.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 4, reminder.recurrence.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_int(stmt, 5, reminder.triggered ? 1 : 0);
-        // Handle task_id: bind NULL if taskId is 0 (no task linked)
-        if (reminder.taskId > 0) {
-            sqlite3_bind_int(stmt, 6, reminder.taskId);
+        // Handle task_id: bind NULL if task_id is 0 (no task linked)
+        if (reminder.task_id > 0) {
+            sqlite3_bind_int(stmt, 6, reminder.task_id);
         } else {
             sqlite3_bind_null(stmt, 6);
         }
         sqlite3_bind_int(stmt, 7, reminder.enabled ? 1 : 0);
         sqlite3_bind_text(stmt, 8, reminder.last_triggered.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_int(stmt, 9, reminder.id);
+        sqlite3_bind_int64(stmt, 9, reminder.triggerAt.seconds);
+        sqlite3_bind_text(stmt, 10, anchorTimeStr.c_str(), -1, SQLITE_TRANSIENT);
+        const std::string& rule = reminder.recurrenceRule.empty() ? reminder.recurrence : reminder.recurrenceRule;
+        sqlite3_bind_text(stmt, 11, rule.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 12, reminder.anchorAt.seconds);
+        sqlite3_bind_int(stmt, 13, reminder.id);
 
         const bool success = (sqlite3_step(stmt) == SQLITE_DONE);
         sqlite3_finalize(stmt);
@@ -383,7 +409,7 @@ public:
         return reminders;
     }
 
-    std::vector<Reminder> getDueReminders(const std::chrono::system_clock::time_point& currentTime) override {
+    std::vector<Reminder> getDueReminders(Timestamp currentTime) override {
         sqlite3* db = getDb();
         if (!db) return {};
 
@@ -392,46 +418,47 @@ public:
             return {};
         }
 
-        const std::string currentTimeStr = timePointToString(currentTime);
-        sqlite3_bind_text(stmt, 1, currentTimeStr.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 1, currentTime.seconds);
 
         auto reminders = extractRemindersFromStatement(stmt);
         sqlite3_finalize(stmt);
         return reminders;
     }
 
-    // 时间相关查询
-    std::vector<Reminder> getRemindersDueToday() override {
+    std::vector<ReminderScheduleEntry> getPendingSchedule(std::int64_t fromEpoch, std::int64_t untilEpoch) override {
         sqlite3* db = getDb();
         if (!db) return {};
 
-        sqlite3_stmt* stmt = nullptr;
-        if (sqlite3_prepare_v2(db, SELECT_DUE_TODAY_SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        // 只读取两列整数，窗口内提醒再多也不会为标题、内容等字符串分配内存
+        sqlite3_stmt* stmt = dbManager.getPreparedStatement(SELECT_PENDING_SCHEDULE_SQL);
+        if (!stmt) {
+            std::cerr << "准备提醒调度查询失败: " << sqlite3_errmsg(db) << std::endl;
             return {};
         }
 
-        auto reminders = extractRemindersFromStatement(stmt);
-        sqlite3_finalize(stmt);
-        return reminders;
-    }
-
-    std::vector<Reminder> getRemindersDueThisWeek() override {
-        sqlite3* db = getDb();
-        if (!db) return {};
+        sqlite3_bind_int64(stmt, 1, fromEpoch);
+        sqlite3_bind_int64(stmt, 2, untilEpoch);
 
-        sqlite3_stmt* stmt = nullptr;
-        if (sqlite3_prepare_v2(db, SELECT_DUE_WEEK_SQL, -1, &stmt, nullptr) != SQLITE_OK) {
-            return {};
+        std::vector<ReminderScheduleEntry> entries;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            entries.push_back({sqlite3_column_int(stmt, 0), sqlite3_column_int64(stmt, 1)});
         }
+        sqlite3_reset(stmt);
+        return entries;
+    }
 
-        auto reminders = extractRemindersFromStatement(stmt);
-        sqlite3_finalize(stmt);
-        return reminders;
+    // 时间相关查询
+    std::vector<Reminder> getRemindersDueToday() override {
+        const DayNumber today = Timestamp::now().localDay();
+        return getPendingInRange(Timestamp::startOfLocalDay(today), Timestamp::startOfLocalDay(today + 1));
     }
 
-    std::vector<Reminder> getRemindersByDateRange(
-        const std::chrono::system_clock::time_point& start,
-        const std::chrono::system_clock::time_point& end) override {
+    std::vector<Reminder> getRemindersDueThisWeek() override {
+        const DayNumber today = Timestamp::now().localDay();
+        return getPendingInRange(Timestamp::startOfLocalDay(today), Timestamp::startOfLocalDay(today + 7));
+    }
+
+    std::vector<Reminder> getRemindersByDateRange(Timestamp start, Timestamp end) override {
         sqlite3* db = getDb();
         if (!db) return {};
 
@@ -440,11 +467,8 @@ public:
             return {};
         }
 
-        const std::string startStr = timePointToString(start);
-        const std::string endStr = timePointToString(end);
-
-        sqlite3_bind_text(stmt, 1, startStr.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 2, endStr.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 1, start.seconds);
+        sqlite3_bind_int64(stmt, 2, end.seconds);
 
         auto reminders = extractRemindersFromStatement(stmt);
         sqlite3_finalize(stmt);
@@ -482,7 +506,7 @@ public:
         return success;
     }
 
-    bool rescheduleReminder(int reminderId, const std::chrono::system_clock::time_point& newTime) override {
+    bool rescheduleReminder(int reminderId, Timestamp newTime) override {
         sqlite3* db = getDb();
         if (!db) return false;
 
@@ -491,32 +515,109 @@ public:
             return false;
         }
 
-        const std::string newTimeStr = timePointToString(newTime);
+        const std::string newTimeStr = toText(newTime);
         sqlite3_bind_text(stmt, 1, newTimeStr.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_int(stmt, 2, reminderId);
+        sqlite3_bind_int64(stmt, 2, newTime.seconds);
+        sqlite3_bind_int(stmt, 3, reminderId);
 
         const bool success = (sqlite3_step(stmt) == SQLITE_DONE);
         sqlite3_finalize(stmt);
         return success;
     }
 
+    std::vector<Reminder> getAgendaCandidates(std::int64_t fromEpoch, std::int64_t untilEpoch) override {
+        sqlite3* db = getDb();
+        if (!db) return {};
+
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, SELECT_AGENDA_SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "准备日程查询失败: " << sqlite3_errmsg(db) << std::endl;
+            return {};
+        }
+
+        sqlite3_bind_int64(stmt, 1, untilEpoch);
+        sqlite3_bind_int64(stmt, 2, fromEpoch);
+
+        auto reminders = extractRemindersFromStatement(stmt);
+        sqlite3_finalize(stmt);
+        return reminders;
+    }
+
     // 重复提醒
-    bool createNextRecurringReminder(int originalReminderId) override {
-        auto original = getReminderById(originalReminderId);
-        if (!original || original->recurrence == "once") {
+    bool advanceRecurringReminder(int reminderId, Timestamp nextTime) override {
+        sqlite3* db = getDb();
+        if (!db) return false;
+
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, ADVANCE_RECURRING_SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+            return false;
+        }
+
+        const std::string nextTimeStr = toText(nextTime);
+        sqlite3_bind_text(stmt, 1, nextTimeStr.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 2, nextTime.seconds);
+        sqlite3_bind_int(stmt, 3, reminderId);
+
+        const bool success = sqlite3_step(stmt) == SQLITE_DONE && sqlite3_changes(db) > 0;
+        sqlite3_finalize(stmt);
+        return success;
+    }
+
+    bool completeDueReminders(const std::vector<int>& triggeredIds,
+        const std::vector<std::pair<int, Timestamp>>& advances) override {
+        if (triggeredIds.empty() && advances.empty()) return true;
+
+        sqlite3* db = getDb();
+        if (!db) return false;
+
+        // 使用保存点而非 BEGIN：调用方已在事务中时会嵌套进去，否则自成一个事务，整批只提交一次
+        auto writeLock = dbManager.lockWrites();
+        if (!dbManager.execute("SAVEPOINT reminder_fire;")) {
             return false;
         }
 
-        Reminder newReminder = *original;
-        newReminder.id = 0;
-        newReminder.triggered = false;
-        newReminder.status = ReminderStatus::PENDING;
-        newReminder.triggerTime = calculateNextTrigger(*original);
-        newReminder.trigger_time = timePointToString(newReminder.triggerTime);
-        newReminder.last_triggered.clear();
-        newReminder.enabled = true;
+        bool ok = true;
+        for (size_t start = 0; ok && start < triggeredIds.size(); start += MAX_BATCH_IDS) {
+            const size_t count = std::min(MAX_BATCH_IDS, triggeredIds.size() - start);
+            std::string sql = MARK_TRIGGERED_BATCH_PREFIX;
+            for (size_t i = 0; i < count; ++i) {
+                sql += i == 0 ? "?" : ", ?";
+            }
+            sql += ");";
+
+            sqlite3_stmt* stmt = nullptr;
+            if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                ok = false;
+                break;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                sqlite3_bind_int(stmt, static_cast<int>(i + 1), triggeredIds[start + i]);
+            }
+            ok = sqlite3_step(stmt) == SQLITE_DONE;
+            sqlite3_finalize(stmt);
+        }
+
+        if (ok && !advances.empty()) {
+            sqlite3_stmt* stmt = nullptr;
+            ok = sqlite3_prepare_v2(db, ADVANCE_RECURRING_SQL, -1, &stmt, nullptr) == SQLITE_OK;
+            for (size_t i = 0; ok && i < advances.size(); ++i) {
+                const std::string nextTimeStr = toText(advances[i].second);
+                sqlite3_bind_text(stmt, 1, nextTimeStr.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_int64(stmt, 2, advances[i].second.seconds);
+                sqlite3_bind_int(stmt, 3, advances[i].first);
+                ok = sqlite3_step(stmt) == SQLITE_DONE;
+                sqlite3_reset(stmt);
+            }
+            sqlite3_finalize(stmt);
+        }
 
-        return insertReminder(newReminder);
+        if (!ok) {
+            std::cerr << "批量更新到期提醒失败: " << sqlite3_errmsg(db) << std::endl;
+            dbManager.execute("ROLLBACK TO reminder_fire;");
+            dbManager.execute("RELEASE reminder_fire;");
+            return false;
+        }
+        return dbManager.execute("RELEASE reminder_fire;");
     }
 
     std::vector<Reminder> getRecurringReminders() override {
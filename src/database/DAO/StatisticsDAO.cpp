@@ -1 +1,473 @@
+#include "database/DAO/StatisticsDAO.h"
+#include "database/DatabaseManager.h"
+#include "statistics/StreakTracker.h"
+#include <sqlite3.h>
+#include <iostream>
+#include <climits>
+#include <ctime>
 
+// 番茄钟专注统计列：会话数、完成数、中断数、专注秒数
+#define POMODORO_FOCUS_COLUMNS "COUNT(*), COALESCE(SUM(completed = 1), 0), COALESCE(SUM(interrupted = 1), 0), " \
+    "COALESCE(SUM(focus_seconds), 0) "
+
+// === 辅助结构体构造函数 ===
+
+CompletionTrend::CompletionTrend() : trendSlope(0.0), isImproving(false) {}
+
+ProductivityTrend::ProductivityTrend() : averageProductivity(0.0), isImproving(false) {}
+
+ChallengeCompletionStats::ChallengeCompletionStats()
+    : dailyChallengesCompleted(0), weeklyChallengesCompleted(0), totalChallengesCompleted(0),
+      dailyChallengeCompletionRate(0.0), weeklyChallengeCompletionRate(0.0) {}
+
+AchievementUnlockStats::AchievementUnlockStats() : totalUnlocked(0), totalLocked(0), unlockRate(0.0) {}
+
+/**
+ * SQLite 统计 DAO
+ *
+ * - 所有查询都在只读连接池上执行，预编译语句按连接缓存，不拼接字符串 SQL
+ * - 日期条件写成 completed_day >= ? AND completed_day < ? 的区间形式，
+ *   可以直接走 idx_tasks_completed_day / idx_tasks_created_date / idx_pomodoro_start_day，
+ *   避免 DATE(column) 导致的全表扫描；完成日期按整数天数分组，结果无需再解析字符串
+ * - 日期使用 UTC 天数，与 datetime('now') 写入的时间戳一致
+ * - 完成数只统计未删除的任务（deleted = 0）：删除已完成任务时发布 TaskReopened，重新统计须与之一致
+ */
+class SqliteStatisticsDAO : public StatisticsDAO {
+private:
+    DatabaseManager& dbManager;
+
+    static constexpr const char* COMPLETED_BY_DAY_SQL =
+        "SELECT completed_day, COUNT(*) FROM tasks "
+        "WHERE completed = 1 AND deleted = 0 AND completed_day >= ? AND completed_day < ? GROUP BY completed_day;";
+
+    static constexpr const char* CREATED_BY_DAY_SQL =
+        "SELECT substr(created_date, 1, 10) AS day, COUNT(*) FROM tasks "
+        "WHERE created_date >= ? AND created_date < ? GROUP BY day;";
+
+    static constexpr const char* POMODOROS_BY_DAY_SQL =
+        "SELECT start_day, COUNT(*) FROM pomodoro_sessions "
+        "WHERE start_day >= ? AND start_day < ? AND completed = 1 GROUP BY start_day;";
+
+    static constexpr const char* COUNT_COMPLETED_RANGE_SQL =
+        "SELECT COUNT(*) FROM tasks WHERE completed = 1 AND deleted = 0 AND completed_day >= ? AND completed_day < ?;";
+
+    static constexpr const char* COUNT_CREATED_RANGE_SQL =
+        "SELECT COUNT(*) FROM tasks WHERE created_date >= ? AND created_date < ?;";
+
+    static constexpr const char* COUNT_POMODOROS_RANGE_SQL =
+        "SELECT COUNT(*) FROM pomodoro_sessions WHERE start_day >= ? AND start_day < ? AND completed = 1;";
+
+    static constexpr const char* POMODORO_FOCUS_BY_DAY_SQL =
+        "SELECT start_day, " POMODORO_FOCUS_COLUMNS "FROM pomodoro_sessions "
+        "WHERE start_day >= ? AND start_day < ? GROUP BY start_day;";
+
+    static constexpr const char* POMODORO_FOCUS_BY_TASK_SQL =
+        "SELECT task_id, " POMODORO_FOCUS_COLUMNS "FROM pomodoro_sessions "
+        "WHERE start_day >= ? AND start_day < ? AND task_id IS NOT NULL "
+        "GROUP BY task_id ORDER BY SUM(focus_seconds) DESC;";
+
+    static constexpr const char* POMODORO_FOCUS_FOR_TASK_SQL =
+        "SELECT task_id, " POMODORO_FOCUS_COLUMNS "FROM pomodoro_sessions WHERE task_id = ?;";
+
+    static constexpr const char* CHALLENGE_STATS_SQL =
+        "SELECT COALESCE(SUM(type = 'daily' AND completed = 1), 0), COALESCE(SUM(type = 'daily'), 0), "
+        "COALESCE(SUM(type = 'weekly' AND completed = 1), 0), COALESCE(SUM(type = 'weekly'), 0), "
+        "COALESCE(SUM(completed = 1), 0) FROM challenges;";
+
+    static constexpr const char* ACHIEVEMENT_STATS_SQL =
+        "SELECT COALESCE(a.category, 'special'), COUNT(ua.unlocked_at), COUNT(*) "
+        "FROM achievements a "
+        "LEFT JOIN user_achievements ua ON ua.user_id = 1 AND ua.achievement_key = a.unlock_condition "
+        "GROUP BY 1;";
+
+    static constexpr const char* OVERALL_STATS_SQL =
+        "SELECT (SELECT COUNT(*) FROM tasks), "
+        "(SELECT COUNT(*) FROM tasks WHERE completed = 1 AND deleted = 0), "
+        "(SELECT COALESCE(SUM(pomodoro_count), 0) FROM tasks), "
+        "(SELECT COUNT(*) FROM pomodoro_sessions WHERE completed = 1), "
+        "(SELECT COUNT(*) FROM projects WHERE archived = 0), "
+        "(SELECT COUNT(*) FROM projects WHERE progress >= 1.0 AND archived = 0), "
+        "(SELECT COUNT(*) FROM challenges WHERE completed = 1), "
+        "(SELECT COUNT(*) FROM user_achievements WHERE user_id = 1 AND unlocked_at IS NOT NULL);";
+
+    // 在只读连接上执行缓存的预编译语句
+    template <typename Binder, typename RowHandler>
+    bool runQuery(const char* sql, Binder bind, RowHandler onRow) {
+        ReadConnectionLease conn = dbManager.acquireReadConnection();
+        if (!conn) return false;
+
+        sqlite3_stmt* stmt = conn.prepare(sql);
+        if (!stmt) return false;
+
+        bind(stmt);
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            onRow(stmt);
+        }
+        bool ok = (rc == SQLITE_DONE);
+        if (!ok) {
+            std::cerr << "统计查询失败: " << sqlite3_errmsg(conn.get()) << std::endl;
+        }
+        sqlite3_reset(stmt);
+        return ok;
+    }
+
+    // 查询的日期列是整数天数（completed_day / start_day）还是文本时间戳（created_date）
+    enum class DayColumn { Number, Text };
+
+    static auto bindDayRange(DayColumn column, int startDay, int endDay) {
+        return [column, startDay, endDay](sqlite3_stmt* stmt) {
+            if (column == DayColumn::Number) {
+                sqlite3_bind_int(stmt, 1, startDay);
+                sqlite3_bind_int(stmt, 2, endDay);
+            } else {
+                sqlite3_bind_text(stmt, 1, DayNumber(startDay).toString().c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(stmt, 2, DayNumber(endDay).toString().c_str(), -1, SQLITE_TRANSIENT);
+            }
+        };
+    }
+
+    static void noBind(sqlite3_stmt*) {}
+
+    static int toDay(const std::chrono::system_clock::time_point& tp) {
+        return Timestamp::fromTimePoint(tp).utcDay().value;
+    }
+
+    static std::chrono::system_clock::time_point fromDay(int day) {
+        return Timestamp(static_cast<std::int64_t>(day) * DayNumber::SECONDS_PER_DAY).toTimePoint();
+    }
+
+    // [startDay, startDay + numDays) 内每天的计数（稠密数组，缺失的天为 0）
+    std::vector<int> countByDay(const char* sql, DayColumn column, int startDay, int numDays) {
+        std::vector<int> counts(numDays > 0 ? numDays : 0, 0);
+        if (numDays <= 0) return counts;
+
+        runQuery(sql, bindDayRange(column, startDay, startDay + numDays), [&](sqlite3_stmt* stmt) {
+            if (sqlite3_column_type(stmt, 0) == SQLITE_NULL) return;
+            DayNumber day;
+            if (column == DayColumn::Number) {
+                day = DayNumber(sqlite3_column_int(stmt, 0));
+            } else if (!DayNumber::parse(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)), day)) {
+                return;
+            }
+            int index = day.value - startDay;
+            if (index >= 0 && index < numDays) {
+                counts[index] = sqlite3_column_int(stmt, 1);
+            }
+        });
+        return counts;
+    }
+
+    int countInRange(const char* sql, DayColumn column, int startDay, int endDay) {
+        int count = 0;
+        runQuery(sql, bindDayRange(column, startDay, endDay), [&](sqlite3_stmt* stmt) {
+            count = sqlite3_column_int(stmt, 0);
+        });
+        return count;
+    }
+
+    // 读取 POMODORO_FOCUS_COLUMNS（从第 1 列开始）
+    static void readFocus(sqlite3_stmt* stmt, PomodoroFocusStats& stats) {
+        stats.sessions = sqlite3_column_int(stmt, 1);
+        stats.completed = sqlite3_column_int(stmt, 2);
+        stats.interrupted = sqlite3_column_int(stmt, 3);
+        stats.focusMinutes = static_cast<int>(sqlite3_column_int64(stmt, 4) / 60);
+        stats.interruptionRate = stats.sessions > 0 ? (double)stats.interrupted / stats.sessions : 0.0;
+    }
+
+    std::vector<DailyCompletionStats> dailyStats(int startDay, int numDays) {
+        std::vector<int> completed = countByDay(COMPLETED_BY_DAY_SQL, DayColumn::Number, startDay, numDays);
+        std::vector<int> created = countByDay(CREATED_BY_DAY_SQL, DayColumn::Text, startDay, numDays);
+        std::vector<int> pomodoros = countByDay(POMODOROS_BY_DAY_SQL, DayColumn::Number, startDay, numDays);
+
+        std::vector<DailyCompletionStats> stats(completed.size());
+        for (size_t i = 0; i < stats.size(); ++i) {
+            stats[i].date = StreakTracker::dateFromDay(startDay + static_cast<int>(i));
+            stats[i].tasksCompleted = completed[i];
+            stats[i].tasksCreated = created[i];
+            stats[i].completionRate = created[i] > 0 ? (double)completed[i] / created[i] : 0.0;
+            stats[i].pomodorosCompleted = pomodoros[i];
+        }
+        return stats;
+    }
+
+    // 最小二乘斜率，x 为天序号
+    template <typename T>
+    static double slopeOf(const std::vector<T>& values) {
+        const size_t n = values.size();
+        if (n < 2) return 0.0;
+
+        double sumX = 0, sumY = 0, sumXY = 0, sumXX = 0;
+        for (size_t i = 0; i < n; ++i) {
+            double x = static_cast<double>(i);
+            double y = static_cast<double>(values[i]);
+            sumX += x;
+            sumY += y;
+            sumXY += x * y;
+            sumXX += x * x;
+        }
+        double denom = n * sumXX - sumX * sumX;
+        return denom == 0 ? 0.0 : (n * sumXY - sumX * sumY) / denom;
+    }
+
+public:
+    SqliteStatisticsDAO() : dbManager(DatabaseManager::getInstance()) {}
+    ~SqliteStatisticsDAO() override = default;
+
+    // === 任务完成统计 ===
+
+    DailyCompletionStats getDailyCompletionStats(
+        const std::chrono::system_clock::time_point& date) override {
+        return dailyStats(toDay(date), 1).front();
+    }
+
+    std::vector<DailyCompletionStats> getWeeklyCompletionStats(
+        const std::chrono::system_clock::time_point& startDate) override {
+        return dailyStats(toDay(startDate), 7);
+    }
+
+    std::vector<DailyCompletionStats> getMonthlyCompletionStats(int year, int month) override {
+        if (month < 1 || month > 12) return {};
+
+        const DayNumber first = DayNumber::fromCivil(year, static_cast<unsigned>(month), 1);
+        return dailyStats(first.value, civil::daysInMonth(year, static_cast<unsigned>(month)));
+    }
+
+    // === 热力图数据 ===
+
+    std::vector<HeatmapData> getHeatmapData(int days) override {
+        std::vector<HeatmapData> data;
+        if (days <= 0) return data;
+
+        int startDay = StreakTracker::today() - days + 1;
+        std::vector<int> counts = countByDay(COMPLETED_BY_DAY_SQL, DayColumn::Number, startDay, days);
+
+        data.resize(counts.size());
+        for (size_t i = 0; i < counts.size(); ++i) {
+            data[i].date = StreakTracker::dateFromDay(startDay + static_cast<int>(i));
+            data[i].taskCount = counts[i];
+        }
+        return data;
+    }
+
+    std::map<std::chrono::system_clock::time_point, int> getCompletionCountByDate(
+        const std::chrono::system_clock::time_point& startDate,
+        const std::chrono::system_clock::time_point& endDate) override {
+        std::map<std::chrono::system_clock::time_point, int> result;
+
+        int startDay = toDay(startDate);
+        std::vector<int> counts = countByDay(COMPLETED_BY_DAY_SQL, DayColumn::Number, startDay, toDay(endDate) - startDay + 1);
+        for (size_t i = 0; i < counts.size(); ++i) {
+            if (counts[i] > 0) {
+                result[fromDay(startDay + static_cast<int>(i))] = counts[i];
+            }
+        }
+        return result;
+    }
+
+    int getCompletedCount(
+        const std::chrono::system_clock::time_point& startDate,
+        const std::chrono::system_clock::time_point& endDate) override {
+        int startDay = toDay(startDate);
+        int endDay = toDay(endDate) + 1;
+        return endDay > startDay ? countInRange(COUNT_COMPLETED_RANGE_SQL, DayColumn::Number, startDay, endDay) : 0;
+    }
+
+    // === 生产力分析 ===
+
+    ProductivityReport generateProductivityReport(
+        const std::chrono::system_clock::time_point& startDate,
+        const std::chrono::system_clock::time_point& endDate) override {
+        ProductivityReport report;
+
+        int startDay = toDay(startDate);
+        int endDay = toDay(endDate) + 1;   // 包含结束当天
+        if (endDay <= startDay) return report;
+
+        report.startDate = StreakTracker::dateFromDay(startDay);
+        report.endDate = StreakTracker::dateFromDay(endDay - 1);
+        report.totalTasks = countInRange(COUNT_CREATED_RANGE_SQL, DayColumn::Text, startDay, endDay);
+        report.completedTasks = countInRange(COUNT_COMPLETED_RANGE_SQL, DayColumn::Number, startDay, endDay);
+        report.completionRate = report.totalTasks > 0
+            ? (double)report.completedTasks / report.totalTasks : 0.0;
+        report.averageTasksPerDay = (double)report.completedTasks / (endDay - startDay);
+        return report;
+    }
+
+    // === Pomodoro统计 ===
+
+    PomodoroStatistics getPomodoroStatistics(
+        const std::chrono::system_clock::time_point& startDate,
+        const std::chrono::system_clock::time_point& endDate) override {
+        PomodoroStatistics stats;
+
+        int startDay = toDay(startDate);
+        int endDay = toDay(endDate) + 1;
+        int today = StreakTracker::today();
+        int weekStart = today - DayNumber(today).weekday();
+
+        stats.totalPomodoros = endDay > startDay ? countInRange(COUNT_POMODOROS_RANGE_SQL, DayColumn::Number, startDay, endDay) : 0;
+        stats.pomodorosToday = countInRange(COUNT_POMODOROS_RANGE_SQL, DayColumn::Number, today, today + 1);
+        stats.pomodorosThisWeek = countInRange(COUNT_POMODOROS_RANGE_SQL, DayColumn::Number, weekStart, today + 1);
+        stats.averagePomodorosPerDay = endDay > startDay
+            ? (double)stats.totalPomodoros / (endDay - startDay) : 0.0;
+        return stats;
+    }
+
+    std::vector<PomodoroFocusStats> getPomodoroFocusByDay(
+        const std::chrono::system_clock::time_point& startDate, int days) override {
+        std::vector<PomodoroFocusStats> stats(days > 0 ? days : 0);
+        if (days <= 0) return stats;
+
+        int startDay = toDay(startDate);
+        for (int i = 0; i < days; ++i) {
+            stats[i].date = StreakTracker::dateFromDay(startDay + i);
+        }
+        runQuery(POMODORO_FOCUS_BY_DAY_SQL, bindDayRange(DayColumn::Number, startDay, startDay + days),
+            [&](sqlite3_stmt* stmt) {
+                int index = sqlite3_column_int(stmt, 0) - startDay;
+                if (index >= 0 && index < days) {
+                    readFocus(stmt, stats[index]);
+                }
+            });
+        return stats;
+    }
+
+    std::vector<PomodoroFocusStats> getPomodoroFocusByTask(
+        const std::chrono::system_clock::time_point& startDate,
+        const std::chrono::system_clock::time_point& endDate) override {
+        std::vector<PomodoroFocusStats> stats;
+        int startDay = toDay(startDate);
+        int endDay = toDay(endDate) + 1;
+        if (endDay <= startDay) return stats;
+
+        runQuery(POMODORO_FOCUS_BY_TASK_SQL, bindDayRange(DayColumn::Number, startDay, endDay),
+            [&](sqlite3_stmt* stmt) {
+                PomodoroFocusStats row;
+                row.taskId = sqlite3_column_int(stmt, 0);
+                readFocus(stmt, row);
+                stats.push_back(row);
+            });
+        return stats;
+    }
+
+    PomodoroFocusStats getPomodoroFocusForTask(int taskId) override {
+        PomodoroFocusStats stats;
+        stats.taskId = taskId;
+        runQuery(POMODORO_FOCUS_FOR_TASK_SQL,
+            [taskId](sqlite3_stmt* stmt) { sqlite3_bind_int(stmt, 1, taskId); },
+            [&](sqlite3_stmt* stmt) { readFocus(stmt, stats); });
+        return stats;
+    }
+
+    // === 趋势分析 ===
+
+    CompletionTrend getCompletionTrend(int days) override {
+        CompletionTrend trend;
+        if (days <= 0) return trend;
+
+        int startDay = StreakTracker::today() - days + 1;
+        std::vector<int> counts = countByDay(COMPLETED_BY_DAY_SQL, DayColumn::Number, startDay, days);
+
+        trend.dailyCompletions.reserve(counts.size());
+        for (size_t i = 0; i < counts.size(); ++i) {
+            trend.dailyCompletions.emplace_back(fromDay(startDay + static_cast<int>(i)), counts[i]);
+        }
+        trend.trendSlope = slopeOf(counts);
+        trend.isImproving = trend.trendSlope > 0;
+        return trend;
+    }
+
+    // 每日生产力 = 完成任务数 + 完成番茄钟数 / 4（4 个番茄钟约等于一个任务的工作量）
+    ProductivityTrend getProductivityTrend(int days) override {
+        ProductivityTrend trend;
+        if (days <= 0) return trend;
+
+        int startDay = StreakTracker::today() - days + 1;
+        std::vector<int> tasks = countByDay(COMPLETED_BY_DAY_SQL, DayColumn::Number, startDay, days);
+        std::vector<int> pomodoros = countByDay(POMODOROS_BY_DAY_SQL, DayColumn::Number, startDay, days);
+
+        std::vector<double> values(tasks.size());
+        double total = 0.0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = tasks[i] + pomodoros[i] / 4.0;
+            total += values[i];
+            trend.dailyProductivity.emplace_back(fromDay(startDay + static_cast<int>(i)), values[i]);
+        }
+        trend.averageProductivity = values.empty() ? 0.0 : total / values.size();
+        trend.isImproving = slopeOf(values) > 0;
+        return trend;
+    }
+
+    // === streaks 统计（由 StreakTracker 在内存中维护） ===
+
+    int getCurrentCompletionStreak() override {
+        return StreakTracker::getInstance().getCurrentStreak();
+    }
+
+    int getLongestCompletionStreak() override {
+        return StreakTracker::getInstance().getLongestStreak();
+    }
+
+    std::vector<StreakRecord> getStreakHistory() override {
+        return StreakTracker::getInstance().getStreakHistory();
+    }
+
+    // === 挑战和成就统计 ===
+
+    ChallengeCompletionStats getChallengeCompletionStats() override {
+        ChallengeCompletionStats stats;
+        runQuery(CHALLENGE_STATS_SQL, noBind, [&](sqlite3_stmt* stmt) {
+            int dailyDone = sqlite3_column_int(stmt, 0);
+            int dailyTotal = sqlite3_column_int(stmt, 1);
+            int weeklyDone = sqlite3_column_int(stmt, 2);
+            int weeklyTotal = sqlite3_column_int(stmt, 3);
+
+            stats.dailyChallengesCompleted = dailyDone;
+            stats.weeklyChallengesCompleted = weeklyDone;
+            stats.totalChallengesCompleted = sqlite3_column_int(stmt, 4);
+            stats.dailyChallengeCompletionRate = dailyTotal > 0 ? (double)dailyDone / dailyTotal : 0.0;
+            stats.weeklyChallengeCompletionRate = weeklyTotal > 0 ? (double)weeklyDone / weeklyTotal : 0.0;
+        });
+        return stats;
+    }
+
+    AchievementUnlockStats getAchievementUnlockStats() override {
+        AchievementUnlockStats stats;
+        int total = 0;
+        runQuery(ACHIEVEMENT_STATS_SQL, noBind, [&](sqlite3_stmt* stmt) {
+            const char* category = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            int unlocked = sqlite3_column_int(stmt, 1);
+            stats.unlocksByCategory[category ? category : "special"] = unlocked;
+            stats.totalUnlocked += unlocked;
+            total += sqlite3_column_int(stmt, 2);
+        });
+        stats.totalLocked = total - stats.totalUnlocked;
+        stats.unlockRate = total > 0 ? (double)stats.totalUnlocked / total : 0.0;
+        return stats;
+    }
+
+    // === 综合统计 ===
+
+    std::map<std::string, int> getOverallStatistics() override {
+        std::map<std::string, int> stats;
+        runQuery(OVERALL_STATS_SQL, noBind, [&](sqlite3_stmt* stmt) {
+            stats["tasks_created"] = sqlite3_column_int(stmt, 0);
+            stats["tasks_completed"] = sqlite3_column_int(stmt, 1);
+            stats["task_pomodoros"] = sqlite3_column_int(stmt, 2);
+            stats["pomodoro_sessions"] = sqlite3_column_int(stmt, 3);
+            stats["projects_active"] = sqlite3_column_int(stmt, 4);
+            stats["projects_completed"] = sqlite3_column_int(stmt, 5);
+            stats["challenges_completed"] = sqlite3_column_int(stmt, 6);
+            stats["achievements_unlocked"] = sqlite3_column_int(stmt, 7);
+        });
+        stats["current_streak"] = getCurrentCompletionStreak();
+        stats["longest_streak"] = getLongestCompletionStreak();
+        return stats;
+    }
+};
+
+// 工厂函数
+std::unique_ptr<StatisticsDAO> createStatisticsDAO() {
+    return std::make_unique<SqliteStatisticsDAO>();
+}
@@ -1,10 +1,16 @@
 #include "database/DAO/TaskDAO.h"
 #include "database/DatabaseManager.h"
+#include "common/TimeTypes.h"
+#include "task/TagRegistry.h"
 #include <sqlite3.h>
 #include <iostream>
 #include <sstream>
 #include <ctime>
 #include <optional>
+#include <cctype>
+#include <algorithm>
+#include <climits>
+#include <variant>
 
 // =====================
 // 构造函数
@@ -61,6 +67,9 @@ bool TaskDAOImpl::updateTaskProject(int taskId, std::optional<int> projectId) {
     sqlite3* db = getDatabaseConnection();
     if (!db) return false;
 
+    // 单条写入也要等其他线程的保存点结束，否则会被并入其中、随之回滚
+    auto writeLock = DatabaseManager::getInstance().lockWrites();
+
     const char* sql = R"(
         UPDATE tasks
         SET project_id = ?
@@ -96,22 +105,31 @@ int TaskDAOImpl::insertTask(const Task& task) {
         INSERT INTO tasks (
             title, description, priority, due_date,
             completed, tags, project_id, pomodoro_count,
-            estimated_pomodoros, reminder_time
-        ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+            estimated_pomodoros, reminder_time, due_day
+        ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
     )";
 
+    // 任务行与标签关联在同一保存点内写入
+    auto& dbManager = DatabaseManager::getInstance();
+    auto writeLock = dbManager.lockWrites();
+    if (!dbManager.execute("SAVEPOINT task_insert;")) return -1;
+
     sqlite3_stmt* stmt;
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
         std::cerr << "Prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        dbManager.execute("ROLLBACK TO task_insert; RELEASE task_insert;");
         return -1;
     }
 
+    const std::vector<std::string> tags = TagRegistry::parse(task.getTags());
+    const std::string joinedTags = TagRegistry::join(tags);
+
     sqlite3_bind_text(stmt, 1, task.getName().c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 2, task.getDescription().c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(stmt, 3, task.getPriority());
     sqlite3_bind_text(stmt, 4, task.getDueDate().c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(stmt, 5, task.isCompleted() ? 1 : 0);
-    sqlite3_bind_text(stmt, 6, task.getTags().c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 6, joinedTags.c_str(), -1, SQLITE_TRANSIENT);
 
     // project_id 可为 NULL
     if (task.getProjectId().has_value())
@@ -123,6 +141,13 @@ int TaskDAOImpl::insertTask(const Task& task) {
     sqlite3_bind_int(stmt, 9, task.getEstimatedPomodoros());
     sqlite3_bind_text(stmt, 10, task.getReminderTime().c_str(), -1, SQLITE_TRANSIENT);
 
+    // 截止日期只在写入时解析一次，查询按整数天数比较
+    DayNumber dueDay;
+    if (DayNumber::parse(task.getDueDate(), dueDay))
+        sqlite3_bind_int(stmt, 11, dueDay.value);
+    else
+        sqlite3_bind_null(stmt, 11);
+
     int id = -1;
     if (sqlite3_step(stmt) == SQLITE_DONE)
         id = sqlite3_last_insert_rowid(db);
@@ -130,6 +155,13 @@ int TaskDAOImpl::insertTask(const Task& task) {
         std::cerr << "Insert failed: " << sqlite3_errmsg(db) << std::endl;
 
     sqlite3_finalize(stmt);
+
+    if (id < 0 || !writeTaskTags(db, id, tags)) {
+        dbManager.execute("ROLLBACK TO task_insert; RELEASE task_insert;");
+        TagRegistry::getInstance().clear();     // 回滚可能撤销了刚驻留的标签
+        return -1;
+    }
+    dbManager.execute("RELEASE task_insert;");
     return id;
 }
 
@@ -256,15 +288,19 @@ bool TaskDAOImpl::updateTask(const Task& task) {
     sqlite3* db = getDatabaseConnection();
     if (!db) return false;
 
+    auto writeLock = DatabaseManager::getInstance().lockWrites();
+
     // 仅更新完成状态和时间戳，避免触碰其他字段（例如 project_id 导致 FK 问题）
     const char* sql = R"(
         UPDATE tasks
         SET
-            completed = ?,
+            completed = ?1,
             updated_date = datetime('now'),
-            -- 如果当前传入为 completed=1，则当数据库中 completed_date 为空时设置为 now
-            completed_date = CASE WHEN ? = 1 THEN COALESCE(completed_date, datetime('now')) ELSE completed_date END
-        WHERE id = ?
+            -- 如果当前传入为 completed=1，则当数据库中 completed_date 为空时设置为 now；
+            -- 重新打开时清空，再次完成记为当天，与 TaskManager 记入连续打卡的 StreakTracker::today() 一致
+            completed_date = CASE WHEN ?2 = 1 THEN COALESCE(completed_date, datetime('now')) ELSE NULL END,
+            completed_day = CASE WHEN ?2 = 1 THEN COALESCE(completed_day, CAST(strftime('%s', 'now') AS INTEGER) / 86400) ELSE NULL END
+        WHERE id = ?3
     )";
 
     sqlite3_stmt* stmt = nullptr;
@@ -274,7 +310,7 @@ bool TaskDAOImpl::updateTask(const Task& task) {
     }
 
     int c = task.isCompleted() ? 1 : 0;
-    // 绑定： completed, 用于 completed_date 的判断, 然后 id
+    // 绑定： completed, 用于 completed_date / completed_day 的判断, 然后 id
     sqlite3_bind_int(stmt, 1, c);
     sqlite3_bind_int(stmt, 2, c);
     sqlite3_bind_int(stmt, 3, task.getId());
@@ -297,6 +333,8 @@ bool TaskDAOImpl::deleteTask(int id) {
     sqlite3* db = getDatabaseConnection();
     if (!db) return false;
 
+    auto writeLock = DatabaseManager::getInstance().lockWrites();
+
     const char* sql = "UPDATE tasks SET deleted = 1, updated_date = datetime('now') WHERE id = ?";
     sqlite3_stmt* stmt;
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
@@ -311,120 +349,496 @@ bool TaskDAOImpl::deleteTask(int id) {
 
 
 
+// 以下固定查询都由 TaskQuery 编译，返回完整的任务行
 std::vector<Task> TaskDAOImpl::getTasksByStatus(bool completed) {
-    sqlite3* db = getDatabaseConnection();
-    std::vector<Task> tasks;
-    if (!db) return tasks;
+    TaskPage page;
+    queryTasks(TaskQuery().status(completed).take(0), page);
+    return page.tasks;
+}
 
-    const char* sql = "SELECT id, title, description, completed, project_id FROM tasks WHERE completed = ? AND deleted = 0 ORDER BY created_date DESC";
-    sqlite3_stmt* stmt;
+std::vector<Task> TaskDAOImpl::getTasksByProject(int projectId) {
+    TaskPage page;
+    queryTasks(TaskQuery().project(projectId).take(0), page);
+    return page.tasks;
+}
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        return tasks;
-    }
+std::vector<Task> TaskDAOImpl::getOverdueTasks() {
+    TaskPage page;
+    queryTasks(TaskQuery()
+                   .status(false)
+                   .dueBetween(std::nullopt, DayNumber::todayUtc() - 1)
+                   .sortBy(TaskQuery::Sort::DueDate)
+                   .take(0),
+               page);
+    return page.tasks;
+}
 
-    sqlite3_bind_int(stmt, 1, completed ? 1 : 0);
+std::vector<Task> TaskDAOImpl::getTodayTasks() {
+    const DayNumber today = DayNumber::todayUtc();
+    TaskPage page;
+    queryTasks(TaskQuery().dueBetween(today, today).take(0), page);
+    return page.tasks;
+}
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Task task;
-        task.setId(sqlite3_column_int(stmt, 0));
-        task.setName(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
-        task.setDescription(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)));
-        task.setCompleted(sqlite3_column_int(stmt, 3) != 0);
-        task.setProjectId(sqlite3_column_int(stmt, 4));
-        tasks.push_back(task);
+// =======================
+// searchTasks
+// =======================
+namespace {
+    // 完整任务行，readTaskRow 按此顺序读取
+    #define TASK_ROW_COLUMNS \
+        "t.id, t.title, t.description, t.completed, t.project_id, " \
+        "t.priority, t.due_date, t.tags, t.pomodoro_count, " \
+        "t.estimated_pomodoros, t.reminder_time"
+
+    // 命中数超过该值的检索只对最新的这些命中打分；索引只含未删除的任务，窗口内都是有效命中
+    static constexpr int SEARCH_RANK_WINDOW = 1000;
+
+    // 命中数是否超过窗口：按 rowid 顺序流式读取倒排列表，不计算相关度
+    static constexpr const char* SQL_SEARCH_PROBE =
+        "SELECT rowid FROM tasks_fts WHERE tasks_fts MATCH ?1 ORDER BY rowid DESC LIMIT 1 OFFSET ?2";
+
+    // 命中不多时：对全部命中按 bm25 排序；标题权重最高，其次是标签，描述最低
+    static constexpr const char* SQL_SEARCH_ALL =
+        "SELECT " TASK_ROW_COLUMNS ", f.rank, "
+        "       highlight(tasks_fts, 0, char(2), char(3)), "
+        "       snippet(tasks_fts, 1, char(2), char(3), '...', 16) "
+        "FROM tasks_fts f JOIN tasks t ON t.id = f.rowid "
+        "WHERE tasks_fts MATCH ?1 AND f.rank MATCH 'bm25(10.0, 1.0, 4.0)' AND t.deleted = 0 "
+        "ORDER BY f.rank LIMIT ?2 OFFSET ?3";
+
+    // 命中很多时：bm25 计算 IDF 要扫描全部命中，改为只对最新的窗口内命中用 task_rank 打分。
+    // 高亮与片段也在窗口内一并生成：辅助函数只能在检索游标上调用，事后按 rowid 逐条补查
+    // 会为每条结果重新合并一遍前缀词的倒排列表，反而更慢
+    static constexpr const char* SQL_SEARCH_RECENT =
+        "SELECT " TASK_ROW_COLUMNS ", f.score, f.title_html, f.snippet "
+        "FROM (SELECT rowid, task_rank(tasks_fts, 10.0, 1.0, 4.0) AS score, "
+        "             highlight(tasks_fts, 0, char(2), char(3)) AS title_html, "
+        "             snippet(tasks_fts, 1, char(2), char(3), '...', 16) AS snippet "
+        "      FROM tasks_fts WHERE tasks_fts MATCH ?1 ORDER BY rowid DESC LIMIT ?4) f "
+        "JOIN tasks t ON t.id = f.rowid "
+        "WHERE t.deleted = 0 "
+        "ORDER BY f.score LIMIT ?2 OFFSET ?3";
+
+    static constexpr size_t MAX_SEARCH_TERMS = 8;
+
+    // 把用户输入转换为 FTS5 查询：每个词加引号按字面匹配（避免输入中的 AND/NEAR/* 等被当作语法），
+    // 并按前缀匹配以支持边输入边搜索；没有可用的词时返回空串
+    std::string toFtsQuery(const std::string& input) {
+        std::string query;
+        std::string term;
+        size_t terms = 0;
+        auto flush = [&]() {
+            if (!term.empty() && terms < MAX_SEARCH_TERMS) {
+                if (!query.empty()) query += ' ';
+                query += '"' + term + "\"*";
+                ++terms;
+            }
+            term.clear();
+        };
+        for (char c : input) {
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                flush();
+            } else if (c != '"') {
+                term += c;
+            }
+        }
+        flush();
+        return query;
     }
 
-    sqlite3_finalize(stmt);
+    std::string columnText(sqlite3_stmt* stmt, int col) {
+        const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+        return text ? text : "";
+    }
 
-    return tasks;
+    Task readTaskRow(sqlite3_stmt* stmt) {
+        std::optional<int> projectId;
+        if (sqlite3_column_type(stmt, 4) != SQLITE_NULL)
+            projectId = sqlite3_column_int(stmt, 4);
+
+        return Task(
+            sqlite3_column_int(stmt, 0),
+            columnText(stmt, 1),
+            columnText(stmt, 2),
+            sqlite3_column_int(stmt, 3) != 0,
+            projectId.value_or(0),
+            sqlite3_column_int(stmt, 5),
+            columnText(stmt, 6),
+            columnText(stmt, 7),
+            sqlite3_column_int(stmt, 8),
+            sqlite3_column_int(stmt, 9),
+            columnText(stmt, 10)
+        );
+    }
+
+    // 读取 TASK_ROW_COLUMNS 与其后的相关度、高亮标题、描述片段
+    TaskSearchHit readSearchHit(sqlite3_stmt* stmt) {
+        TaskSearchHit hit;
+        hit.task = readTaskRow(stmt);
+        hit.score = sqlite3_column_double(stmt, 11);
+        hit.titleHighlight = columnText(stmt, 12);
+        hit.snippet = columnText(stmt, 13);
+        return hit;
+    }
 }
 
-std::vector<Task> TaskDAOImpl::getTasksByProject(int projectId) {
-    sqlite3* db = getDatabaseConnection();
-    std::vector<Task> tasks;
-    if (!db) return tasks;
+std::vector<TaskSearchHit> TaskDAOImpl::searchTasks(const std::string& query, int limit, int offset,
+                                                    bool* truncated) {
+    std::vector<TaskSearchHit> hits;
+    if (truncated) *truncated = false;
+    const std::string match = toFtsQuery(query);
+    if (match.empty() || limit <= 0) return hits;
+    offset = offset > 0 ? offset : 0;
 
-    const char* sql = "SELECT id, title, description, completed, project_id FROM tasks WHERE project_id = ? AND deleted = 0 ORDER BY created_date DESC";
-    sqlite3_stmt* stmt;
+    // 检索走只读连接池，不与写操作争用主连接；语句按连接缓存
+    auto& dbManager = DatabaseManager::getInstance();
+    if (!dbManager.isOpen() && !dbManager.initialize(databasePath)) return hits;
+    ReadConnectionLease conn = dbManager.acquireReadConnection();
+    if (!conn) return hits;
+
+    bool manyMatches = false;
+    if (sqlite3_stmt* probe = conn.prepare(SQL_SEARCH_PROBE)) {
+        sqlite3_bind_text(probe, 1, match.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(probe, 2, SEARCH_RANK_WINDOW);
+        manyMatches = sqlite3_step(probe) == SQLITE_ROW;
+        sqlite3_reset(probe);
+    }
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        return tasks;
+    if (manyMatches) {
+        if (truncated) *truncated = true;
+        // 窗口之外的命中不参与排序，分页到窗口末尾为止
+        if (offset >= SEARCH_RANK_WINDOW) return hits;
+        limit = std::min(limit, SEARCH_RANK_WINDOW - offset);
     }
 
-    sqlite3_bind_int(stmt, 1, projectId);
+    sqlite3_stmt* stmt = manyMatches ? conn.prepare(SQL_SEARCH_RECENT) : nullptr;
+    const bool windowed = stmt != nullptr;
+    if (!windowed) {
+        stmt = conn.prepare(SQL_SEARCH_ALL);
+    }
+    if (!stmt) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(conn.get()) << std::endl;
+        return hits;
+    }
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Task task;
-        task.setId(sqlite3_column_int(stmt, 0));
-        task.setName(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
-        task.setDescription(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)));
-        task.setCompleted(sqlite3_column_int(stmt, 3) != 0);
-        task.setProjectId(sqlite3_column_int(stmt, 4));
-        tasks.push_back(task);
+    sqlite3_bind_text(stmt, 1, match.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, limit);
+    sqlite3_bind_int(stmt, 3, offset);
+    if (windowed) {
+        sqlite3_bind_int(stmt, 4, SEARCH_RANK_WINDOW);
     }
 
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        hits.push_back(readSearchHit(stmt));
+    }
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Search failed: " << sqlite3_errmsg(conn.get()) << std::endl;
+    }
+    sqlite3_reset(stmt);
+    return hits;
+}
+
+// =======================
+// 标签
+// =======================
+namespace {
+    static constexpr const char* SQL_DELETE_TASK_TAGS = "DELETE FROM task_tags WHERE task_id = ?1;";
+    static constexpr const char* SQL_INSERT_TASK_TAG =
+        "INSERT OR IGNORE INTO task_tags (task_id, tag_id) VALUES (?1, ?2);";
+    static constexpr const char* SQL_UPDATE_TASK_TAGS =
+        "UPDATE tasks SET tags = ?1, updated_date = datetime('now') WHERE id = ?2 AND deleted = 0;";
+
+    // 只按 tag_id 分组计数，名称由 TagRegistry 取回，不再连接 tags 表
+    static constexpr const char* SQL_TAG_COUNTS =
+        "SELECT tt.tag_id, COUNT(*) AS task_count, SUM(t.completed = 0) "
+        "FROM task_tags tt JOIN tasks t ON t.id = tt.task_id "
+        "WHERE t.deleted = 0 "
+        "GROUP BY tt.tag_id "
+        "ORDER BY task_count DESC, tt.tag_id "
+        "LIMIT ?1;";
+}
+
+bool TaskDAOImpl::writeTaskTags(sqlite3* db, int taskId, const std::vector<std::string>& tags) {
+    sqlite3_stmt* stmt = nullptr;
+    bool ok = sqlite3_prepare_v2(db, SQL_DELETE_TASK_TAGS, -1, &stmt, nullptr) == SQLITE_OK;
+    if (ok) {
+        sqlite3_bind_int(stmt, 1, taskId);
+        ok = sqlite3_step(stmt) == SQLITE_DONE;
+    }
     sqlite3_finalize(stmt);
+    stmt = nullptr;
+
+    if (ok && !tags.empty()) {
+        ok = sqlite3_prepare_v2(db, SQL_INSERT_TASK_TAG, -1, &stmt, nullptr) == SQLITE_OK;
+        auto& registry = TagRegistry::getInstance();
+        for (size_t i = 0; ok && i < tags.size(); ++i) {
+            const int tagId = registry.intern(tags[i]);
+            if (tagId < 0) {
+                ok = false;
+                break;
+            }
+            sqlite3_bind_int(stmt, 1, taskId);
+            sqlite3_bind_int(stmt, 2, tagId);
+            ok = sqlite3_step(stmt) == SQLITE_DONE;
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+    }
 
-    return tasks;
+    if (!ok) {
+        std::cerr << "写入任务标签失败: " << sqlite3_errmsg(db) << std::endl;
+    }
+    return ok;
 }
 
-std::vector<Task> TaskDAOImpl::getOverdueTasks() {
+bool TaskDAOImpl::setTaskTags(int taskId, const std::string& tags) {
     sqlite3* db = getDatabaseConnection();
-    std::vector<Task> tasks;
-    if (!db) return tasks;
+    if (!db) return false;
 
-    const char* sql = "SELECT id, title, description, completed, project_id FROM tasks WHERE due_date < date('now') AND completed = 0 AND deleted = 0 ORDER BY due_date ASC";
-    sqlite3_stmt* stmt;
+    auto& dbManager = DatabaseManager::getInstance();
+    auto writeLock = dbManager.lockWrites();
+    if (!dbManager.execute("SAVEPOINT task_tags_update;")) return false;
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        return tasks;
-    }
+    const std::vector<std::string> parsed = TagRegistry::parse(tags);
+    const std::string joined = TagRegistry::join(parsed);
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Task task;
-        task.setId(sqlite3_column_int(stmt, 0));
-        task.setName(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
-        task.setDescription(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)));
-        task.setCompleted(sqlite3_column_int(stmt, 3) != 0);
-        task.setProjectId(sqlite3_column_int(stmt, 4));
-        tasks.push_back(task);
+    sqlite3_stmt* stmt = nullptr;
+    bool ok = sqlite3_prepare_v2(db, SQL_UPDATE_TASK_TAGS, -1, &stmt, nullptr) == SQLITE_OK;
+    if (ok) {
+        sqlite3_bind_text(stmt, 1, joined.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 2, taskId);
+        ok = sqlite3_step(stmt) == SQLITE_DONE && sqlite3_changes(db) > 0;
     }
-
     sqlite3_finalize(stmt);
 
-    return tasks;
+    if (!ok || !writeTaskTags(db, taskId, parsed)) {
+        dbManager.execute("ROLLBACK TO task_tags_update; RELEASE task_tags_update;");
+        TagRegistry::getInstance().clear();
+        return false;
+    }
+    return dbManager.execute("RELEASE task_tags_update;");
 }
 
-std::vector<Task> TaskDAOImpl::getTodayTasks() {
-    sqlite3* db = getDatabaseConnection();
-    std::vector<Task> tasks;
-    if (!db) return tasks;
+std::vector<Task> TaskDAOImpl::getTasksByTags(const std::vector<std::string>& tags, bool matchAll) {
+    TaskPage page;
+    queryTasks(TaskQuery().tags(tags, matchAll).take(0), page);
+    return page.tasks;
+}
 
-    const char* sql = "SELECT id, title, description, completed, project_id FROM tasks WHERE due_date = date('now') AND deleted = 0 ORDER BY created_date DESC";
-    sqlite3_stmt* stmt;
+std::vector<TagCount> TaskDAOImpl::getTagCounts(int limit) {
+    std::vector<TagCount> counts;
+    if (limit <= 0) return counts;
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        return tasks;
+    auto& dbManager = DatabaseManager::getInstance();
+    if (!dbManager.isOpen() && !dbManager.initialize(databasePath)) return counts;
+    ReadConnectionLease conn = dbManager.acquireReadConnection();
+    if (!conn) return counts;
+
+    sqlite3_stmt* stmt = conn.prepare(SQL_TAG_COUNTS);
+    if (!stmt) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(conn.get()) << std::endl;
+        return counts;
     }
+    sqlite3_bind_int(stmt, 1, limit);
 
+    auto& registry = TagRegistry::getInstance();
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Task task;
-        task.setId(sqlite3_column_int(stmt, 0));
-        task.setName(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
-        task.setDescription(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)));
-        task.setCompleted(sqlite3_column_int(stmt, 3) != 0);
-        task.setProjectId(sqlite3_column_int(stmt, 4));
-        tasks.push_back(task);
+        TagCount count;
+        count.name = registry.nameOf(sqlite3_column_int(stmt, 0));
+        count.taskCount = sqlite3_column_int(stmt, 1);
+        count.openCount = sqlite3_column_int(stmt, 2);
+        if (!count.name.empty()) counts.push_back(std::move(count));
     }
+    sqlite3_reset(stmt);
+    return counts;
+}
 
-    sqlite3_finalize(stmt);
+// =======================
+// queryTasks
+// =======================
+namespace {
+    // 没有截止日期的任务排在最后；索引 idx_tasks_live_due* 建在同一个表达式上
+    #define TASK_DUE_KEY "IFNULL(t.due_day, 2147483647)"
+    static constexpr std::int64_t NO_DUE_KEY = 2147483647;
+
+    static constexpr size_t MAX_TAG_FILTER = 16;
+
+    using QueryParam = std::variant<std::int64_t, std::string>;
+
+    struct CompiledTaskQuery {
+        std::string sql;
+        std::string index;
+        std::vector<QueryParam> params;     // 依次对应 ?1..?N
+    };
+
+    /**
+     * 查询形状 → 驱动索引（tasks 上的索引都是 WHERE deleted = 0 的部分索引）：
+     *   全文检索          tasks_fts，按 rowid 回表
+     *   标签              idx_task_tags_tag，每个标签一段范围扫描后取交集/并集，按 rowid 回表
+     *   项目              idx_tasks_live_project (project_id, completed)
+     *   截止日期区间/排序  idx_tasks_live_due (completed, due_key)，不限状态时 idx_tasks_live_due_any (due_key)
+     *   按优先级排序      idx_tasks_live_priority (completed, priority)，不限状态时 idx_tasks_live_priority_any (priority)
+     *   其余（按最新）     idx_tasks_live_completed (completed)，不限状态时按 rowid 倒序扫表；
+     *                     优先级只有三档，按最新排序时区间过滤边扫边筛比走优先级索引再整体排序更快
+     * 排序与所选索引一致时不需要临时排序，游标条件直接定位到索引中的位置。
+     * 用 INDEXED BY / NOT INDEXED 固定下来，避免没有统计信息时选中 idx_tasks_deleted 这类低选择性索引。
+     * 返回 false 表示结果必然为空（例如要求全部匹配的标签从未出现过），不必执行。
+     */
+    bool compileTaskQuery(const TaskQuery& q, CompiledTaskQuery& out) {
+        auto bind = [&out](QueryParam value) {
+            out.params.push_back(std::move(value));
+            return "?" + std::to_string(out.params.size());
+        };
+
+        std::string where = "t.deleted = 0";
+        if (q.completed) {
+            where += " AND t.completed = " + bind(std::int64_t(*q.completed ? 1 : 0));
+        }
+        if (q.projectId) {
+            where += " AND t.project_id = " + bind(std::int64_t(*q.projectId));
+        }
+        const bool priorityRange = q.minPriority || q.maxPriority;
+        if (priorityRange) {
+            where += " AND t.priority BETWEEN " + bind(std::int64_t(q.minPriority.value_or(0)));
+            where += " AND " + bind(std::int64_t(q.maxPriority.value_or(2)));
+        }
+        // 总是两端都绑定，只设一端时另一端取极值，形状不变；上界不超过 NO_DUE_KEY - 1，排除没有截止日期的任务
+        const bool dueRange = q.dueFrom || q.dueTo;
+        if (dueRange) {
+            where += " AND " TASK_DUE_KEY " BETWEEN " + bind(std::int64_t(q.dueFrom ? q.dueFrom->value : INT32_MIN));
+            where += " AND " + bind(std::int64_t(q.dueTo ? q.dueTo->value : NO_DUE_KEY - 1));
+        }
+
+        const std::string match = toFtsQuery(q.text);
+        if (!match.empty()) {
+            where += " AND t.id IN (SELECT rowid FROM tasks_fts WHERE tasks_fts MATCH " + bind(match) + ")";
+        }
+
+        // 标签名先在驻留表里换成 id：全部匹配时有未知标签则结果为空，任一匹配时忽略未知标签
+        std::vector<int> tagIds;
+        for (const auto& name : q.tagNames) {
+            if (tagIds.size() >= MAX_TAG_FILTER) break;
+            std::optional<int> id = TagRegistry::getInstance().find(name);
+            if (!id) {
+                if (q.matchAllTags) return false;
+            } else if (std::find(tagIds.begin(), tagIds.end(), *id) == tagIds.end()) {
+                tagIds.push_back(*id);
+            }
+        }
+        if (!q.tagNames.empty()) {
+            if (tagIds.empty()) return false;
+            std::string ids;
+            for (size_t i = 0; i < tagIds.size(); ++i) {
+                if (i > 0) ids += q.matchAllTags ? " INTERSECT " : " UNION ";
+                ids += "SELECT task_id FROM task_tags WHERE tag_id = " + bind(std::int64_t(tagIds[i]));
+            }
+            where += " AND t.id IN (" + ids + ")";
+        }
+
+        std::string sortKey;
+        std::string order;
+        switch (q.sort) {
+        case TaskQuery::Sort::DueDate:
+            sortKey = TASK_DUE_KEY;
+            order = TASK_DUE_KEY ", t.id";
+            if (q.after) {
+                where += " AND (" TASK_DUE_KEY ", t.id) > (" + bind(q.after->key) + ", " + bind(std::int64_t(q.after->id)) + ")";
+            }
+            break;
+        case TaskQuery::Sort::Priority:
+            sortKey = "t.priority";
+            order = "t.priority DESC, t.id DESC";
+            if (q.after) {
+                where += " AND (t.priority, t.id) < (" + bind(q.after->key) + ", " + bind(std::int64_t(q.after->id)) + ")";
+            }
+            break;
+        case TaskQuery::Sort::Newest:
+            sortKey = "0";
+            order = "t.id DESC";
+            if (q.after) {
+                where += " AND t.id < " + bind(std::int64_t(q.after->id));
+            }
+            break;
+        }
+
+        std::string access;
+        if (!match.empty()) {
+            out.index = "tasks_fts";
+            access = " NOT INDEXED";
+        } else if (!tagIds.empty()) {
+            out.index = "idx_task_tags_tag";
+            access = " NOT INDEXED";
+        } else if (q.projectId) {
+            out.index = "idx_tasks_live_project";
+        } else if (dueRange || q.sort == TaskQuery::Sort::DueDate) {
+            out.index = q.completed ? "idx_tasks_live_due" : "idx_tasks_live_due_any";
+        } else if (q.sort == TaskQuery::Sort::Priority) {
+            out.index = q.completed ? "idx_tasks_live_priority" : "idx_tasks_live_priority_any";
+        } else if (q.completed) {
+            out.index = "idx_tasks_live_completed";
+        } else {
+            out.index = "tasks";
+            access = " NOT INDEXED";
+        }
+        if (access.empty()) {
+            access = " INDEXED BY " + out.index;
+        }
+
+        // 多取一行判断是否还有下一页；不限条数时绑定 -1
+        const int limit = q.limit > 0 ? std::min(q.limit, TaskQuery::MAX_LIMIT) + 1 : -1;
+        out.sql = "SELECT " TASK_ROW_COLUMNS ", " + sortKey + " FROM tasks t" + access +
+                  " WHERE " + where + " ORDER BY " + order + " LIMIT " + bind(std::int64_t(limit)) + ";";
+        return true;
+    }
+}
 
-    return tasks;
+bool TaskDAOImpl::queryTasks(const TaskQuery& query, TaskPage& page) {
+    page = TaskPage();
+    CompiledTaskQuery compiled;
+    if (!compileTaskQuery(query, compiled)) {
+        return true;
+    }
+    page.index = compiled.index;
+
+    auto& dbManager = DatabaseManager::getInstance();
+    if (!dbManager.isOpen() && !dbManager.initialize(databasePath)) return false;
+    ReadConnectionLease conn = dbManager.acquireReadConnection();
+    if (!conn) return false;
+
+    // SQL 文本只随查询形状变化，预编译语句按连接缓存
+    sqlite3_stmt* stmt = conn.prepare(compiled.sql);
+    if (!stmt) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(conn.get()) << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < compiled.params.size(); ++i) {
+        const int index = static_cast<int>(i + 1);
+        if (const auto* value = std::get_if<std::int64_t>(&compiled.params[i])) {
+            sqlite3_bind_int64(stmt, index, *value);
+        } else {
+            sqlite3_bind_text(stmt, index, std::get<std::string>(compiled.params[i]).c_str(), -1, SQLITE_TRANSIENT);
+        }
+    }
+
+    const size_t pageSize = query.limit > 0 ? static_cast<size_t>(std::min(query.limit, TaskQuery::MAX_LIMIT)) : 0;
+    TaskCursor last;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        if (pageSize > 0 && page.tasks.size() == pageSize) {
+            page.next = last;
+            break;
+        }
+        page.tasks.push_back(readTaskRow(stmt));
+        last.key = sqlite3_column_int64(stmt, 11);
+        last.id = sqlite3_column_int(stmt, 0);
+    }
+    const bool ok = rc == SQLITE_ROW || rc == SQLITE_DONE;
+    if (!ok) {
+        std::cerr << "Query tasks failed: " << sqlite3_errmsg(conn.get()) << std::endl;
+    }
+    sqlite3_reset(stmt);
+    return ok;
 }
 
 int TaskDAOImpl::countAllTasks() {
@@ -475,6 +889,8 @@ bool TaskDAOImpl::assignTaskToProject(int taskId, int projectId) {
     sqlite3* db = getDatabaseConnection();
     if (!db) return false;
 
+    auto writeLock = DatabaseManager::getInstance().lockWrites();
+
     const char* sql = "UPDATE tasks SET project_id = ?, updated_date = datetime('now') WHERE id = ?";
     sqlite3_stmt* stmt;
 
@@ -501,6 +917,8 @@ bool TaskDAOImpl::incrementPomodoro(int taskId) {
     sqlite3* db = getDatabaseConnection();
     if (!db) return false;
 
+    auto writeLock = DatabaseManager::getInstance().lockWrites();
+
     const char* sql = "UPDATE tasks SET pomodoro_count = pomodoro_count + 1, updated_date = datetime('now') WHERE id = ?";
     sqlite3_stmt* stmt;
 
@@ -11,6 +11,68 @@
 std::unique_ptr<DatabaseManager> DatabaseManager::instance = nullptr;
 std::mutex DatabaseManager::instanceMutex;
 
+namespace {
+    /**
+     * task_rank(tasks_fts, 标题权重, 描述权重, 标签权重)：BM25 去掉 IDF 的部分（词频饱和 + 按列长度归一化）。
+     * 内置 bm25() 第一次调用时要扫描每个短语的完整倒排列表来计算 IDF，代价与命中数成正比；
+     * 本函数只读取当前行的命中位置和列长度，适合只对部分候选行打分。返回值越小越相关，与 bm25() 一致。
+     */
+    void taskRankFunction(const Fts5ExtensionApi* api, Fts5Context* fts, sqlite3_context* ctx,
+                          int argc, sqlite3_value** argv) {
+        constexpr double k1 = 1.2;
+        constexpr double b = 0.75;
+        const int columns = api->xColumnCount(fts);
+        const int phrases = api->xPhraseCount(fts);
+
+        sqlite3_int64 rows = 0;
+        int instances = 0;
+        if (api->xRowCount(fts, &rows) != SQLITE_OK || api->xInstCount(fts, &instances) != SQLITE_OK) {
+            sqlite3_result_error(ctx, "task_rank: failed to read match info", -1);
+            return;
+        }
+
+        std::vector<int> freq(static_cast<size_t>(phrases * columns), 0);
+        for (int i = 0; i < instances; ++i) {
+            int phrase = 0, column = 0, offset = 0;
+            if (api->xInst(fts, i, &phrase, &column, &offset) == SQLITE_OK) {
+                ++freq[static_cast<size_t>(phrase * columns + column)];
+            }
+        }
+
+        double score = 0.0;
+        for (int column = 0; column < columns; ++column) {
+            const double weight = column < argc ? sqlite3_value_double(argv[column]) : 1.0;
+            int length = 0;
+            sqlite3_int64 total = 0;
+            api->xColumnSize(fts, column, &length);
+            api->xColumnTotalSize(fts, column, &total);
+            const double average = rows > 0 && total > 0 ? static_cast<double>(total) / rows : 1.0;
+            const double norm = k1 * (1.0 - b + b * length / average);
+            for (int phrase = 0; phrase < phrases; ++phrase) {
+                const int tf = freq[static_cast<size_t>(phrase * columns + column)];
+                if (tf > 0) {
+                    score += weight * tf * (k1 + 1.0) / (tf + norm);
+                }
+            }
+        }
+        sqlite3_result_double(ctx, -score);
+    }
+
+    // 在连接上注册全文检索用的辅助函数；FTS5 不可用时只打印警告，检索会退回内置 bm25
+    void registerSearchFunctions(sqlite3* db) {
+        fts5_api* api = nullptr;
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, "SELECT fts5(?1)", -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_bind_pointer(stmt, 1, &api, "fts5_api_ptr", nullptr);
+            sqlite3_step(stmt);
+        }
+        sqlite3_finalize(stmt);
+        if (!api || api->xCreateFunction(api, "task_rank", nullptr, &taskRankFunction, nullptr) != SQLITE_OK) {
+            std::cerr << "注册全文检索函数失败: " << sqlite3_errmsg(db) << std::endl;
+        }
+    }
+}
+
 DatabaseManager::DatabaseManager() 
     : db(nullptr)
     , dbPath("task_manager.db")
@@ -58,7 +120,8 @@ bool DatabaseManager::initialize(const std::string& databasePath) {
         dbPath = databasePath;
         
         if (db) {
-            // 如果已经初始化，先关闭
+            // 如果已经初始化，先关闭（只读连接指向旧文件，一并关闭）
+            closeReadConnections();
             sqlite3_close(db.release()); 
         }
 
@@ -75,6 +138,8 @@ bool DatabaseManager::initialize(const std::string& databasePath) {
         }
         
         db.reset(rawDb);
+        sqlite3_update_hook(rawDb, &DatabaseManager::onRowChanged, this);
+        registerSearchFunctions(rawDb);
     } // dbMutex 在此处释放
 
     // 此时 execute 内部会自己加锁，不会导致死锁
@@ -118,6 +183,7 @@ bool DatabaseManager::close() {
     // 清理语句需要在 db 关闭前进行
     // 注意：cleanupPreparedStatements 会锁 stmtMutex，这是安全的
     cleanupPreparedStatements(); 
+    closeReadConnections();
     
     if (db) {
         db.reset(); // reset 会调用 deleter (sqlite3_close)
@@ -143,6 +209,7 @@ bool DatabaseManager::createTables() {
     success = success && createReminderTable();
     success = success && createAchievementTable();
     success = success && createUserStatsTable();
+    success = success && createExperienceLedgerTable();
     success = success && createUserSettingsTable();
     success = success && createPomodoroTable();
     
@@ -167,6 +234,8 @@ bool DatabaseManager::createTaskTable() {
             completed_date TEXT,
             reminder_time TEXT,
             deleted BOOLEAN DEFAULT 0,
+            due_day INTEGER,
+            completed_day INTEGER,
             FOREIGN KEY (project_id) REFERENCES projects(id) ON DELETE SET NULL
         );
         
@@ -176,9 +245,161 @@ bool DatabaseManager::createTaskTable() {
         CREATE INDEX IF NOT EXISTS idx_tasks_project_id ON tasks(project_id);
         CREATE INDEX IF NOT EXISTS idx_tasks_created_date ON tasks(created_date);
         CREATE INDEX IF NOT EXISTS idx_tasks_deleted ON tasks(deleted);
+        CREATE INDEX IF NOT EXISTS idx_tasks_completed_date ON tasks(completed, completed_date);
     )";
     
-    return execute(sql);
+    if (!execute(sql)) {
+        return false;
+    }
+    
+    // 截止/完成日期另存为自 1970-01-01 起的天数，统计与连续打卡按整数区间查询，不再调用 DATE()
+    bool hasDayColumns = false;
+    executeQuery("SELECT 1 FROM pragma_table_info('tasks') WHERE name = 'completed_day';",
+                 [&hasDayColumns](sqlite3_stmt*) { hasDayColumns = true; return false; });
+    if (!hasDayColumns && !execute(R"(
+        ALTER TABLE tasks ADD COLUMN due_day INTEGER;
+        ALTER TABLE tasks ADD COLUMN completed_day INTEGER;
+        UPDATE tasks SET
+            due_day = CAST(julianday(substr(due_date, 1, 10)) - 2440587.5 AS INTEGER),
+            completed_day = CAST(julianday(substr(completed_date, 1, 10)) - 2440587.5 AS INTEGER);
+    )")) {
+        return false;
+    }
+    
+    if (!execute(R"(
+        CREATE INDEX IF NOT EXISTS idx_tasks_due_day ON tasks(due_day);
+        CREATE INDEX IF NOT EXISTS idx_tasks_completed_day ON tasks(completed, completed_day);
+    )")) {
+        return false;
+    }
+    
+    // TaskQuery 各查询形状的驱动索引（映射见 TaskDAOImpl.cpp compileTaskQuery）。
+    // 只索引未删除的任务；截止日期按 IFNULL(due_day, 2147483647) 索引，没有截止日期的排在最后
+    if (!execute(R"(
+        CREATE INDEX IF NOT EXISTS idx_tasks_live_completed ON tasks(completed) WHERE deleted = 0;
+        CREATE INDEX IF NOT EXISTS idx_tasks_live_project ON tasks(project_id, completed) WHERE deleted = 0;
+        CREATE INDEX IF NOT EXISTS idx_tasks_live_due ON tasks(completed, IFNULL(due_day, 2147483647)) WHERE deleted = 0;
+        CREATE INDEX IF NOT EXISTS idx_tasks_live_due_any ON tasks(IFNULL(due_day, 2147483647)) WHERE deleted = 0;
+        CREATE INDEX IF NOT EXISTS idx_tasks_live_priority ON tasks(completed, priority) WHERE deleted = 0;
+        CREATE INDEX IF NOT EXISTS idx_tasks_live_priority_any ON tasks(priority) WHERE deleted = 0;
+    )")) {
+        return false;
+    }
+    
+    return createTaskSearchIndex() && createTaskTagTables();
+}
+
+bool DatabaseManager::createTaskSearchIndex() {
+    // 标题、描述、标签的全文索引：外部内容表，只存倒排索引不存正文，由触发器与 tasks 保持同步。
+    // 只索引未删除的任务：软删除时移出索引、恢复时重新加入，检索窗口不会被已删除的命中占用；
+    // 只改完成状态等其他列时不触碰索引
+    bool hasIndex = tableExists("tasks_fts");
+    if (!execute(R"(
+        CREATE VIRTUAL TABLE IF NOT EXISTS tasks_fts USING fts5(
+            title, description, tags,
+            content = 'tasks', content_rowid = 'id',
+            tokenize = 'unicode61 remove_diacritics 2',
+            prefix = '2 3'
+        );
+    )")) {
+        return false;
+    }
+    
+    // 旧版触发器不区分软删除，索引里还留着已删除的任务；换成新触发器时一并清理
+    bool liveOnly = false;
+    executeQuery("SELECT 1 FROM sqlite_master WHERE type = 'trigger' AND name = 'tasks_fts_update' "
+                 "AND sql LIKE '%deleted%';",
+                 [&liveOnly](sqlite3_stmt*) { liveOnly = true; return false; });
+    if (liveOnly) {
+        return true;
+    }
+    
+    // 外部内容表的 'delete' 必须给出入索引时的原值，所以每条语句都按 deleted 判断该行是否在索引中
+    const char* triggers = R"(
+        DROP TRIGGER IF EXISTS tasks_fts_insert;
+        DROP TRIGGER IF EXISTS tasks_fts_delete;
+        DROP TRIGGER IF EXISTS tasks_fts_update;
+        
+        CREATE TRIGGER tasks_fts_insert AFTER INSERT ON tasks WHEN new.deleted = 0 BEGIN
+            INSERT INTO tasks_fts(rowid, title, description, tags)
+            VALUES (new.id, new.title, new.description, new.tags);
+        END;
+        CREATE TRIGGER tasks_fts_delete AFTER DELETE ON tasks WHEN old.deleted = 0 BEGIN
+            INSERT INTO tasks_fts(tasks_fts, rowid, title, description, tags)
+            VALUES ('delete', old.id, old.title, old.description, old.tags);
+        END;
+        CREATE TRIGGER tasks_fts_update AFTER UPDATE OF title, description, tags, deleted ON tasks BEGIN
+            INSERT INTO tasks_fts(tasks_fts, rowid, title, description, tags)
+            SELECT 'delete', old.id, old.title, old.description, old.tags WHERE old.deleted = 0;
+            INSERT INTO tasks_fts(rowid, title, description, tags)
+            SELECT new.id, new.title, new.description, new.tags WHERE new.deleted = 0;
+        END;
+    )";
+    // 已有任务的旧库首次建索引时从 tasks 全量重建；rebuild 会读入所有行，随后移除已删除的任务
+    std::string sql = triggers;
+    if (!hasIndex) {
+        sql += "INSERT INTO tasks_fts(tasks_fts) VALUES ('rebuild');";
+    }
+    sql += "INSERT INTO tasks_fts(tasks_fts, rowid, title, description, tags) "
+           "SELECT 'delete', id, title, description, tags FROM tasks WHERE deleted IS NOT 0;";
+    
+    if (!beginTransaction()) {
+        return false;
+    }
+    if (!execute(sql)) {
+        rollbackTransaction();
+        std::cerr << "重建任务全文索引失败" << std::endl;
+        return false;
+    }
+    return commitTransaction();
+}
+
+bool DatabaseManager::createTaskTagTables() {
+    // 规范化的标签索引：tasks.tags 仍保存展示用的 "a,b" 字符串（全文索引也读它），
+    // 按标签过滤和统计走 task_tags。两者由 TaskDAO 在同一事务中写入
+    const char* schema = R"(
+        CREATE TABLE IF NOT EXISTS tags (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            name TEXT NOT NULL UNIQUE COLLATE NOCASE
+        );
+        
+        CREATE TABLE IF NOT EXISTS task_tags (
+            task_id INTEGER NOT NULL REFERENCES tasks(id) ON DELETE CASCADE,
+            tag_id INTEGER NOT NULL REFERENCES tags(id) ON DELETE CASCADE,
+            PRIMARY KEY (task_id, tag_id)
+        ) WITHOUT ROWID;
+        
+        CREATE INDEX IF NOT EXISTS idx_task_tags_tag ON task_tags(tag_id, task_id);
+    )";
+    if (tableExists("task_tags")) {
+        return execute(schema);
+    }
+    
+    // 首次建表时拆分已有的 tasks.tags 回填，与建表放在同一保存点内，中途失败不会留下半满的索引。
+    // 拆分规则与 TagRegistry::parse 一致：半角/中文逗号分隔，去掉首尾空白
+    const std::string migration = std::string("SAVEPOINT task_tag_migration;") + schema + R"(
+        CREATE TEMP TABLE task_tag_backfill AS
+        WITH RECURSIVE split(task_id, tag, rest) AS (
+            SELECT id, '', replace(tags, '，', ',') || ',' FROM tasks WHERE tags IS NOT NULL AND tags <> ''
+            UNION ALL
+            SELECT task_id,
+                   trim(substr(rest, 1, instr(rest, ',') - 1), ' ' || char(9, 10, 13)),
+                   substr(rest, instr(rest, ',') + 1)
+            FROM split WHERE rest <> ''
+        )
+        SELECT task_id, tag FROM split WHERE tag <> '';
+        
+        INSERT OR IGNORE INTO tags (name) SELECT tag FROM task_tag_backfill;
+        INSERT OR IGNORE INTO task_tags (task_id, tag_id)
+            SELECT b.task_id, g.id FROM task_tag_backfill b JOIN tags g ON g.name = b.tag;
+        DROP TABLE task_tag_backfill;
+        RELEASE task_tag_migration;
+    )";
+    if (!execute(migration)) {
+        execute("ROLLBACK TO task_tag_migration; RELEASE task_tag_migration; DROP TABLE IF EXISTS temp.task_tag_backfill;");
+        return false;
+    }
+    return true;
 }
 bool DatabaseManager::createProjectTable() {
     const char* sql = R"(
@@ -244,6 +465,10 @@ bool DatabaseManager::createReminderTable() {
             task_id INTEGER,
             enabled BOOLEAN DEFAULT 1,
             last_triggered TEXT,
+            trigger_epoch INTEGER,
+            anchor_time TEXT,
+            recurrence_rule TEXT,
+            anchor_epoch INTEGER,
             FOREIGN KEY (task_id) REFERENCES tasks(id) ON DELETE CASCADE
         );
         
@@ -252,37 +477,146 @@ bool DatabaseManager::createReminderTable() {
         CREATE INDEX IF NOT EXISTS idx_reminders_task_id ON reminders(task_id);
     )";
     
-    return execute(sql);
+    if (!execute(sql)) {
+        return false;
+    }
+    
+    // 旧库没有 trigger_epoch 列：补列并按本地时间换算已有的 trigger_time
+    bool hasEpoch = false;
+    executeQuery("SELECT 1 FROM pragma_table_info('reminders') WHERE name = 'trigger_epoch';",
+                 [&hasEpoch](sqlite3_stmt*) { hasEpoch = true; return false; });
+    if (!hasEpoch && !execute(R"(
+        ALTER TABLE reminders ADD COLUMN trigger_epoch INTEGER;
+        UPDATE reminders SET trigger_epoch = CAST(strftime('%s', trigger_time, 'utc') AS INTEGER);
+    )")) {
+        return false;
+    }
+    
+    // 重复提醒改为单行原地推进后，需要记录规则起点；旧数据以当前触发时间作为起点
+    bool hasAnchor = false;
+    executeQuery("SELECT 1 FROM pragma_table_info('reminders') WHERE name = 'anchor_time';",
+                 [&hasAnchor](sqlite3_stmt*) { hasAnchor = true; return false; });
+    if (!hasAnchor && !execute(R"(
+        ALTER TABLE reminders ADD COLUMN anchor_time TEXT;
+        UPDATE reminders SET anchor_time = trigger_time;
+    )")) {
+        return false;
+    }
+    
+    // recurrence 列受 CHECK 约束只能存分类，完整的 RRULE 规则另存一列；为空时按 recurrence 解释
+    bool hasRule = false;
+    executeQuery("SELECT 1 FROM pragma_table_info('reminders') WHERE name = 'recurrence_rule';",
+                 [&hasRule](sqlite3_stmt*) { hasRule = true; return false; });
+    if (!hasRule && !execute("ALTER TABLE reminders ADD COLUMN recurrence_rule TEXT;")) {
+        return false;
+    }
+    
+    // 提醒实体只保存整数时间，起点同样需要 epoch 列；文本列保留给旧版本与人工查看
+    bool hasAnchorEpoch = false;
+    executeQuery("SELECT 1 FROM pragma_table_info('reminders') WHERE name = 'anchor_epoch';",
+                 [&hasAnchorEpoch](sqlite3_stmt*) { hasAnchorEpoch = true; return false; });
+    if (!hasAnchorEpoch && !execute(R"(
+        ALTER TABLE reminders ADD COLUMN anchor_epoch INTEGER;
+        UPDATE reminders SET anchor_epoch = COALESCE(CAST(strftime('%s', anchor_time, 'utc') AS INTEGER), trigger_epoch);
+    )")) {
+        return false;
+    }
+    
+    // 部分索引只包含待触发的提醒，调度器按时间窗口加载时只扫描这一部分
+    return execute(
+        "CREATE INDEX IF NOT EXISTS idx_reminders_pending_epoch ON reminders(trigger_epoch) "
+        "WHERE enabled = 1 AND triggered = 0;");
+}
+
+// Default user ID for the single-user system
+namespace {
+    const int DEFAULT_USER_ID = 1;
 }
 
 bool DatabaseManager::createAchievementTable() {
+    // 成就定义以 unlock_condition 作为唯一键；用户进度单独存放在 user_achievements，
+    // 进度更新与解锁都只写一行
     const char* sql = R"(
         CREATE TABLE IF NOT EXISTS achievements (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             created_date TEXT NOT NULL DEFAULT (datetime('now')),
             updated_date TEXT NOT NULL DEFAULT (datetime('now')),
-            name TEXT NOT NULL UNIQUE,
+            name TEXT NOT NULL,
             description TEXT,
             icon TEXT,
-            unlock_condition TEXT,
-            unlocked BOOLEAN DEFAULT 0,
-            unlocked_date TEXT,
+            unlock_condition TEXT NOT NULL UNIQUE,
             reward_xp INTEGER DEFAULT 0,
-            category TEXT CHECK(category IN ('task', 'time', 'streak', 'special')),
-            progress INTEGER DEFAULT 0 CHECK(progress >= 0 AND progress <= 100),
+            category TEXT DEFAULT 'special',
             target_value INTEGER DEFAULT 0
         );
         
-        CREATE INDEX IF NOT EXISTS idx_achievements_unlocked ON achievements(unlocked);
-        CREATE INDEX IF NOT EXISTS idx_achievements_category ON achievements(category);
+        CREATE TABLE IF NOT EXISTS user_achievements (
+            user_id INTEGER NOT NULL,
+            achievement_key TEXT NOT NULL,
+            progress INTEGER NOT NULL DEFAULT 0,
+            unlocked_at TEXT,
+            updated_date TEXT NOT NULL DEFAULT (datetime('now')),
+            PRIMARY KEY (user_id, achievement_key)
+        ) WITHOUT ROWID;
     )";
     
-    return execute(sql);
+    if (!execute(sql) || !migrateLegacyAchievementTable()) {
+        return false;
+    }
+    
+    return execute(R"(
+        CREATE INDEX IF NOT EXISTS idx_achievements_category ON achievements(category);
+        CREATE INDEX IF NOT EXISTS idx_user_achievements_unlocked ON user_achievements(user_id, unlocked_at);
+    )");
 }
 
-// Default user ID for the single-user system
-namespace {
-    const int DEFAULT_USER_ID = 1;
+bool DatabaseManager::migrateLegacyAchievementTable() {
+    // 旧版 achievements 表把用户进度（unlocked/progress）混在定义里，且 category/progress 带 CHECK 约束
+    bool legacy = false;
+    executeQuery("SELECT 1 FROM pragma_table_info('achievements') WHERE name = 'unlocked';",
+                 [&legacy](sqlite3_stmt*) { legacy = true; return false; });
+    if (!legacy) {
+        return true;
+    }
+    
+    const std::string userId = std::to_string(DEFAULT_USER_ID);
+    const std::string sql = R"(
+        DROP INDEX IF EXISTS idx_achievements_unlocked;
+        DROP INDEX IF EXISTS idx_achievements_category;
+        ALTER TABLE achievements RENAME TO achievements_legacy;
+        CREATE TABLE achievements (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            created_date TEXT NOT NULL DEFAULT (datetime('now')),
+            updated_date TEXT NOT NULL DEFAULT (datetime('now')),
+            name TEXT NOT NULL,
+            description TEXT,
+            icon TEXT,
+            unlock_condition TEXT NOT NULL UNIQUE,
+            reward_xp INTEGER DEFAULT 0,
+            category TEXT DEFAULT 'special',
+            target_value INTEGER DEFAULT 0
+        );
+        INSERT OR IGNORE INTO achievements
+            (id, created_date, updated_date, name, description, icon, unlock_condition, reward_xp, category, target_value)
+            SELECT id, created_date, updated_date, name, description, icon,
+                   COALESCE(NULLIF(unlock_condition, ''), 'legacy_' || id), reward_xp, category, target_value
+            FROM achievements_legacy;
+        INSERT OR IGNORE INTO user_achievements (user_id, achievement_key, progress, unlocked_at)
+            SELECT )" + userId + R"(, COALESCE(NULLIF(unlock_condition, ''), 'legacy_' || id), progress,
+                   CASE WHEN unlocked = 1 THEN COALESCE(unlocked_date, datetime('now')) END
+            FROM achievements_legacy WHERE unlocked = 1 OR progress > 0;
+        DROP TABLE achievements_legacy;
+    )";
+    
+    if (!beginTransaction()) {
+        return false;
+    }
+    if (!execute(sql)) {
+        rollbackTransaction();
+        std::cerr << "迁移旧版成就表失败" << std::endl;
+        return false;
+    }
+    return commitTransaction();
 }
 
 bool DatabaseManager::createUserStatsTable() {
@@ -316,6 +650,24 @@ bool DatabaseManager::createUserStatsTable() {
     return execute(initSql.str());
 }
 
+bool DatabaseManager::createExperienceLedgerTable() {
+    // 经验值流水：每次奖励/扣除追加一行，user_stats.total_xp 为其累计值
+    const char* sql = R"(
+        CREATE TABLE IF NOT EXISTS xp_ledger (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            created_date TEXT NOT NULL DEFAULT (datetime('now')),
+            user_id INTEGER NOT NULL DEFAULT 1,
+            amount INTEGER NOT NULL,
+            source TEXT NOT NULL,
+            description TEXT
+        );
+
+        CREATE INDEX IF NOT EXISTS idx_xp_ledger_user_date ON xp_ledger(user_id, created_date);
+    )";
+
+    return execute(sql);
+}
+
 bool DatabaseManager::createUserSettingsTable() {
     const char* sql = R"(
         CREATE TABLE IF NOT EXISTS user_settings (
@@ -330,11 +682,23 @@ bool DatabaseManager::createUserSettingsTable() {
             notifications_enabled BOOLEAN DEFAULT 1,
             theme TEXT DEFAULT 'default',
             language TEXT DEFAULT 'zh',
-            auto_start_pomodoros BOOLEAN DEFAULT 0
+            auto_start_pomodoros BOOLEAN DEFAULT 0,
+            user_id INTEGER NOT NULL DEFAULT 1
         );
     )";
     
-    return execute(sql);
+    if (!execute(sql)) {
+        return false;
+    }
+    
+    // 番茄钟引擎按用户读取设置；旧表的设置行都归默认用户 1
+    bool hasUserColumn = false;
+    executeQuery("SELECT 1 FROM pragma_table_info('user_settings') WHERE name = 'user_id';",
+                 [&hasUserColumn](sqlite3_stmt*) { hasUserColumn = true; return false; });
+    if (!hasUserColumn && !execute("ALTER TABLE user_settings ADD COLUMN user_id INTEGER NOT NULL DEFAULT 1;")) {
+        return false;
+    }
+    return execute("CREATE INDEX IF NOT EXISTS idx_user_settings_user ON user_settings(user_id, id);");
 }
 
 bool DatabaseManager::createPomodoroTable() {
@@ -349,6 +713,8 @@ bool DatabaseManager::createPomodoroTable() {
             completed BOOLEAN DEFAULT 0,
             interrupted BOOLEAN DEFAULT 0,
             interruption_reason TEXT,
+            start_day INTEGER,
+            focus_seconds INTEGER DEFAULT 0,
             FOREIGN KEY (task_id) REFERENCES tasks(id) ON DELETE SET NULL
         );
         
@@ -357,10 +723,38 @@ bool DatabaseManager::createPomodoroTable() {
         CREATE INDEX IF NOT EXISTS idx_pomodoro_completed ON pomodoro_sessions(completed);
     )";
     
-    return execute(sql);
+    if (!execute(sql)) {
+        return false;
+    }
+    
+    // 会话按开始日期（UTC 天数）统计，实际专注秒数单独存一列；旧数据从文本时间换算
+    bool hasDayColumns = false;
+    executeQuery("SELECT 1 FROM pragma_table_info('pomodoro_sessions') WHERE name = 'start_day';",
+                 [&hasDayColumns](sqlite3_stmt*) { hasDayColumns = true; return false; });
+    if (!hasDayColumns && !execute(R"(
+        ALTER TABLE pomodoro_sessions ADD COLUMN start_day INTEGER;
+        ALTER TABLE pomodoro_sessions ADD COLUMN focus_seconds INTEGER DEFAULT 0;
+        UPDATE pomodoro_sessions SET
+            start_day = CAST(julianday(substr(start_time, 1, 10)) - 2440587.5 AS INTEGER),
+            focus_seconds = CASE
+                WHEN end_time IS NOT NULL THEN CAST((julianday(end_time) - julianday(start_time)) * 86400 AS INTEGER)
+                WHEN completed = 1 THEN COALESCE(duration, 0) * 60
+                ELSE 0 END;
+    )")) {
+        return false;
+    }
+    
+    // 按天区间的计数与专注汇总只读覆盖索引 idx_pomodoro_start_day，单个任务的统计走 (task_id, start_day)；
+    // 旧的 (completed, start_time) 索引已不再使用，删掉以减少追加时的索引维护
+    return execute(R"(
+        DROP INDEX IF EXISTS idx_pomodoro_completed_start;
+        CREATE INDEX IF NOT EXISTS idx_pomodoro_start_day ON pomodoro_sessions(start_day, completed, interrupted, focus_seconds, task_id);
+        CREATE INDEX IF NOT EXISTS idx_pomodoro_task_day ON pomodoro_sessions(task_id, start_day);
+    )");
 }
 
 bool DatabaseManager::execute(const std::string& sql) {
+    std::lock_guard<std::recursive_mutex> writeLock(writeMutex);
     std::lock_guard<std::mutex> lock(dbMutex);
     if (!db) return false;
     
@@ -384,6 +778,7 @@ bool DatabaseManager::execute(const std::string& sql) {
 
 bool DatabaseManager::executeParameterized(const std::string& sql, 
                                          const std::vector<std::string>& params) {
+    std::lock_guard<std::recursive_mutex> writeLock(writeMutex);
     std::lock_guard<std::mutex> lock(dbMutex);
     if (!db) return false;
     
@@ -484,51 +879,62 @@ void DatabaseManager::releasePreparedStatement(const std::string& key) {
 }
 
 bool DatabaseManager::beginTransaction() {
+    // 先拿写事务锁：其他线程的事务或保存点未结束时在此等待，而不是嵌套进去
+    writeMutex.lock();
     if (isTransactionActive) {
+        writeMutex.unlock();
         std::cerr << "事务已在进行中" << std::endl;
         return false;
     }
     
     if (execute("BEGIN TRANSACTION;")) {
+        transactionOwner = std::this_thread::get_id();
         isTransactionActive = true;
         return true;
     }
     
+    writeMutex.unlock();
     return false;
 }
 
 bool DatabaseManager::commitTransaction() {
-    if (!isTransactionActive) {
+    if (!isTransactionActive || transactionOwner != std::this_thread::get_id()) {
         std::cerr << "没有活跃的事务可提交" << std::endl;
         return false;
     }
     
-    if (execute("COMMIT TRANSACTION;")) {
-        isTransactionActive = false;
-        return true;
+    bool committed = execute("COMMIT TRANSACTION;");
+    if (!committed) {
+        // 提交失败时就地回滚，保证写事务锁在这里释放
+        execute("ROLLBACK TRANSACTION;");
     }
-    
-    return false;
+    isTransactionActive = false;
+    transactionOwner = std::thread::id();
+    writeMutex.unlock();
+    return committed;
 }
 
 bool DatabaseManager::rollbackTransaction() {
-    if (!isTransactionActive) {
+    if (!isTransactionActive || transactionOwner != std::this_thread::get_id()) {
         std::cerr << "没有活跃的事务可回滚" << std::endl;
         return false;
     }
     
-    if (execute("ROLLBACK TRANSACTION;")) {
-        isTransactionActive = false;
-        return true;
-    }
-    
-    return false;
+    bool rolledBack = execute("ROLLBACK TRANSACTION;");
+    isTransactionActive = false;
+    transactionOwner = std::thread::id();
+    writeMutex.unlock();
+    return rolledBack;
 }
 
 bool DatabaseManager::isInTransaction() const {
     return isTransactionActive;
 }
 
+std::unique_lock<std::recursive_mutex> DatabaseManager::lockWrites() {
+    return std::unique_lock<std::recursive_mutex>(writeMutex);
+}
+
 bool DatabaseManager::backupDatabase(const std::string& backupPath) {
     std::lock_guard<std::mutex> lock(dbMutex);
     if (!db) return false;
@@ -592,8 +998,8 @@ bool DatabaseManager::checkDatabaseIntegrity() {
 
 bool DatabaseManager::dropTables() {
     const char* tables[] = {
-        "pomodoro_sessions", "user_settings", "user_stats", 
-        "achievements", "reminders", "challenges", "tasks", "projects"
+        "pomodoro_sessions", "user_settings", "xp_ledger", "user_stats",
+        "user_achievements", "achievements", "reminders", "challenges", "task_tags", "tags", "tasks_fts", "tasks", "projects"
     };
     
     bool success = true;
@@ -689,4 +1095,160 @@ sqlite3* DatabaseManager::getRawConnection() {
 
 std::string DatabaseManager::getDatabasePath() const {
     return dbPath;
-}
\ No newline at end of file
+}
+// === 只读连接池 ===
+
+ReadConnectionLease::ReadConnectionLease(DatabaseManager* owner, ReadConnection* conn)
+    : owner(owner), conn(conn) {
+}
+
+ReadConnectionLease::ReadConnectionLease(ReadConnectionLease&& other) noexcept
+    : owner(other.owner), conn(other.conn) {
+    other.owner = nullptr;
+    other.conn = nullptr;
+}
+
+ReadConnectionLease& ReadConnectionLease::operator=(ReadConnectionLease&& other) noexcept {
+    if (this != &other) {
+        release();
+        owner = other.owner;
+        conn = other.conn;
+        other.owner = nullptr;
+        other.conn = nullptr;
+    }
+    return *this;
+}
+
+ReadConnectionLease::~ReadConnectionLease() {
+    release();
+}
+
+void ReadConnectionLease::release() {
+    if (owner && conn) {
+        owner->releaseReadConnection(conn);
+    }
+    owner = nullptr;
+    conn = nullptr;
+}
+
+sqlite3* ReadConnectionLease::get() const {
+    return conn ? conn->db : nullptr;
+}
+
+sqlite3_stmt* ReadConnectionLease::prepare(const std::string& sql) {
+    if (!conn || !conn->db) return nullptr;
+
+    // 租约期间连接为独占，语句缓存无需额外加锁
+    auto it = conn->statements.find(sql);
+    if (it != conn->statements.end()) {
+        sqlite3_reset(it->second);
+        sqlite3_clear_bindings(it->second);
+        return it->second;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(conn->db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "准备只读查询失败: " << sqlite3_errmsg(conn->db) << std::endl;
+        return nullptr;
+    }
+    conn->statements[sql] = stmt;
+    return stmt;
+}
+
+ReadConnection* DatabaseManager::openReadConnection() {
+    auto conn = std::make_unique<ReadConnection>();
+
+    // 内存数据库无法被第二个连接打开，回退为共享主连接
+    bool inMemory = dbPath.empty() || dbPath == ":memory:" ||
+                    dbPath.rfind("file::memory:", 0) == 0;
+    if (!inMemory) {
+        sqlite3* rawDb = nullptr;
+        int result = sqlite3_open_v2(dbPath.c_str(), &rawDb,
+                                     SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+        if (result == SQLITE_OK) {
+            sqlite3_busy_timeout(rawDb, 2000);
+            registerSearchFunctions(rawDb);
+            conn->db = rawDb;
+        } else {
+            std::cerr << "无法打开只读连接，回退为主连接: "
+                      << (rawDb ? sqlite3_errmsg(rawDb) : "内存分配失败") << std::endl;
+            if (rawDb) sqlite3_close(rawDb);
+        }
+    }
+
+    if (!conn->db) {
+        conn->db = db.get();
+        conn->ownsConnection = false;
+    }
+
+    readConnections.push_back(std::move(conn));
+    return readConnections.back().get();
+}
+
+ReadConnectionLease DatabaseManager::acquireReadConnection() {
+    std::unique_lock<std::mutex> lock(poolMutex);
+    if (!db) return ReadConnectionLease();
+
+    while (idleReadConnections.empty()) {
+        // 回退到主连接时只允许一个租约，避免多个线程共享同一条语句缓存
+        bool sharedFallback = !readConnections.empty() && !readConnections.front()->ownsConnection;
+        if (!sharedFallback && readConnections.size() < maxReadConnections) {
+            return ReadConnectionLease(this, openReadConnection());
+        }
+        poolCv.wait(lock);
+        if (!db) return ReadConnectionLease();
+    }
+
+    ReadConnection* conn = idleReadConnections.back();
+    idleReadConnections.pop_back();
+    return ReadConnectionLease(this, conn);
+}
+
+void DatabaseManager::releaseReadConnection(ReadConnection* conn) {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        idleReadConnections.push_back(conn);
+    }
+    poolCv.notify_one();
+}
+
+void DatabaseManager::closeReadConnections() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    // 调用方需保证此时没有未归还的租约
+    for (auto& conn : readConnections) {
+        for (auto& [sql, stmt] : conn->statements) {
+            if (stmt) sqlite3_finalize(stmt);
+        }
+        conn->statements.clear();
+        if (conn->ownsConnection && conn->db) {
+            sqlite3_close(conn->db);
+        }
+    }
+    readConnections.clear();
+    idleReadConnections.clear();
+    poolCv.notify_all();
+}
+
+void DatabaseManager::setMaxReadConnections(size_t count) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    maxReadConnections = count == 0 ? 1 : count;
+}
+
+size_t DatabaseManager::getMaxReadConnections() const {
+    return maxReadConnections;
+}
+
+// === 数据版本 ===
+
+void DatabaseManager::onRowChanged(void* self, int /*op*/, const char* /*dbName*/,
+                                   const char* table, sqlite3_int64 /*rowid*/) {
+    auto* manager = static_cast<DatabaseManager*>(self);
+    std::lock_guard<std::mutex> lock(manager->versionMutex);
+    ++manager->tableVersions[table];
+}
+
+uint64_t DatabaseManager::getTableVersion(const std::string& tableName) const {
+    std::lock_guard<std::mutex> lock(versionMutex);
+    auto it = tableVersions.find(tableName);
+    return it != tableVersions.end() ? it->second : 0;
+}
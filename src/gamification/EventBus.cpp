@@ -0,0 +1,39 @@
+#include "gamification/EventBus.h"
+#include <algorithm>
+
+EventBus& EventBus::getInstance() {
+    static EventBus instance;
+    return instance;
+}
+
+EventBus::SubscriptionId EventBus::subscribe(GameEventType type, Handler handler) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto updated = std::make_shared<SubscriptionList>(*subscriptions);
+    SubscriptionId id = nextId++;
+    updated->push_back({id, type, std::move(handler)});
+    subscriptions = std::move(updated);
+    return id;
+}
+
+void EventBus::unsubscribe(SubscriptionId id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto updated = std::make_shared<SubscriptionList>(*subscriptions);
+    updated->erase(std::remove_if(updated->begin(), updated->end(),
+                                  [id](const Subscription& s) { return s.id == id; }),
+                   updated->end());
+    subscriptions = std::move(updated);
+}
+
+void EventBus::publish(const GameEvent& event) {
+    std::shared_ptr<const SubscriptionList> current;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = subscriptions;
+    }
+
+    for (const auto& subscription : *current) {
+        if (subscription.type == event.type) {
+            subscription.handler(event);
+        }
+    }
+}
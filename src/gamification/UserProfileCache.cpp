@@ -0,0 +1,99 @@
+#include "gamification/UserProfileCache.h"
+#include "statistics/StreakTracker.h"
+#include <algorithm>
+
+namespace {
+    const std::shared_ptr<const UserProfile>& defaultProfile() {
+        static const auto profile = std::make_shared<const UserProfile>();
+        return profile;
+    }
+}
+
+UserProfileCache& UserProfileCache::getInstance() {
+    static UserProfileCache instance;
+    return instance;
+}
+
+UserProfileCache::UserProfileCache() {
+    auto& bus = EventBus::getInstance();
+    auto handler = [this](const GameEvent& event) { onGameEvent(event); };
+    for (auto type : {GameEventType::TaskCompleted, GameEventType::TaskReopened,
+                      GameEventType::PomodoroCompleted, GameEventType::StreakChanged}) {
+        subscriptions.push_back(bus.subscribe(type, handler));
+    }
+}
+
+UserProfileCache::~UserProfileCache() {
+    auto& bus = EventBus::getInstance();
+    for (auto id : subscriptions) {
+        bus.unsubscribe(id);
+    }
+}
+
+std::shared_ptr<const UserProfile> UserProfileCache::snapshot() {
+    auto profile = std::atomic_load(&current);
+    if (!profile) {
+        return defaultProfile();
+    }
+
+    // 跨天后连续打卡可能中断而没有任何事件，从 StreakTracker 的内存数据重新取值
+    if (profile->streakDay != StreakTracker::today()) {
+        auto& tracker = StreakTracker::getInstance();
+        const int streak = tracker.getCurrentStreak();
+        const int longest = tracker.getLongestStreak();
+        update([&](UserProfile& p) {
+            p.currentStreak = streak;
+            p.longestStreak = longest;
+            p.streakDay = StreakTracker::today();
+        });
+        profile = std::atomic_load(&current);
+    }
+    return profile;
+}
+
+bool UserProfileCache::isLoaded() const {
+    return std::atomic_load(&current) != nullptr;
+}
+
+void UserProfileCache::reset(const UserProfile& profile) {
+    std::atomic_store(&current, std::shared_ptr<const UserProfile>(std::make_shared<UserProfile>(profile)));
+}
+
+void UserProfileCache::update(const Mutator& mutate) {
+    auto expected = std::atomic_load(&current);
+    while (expected) {
+        auto updated = std::make_shared<UserProfile>(*expected);
+        mutate(*updated);
+        std::shared_ptr<const UserProfile> desired = std::move(updated);
+        if (std::atomic_compare_exchange_weak(&current, &expected, desired)) {
+            return;
+        }
+    }
+}
+
+void UserProfileCache::onGameEvent(const GameEvent& event) {
+    if (event.userId != 1) {
+        return;
+    }
+
+    switch (event.type) {
+        case GameEventType::TaskCompleted:
+            update([&](UserProfile& p) { p.totalTasksCompleted += event.value; });
+            break;
+        case GameEventType::TaskReopened:
+            update([&](UserProfile& p) { p.totalTasksCompleted = std::max(0, p.totalTasksCompleted - event.value); });
+            break;
+        case GameEventType::PomodoroCompleted:
+            update([&](UserProfile& p) { p.totalPomodoros += event.value; });
+            break;
+        case GameEventType::StreakChanged:
+            update([&](UserProfile& p) {
+                p.currentStreak = event.value;
+                p.longestStreak = std::max(p.longestStreak, event.value);
+                p.streakDay = StreakTracker::today();
+            });
+            break;
+        case GameEventType::LevelUp:
+            break;
+    }
+}
@@ -1,8 +1,11 @@
 #include "gamification/XPSystem.h"
+#include "gamification/EventBus.h"
+#include "statistics/StreakTracker.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
 #include <sqlite3.h>
 
 XPSystem::XPSystem() {
@@ -11,83 +14,58 @@ XPSystem::XPSystem() {
         cerr << "⚠️  警告: 数据库未打开，XPSystem可能无法正常工作" << endl;
     }
     
-    initializeLevelSystem();
+    std::vector<LevelDefinition> levels;
+    for (const auto& info : LevelTable::LEVELS) {
+        LevelDefinition definition;
+        definition.level = info.level;
+        definition.requiredXP = info.requiredXP;
+        definition.title = std::string(info.title);
+        levels.push_back(definition);
+    }
+    experienceDAO = createExperienceDAO(levels);
+    
+    if (dbManager->isOpen() && !UserProfileCache::getInstance().isLoaded()) {
+        refreshProfile();
+    }
 }
 
 XPSystem::~XPSystem() {
     // DatabaseManager是单例，不需要在这里删除
 }
 
-void XPSystem::initializeLevelSystem() {
-    // 等级阈值配置（指数增长）
-    levelThresholds[1] = 0;
-    levelThresholds[2] = 100;
-    levelThresholds[3] = 250;
-    levelThresholds[4] = 500;
-    levelThresholds[5] = 1000;
-    levelThresholds[6] = 1750;
-    levelThresholds[7] = 2750;
-    levelThresholds[8] = 4000;
-    levelThresholds[9] = 5500;
-    levelThresholds[10] = 7500;
-    levelThresholds[11] = 10000;
-    levelThresholds[12] = 13000;
-    levelThresholds[13] = 16500;
-    levelThresholds[14] = 20500;
-    levelThresholds[15] = 25000;
-    levelThresholds[16] = 30000;
-    levelThresholds[17] = 36000;
-    levelThresholds[18] = 43000;
-    levelThresholds[19] = 51000;
-    levelThresholds[20] = 60000;
-    
-    // 等级称号
-    levelTitles[1] = "新手";
-    levelTitles[2] = "初学者";
-    levelTitles[3] = "学徒";
-    levelTitles[4] = "实践者";
-    levelTitles[5] = "熟练者";
-    levelTitles[6] = "资深者";
-    levelTitles[7] = "精英";
-    levelTitles[8] = "专家";
-    levelTitles[9] = "大师";
-    levelTitles[10] = "宗师";
-    levelTitles[11] = "传奇";
-    levelTitles[12] = "史诗";
-    levelTitles[13] = "神话";
-    levelTitles[14] = "不朽";
-    levelTitles[15] = "永恒";
-    levelTitles[16] = "至尊";
-    levelTitles[17] = "主宰";
-    levelTitles[18] = "神圣";
-    levelTitles[19] = "超凡";
-    levelTitles[20] = "传说";
+void XPSystem::fillLevelFields(UserProfile& profile, int totalXP, int level) const {
+    profile.totalXP = totalXP;
+    profile.level = level;
+    profile.title = LevelTable::title(level);
+    profile.levelStartXP = LevelTable::requiredXP(level);
+    profile.xpIntoLevel = totalXP - profile.levelStartXP;
+    profile.nextLevelXP = LevelTable::nextLevelXP(level);
+    
+    int xpNeeded = profile.nextLevelXP - profile.levelStartXP;
+    profile.levelProgress = xpNeeded > 0 ? (double)profile.xpIntoLevel / xpNeeded : 1.0;
 }
 
-int XPSystem::calculateLevel(int totalXP) {
-    int level = 1;
+void XPSystem::refreshProfile() {
+    if (!dbManager->isOpen()) return;
     
-    // 从高到低查找对应等级
-    for (int l = 20; l >= 1; l--) {
-        if (totalXP >= levelThresholds[l]) {
-            level = l;
-            break;
-        }
-    }
+    UserProfile profile;
+    fillLevelFields(profile, getTotalXP(), getCurrentLevel());
     
-    return level;
-}
-
-void XPSystem::updateUserStats(int totalXP, int level) {
-    if (!dbManager->isOpen()) return;
+    dbManager->executeQuery(
+        "SELECT (SELECT COUNT(*) FROM tasks WHERE completed = 1 AND deleted = 0), "
+        "(SELECT COUNT(*) FROM pomodoro_sessions WHERE completed = 1);",
+        [&profile](sqlite3_stmt* stmt) {
+            profile.totalTasksCompleted = sqlite3_column_int(stmt, 0);
+            profile.totalPomodoros = sqlite3_column_int(stmt, 1);
+            return false;
+        });
     
-    stringstream sql;
-    sql << "UPDATE user_stats SET "
-        << "total_xp = " << totalXP << ", "
-        << "level = " << level << " "
-        << "WHERE id = 1;";
+    auto& tracker = StreakTracker::getInstance();
+    profile.currentStreak = tracker.getCurrentStreak();
+    profile.longestStreak = tracker.getLongestStreak();
+    profile.streakDay = StreakTracker::today();
     
-    dbManager->execute(sql.str());
+    UserProfileCache::getInstance().reset(profile);
 }
 
 // === 经验值管理 ===
@@ -95,28 +73,32 @@ void XPSystem::updateUserStats(int totalXP, int level) {
 bool XPSystem::awardXP(int amount, const string& source) {
     if (!dbManager->isOpen() || amount <= 0) return false;
     
-    // 获取当前总经验值
-    int currentTotal = getTotalXP();
-    int oldLevel = getCurrentLevel();
-    
-    // 增加经验值
-    int newTotal = currentTotal + amount;
-    int newLevel = calculateLevel(newTotal);
+    // 单条 UPDATE 原子累加并写入流水，并发奖励不会丢失经验值
+    ExperienceAward award;
+    if (!experienceDAO->addExperienceAtomic(1, amount, source, "", award)) {
+        return false;
+    }
     
-    // 更新数据库
-    updateUserStats(newTotal, newLevel);
+    // 用本次 UPDATE 返回的结果更新档案快照；并发奖励时保留较大的总经验值
+    UserProfileCache::getInstance().update([&](UserProfile& profile) {
+        if (award.totalXP > profile.totalXP) {
+            fillLevelFields(profile, award.totalXP, std::max(profile.level, award.newLevel));
+        }
+    });
     
     // 显示获得经验值的消息
     cout << "\n✨ 获得 " << amount << " 经验值! ";
     cout << "(" << source << ")\n";
     
     // 检查是否升级
-    if (newLevel > oldLevel) {
+    if (award.newLevel > award.previousLevel) {
         cout << "\n";
         cout << "🎉🎉🎉 恭喜升级！🎉🎉🎉\n";
-        cout << "等级: " << oldLevel << " (" << getLevelTitle(oldLevel) << ") "
-             << "→ " << newLevel << " (" << getLevelTitle(newLevel) << ")\n";
+        cout << "等级: " << award.previousLevel << " (" << getLevelTitle(award.previousLevel) << ") "
+             << "→ " << award.newLevel << " (" << getLevelTitle(award.newLevel) << ")\n";
         cout << "继续加油！\n\n";
+        
+        EventBus::getInstance().publish({GameEventType::LevelUp, 1, award.newLevel});
     }
     
     return true;
@@ -127,7 +109,7 @@ int XPSystem::getCurrentXP() {
     int level = getCurrentLevel();
     
     // 当前等级的起始经验值
-    int levelStartXP = levelThresholds[level];
+    int levelStartXP = LevelTable::requiredXP(level);
     
     // 当前等级内的经验值
     return totalXP - levelStartXP;
@@ -135,50 +117,19 @@ int XPSystem::getCurrentXP() {
 
 int XPSystem::getTotalXP() {
     if (!dbManager->isOpen()) return 0;
-    
-    string sql = "SELECT total_xp FROM user_stats WHERE id = 1;";
-    sqlite3* db = dbManager->getRawConnection();
-    sqlite3_stmt* stmt;
-    int result = 0;
-    
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            result = sqlite3_column_int(stmt, 0);
-        }
-        sqlite3_finalize(stmt);
-    }
-    
-    return result;
+    return experienceDAO->getCurrentExperience(1);
 }
 
 // === 等级管理 ===
 
 int XPSystem::getCurrentLevel() {
     if (!dbManager->isOpen()) return 1;
-    
-    string sql = "SELECT level FROM user_stats WHERE id = 1;";
-    sqlite3* db = dbManager->getRawConnection();
-    sqlite3_stmt* stmt;
-    int result = 1;
-    
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            result = sqlite3_column_int(stmt, 0);
-        }
-        sqlite3_finalize(stmt);
-    }
-    
-    return result;
+    return experienceDAO->getCurrentLevel(1);
 }
 
 int XPSystem::getXPForNextLevel() {
-    int level = getCurrentLevel();
-    
-    if (level >= 20) {
-        return levelThresholds[20]; // 已满级
-    }
-    
-    return levelThresholds[level + 1];
+    // 满级时返回满级门槛
+    return LevelTable::nextLevelXP(getCurrentLevel());
 }
 
 int XPSystem::getXPProgressToNextLevel() {
@@ -191,13 +142,13 @@ int XPSystem::getXPProgressToNextLevel() {
 double XPSystem::getLevelProgress() {
     int level = getCurrentLevel();
     
-    if (level >= 20) {
+    if (level >= LevelTable::MAX_LEVEL) {
         return 1.0; // 已满级
     }
     
     int totalXP = getTotalXP();
-    int currentLevelXP = levelThresholds[level];
-    int nextLevelXP = levelThresholds[level + 1];
+    int currentLevelXP = LevelTable::requiredXP(level);
+    int nextLevelXP = LevelTable::nextLevelXP(level);
     
     int xpInLevel = totalXP - currentLevelXP;
     int xpNeeded = nextLevelXP - currentLevelXP;
@@ -207,14 +158,11 @@ double XPSystem::getLevelProgress() {
     return (double)xpInLevel / xpNeeded;
 }
 
-string XPSystem::getLevelTitle(int level) {
-    if (levelTitles.find(level) != levelTitles.end()) {
-        return levelTitles[level];
-    }
-    return "未知";
+std::string_view XPSystem::getLevelTitle(int level) const {
+    return LevelTable::title(level);
 }
 
-string XPSystem::getCurrentLevelTitle() {
+std::string_view XPSystem::getCurrentLevelTitle() {
     return getLevelTitle(getCurrentLevel());
 }
 
@@ -256,7 +204,7 @@ string XPSystem::displayLevelInfo() {
     int level = getCurrentLevel();
     int totalXP = getTotalXP();
     int currentXP = getCurrentXP();
-    string title = getCurrentLevelTitle();
+    std::string_view title = getCurrentLevelTitle();
     
     info << "\n";
     info << "╔═══════════════════════════════════════════════════╗\n";
@@ -266,12 +214,12 @@ string XPSystem::displayLevelInfo() {
     info << "等级: " << level << " (" << title << ")\n";
     info << "总经验值: " << totalXP << " XP\n";
     
-    if (level < 20) {
+    if (level < LevelTable::MAX_LEVEL) {
         int nextLevelXP = getXPForNextLevel();
         int needed = getXPProgressToNextLevel();
         double progress = getLevelProgress() * 100;
         
-        info << "当前进度: " << currentXP << " / " << (nextLevelXP - levelThresholds[level]) << " XP\n";
+        info << "当前进度: " << currentXP << " / " << (nextLevelXP - LevelTable::requiredXP(level)) << " XP\n";
         info << "距离下级: " << needed << " XP\n";
         info << "进度: " << fixed << setprecision(1) << progress << "%\n";
         
@@ -306,7 +254,7 @@ string XPSystem::displayXPBar(int width) {
 }
 
 string XPSystem::getLevelBadge(int level) {
-    if (level >= 20) return "👑";
+    if (level >= LevelTable::MAX_LEVEL) return "👑";
     if (level >= 15) return "💎";
     if (level >= 10) return "🏆";
     if (level >= 5) return "⭐";
@@ -202,9 +202,19 @@ int main(int argc, char* argv[]) {
             ProjectManager projMgr;
             projMgr.initialize();
             ReminderSystem reminderSys(std::move(reminderDAO));
+            // --catch-up=all|latest|skip：启动时积压的错过提醒如何通知
+            for (int i = 1; i < argc; ++i) {
+                string a(argv[i]);
+                CatchUpPolicy policy;
+                if (a.rfind("--catch-up=", 0) == 0 && ReminderSystem::parseCatchUpPolicy(a.substr(11), policy)) {
+                    reminderSys.setCatchUpPolicy(policy);
+                }
+            }
+            ReminderDaemon reminderDaemon(reminderSys);
+            reminderDaemon.startChecking();
             XPSystem xpSys;
             StatisticsAnalyzer statsAnalyzer;
-            auto achievementDAO = std::make_unique<AchievementDAO>("./data/");
+            auto achievementDAO = createAchievementDAO("./data/");
             AchievementManager achieveMgr(std::move(achievementDAO), 1);
             HeatmapVisualizer heatmap("task_manager.db");
             heatmap.initialize();
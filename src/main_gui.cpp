@@ -43,7 +43,7 @@ int main(int argc, char* argv[]) {
     static ReminderSystem reminderSys(std::move(reminderDAO));
 
     // ʼɾϵͳ
-    auto achieveDAO = std::make_unique<AchievementDAO>("./data/");
+    auto achieveDAO = createAchievementDAO("./data/");
     static AchievementManager achieveMgr(std::move(achieveDAO), 1);
 
     // ݿʼ
@@ -0,0 +1,417 @@
+#include "reminder/Recurrence.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+    // 连续多少个周期没有任何候选日期时认为规则不会再触发（例如 INTERVAL=12;BYMONTHDAY=30 且起点在二月）
+    constexpr int MAX_EMPTY_PERIODS = 4000;
+
+    using civil::daysFromCivil;
+    using civil::civilFromDays;
+    using civil::weekday;
+    using civil::daysInMonth;
+    using civil::floorDiv;
+
+    bool monthDayMatches(std::uint32_t mask, int day) {
+        int y;
+        unsigned m, d;
+        civilFromDays(day, y, m, d);
+        return (mask >> d & 1u) || ((mask & 1u) && static_cast<int>(d) == daysInMonth(y, m));
+    }
+
+    int localDay(std::time_t t) {
+        return Timestamp(t).localDay().value;
+    }
+
+    bool parseInt(const std::string& text, int& value) {
+        if (text.empty()) return false;
+        char* end = nullptr;
+        long result = std::strtol(text.c_str(), &end, 10);
+        if (*end != '\0' || result < std::numeric_limits<int>::min() || result > std::numeric_limits<int>::max()) {
+            return false;
+        }
+        value = static_cast<int>(result);
+        return true;
+    }
+
+    // YYYYMMDD（当天结束）、YYYYMMDDTHHMMSS（本地时间）或 YYYYMMDDTHHMMSSZ（UTC）
+    bool parseUntil(const std::string& text, std::int64_t& epoch) {
+        int y, mo, d, h = 23, mi = 59, s = 59;
+        char zone = '\0';
+        if (text.size() == 8) {
+            if (std::sscanf(text.c_str(), "%4d%2d%2d", &y, &mo, &d) != 3) return false;
+        } else if (text.size() == 15 || text.size() == 16) {
+            if (std::sscanf(text.c_str(), "%4d%2d%2dT%2d%2d%2d%c", &y, &mo, &d, &h, &mi, &s, &zone) < 6) return false;
+            if (text.size() == 16 && zone != 'Z') return false;
+        } else {
+            return false;
+        }
+        if (mo < 1 || mo > 12 || d < 1 || d > 31 || h > 23 || mi > 59 || s > 59) return false;
+
+        // UTC 直接按日期编号换算，不依赖 POSIX 的 timegm（MinGW 没有）
+        if (zone == 'Z') {
+            epoch = static_cast<std::int64_t>(daysFromCivil(y, static_cast<unsigned>(mo), static_cast<unsigned>(d))) * 86400
+                  + h * 3600 + mi * 60 + s;
+            return true;
+        }
+
+        std::tm tm = {};
+        tm.tm_year = y - 1900;
+        tm.tm_mon = mo - 1;
+        tm.tm_mday = d;
+        tm.tm_hour = h;
+        tm.tm_min = mi;
+        tm.tm_sec = s;
+        tm.tm_isdst = -1;
+        epoch = std::mktime(&tm);
+        return epoch != -1;
+    }
+
+    template <typename Fn>
+    void forEachToken(const std::string& text, char separator, Fn fn) {
+        size_t start = 0;
+        while (start <= text.size()) {
+            size_t end = text.find(separator, start);
+            if (end == std::string::npos) end = text.size();
+            fn(text.substr(start, end - start));
+            start = end + 1;
+        }
+    }
+}
+
+// ==================== RecurrenceRule ====================
+
+bool RecurrenceRule::parse(const std::string& text, RecurrenceRule& rule, std::string* error) {
+    rule = RecurrenceRule();
+    auto fail = [error](const std::string& message) {
+        if (error) *error = message;
+        return false;
+    };
+
+    std::string upper;
+    for (unsigned char c : text) {
+        if (!std::isspace(c)) upper += static_cast<char>(std::toupper(c));
+    }
+
+    // 旧格式
+    if (upper.empty() || upper == "ONCE") return true;
+    if (upper == "DAILY") { rule.freq = Frequency::Daily; return true; }
+    if (upper == "WEEKLY") { rule.freq = Frequency::Weekly; return true; }
+    if (upper == "MONTHLY") { rule.freq = Frequency::Monthly; return true; }
+
+    if (upper.compare(0, 6, "RRULE:") == 0) {
+        upper.erase(0, 6);
+    }
+
+    bool ok = true;
+    std::string message;
+    forEachToken(upper, ';', [&](const std::string& part) {
+        if (!ok || part.empty()) return;
+        const size_t eq = part.find('=');
+        if (eq == std::string::npos) {
+            ok = false;
+            message = "expected KEY=VALUE in '" + part + "'";
+            return;
+        }
+        const std::string key = part.substr(0, eq);
+        const std::string value = part.substr(eq + 1);
+
+        if (key == "FREQ") {
+            if (value == "DAILY") rule.freq = Frequency::Daily;
+            else if (value == "WEEKLY") rule.freq = Frequency::Weekly;
+            else if (value == "MONTHLY") rule.freq = Frequency::Monthly;
+            else { ok = false; message = "unsupported FREQ '" + value + "'"; }
+        } else if (key == "INTERVAL") {
+            if (!parseInt(value, rule.interval) || rule.interval < 1 || rule.interval > 1000) {
+                ok = false;
+                message = "INTERVAL must be 1-1000";
+            }
+        } else if (key == "COUNT") {
+            if (!parseInt(value, rule.count) || rule.count < 1) {
+                ok = false;
+                message = "COUNT must be positive";
+            }
+        } else if (key == "UNTIL") {
+            if (!parseUntil(value, rule.until)) {
+                ok = false;
+                message = "invalid UNTIL '" + value + "'";
+            }
+        } else if (key == "BYDAY") {
+            static const char* const names[] = {"MO", "TU", "WE", "TH", "FR", "SA", "SU"};
+            forEachToken(value, ',', [&](const std::string& token) {
+                const auto* it = std::find(std::begin(names), std::end(names), token);
+                if (it == std::end(names)) {
+                    ok = false;
+                    message = "unsupported BYDAY '" + token + "'";
+                    return;
+                }
+                rule.byDayMask |= static_cast<std::uint8_t>(1u << (it - std::begin(names)));
+            });
+        } else if (key == "BYMONTHDAY") {
+            forEachToken(value, ',', [&](const std::string& token) {
+                int day = 0;
+                if (!parseInt(token, day) || !(day == -1 || (day >= 1 && day <= 31))) {
+                    ok = false;
+                    message = "BYMONTHDAY must be 1-31 or -1";
+                    return;
+                }
+                rule.byMonthDayMask |= 1u << (day == -1 ? 0 : day);
+            });
+        } else {
+            ok = false;
+            message = "unsupported part '" + key + "'";
+        }
+    });
+
+    if (!ok) return fail(message);
+    if (rule.freq == Frequency::None) return fail("missing FREQ");
+    if (rule.count > 0 && rule.until > 0) return fail("COUNT and UNTIL are mutually exclusive");
+    return true;
+}
+
+RecurrenceRule RecurrenceRule::fromType(ReminderType type) {
+    RecurrenceRule rule;
+    switch (type) {
+        case ReminderType::DAILY:   rule.freq = Frequency::Daily; break;
+        case ReminderType::WEEKLY:  rule.freq = Frequency::Weekly; break;
+        case ReminderType::MONTHLY: rule.freq = Frequency::Monthly; break;
+        default: break;
+    }
+    return rule;
+}
+
+ReminderType RecurrenceRule::type() const {
+    switch (freq) {
+        case Frequency::Daily:   return ReminderType::DAILY;
+        case Frequency::Weekly:  return ReminderType::WEEKLY;
+        case Frequency::Monthly: return ReminderType::MONTHLY;
+        default:                 return ReminderType::ONCE;
+    }
+}
+
+const char* RecurrenceRule::category() const {
+    switch (freq) {
+        case Frequency::Daily:   return "daily";
+        case Frequency::Weekly:  return "weekly";
+        case Frequency::Monthly: return "monthly";
+        default:                 return "once";
+    }
+}
+
+// ==================== RecurrenceSeries ====================
+
+RecurrenceSeries::RecurrenceSeries(const RecurrenceRule& rule, std::time_t anchor)
+    : recurrenceRule(rule), anchorEpoch(anchor) {
+    std::tm tm = {};
+    civil::toLocalTm(anchor, tm);
+    anchorDay = daysFromCivil(tm.tm_year + 1900, static_cast<unsigned>(tm.tm_mon + 1), static_cast<unsigned>(tm.tm_mday));
+    secondsOfDay = tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+    anchorMonth = (tm.tm_year + 1900) * 12 + tm.tm_mon;
+    anchorMonthDay = tm.tm_mday;
+}
+
+std::time_t RecurrenceSeries::toEpoch(int day) const {
+    int y;
+    unsigned m, d;
+    civilFromDays(day, y, m, d);
+
+    // 按日历日期与墙上时间换算，跨夏令时切换时保持本地时间不变
+    std::tm tm = {};
+    tm.tm_year = y - 1900;
+    tm.tm_mon = static_cast<int>(m) - 1;
+    tm.tm_mday = static_cast<int>(d);
+    tm.tm_hour = secondsOfDay / 3600;
+    tm.tm_min = secondsOfDay / 60 % 60;
+    tm.tm_sec = secondsOfDay % 60;
+    tm.tm_isdst = -1;
+    return std::mktime(&tm);
+}
+
+int RecurrenceSeries::candidates(long long period, int* days) const {
+    const auto& rule = recurrenceRule;
+    int n = 0;
+    auto accept = [&](int day) {
+        if (day >= anchorDay) days[n++] = day;
+    };
+
+    switch (rule.freq) {
+        case RecurrenceRule::Frequency::None:
+            if (period == 0) accept(anchorDay);
+            break;
+
+        case RecurrenceRule::Frequency::Daily: {
+            const int day = anchorDay + static_cast<int>(period * rule.interval);
+            if ((!rule.byDayMask || (rule.byDayMask >> weekday(day) & 1u)) &&
+                (!rule.byMonthDayMask || monthDayMatches(rule.byMonthDayMask, day))) {
+                accept(day);
+            }
+            break;
+        }
+
+        case RecurrenceRule::Frequency::Weekly: {
+            const int weekStart = anchorDay - weekday(anchorDay) + static_cast<int>(7 * period * rule.interval);
+            const unsigned mask = rule.byDayMask ? rule.byDayMask : 1u << weekday(anchorDay);
+            for (int i = 0; i < 7; ++i) {
+                if ((mask >> i & 1u) && (!rule.byMonthDayMask || monthDayMatches(rule.byMonthDayMask, weekStart + i))) {
+                    accept(weekStart + i);
+                }
+            }
+            break;
+        }
+
+        case RecurrenceRule::Frequency::Monthly: {
+            const long long monthIndex = anchorMonth + period * rule.interval;
+            const int y = static_cast<int>(floorDiv(monthIndex, 12));
+            const auto m = static_cast<unsigned>(monthIndex - static_cast<long long>(y) * 12 + 1);
+            const int first = daysFromCivil(y, m, 1);
+            const int dim = daysInMonth(y, m);
+
+            if (!rule.byDayMask && !rule.byMonthDayMask) {
+                // 未指定日期时沿用起点的日期，超出当月天数取月末
+                accept(first + std::min(anchorMonthDay, dim) - 1);
+                break;
+            }
+            for (int d = 1; d <= dim; ++d) {
+                const int day = first + d - 1;
+                if (rule.byMonthDayMask && !((rule.byMonthDayMask >> d & 1u) || ((rule.byMonthDayMask & 1u) && d == dim))) {
+                    continue;
+                }
+                if (rule.byDayMask && !(rule.byDayMask >> weekday(day) & 1u)) {
+                    continue;
+                }
+                accept(day);
+            }
+            break;
+        }
+    }
+    return n;
+}
+
+long long RecurrenceSeries::firstPeriodNear(std::time_t after) const {
+    const auto& rule = recurrenceRule;
+    if (rule.count > 0 || after <= anchorEpoch) {
+        return 0;
+    }
+
+    const int day = localDay(after);
+    long long period = 0;
+    switch (rule.freq) {
+        case RecurrenceRule::Frequency::Daily:
+            period = (day - anchorDay) / rule.interval;
+            break;
+        case RecurrenceRule::Frequency::Weekly:
+            period = (day - (anchorDay - weekday(anchorDay))) / (7LL * rule.interval);
+            break;
+        case RecurrenceRule::Frequency::Monthly: {
+            int y;
+            unsigned m, d;
+            civilFromDays(day, y, m, d);
+            period = (static_cast<long long>(y) * 12 + m - 1 - anchorMonth) / rule.interval;
+            break;
+        }
+        case RecurrenceRule::Frequency::None:
+            return 0;
+    }
+    // 退一个周期，避免夏令时等边界情况下越过 after
+    return std::max(0LL, period - 1);
+}
+
+std::time_t RecurrenceSeries::nextAfter(std::time_t after) const {
+    OccurrenceIterator it(*this, after + 1, std::numeric_limits<std::time_t>::max());
+    return it.valid() ? *it : -1;
+}
+
+size_t RecurrenceSeries::nextN(std::time_t after, std::time_t* out, size_t n) const {
+    size_t count = 0;
+    for (OccurrenceIterator it(*this, after + 1, std::numeric_limits<std::time_t>::max()); count < n && it.valid(); ++it) {
+        out[count++] = *it;
+    }
+    return count;
+}
+
+// ==================== OccurrenceIterator ====================
+
+OccurrenceIterator::OccurrenceIterator(const RecurrenceSeries& series, std::time_t from, std::time_t until)
+    : series(series), until(until) {
+    period = series.firstPeriodNear(from);
+    dayCount = series.candidates(period, days.data());
+
+    // 有 COUNT 时必须从起点数起；早于 from 所在日期的候选日只计数，不换算时间
+    const int fromDay = from > series.anchorEpoch ? localDay(from) : series.anchorDay;
+    step(fromDay);
+    while (current != -1 && current < from) {
+        step(fromDay);
+    }
+}
+
+void OccurrenceIterator::step(int skipBeforeDay) {
+    const auto& rule = series.recurrenceRule;
+    int emptyPeriods = 0;
+    while (true) {
+        while (dayIndex >= dayCount) {
+            if (rule.freq == RecurrenceRule::Frequency::None || ++emptyPeriods > MAX_EMPTY_PERIODS) {
+                current = -1;
+                return;
+            }
+            ++period;
+            dayCount = series.candidates(period, days.data());
+            dayIndex = 0;
+        }
+        if (rule.count > 0 && emitted >= rule.count) {
+            current = -1;
+            return;
+        }
+
+        const int day = days[dayIndex++];
+        ++emitted;
+        if (day < skipBeforeDay) {
+            emptyPeriods = 0;
+            continue;
+        }
+
+        const std::time_t t = series.toEpoch(day);
+        if (rule.until > 0 && t > rule.until) {
+            current = -1;
+            return;
+        }
+        current = t;
+        return;
+    }
+}
+
+OccurrenceIterator& OccurrenceIterator::operator++() {
+    if (current != -1) {
+        step(std::numeric_limits<int>::min());
+    }
+    return *this;
+}
+
+// ==================== NextFireCache ====================
+
+bool NextFireCache::lookup(std::time_t after, std::time_t& next) const {
+    if (anchor == -1 || after < from) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (times[i] > after) {
+            next = times[i];
+            return true;
+        }
+    }
+    if (count < K) {
+        // 上次计算时序列就已结束（COUNT/UNTIL）
+        next = -1;
+        return true;
+    }
+    return false;
+}
+
+void NextFireCache::refill(const std::string& ruleText, const RecurrenceSeries& series, std::time_t after) {
+    rule = ruleText;
+    anchor = series.anchor();
+    from = after;
+    count = series.nextN(after, times.data(), K);
+}
@@ -1,11 +1,23 @@
 #include "reminder/ReminderSystem.h"
 #include <iostream>
-#include <sstream>
-#include <iomanip>
 #include <ctime>
 #include <chrono>
 #include <thread>
 #include <atomic>
+#include <algorithm>
+#include <limits>
+
+namespace {
+    // 完整的重复规则；旧数据没有 recurrence_rule 时退回分类
+    const std::string& ruleText(const Reminder& reminder) {
+        return reminder.recurrenceRule.empty() ? reminder.recurrence : reminder.recurrenceRule;
+    }
+
+    // 今天起第 offsetDays 天的本地零点
+    Timestamp localDayStart(int offsetDays) {
+        return Timestamp::startOfLocalDay(Timestamp::now().localDay() + offsetDays);
+    }
+}
 
 // 构造函数接收 ReminderDAO
 ReminderSystem::ReminderSystem(std::unique_ptr<ReminderDAO> dao) 
@@ -13,9 +25,41 @@ ReminderSystem::ReminderSystem(std::unique_ptr<ReminderDAO> dao)
     initialize();
 }
 
+void ReminderSystem::setScheduleListener(ScheduleListener listener) {
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    scheduleListener = std::move(listener);
+}
+
+void ReminderSystem::notifyScheduleChanged(const Reminder& reminder) {
+    if (!reminder.enabled || reminder.triggered) {
+        notifyScheduleRemoved(reminder.id);
+        return;
+    }
+
+    ScheduleListener listener;
+    {
+        std::lock_guard<std::mutex> lock(listenerMutex);
+        listener = scheduleListener;
+    }
+    if (listener) {
+        listener(reminder.id, reminder.triggerAt);
+    }
+}
+
+void ReminderSystem::notifyScheduleRemoved(int reminderId) {
+    ScheduleListener listener;
+    {
+        std::lock_guard<std::mutex> lock(listenerMutex);
+        listener = scheduleListener;
+    }
+    if (listener) {
+        listener(reminderId, std::nullopt);
+    }
+}
+
 void ReminderSystem::initialize() {
     if (loadRemindersFromDB()) {
-        std::cout << "提醒系统初始化完成，共加载 " << reminders.size() << " 个提醒\n";
+        std::cout << "提醒系统初始化完成\n";
     } else {
         std::cout << "提醒系统初始化失败\n";
     }
@@ -28,9 +72,12 @@ bool ReminderSystem::loadRemindersFromDB() {
     }
     
     try {
-        // 使用DAO获取所有提醒
-        reminders = reminderDAO->getAllReminders();
-        std::cout << "从数据库加载了 " << reminders.size() << " 个提醒\n";
+        // 提醒数量可能很大，不再整体载入内存；调度由 ReminderDaemon 按时间窗口加载
+        int pending = reminderDAO->getReminderCountByStatus(ReminderStatus::PENDING);
+        if (pending < 0) {
+            return false;
+        }
+        std::cout << "数据库中共有 " << pending << " 个待触发提醒\n";
         return true;
     } catch (const std::exception& e) {
         std::cerr << "加载提醒失败: " << e.what() << "\n";
@@ -38,37 +85,37 @@ bool ReminderSystem::loadRemindersFromDB() {
     }
 }
 
+void ReminderSystem::setCatchUpPolicy(CatchUpPolicy policy, int graceSeconds) {
+    catchUpPolicy = policy;
+    catchUpGraceSeconds = std::max(0, graceSeconds);
+}
+
+bool ReminderSystem::parseCatchUpPolicy(const std::string& text, CatchUpPolicy& policy) {
+    if (text == "all") {
+        policy = CatchUpPolicy::FireAll;
+    } else if (text == "latest") {
+        policy = CatchUpPolicy::FireLatest;
+    } else if (text == "skip") {
+        policy = CatchUpPolicy::Skip;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 void ReminderSystem::checkDueReminders() {
     if (!reminderDAO) {
         std::cerr << "ReminderDAO 未初始化\n";
         return;
     }
     
-    auto currentTime = std::chrono::system_clock::now();
-    
     std::cout << "=== 检查到期提醒 (" << getCurrentTime() << ") ===\n";
     
     try {
-        // 使用DAO获取到期的提醒
-        auto dueReminders = reminderDAO->getDueReminders(currentTime);
-        int triggeredCount = 0;
-        
-        for (auto& reminder : dueReminders) {
-            // 统一使用 notifyUser 通知 UI / 用户
-            notifyUser(reminder);
-
-            // 标记为已触发
-            if (markReminderAsTriggered(reminder.id)) {
-                triggeredCount++;
-
-                // 处理重复提醒
-                if (reminder.recurrence != "once") {
-                    processRecurringReminder(reminder);
-                }
-            }
-        }
-        
-        if (triggeredCount == 0) {
+        int triggeredCount = fireDueReminders();
+        if (triggeredCount < 0) {
+            std::cerr << "触发到期提醒失败，稍后重试\n";
+        } else if (triggeredCount == 0) {
             std::cout << "暂无到期提醒\n";
         } else {
             std::cout << "共触发 " << triggeredCount << " 个提醒\n";
@@ -81,61 +128,182 @@ void ReminderSystem::checkDueReminders() {
     std::cout << "===================\n\n";
 }
 
+int ReminderSystem::fireDueReminders() {
+    if (!reminderDAO) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> fireLock(fireMutex);
+    const std::time_t now = std::time(nullptr);
+    auto dueReminders = reminderDAO->getDueReminders(Timestamp(now));
+    if (dueReminders.empty()) {
+        return 0;
+    }
+
+    const CatchUpPolicy policy = catchUpPolicy.load();
+    const std::time_t missedBefore = now - catchUpGraceSeconds.load();
+
+    std::vector<int> triggeredIds;
+    std::vector<std::pair<int, Timestamp>> advances;
+    std::vector<Reminder> advanced;
+    std::vector<const Reminder*> toNotify;
+    const Reminder* latestMissed = nullptr;
+    size_t skipped = 0;
+
+    for (const auto& reminder : dueReminders) {
+        const std::time_t due = reminder.triggerAt.toTimeT();
+        if (due >= missedBefore || policy == CatchUpPolicy::FireAll) {
+            toNotify.push_back(&reminder);
+        } else {
+            ++skipped;
+            if (policy == CatchUpPolicy::FireLatest && (!latestMissed || reminder.triggerAt >= latestMissed->triggerAt)) {
+                latestMissed = &reminder;
+            }
+        }
+
+        // 守护线程停机期间错过的重复触发不再补发，直接跳到当前时间之后
+        const std::time_t next = nextOccurrenceAfter(reminder, std::max(due, now));
+        if (next == -1) {
+            triggeredIds.push_back(reminder.id);
+        } else {
+            Reminder moved = reminder;
+            moved.triggerAt = Timestamp(next);
+            advances.emplace_back(moved.id, moved.triggerAt);
+            advanced.push_back(std::move(moved));
+        }
+    }
+    if (latestMissed) {
+        toNotify.push_back(latestMissed);
+        --skipped;
+    }
+
+    // 先提交再通知：提交失败时不弹出通知，下次检查会重新处理这一批
+    if (!reminderDAO->completeDueReminders(triggeredIds, advances)) {
+        return -1;
+    }
+
+    std::sort(toNotify.begin(), toNotify.end(),
+              [](const Reminder* a, const Reminder* b) { return a->triggerAt < b->triggerAt; });
+    notifyGrouped(toNotify);
+    if (skipped > 0) {
+        std::cout << "已跳过 " << skipped << " 个错过的提醒\n";
+    }
+
+    for (int reminderId : triggeredIds) {
+        notifyScheduleRemoved(reminderId);
+    }
+    for (const auto& reminder : advanced) {
+        notifyScheduleChanged(reminder);
+    }
+    return static_cast<int>(dueReminders.size());
+}
+
+void ReminderSystem::notifyGrouped(const std::vector<const Reminder*>& reminders) {
+    // 保持首次出现的顺序；未关联任务的提醒各自单独通知
+    std::vector<std::vector<const Reminder*>> groups;
+    std::unordered_map<int, size_t> groupByTask;
+    for (const Reminder* reminder : reminders) {
+        if (reminder->task_id <= 0) {
+            groups.push_back({reminder});
+            continue;
+        }
+        auto [it, inserted] = groupByTask.emplace(reminder->task_id, groups.size());
+        if (inserted) {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(reminder);
+    }
+
+    for (const auto& group : groups) {
+        if (group.size() == 1) {
+            notifyUser(*group.front());
+            continue;
+        }
+        std::cout << "🔔 任务 " << group.front()->task_id << " 有 " << group.size() << " 个提醒:\n";
+        for (const Reminder* reminder : group) {
+            std::cout << "   [" << reminder->triggerAt.toLocalString() << "] " << reminder->title << "\n";
+        }
+        std::cout << "\n";
+    }
+}
+
 bool ReminderSystem::isReminderDue(const Reminder& reminder) const {
-    // 解析提醒时间
-    std::time_t reminderTime = parseTimeString(reminder.trigger_time);
-    if (reminderTime == -1) return false;
-    
-    // 获取当前时间
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_time = std::chrono::system_clock::to_time_t(now);
-    
-    return reminderTime <= now_time;
+    return reminder.triggerAt <= Timestamp::now();
 }
 
-void ReminderSystem::processRecurringReminder(const Reminder& reminder) {
-    std::string nextTime = calculateNextTriggerTime(reminder);
+std::time_t ReminderSystem::nextOccurrenceAfter(const Reminder& reminder, std::time_t after) {
+    const std::time_t anchor = reminder.anchorAt.toTimeT();
+    std::time_t next = -1;
+
+    std::lock_guard<std::mutex> lock(fireTimeCacheMutex);
+    auto cached = fireTimeCache.find(reminder.id);
+    if (cached != fireTimeCache.end() && cached->second.matches(ruleText(reminder), anchor) &&
+        cached->second.lookup(after, next)) {
+        return next;
+    }
+
+    // 未命中时解析规则并一次算出接下来的 K 次，后续触发直接从缓存取
+    RecurrenceRule rule;
+    if (!RecurrenceRule::parse(ruleText(reminder), rule) || !rule.isRecurring()) {
+        return -1;
+    }
+    auto& cache = fireTimeCache[reminder.id];
+    cache.refill(ruleText(reminder), RecurrenceSeries(rule, anchor), after);
+    cache.lookup(after, next);
+    return next;
+}
 
-    if (nextTime.empty()) {
-        std::cerr << "无法计算下一次重复提醒时间，recurrence=" << reminder.recurrence << "\n";
+void ReminderSystem::forgetFireTimes(int reminderId) {
+    std::lock_guard<std::mutex> lock(fireTimeCacheMutex);
+    fireTimeCache.erase(reminderId);
+}
+
+void ReminderSystem::processRecurringReminder(const Reminder& reminder) {
+    const std::time_t cursor = reminder.triggerAt.toTimeT();
+
+    // 守护线程停机期间错过的触发不再补发，直接跳到当前时间之后
+    const std::time_t next = nextOccurrenceAfter(reminder, std::max(cursor, std::time(nullptr)));
+    if (next == -1) {
+        // COUNT/UNTIL 已用完，整个系列结束
+        markReminderAsTriggered(reminder.id);
+        forgetFireTimes(reminder.id);
         return;
     }
 
-    // 创建新的提醒记录
-    Reminder newReminder;
-    newReminder.title = reminder.title;
-    newReminder.message = reminder.message;
-    newReminder.trigger_time = nextTime;
-    newReminder.triggerTime = stringToTimePoint(nextTime);
-    newReminder.recurrence = reminder.recurrence;
-    newReminder.recurrenceRule = reminder.recurrence;
-    newReminder.task_id = reminder.task_id;
-    newReminder.taskId = reminder.task_id;
-    newReminder.enabled = true;
-    newReminder.triggered = false;
-    newReminder.type = reminder.type;
-    newReminder.status = ReminderStatus::PENDING;
+    Reminder advanced = reminder;
+    advanced.triggerAt = Timestamp(next);
+    advanced.triggered = false;
+    advanced.status = ReminderStatus::PENDING;
 
-    // 使用DAO保存新提醒
-    if (reminderDAO->insertReminder(newReminder)) {
-        std::cout << "已创建下一次提醒，时间: " << nextTime << "\n";
+    if (reminderDAO->advanceRecurringReminder(reminder.id, advanced.triggerAt)) {
+        std::cout << "下一次提醒时间: " << advanced.triggerAt.toLocalString() << "\n";
+        notifyScheduleChanged(advanced);
     } else {
-        std::cerr << "创建重复提醒失败\n";
+        std::cerr << "推进重复提醒失败\n";
     }
 }
 
+bool ReminderSystem::finishOccurrence(const Reminder& reminder) {
+    RecurrenceRule rule;
+    if (!RecurrenceRule::parse(ruleText(reminder), rule) || !rule.isRecurring()) {
+        return markReminderAsTriggered(reminder.id);
+    }
+    processRecurringReminder(reminder);
+    return true;
+}
+
 std::string ReminderSystem::calculateNextTriggerTime(const Reminder& reminder) const {
-    // 将字符串规则映射到枚举类型 ReminderType
-    ReminderType type = ReminderType::ONCE;
-    if (reminder.recurrence == "daily") {
-        type = ReminderType::DAILY;
-    } else if (reminder.recurrence == "weekly") {
-        type = ReminderType::WEEKLY;
-    } else if (reminder.recurrence == "monthly") {
-        type = ReminderType::MONTHLY;
+    RecurrenceRule rule;
+    if (!RecurrenceRule::parse(ruleText(reminder), rule)) {
+        return "";
+    }
+    if (!rule.isRecurring()) {
+        return reminder.triggerAt.toLocalString();
     }
 
-    return calculateNextReminderTime(reminder.trigger_time, type);
+    // 从规则起点计算，按月重复时不会因为某个月较短而把日期永久提前
+    const std::time_t next = RecurrenceSeries(rule, reminder.anchorAt.toTimeT()).nextAfter(reminder.triggerAt.toTimeT());
+    return next == -1 ? "" : formatTime(next);
 }
 
 std::string ReminderSystem::calculateNextReminderTime(
@@ -146,26 +314,11 @@ std::string ReminderSystem::calculateNextReminderTime(
         return "";
     }
 
-    std::time_t nextTime = baseTime;
-
-    switch (type) {
-    case ReminderType::DAILY:
-        nextTime += 24 * 60 * 60; // 增加1天
-        break;
-    case ReminderType::WEEKLY:
-        nextTime += 7 * 24 * 60 * 60; // 增加1周
-        break;
-    case ReminderType::MONTHLY:
-        // 简单实现：增加30天，如果需要更精确，可以在这里改成年月日计算
-        nextTime += 30 * 24 * 60 * 60;
-        break;
-    case ReminderType::ONCE:
-    default:
-        // 一次性或未知类型，不移动时间，直接返回原时间
-        break;
+    // 一次性或未知类型不移动时间，直接返回原时间
+    if (type == ReminderType::ONCE) {
+        return formatTime(baseTime);
     }
-
-    return formatTime(nextTime);
+    return formatTime(RecurrenceSeries(RecurrenceRule::fromType(type), baseTime).nextAfter(baseTime));
 }
 
 bool ReminderSystem::addReminder(const std::string& title, const std::string& message,
@@ -176,32 +329,35 @@ bool ReminderSystem::addReminder(const std::string& title, const std::string& me
         return false;
     }
 
+    RecurrenceRule parsedRule;
+    std::string ruleError;
+    if (!RecurrenceRule::parse(rule, parsedRule, &ruleError)) {
+        std::cerr << "无效的重复规则: " << rule << " (" << ruleError << ")\n";
+        return false;
+    }
+
+    Timestamp triggerAt;
+    if (!Timestamp::parseLocal(time, triggerAt)) {
+        std::cerr << "无效的提醒时间格式: " << time << "\n";
+        return false;
+    }
+
     Reminder newReminder;
     newReminder.title = title;
     newReminder.message = message;
-    newReminder.trigger_time = time;
-    newReminder.triggerTime = stringToTimePoint(time);
-    newReminder.recurrence = rule;
-    newReminder.recurrenceRule = rule;
-    newReminder.type = rule == "daily" ? ReminderType::DAILY
-        : rule == "weekly" ? ReminderType::WEEKLY
-        : rule == "monthly" ? ReminderType::MONTHLY
-        : ReminderType::ONCE;
+    newReminder.triggerAt = triggerAt;
+    newReminder.anchorAt = triggerAt;
+    newReminder.recurrence = parsedRule.category();
+    newReminder.recurrenceRule = rule.empty() ? newReminder.recurrence : rule;
+    newReminder.type = parsedRule.type();
     newReminder.status = ReminderStatus::PENDING;
     newReminder.task_id = task_id;
-    newReminder.taskId = task_id;
     newReminder.enabled = true;
     newReminder.triggered = false;
 
-    if (newReminder.triggerTime.time_since_epoch().count() == 0) {
-        std::cerr << "无效的提醒时间格式: " << time << "\n";
-        return false;
-    }
-
     if (reminderDAO->insertReminder(newReminder)) {
         std::cout << "✅ 已添加提醒: " << title << " (时间: " << time << ", 重复: " << rule << ")\n";
-        // 重新加载提醒列表以包含新提醒
-        loadRemindersFromDB();
+        notifyScheduleChanged(newReminder);
         return true;
     } else {
         std::cerr << "添加提醒失败\n";
@@ -210,11 +366,17 @@ bool ReminderSystem::addReminder(const std::string& title, const std::string& me
 }
 
 void ReminderSystem::displayAllReminders() {
+    if (!reminderDAO) {
+        std::cerr << "ReminderDAO 未初始化\n";
+        return;
+    }
+
+    const auto reminders = reminderDAO->getAllReminders();
     std::cout << "=== 所有提醒 (" << reminders.size() << "个) ===\n";
     for (const auto& reminder : reminders) {
         std::cout << (reminder.triggered ? "✅ " : "⏰ ");
         std::cout << "ID: " << reminder.id;
-        std::cout << " | 时间: " << reminder.trigger_time;
+        std::cout << " | 时间: " << reminder.triggerAt.toLocalString();
         std::cout << " | 重复: " << reminder.recurrence;
         std::cout << " | 状态: " << (reminder.enabled ? "启用" : "禁用") << "\n";
         std::cout << "   标题: " << reminder.title << "\n";
@@ -243,7 +405,7 @@ void ReminderSystem::displayPendingReminders() {
         
         for (const auto& reminder : activeReminders) {
             std::cout << "⏰ ID: " << reminder.id;
-            std::cout << " | 时间: " << reminder.trigger_time;
+            std::cout << " | 时间: " << reminder.triggerAt.toLocalString();
             std::cout << " | 重复: " << reminder.recurrence << "\n";
             std::cout << "   标题: " << reminder.title << "\n";
         }
@@ -261,6 +423,13 @@ void ReminderSystem::displayPendingReminders() {
 }
 
 // 新增方法实现
+std::optional<Reminder> ReminderSystem::getReminder(int reminderId) {
+    if (reminderDAO) {
+        return reminderDAO->getReminderById(reminderId);
+    }
+    return std::nullopt;
+}
+
 std::vector<Reminder> ReminderSystem::getActiveReminders() {
     if (reminderDAO) {
         return reminderDAO->getActiveReminders();
@@ -276,27 +445,83 @@ std::vector<Reminder> ReminderSystem::getRemindersByTask(int taskId) {
 }
 
 std::vector<Reminder> ReminderSystem::getDueRemindersForToday() {
+    // 重复提醒每次展开为一条，triggerAt 为当天的触发时间
+    std::vector<Reminder> reminders;
+    for (auto& occurrence : getTodayAgenda()) {
+        occurrence.reminder.triggerAt = occurrence.occursAt;
+        reminders.push_back(std::move(occurrence.reminder));
+    }
+    return reminders;
+}
+
+std::vector<ReminderOccurrence> ReminderSystem::getAgenda(Timestamp from, Timestamp until) {
+    std::vector<ReminderOccurrence> agenda;
+    if (!reminderDAO) {
+        return agenda;
+    }
+
+    for (const auto& reminder : reminderDAO->getAgendaCandidates(from.seconds, until.seconds)) {
+        RecurrenceRule rule;
+        if (!RecurrenceRule::parse(ruleText(reminder), rule) || !rule.isRecurring()) {
+            agenda.push_back({reminder, reminder.triggerAt});
+            continue;
+        }
+
+        // 已触发过的部分在游标之前，只展开游标之后落在区间内的各次
+        const RecurrenceSeries series(rule, reminder.anchorAt.toTimeT());
+        for (OccurrenceIterator it(series, std::max(from, reminder.triggerAt).toTimeT(), until.toTimeT()); it.valid(); ++it) {
+            agenda.push_back({reminder, Timestamp(*it)});
+        }
+    }
+
+    std::stable_sort(agenda.begin(), agenda.end(),
+                     [](const ReminderOccurrence& a, const ReminderOccurrence& b) { return a.occursAt < b.occursAt; });
+    return agenda;
+}
+
+std::vector<ReminderOccurrence> ReminderSystem::getTodayAgenda() {
+    return getAgenda(localDayStart(0), localDayStart(1));
+}
+
+std::vector<ReminderOccurrence> ReminderSystem::getWeekAgenda() {
+    return getAgenda(localDayStart(0), localDayStart(7));
+}
+
+std::vector<ReminderScheduleEntry> ReminderSystem::getPendingSchedule(std::int64_t fromEpoch, std::int64_t untilEpoch) {
     if (reminderDAO) {
-        return reminderDAO->getRemindersDueToday();
+        return reminderDAO->getPendingSchedule(fromEpoch, untilEpoch);
     }
     return {};
 }
 
 bool ReminderSystem::markReminderAsTriggered(int reminderId) {
-    if (reminderDAO) {
-        return reminderDAO->markReminderAsTriggered(reminderId);
+    if (reminderDAO && reminderDAO->markReminderAsTriggered(reminderId)) {
+        notifyScheduleRemoved(reminderId);
+        return true;
     }
     return false;
 }
 
 bool ReminderSystem::rescheduleReminder(int reminderId, const std::string& newTime) {
     if (reminderDAO) {
-        auto timePoint = stringToTimePoint(newTime);
-        if (timePoint.time_since_epoch().count() == 0) {
+        Timestamp newTriggerAt;
+        if (!Timestamp::parseLocal(newTime, newTriggerAt)) {
             std::cerr << "无效的时间格式，无法重新安排提醒: " << newTime << "\n";
             return false;
         }
-        return reminderDAO->rescheduleReminder(reminderId, timePoint);
+        if (!reminderDAO->rescheduleReminder(reminderId, newTriggerAt)) {
+            return false;
+        }
+        // 重新安排后提醒恢复为启用、未触发
+        ScheduleListener listener;
+        {
+            std::lock_guard<std::mutex> lock(listenerMutex);
+            listener = scheduleListener;
+        }
+        if (listener) {
+            listener(reminderId, newTriggerAt);
+        }
+        return true;
     }
     return false;
 }
@@ -320,30 +545,31 @@ bool ReminderSystem::updateReminder(int reminderId,
     if (!title.empty()) updated.title = title;
     if (!message.empty()) updated.message = message;
     if (!recurrence.empty()) {
-        updated.recurrence = recurrence;
+        RecurrenceRule parsedRule;
+        std::string ruleError;
+        if (!RecurrenceRule::parse(recurrence, parsedRule, &ruleError)) {
+            std::cerr << "Invalid recurrence rule, cannot update reminder: " << recurrence << " (" << ruleError << ")\n";
+            return false;
+        }
+        updated.recurrence = parsedRule.category();
         updated.recurrenceRule = recurrence;
-        updated.type = recurrence == "daily" ? ReminderType::DAILY
-            : recurrence == "weekly" ? ReminderType::WEEKLY
-            : recurrence == "monthly" ? ReminderType::MONTHLY
-            : ReminderType::ONCE;
+        updated.type = parsedRule.type();
     }
     if (!time.empty()) {
-        auto tp = stringToTimePoint(time);
-        if (tp.time_since_epoch().count() == 0) {
+        Timestamp newTriggerAt;
+        if (!Timestamp::parseLocal(time, newTriggerAt)) {
             std::cerr << "Invalid time format, cannot update reminder: " << time << "\n";
             return false;
         }
-        updated.trigger_time = time;
-        updated.triggerTime = tp;
+        updated.triggerAt = newTriggerAt;
+        updated.anchorAt = newTriggerAt;
         updated.triggered = false;
     }
-    const int linkedTaskId = taskId;
-    updated.task_id = linkedTaskId;
-    updated.taskId = linkedTaskId;
+    updated.task_id = taskId;
     updated.enabled = enabled;
 
     if (reminderDAO->updateReminder(updated)) {
-        loadRemindersFromDB();
+        notifyScheduleChanged(updated);
         return true;
     }
     return false;
@@ -353,8 +579,8 @@ bool ReminderSystem::deleteReminder(int reminderId) {
     if (reminderDAO) {
         bool result = reminderDAO->deleteReminder(reminderId);
         if (result) {
-            // 重新加载提醒列表以反映删除
-            loadRemindersFromDB();
+            forgetFireTimes(reminderId);
+            notifyScheduleRemoved(reminderId);
         }
         return result;
     }
@@ -368,63 +594,131 @@ void ReminderSystem::notifyUser(const Reminder& reminder) {
     if (reminder.task_id > 0) {
         std::cout << "   关联任务ID: " << reminder.task_id << "\n";
     }
-    std::cout << "   触发时间: " << reminder.trigger_time << "\n\n";
+    std::cout << "   触发时间: " << reminder.triggerAt.toLocalString() << "\n\n";
 }
 
 // 时间工具方法
 std::string ReminderSystem::getCurrentTime() const {
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_time = std::chrono::system_clock::to_time_t(now);
-    return formatTime(now_time);
+    return Timestamp::now().toLocalString();
 }
 
 std::time_t ReminderSystem::parseTimeString(const std::string& timeStr) const {
-    std::tm tm = {};
-    std::istringstream ss(timeStr);
-    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-    if (ss.fail()) {
-        return -1;
-    }
-    return std::mktime(&tm);
+    Timestamp ts;
+    return Timestamp::parseLocal(timeStr, ts) ? ts.toTimeT() : -1;
 }
 
 std::string ReminderSystem::formatTime(std::time_t time) const {
-    std::tm* timeinfo = std::localtime(&time);
-    std::stringstream ss;
-    ss << std::put_time(timeinfo, "%Y-%m-%d %H:%M:%S");
-    return ss.str();
-}
-
-std::chrono::system_clock::time_point ReminderSystem::stringToTimePoint(const std::string& timeStr) const {
-    std::time_t time = parseTimeString(timeStr);
-    if (time == -1) {
-        return std::chrono::system_clock::time_point{};
-    }
-    return std::chrono::system_clock::from_time_t(time);
+    return Timestamp(time).toLocalString();
 }
 
 // ==================== ReminderDaemon 实现 ====================
 
 ReminderDaemon::ReminderDaemon(ReminderSystem& system)
-    : reminderSystem(system) {}
+    : reminderSystem(system) {
+    reminderSystem.setScheduleListener(
+        [this](int reminderId, std::optional<Timestamp> due) {
+            schedule(reminderId, due);
+        });
+}
 
 ReminderDaemon::~ReminderDaemon() {
-    // 停止后台线程
-    running = false;
-    if (worker.joinable()) {
-        worker.join();
+    reminderSystem.setScheduleListener(nullptr);
+    stop();
+}
+
+void ReminderDaemon::schedule(int reminderId, std::optional<Timestamp> due) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // 时间轮中的旧条目保留到其槽位到期，届时因代号不一致被丢弃
+        generations.erase(reminderId);
+        if (due) {
+            const std::int64_t epoch = due->seconds;
+            // 窗口之外的提醒等窗口滑动时再从数据库加载
+            if (epoch < loadedUntil) {
+                enqueue(reminderId, epoch);
+            }
+        }
     }
+    wakeup.notify_one();
+}
+
+void ReminderDaemon::enqueue(int reminderId, std::int64_t dueEpoch) {
+    const std::uint32_t generation = nextGeneration++;
+    if (wheel.insert({dueEpoch, static_cast<std::int32_t>(reminderId), generation})) {
+        generations[reminderId] = generation;
+    }
+}
+
+void ReminderDaemon::loadWindow(std::int64_t fromEpoch, std::int64_t untilEpoch) {
+    for (const auto& entry : reminderSystem.getPendingSchedule(fromEpoch, untilEpoch)) {
+        enqueue(entry.id, entry.triggerEpoch);
+    }
+    loadedUntil = untilEpoch;
+}
+
+void ReminderDaemon::loadPending() {
+    std::lock_guard<std::mutex> lock(mutex);
+    wheel.reset(std::time(nullptr));
+    generations.clear();
+    // 首次加载包含所有已过期但未触发的提醒
+    loadWindow(std::numeric_limits<std::int64_t>::min(), wheel.horizonEnd());
 }
 
 void ReminderDaemon::runLoop() {
-    using namespace std::chrono_literals;
+    std::unique_lock<std::mutex> lock(mutex);
+    std::vector<TimingWheel::Entry> expired;
+    std::vector<int> due;
 
     while (running.load()) {
-        // 定期检查待触发提醒
-        checkPendingReminders();
+        const std::int64_t now = std::time(nullptr);
+        expired.clear();
+        wheel.advance(now, expired);
+
+        // 跨天后窗口向前滑动，只加载新进入窗口的部分
+        if (wheel.horizonEnd() > loadedUntil) {
+            loadWindow(loadedUntil, wheel.horizonEnd());
+        }
+
+        due.clear();
+        for (const auto& entry : expired) {
+            auto it = generations.find(entry.reminderId);
+            if (it != generations.end() && it->second == entry.generation) {
+                generations.erase(it);
+                due.push_back(entry.reminderId);
+            }
+        }
+
+        if (!due.empty()) {
+            // 同一时刻到期的提醒（包括启动后的积压）由一次批量处理完成，只提交一个事务；
+            // 触发过程会访问数据库并回调 schedule()，不能持有锁
+            lock.unlock();
+            const int fired = reminderSystem.fireDueReminders();
+            lock.lock();
+
+            if (fired >= 0) {
+                retryDelaySeconds = 0;
+                continue;
+            }
+            // 写库失败时这一批仍在数据库中待触发，但已移出时间轮，也不会有 schedule() 回调；
+            // 按指数退避重新放回时间轮。期间被改期的提醒已由回调重新登记，不再重复放入；
+            // 被删除的提醒重试时数据库中已不存在，不会触发
+            retryDelaySeconds = retryDelaySeconds == 0
+                ? RETRY_MIN_SECONDS : std::min(retryDelaySeconds * 2, RETRY_MAX_SECONDS);
+            const std::int64_t retryAt = static_cast<std::int64_t>(std::time(nullptr)) + retryDelaySeconds;
+            for (int reminderId : due) {
+                if (generations.count(reminderId) == 0) {
+                    enqueue(reminderId, retryAt);
+                }
+            }
+            continue;
+        }
 
-        // 根据业务场景调整检查频率，例如每 30 秒检查一次
-        std::this_thread::sleep_for(30s);
+        // 至少在下一个天边界醒来一次以滑动窗口；新增/改期/删除/停止都会提前唤醒
+        const std::int64_t nextDay = (now / TimingWheel::SECONDS_PER_DAY + 1) * TimingWheel::SECONDS_PER_DAY;
+        const std::int64_t wakeAt = std::min(wheel.nextWakeEpoch(), nextDay);
+        if (wakeAt > now) {
+            wakeup.wait_until(lock, std::chrono::system_clock::from_time_t(static_cast<std::time_t>(wakeAt)));
+        }
     }
 }
 
@@ -434,29 +728,40 @@ void ReminderDaemon::startChecking() {
         return;
     }
 
+    loadPending();
     running = true;
     worker = std::thread(&ReminderDaemon::runLoop, this);
 }
 
+void ReminderDaemon::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wakeup.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
 void ReminderDaemon::checkPendingReminders() {
-    reminderSystem.checkDueReminders();
+    loadPending();
+    wakeup.notify_one();
 }
 
 void ReminderDaemon::triggerReminder(int reminderId) {
-    // 从业务角度看，这里可以理解为“手动立即触发某个提醒”
-    auto activeReminders = reminderSystem.getActiveReminders();
-    for (auto& reminder : activeReminders) {
-        if (reminder.id == reminderId) {
-            // 触发通知
-            reminderSystem.notifyUser(reminder);
-
-            // 标记为已触发并处理重复逻辑
-            if (reminderSystem.markReminderAsTriggered(reminder.id)) {
-                if (reminder.recurrence != "once") {
-                    reminderSystem.processRecurringReminder(reminder);
-                }
-            }
-            break;
-        }
+    // 触发前重新读取，提醒可能已被禁用或已手动触发
+    auto reminder = reminderSystem.getReminder(reminderId);
+    if (!reminder.has_value() || !reminder->enabled || reminder->triggered) {
+        return;
     }
+
+    reminderSystem.notifyUser(*reminder);
+
+    reminderSystem.finishOccurrence(*reminder);
+}
+
+size_t ReminderDaemon::pendingCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return generations.size();
 }
@@ -0,0 +1,146 @@
+#include "reminder/TimingWheel.h"
+#include <algorithm>
+#include <limits>
+
+TimingWheel::TimingWheel(std::int64_t nowEpoch) {
+    // 秒轮 60 × 1s，分轮 60 × 1min，时轮 24 × 1h，天轮 7 × 1d
+    const std::int64_t resolutions[LEVEL_COUNT] = {1, 60, 3600, SECONDS_PER_DAY};
+    const size_t slotCounts[LEVEL_COUNT] = {60, 60, 24, static_cast<size_t>(HORIZON_DAYS)};
+    for (size_t i = 0; i < LEVEL_COUNT; ++i) {
+        levels[i].resolution = resolutions[i];
+        levels[i].slots.resize(slotCounts[i]);
+    }
+    reset(nowEpoch);
+}
+
+void TimingWheel::reset(std::int64_t nowEpoch) {
+    for (auto& level : levels) {
+        for (auto& slot : level.slots) {
+            // 释放容量，避免一次大批量加载后长期占用内存
+            std::vector<Entry>().swap(slot);
+        }
+        level.count = 0;
+    }
+    std::vector<Entry>().swap(ready);
+    tick = nowEpoch;
+    total = 0;
+}
+
+std::int64_t TimingWheel::span(size_t level) const {
+    return levels[level].resolution * static_cast<std::int64_t>(levels[level].slots.size());
+}
+
+std::int64_t TimingWheel::horizonEnd() const {
+    return (tick / SECONDS_PER_DAY + HORIZON_DAYS) * SECONDS_PER_DAY;
+}
+
+bool TimingWheel::insert(const Entry& entry) {
+    if (entry.dueEpoch >= horizonEnd()) {
+        return false;
+    }
+    place(entry);
+    ++total;
+    return true;
+}
+
+void TimingWheel::place(const Entry& entry) {
+    const std::int64_t delta = entry.dueEpoch - tick;
+    if (delta <= 0) {
+        ready.push_back(entry);
+        return;
+    }
+
+    // 放进能覆盖该时间差的最低一层；槽位按绝对时间取模，推进到对应边界时正好被级联
+    for (size_t i = 0; i < LEVEL_COUNT; ++i) {
+        if (delta < span(i) || i + 1 == LEVEL_COUNT) {
+            auto& level = levels[i];
+            level.slots[static_cast<size_t>(entry.dueEpoch / level.resolution) % level.slots.size()].push_back(entry);
+            ++level.count;
+            return;
+        }
+    }
+}
+
+void TimingWheel::cascade(size_t levelIndex) {
+    auto& level = levels[levelIndex];
+    auto& slot = level.slots[static_cast<size_t>(tick / level.resolution) % level.slots.size()];
+    if (slot.empty()) {
+        return;
+    }
+
+    std::vector<Entry> entries;
+    entries.swap(slot);
+    level.count -= entries.size();
+    for (const auto& entry : entries) {
+        place(entry);
+    }
+}
+
+void TimingWheel::advance(std::int64_t nowEpoch, std::vector<Entry>& expired) {
+    while (tick < nowEpoch) {
+        if (levels[0].count == 0) {
+            // 秒轮为空时直接跳到最低非空层的下一个边界，长时间休眠后无需逐秒推进
+            size_t next = 1;
+            while (next < LEVEL_COUNT && levels[next].count == 0) ++next;
+            if (next == LEVEL_COUNT) {
+                tick = nowEpoch;
+                break;
+            }
+            const std::int64_t resolution = levels[next].resolution;
+            tick = std::min(nowEpoch, (tick / resolution + 1) * resolution) - 1;
+        }
+
+        ++tick;
+        // 先级联高层，天 → 时 → 分，条目逐层下沉到秒轮
+        for (size_t i = LEVEL_COUNT - 1; i > 0; --i) {
+            if (tick % levels[i].resolution == 0) {
+                cascade(i);
+            }
+        }
+
+        auto& slot = levels[0].slots[static_cast<size_t>(tick % 60)];
+        if (!slot.empty()) {
+            levels[0].count -= slot.size();
+            total -= slot.size();
+            expired.insert(expired.end(), slot.begin(), slot.end());
+            slot.clear();
+        }
+    }
+
+    if (!ready.empty()) {
+        total -= ready.size();
+        expired.insert(expired.end(), ready.begin(), ready.end());
+        ready.clear();
+    }
+}
+
+std::int64_t TimingWheel::nextWakeEpoch() const {
+    if (!ready.empty()) {
+        return tick;
+    }
+
+    std::int64_t best = std::numeric_limits<std::int64_t>::max();
+    if (levels[0].count > 0) {
+        for (std::int64_t i = 1; i <= 60; ++i) {
+            if (!levels[0].slots[static_cast<size_t>((tick + i) % 60)].empty()) {
+                best = tick + i;
+                break;
+            }
+        }
+    }
+
+    // 上层条目要等到所在槽位的边界级联后才知道精确时间，在边界处醒来一次
+    for (size_t i = 1; i < LEVEL_COUNT; ++i) {
+        const auto& level = levels[i];
+        if (level.count == 0) continue;
+        const auto slotCount = static_cast<std::int64_t>(level.slots.size());
+        for (std::int64_t k = 1; k <= slotCount; ++k) {
+            const std::int64_t boundary = tick / level.resolution + k;
+            if (!level.slots[static_cast<size_t>(boundary % slotCount)].empty()) {
+                best = std::min(best, boundary * level.resolution);
+                break;
+            }
+        }
+    }
+    return best;
+}
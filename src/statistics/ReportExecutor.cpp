@@ -0,0 +1,83 @@
+#include "statistics/ReportExecutor.h"
+#include "database/DatabaseManager.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+ReportExecutor::ReportExecutor(size_t maxParallel)
+    : maxParallel(maxParallel != 0 ? maxParallel
+                                   : DatabaseManager::getInstance().getMaxReadConnections()) {
+}
+
+ReportExecutor::NodeId ReportExecutor::add(std::function<void()> task,
+                                           const std::vector<NodeId>& dependencies) {
+    NodeId id = nodes.size();
+    nodes.push_back(Node{std::move(task), {}, 0, false, nullptr});
+
+    for (NodeId dep : dependencies) {
+        if (dep < id) {
+            nodes[dep].dependents.push_back(id);
+            nodes[id].pendingDependencies++;
+        }
+    }
+    return id;
+}
+
+void ReportExecutor::run() {
+    if (nodes.empty()) return;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<NodeId> ready;
+    size_t remaining = nodes.size();
+
+    for (NodeId id = 0; id < nodes.size(); ++id) {
+        if (nodes[id].pendingDependencies == 0) ready.push_back(id);
+    }
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cv.wait(lock, [&] { return !ready.empty() || remaining == 0; });
+            if (remaining == 0) return;
+
+            NodeId id = ready.front();
+            ready.pop_front();
+
+            Node& node = nodes[id];
+            lock.unlock();
+            // 异常不能逃出工作线程（会直接 std::terminate），先记在节点上
+            if (node.task && !node.skipped) {
+                try {
+                    node.task();
+                } catch (...) {
+                    node.error = std::current_exception();
+                }
+            }
+            lock.lock();
+
+            remaining--;
+            const bool failed = node.skipped || node.error;
+            for (NodeId next : node.dependents) {
+                if (failed) nodes[next].skipped = true;
+                if (--nodes[next].pendingDependencies == 0) ready.push_back(next);
+            }
+            cv.notify_all();
+        }
+    };
+
+    // 当前线程也参与执行，额外线程数不超过并行度
+    size_t threadCount = std::min(maxParallel, nodes.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads) t.join();
+
+    for (const Node& node : nodes) {
+        if (node.error) std::rethrow_exception(node.error);
+    }
+}
@@ -1,12 +1,16 @@
 #include "statistics/StatisticsAnalyzer.h"
+#include "statistics/StreakTracker.h"
+#include "statistics/ReportExecutor.h"
 #include <iostream>
 #include <sstream>
 #include <ctime>
 #include <iomanip>
 #include <sqlite3.h>
+#include <chrono>
 
 StatisticsAnalyzer::StatisticsAnalyzer() {
     dbManager = &DatabaseManager::getInstance();
+    statsDAO = createStatisticsDAO();
     if (!dbManager->isOpen()) {
         cerr << "⚠️  警告: 数据库未打开，StatisticsAnalyzer可能无法正常工作" << endl;
     }
@@ -21,15 +25,19 @@ StatisticsAnalyzer::~StatisticsAnalyzer() {
 int StatisticsAnalyzer::queryInt(const string& sql) {
     if (!dbManager->isOpen()) return 0;
     
-    sqlite3* db = dbManager->getRawConnection();
-    sqlite3_stmt* stmt;
+    // 统计查询走只读连接池，可与写操作及其他统计查询并发执行
+    ReadConnectionLease conn = dbManager->acquireReadConnection();
+    if (!conn) return 0;
+    
+    // 这里的 SQL 都是常量，预编译语句按连接缓存复用
+    sqlite3_stmt* stmt = conn.prepare(sql);
     int result = 0;
     
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+    if (stmt) {
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             result = sqlite3_column_int(stmt, 0);
         }
-        sqlite3_finalize(stmt);
+        sqlite3_reset(stmt);
     }
     
     return result;
@@ -38,15 +46,17 @@ int StatisticsAnalyzer::queryInt(const string& sql) {
 double StatisticsAnalyzer::queryDouble(const string& sql) {
     if (!dbManager->isOpen()) return 0.0;
     
-    sqlite3* db = dbManager->getRawConnection();
-    sqlite3_stmt* stmt;
+    ReadConnectionLease conn = dbManager->acquireReadConnection();
+    if (!conn) return 0.0;
+    
+    sqlite3_stmt* stmt = conn.prepare(sql);
     double result = 0.0;
     
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+    if (stmt) {
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             result = sqlite3_column_double(stmt, 0);
         }
-        sqlite3_finalize(stmt);
+        sqlite3_reset(stmt);
     }
     
     return result;
@@ -90,7 +100,7 @@ string StatisticsAnalyzer::getMonthStartDate() {
 // === 任务统计 ===
 
 int StatisticsAnalyzer::getTotalTasksCompleted() {
-    string sql = "SELECT COUNT(*) FROM tasks WHERE completed = 1;";
+    string sql = "SELECT COUNT(*) FROM tasks WHERE completed = 1 AND deleted = 0;";
     return queryInt(sql);
 }
 
@@ -109,22 +119,25 @@ double StatisticsAnalyzer::getCompletionRate() {
 
 // === 时间维度统计 ===
 
+int StatisticsAnalyzer::countCompletedSince(int startDay) {
+    auto now = chrono::system_clock::now();
+    auto start = now - chrono::hours(24) * (StreakTracker::today() - startDay);
+    return statsDAO->getCompletedCount(start, now);
+}
+
 int StatisticsAnalyzer::getTasksCompletedToday() {
-    string today = getCurrentDate();
-    string sql = "SELECT COUNT(*) FROM tasks WHERE completed = 1 AND DATE(completed_date) = '" + today + "';";
-    return queryInt(sql);
+    return countCompletedSince(StreakTracker::today());
 }
 
 int StatisticsAnalyzer::getTasksCompletedThisWeek() {
-    string weekStart = getWeekStartDate();
-    string sql = "SELECT COUNT(*) FROM tasks WHERE completed = 1 AND DATE(completed_date) >= '" + weekStart + "';";
-    return queryInt(sql);
+    int today = StreakTracker::today();
+    return countCompletedSince(today - (today + 3) % 7);  // 本周一
 }
 
 int StatisticsAnalyzer::getTasksCompletedThisMonth() {
-    string monthStart = getMonthStartDate();
-    string sql = "SELECT COUNT(*) FROM tasks WHERE completed = 1 AND DATE(completed_date) >= '" + monthStart + "';";
-    return queryInt(sql);
+    int today = StreakTracker::today();
+    string monthStart = StreakTracker::dateFromDay(today).substr(0, 8) + "01";
+    return countCompletedSince(StreakTracker::dayFromDate(monthStart));
 }
 
 // === 生产力分析 ===
@@ -133,37 +146,26 @@ double StatisticsAnalyzer::getAverageTasksPerDay() {
     string sql = R"(
         SELECT COUNT(*) / (julianday('now') - julianday(MIN(created_date))) 
         FROM tasks 
-        WHERE completed = 1;
+        WHERE completed = 1 AND deleted = 0;
     )";
     return queryDouble(sql);
 }
 
 vector<int> StatisticsAnalyzer::getWeeklyTrends(int weeks) {
-    vector<int> trends;
-    
-    for (int i = 0; i < weeks; i++) {
-        // 计算每周的起始和结束日期
-        time_t now = time(nullptr);
-        time_t weekStart = now - ((i + 1) * 7 * 24 * 3600);
-        time_t weekEnd = now - (i * 7 * 24 * 3600);
-        
-        tm* startTm = localtime(&weekStart);
-        tm* endTm = localtime(&weekEnd);
-        
-        stringstream startSs, endSs;
-        startSs << (1900 + startTm->tm_year) << "-"
-                << setfill('0') << setw(2) << (1 + startTm->tm_mon) << "-"
-                << setfill('0') << setw(2) << startTm->tm_mday;
-        
-        endSs << (1900 + endTm->tm_year) << "-"
-              << setfill('0') << setw(2) << (1 + endTm->tm_mon) << "-"
-              << setfill('0') << setw(2) << endTm->tm_mday;
-        
-        string sql = "SELECT COUNT(*) FROM tasks WHERE completed = 1 "
-                    "AND DATE(completed_date) >= '" + startSs.str() + "' "
-                    "AND DATE(completed_date) < '" + endSs.str() + "';";
-        
-        trends.push_back(queryInt(sql));
+    vector<int> trends(weeks > 0 ? weeks : 0, 0);
+    if (weeks <= 0) return trends;
+    
+    // 一次按天分组查询覆盖全部周数，再在内存中分桶（第 0 个元素为最近 7 天）
+    int today = StreakTracker::today();
+    auto now = chrono::system_clock::now();
+    auto start = now - chrono::hours(24) * (weeks * 7 - 1);
+    
+    for (const auto& [tp, count] : statsDAO->getCompletionCountByDate(start, now)) {
+        time_t t = chrono::system_clock::to_time_t(tp);
+        int week = (today - static_cast<int>(t / 86400)) / 7;
+        if (week >= 0 && week < weeks) {
+            trends[week] += count;
+        }
     }
     
     return trends;
@@ -172,83 +174,41 @@ vector<int> StatisticsAnalyzer::getWeeklyTrends(int weeks) {
 // === 连续打卡统计 ===
 
 int StatisticsAnalyzer::getCurrentStreak() {
-    string sql = "SELECT current_streak FROM user_stats WHERE id = 1;";
-    return queryInt(sql);
+    return StreakTracker::getInstance().getCurrentStreak();
 }
 
 int StatisticsAnalyzer::getLongestStreak() {
-    string sql = "SELECT longest_streak FROM user_stats WHERE id = 1;";
-    return queryInt(sql);
+    return StreakTracker::getInstance().getLongestStreak();
+}
+
+vector<StreakRecord> StatisticsAnalyzer::getStreakHistory() {
+    return StreakTracker::getInstance().getStreakHistory();
 }
 
 void StatisticsAnalyzer::updateStreak() {
     if (!dbManager->isOpen()) return;
     
-    string today = getCurrentDate();
-    
-    // 获取上次活跃日期
-    string sql = "SELECT last_active_date FROM user_stats WHERE id = 1;";
-    sqlite3* db = dbManager->getRawConnection();
-    sqlite3_stmt* stmt;
-    string lastActiveDate;
-    
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            const char* date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            if (date) lastActiveDate = date;
-        }
-        sqlite3_finalize(stmt);
-    }
-    
-    // 如果今天已经更新过，直接返回
-    if (lastActiveDate == today) return;
-    
-    int currentStreak = getCurrentStreak();
-    int longestStreak = getLongestStreak();
-    
-    // 计算日期差
-    time_t now = time(nullptr);
-    tm ltm = {};
-    std::istringstream ss(lastActiveDate);
-    ss >> std::get_time(&ltm, "%Y-%m-%d");
-    time_t lastTime = mktime(&ltm);
-    int daysDiff = (now - lastTime) / (24 * 3600);
-    
-    // 更新连续打卡
-    if (daysDiff == 1) {
-        // 连续打卡
-        currentStreak++;
-        if (currentStreak > longestStreak) {
-            longestStreak = currentStreak;
-        }
-    } else if (daysDiff > 1) {
-        // 打卡中断
-        currentStreak = 1;
-    }
-    
-    // 更新数据库
-    stringstream updateSql;
-    updateSql << "UPDATE user_stats SET "
-              << "current_streak = " << currentStreak << ", "
-              << "longest_streak = " << longestStreak << ", "
-              << "last_active_date = '" << today << "' "
-              << "WHERE id = 1;";
-    
-    dbManager->execute(updateSql.str());
+    // 连续天数由 StreakTracker 根据完成记录推导，这里只把结果同步到 user_stats 供其他模块读取
+    StreakTracker& tracker = StreakTracker::getInstance();
+    dbManager->executeParameterized(
+        "UPDATE user_stats SET current_streak = ?, longest_streak = ?, "
+        "last_active_date = ?, updated_date = datetime('now') WHERE id = 1;",
+        { to_string(tracker.getCurrentStreak()),
+          to_string(tracker.getLongestStreak()),
+          getCurrentDate() });
 }
 
 // === 番茄钟统计 ===
 
 int StatisticsAnalyzer::getTotalPomodoros() {
-    string sql = "SELECT SUM(pomodoro_count) FROM tasks;";
+    // 以完成的番茄钟会话为准（含未关联任务的会话），与 PomodoroCompleted 事件同源
+    string sql = "SELECT COUNT(*) FROM pomodoro_sessions WHERE completed = 1;";
     return queryInt(sql);
 }
 
 int StatisticsAnalyzer::getPomodorosToday() {
-    string today = getCurrentDate();
-    string sql = "SELECT total_pomodoros FROM user_stats WHERE id = 1;";
-    // 注意：这个需要配合Pomodoro模块实时更新
-    return queryInt(sql);
+    // pomodoro_sessions 按 start_day 区间统计今天已完成的会话
+    return statsDAO->getPomodoroFocusByDay(chrono::system_clock::now(), 1).front().completed;
 }
 
 // === 项目统计 ===
@@ -271,13 +231,11 @@ int StatisticsAnalyzer::getCompletedProjects() {
 // === 游戏化统计 ===
 
 int StatisticsAnalyzer::getAchievementsUnlocked() {
-    string sql = "SELECT COUNT(*) FROM achievements WHERE unlocked = 1;";
-    return queryInt(sql);
+    return statsDAO->getAchievementUnlockStats().totalUnlocked;
 }
 
 int StatisticsAnalyzer::getChallengesCompleted() {
-    string sql = "SELECT COUNT(*) FROM challenges WHERE completed = 1;";
-    return queryInt(sql);
+    return statsDAO->getChallengeCompletionStats().totalChallengesCompleted;
 }
 
 // === 报告生成 ===
@@ -350,6 +308,26 @@ string StatisticsAnalyzer::generateWeeklyReport() {
 }
 
 string StatisticsAnalyzer::generateMonthlyReport() {
+    // 各项统计互不依赖，先并行查询，全部完成后再统一格式化
+    int monthTasks = 0, totalTasks = 0, totalCreated = 0, totalPomodoros = 0;
+    int achievements = 0, challenges = 0, projects = 0, completedProjects = 0;
+    double completionRate = 0.0, avgProgress = 0.0;
+    
+    ReportExecutor executor;
+    executor.add([&] { monthTasks = getTasksCompletedThisMonth(); });
+    auto completedNode = executor.add([&] { totalTasks = getTotalTasksCompleted(); });
+    auto createdNode = executor.add([&] { totalCreated = getTotalTasksCreated(); });
+    executor.add([&] {
+        completionRate = totalCreated == 0 ? 0.0 : (double)totalTasks / totalCreated * 100;
+    }, {completedNode, createdNode});
+    executor.add([&] { totalPomodoros = getTotalPomodoros(); });
+    executor.add([&] { achievements = getAchievementsUnlocked(); });
+    executor.add([&] { challenges = getChallengesCompleted(); });
+    executor.add([&] { projects = getTotalProjects(); });
+    executor.add([&] { completedProjects = getCompletedProjects(); });
+    executor.add([&] { avgProgress = getAverageProjectProgress() * 100; });
+    executor.run();
+    
     stringstream report;
     
     report << "\n";
@@ -359,26 +337,15 @@ string StatisticsAnalyzer::generateMonthlyReport() {
     report << "月份起始: " << getMonthStartDate() << "\n";
     report << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
     
-    int monthTasks = getTasksCompletedThisMonth();
-    int totalTasks = getTotalTasksCompleted();
-    double completionRate = getCompletionRate() * 100;
-    int totalPomodoros = getTotalPomodoros();
-    
     report << "✅ 本月完成任务: " << monthTasks << " 个\n";
     report << "📊 总完成任务: " << totalTasks << " 个\n";
     report << "💯 完成率: " << fixed << setprecision(1) << completionRate << "%\n";
     report << "🍅 总番茄钟数: " << totalPomodoros << " 个\n";
     
-    int achievements = getAchievementsUnlocked();
-    int challenges = getChallengesCompleted();
     report << "\n🎮 游戏化进展:\n";
     report << "  ⭐ 已解锁成就: " << achievements << " 个\n";
     report << "  🏆 已完成挑战: " << challenges << " 个\n";
     
-    int projects = getTotalProjects();
-    int completedProjects = getCompletedProjects();
-    double avgProgress = getAverageProjectProgress() * 100;
-    
     report << "\n📁 项目统计:\n";
     report << "  总项目数: " << projects << " 个\n";
     report << "  已完成: " << completedProjects << " 个\n";
@@ -392,6 +359,28 @@ string StatisticsAnalyzer::generateMonthlyReport() {
 }
 
 string StatisticsAnalyzer::generateSummary() {
+    int totalCreated = 0, totalCompleted = 0;
+    int todayTasks = 0, weekTasks = 0, monthTasks = 0;
+    int currentStreak = 0, longestStreak = 0, projects = 0, achievements = 0;
+    double rate = 0.0;
+    
+    ReportExecutor executor;
+    auto createdNode = executor.add([&] { totalCreated = getTotalTasksCreated(); });
+    auto completedNode = executor.add([&] { totalCompleted = getTotalTasksCompleted(); });
+    executor.add([&] {
+        rate = totalCreated == 0 ? 0.0 : (double)totalCompleted / totalCreated * 100;
+    }, {createdNode, completedNode});
+    executor.add([&] { todayTasks = getTasksCompletedToday(); });
+    executor.add([&] { weekTasks = getTasksCompletedThisWeek(); });
+    executor.add([&] { monthTasks = getTasksCompletedThisMonth(); });
+    executor.add([&] {
+        currentStreak = getCurrentStreak();
+        longestStreak = getLongestStreak();
+    });
+    executor.add([&] { projects = getTotalProjects(); });
+    executor.add([&] { achievements = getAchievementsUnlocked(); });
+    executor.run();
+    
     stringstream summary;
     
     summary << "\n";
@@ -399,34 +388,20 @@ string StatisticsAnalyzer::generateSummary() {
     summary << "║          🎯 统计数据总览                          ║\n";
     summary << "╚═══════════════════════════════════════════════════╝\n\n";
     
-    int totalCreated = getTotalTasksCreated();
-    int totalCompleted = getTotalTasksCompleted();
-    double rate = getCompletionRate() * 100;
-    
     summary << "📋 任务统计:\n";
     summary << "  ├─ 总创建: " << totalCreated << " 个\n";
     summary << "  ├─ 总完成: " << totalCompleted << " 个\n";
     summary << "  └─ 完成率: " << fixed << setprecision(1) << rate << "%\n\n";
     
-    int todayTasks = getTasksCompletedToday();
-    int weekTasks = getTasksCompletedThisWeek();
-    int monthTasks = getTasksCompletedThisMonth();
-    
     summary << "📆 时间维度:\n";
     summary << "  ├─ 今日: " << todayTasks << " 个\n";
     summary << "  ├─ 本周: " << weekTasks << " 个\n";
     summary << "  └─ 本月: " << monthTasks << " 个\n\n";
     
-    int currentStreak = getCurrentStreak();
-    int longestStreak = getLongestStreak();
-    
     summary << "🔥 连续打卡:\n";
     summary << "  ├─ 当前: " << currentStreak << " 天\n";
     summary << "  └─ 最长: " << longestStreak << " 天\n\n";
     
-    int projects = getTotalProjects();
-    int achievements = getAchievementsUnlocked();
-    
     summary << "🎮 其他统计:\n";
     summary << "  ├─ 活跃项目: " << projects << " 个\n";
     summary << "  └─ 解锁成就: " << achievements << " 个\n\n";
@@ -443,29 +418,15 @@ map<string, int> StatisticsAnalyzer::getTaskCompletionData(int days) {
     
     if (!dbManager->isOpen()) return data;
     
-    // 查询过去N天的任务完成数据
-    stringstream sql;
-    sql << "SELECT DATE(completed_date) as date, COUNT(*) as count "
-        << "FROM tasks "
-        << "WHERE completed = 1 "
-        << "AND DATE(completed_date) >= DATE('now', '-" << days << " days') "
-        << "GROUP BY DATE(completed_date) "
-        << "ORDER BY date;";
-    
-    sqlite3* db = dbManager->getRawConnection();
-    sqlite3_stmt* stmt;
-    
-    if (sqlite3_prepare_v2(db, sql.str().c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            const char* dateStr = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            int count = sqlite3_column_int(stmt, 1);
-            
-            if (dateStr) {
-                data[string(dateStr)] = count;
-            }
+    for (const auto& entry : statsDAO->getHeatmapData(days)) {
+        if (entry.taskCount > 0) {
+            data[entry.date] = entry.taskCount;
         }
-        sqlite3_finalize(stmt);
     }
     
     return data;
 }
+
+StatisticsDAO& StatisticsAnalyzer::getStatisticsDAO() {
+    return *statsDAO;
+}
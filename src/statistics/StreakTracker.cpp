@@ -0,0 +1,159 @@
+#include "statistics/StreakTracker.h"
+#include "database/DatabaseManager.h"
+#include <iostream>
+#include <climits>
+#include <algorithm>
+
+namespace {
+    // 直接读取整数天数，走 idx_tasks_completed_day，无需 DATE() 与字符串解析；
+    // 已删除的任务不计入，删除已完成任务后重新加载时它的日期不会回到连续记录里
+    const char* SELECT_COMPLETION_DAYS_SQL =
+        "SELECT DISTINCT completed_day FROM tasks "
+        "WHERE completed = 1 AND deleted = 0 AND completed_day IS NOT NULL "
+        "ORDER BY 1;";
+}
+
+StreakTracker& StreakTracker::getInstance() {
+    static StreakTracker instance;
+    return instance;
+}
+
+// === 日期工具 ===
+
+int StreakTracker::today() {
+    return DayNumber::todayUtc().value;
+}
+
+int StreakTracker::dayFromDate(const std::string& date) {
+    DayNumber day;
+    return DayNumber::parse(date, day) ? day.value : INT_MIN;
+}
+
+std::string StreakTracker::dateFromDay(int day) {
+    return DayNumber(day).toString();
+}
+
+// === 加载与增量更新 ===
+
+void StreakTracker::ensureLoaded() {
+    if (!loaded) {
+        loadFromDatabase();
+        loaded = true;
+    }
+}
+
+void StreakTracker::loadFromDatabase() {
+    runs.clear();
+    longestStreak = 0;
+
+    auto& dbManager = DatabaseManager::getInstance();
+    if (!dbManager.isOpen()) return;
+
+    // 结果按日期升序返回，顺序扫描一次即可合并出所有连续区间
+    dbManager.executeQuery(SELECT_COMPLETION_DAYS_SQL, [this](sqlite3_stmt* stmt) {
+        const int day = sqlite3_column_int(stmt, 0);
+
+        if (!runs.empty() && std::prev(runs.end())->second + 1 >= day) {
+            auto& last = std::prev(runs.end())->second;
+            last = std::max(last, day);
+        } else {
+            runs.emplace(day, day);
+        }
+        return true;
+    });
+
+    for (const auto& [start, end] : runs) {
+        longestStreak = std::max(longestStreak, end - start + 1);
+    }
+}
+
+void StreakTracker::insertDay(int day) {
+    // 找到起始日 <= day 的最后一个区间
+    auto it = runs.upper_bound(day);
+    if (it != runs.begin()) {
+        auto prev = std::prev(it);
+        if (prev->second >= day) return;  // 已记录
+        if (prev->second + 1 == day) {
+            prev->second = day;
+            // 与后一个区间相接时合并
+            if (it != runs.end() && it->first == day + 1) {
+                prev->second = it->second;
+                runs.erase(it);
+            }
+            longestStreak = std::max(longestStreak, prev->second - prev->first + 1);
+            return;
+        }
+    }
+
+    if (it != runs.end() && it->first == day + 1) {
+        int end = it->second;
+        runs.erase(it);
+        runs.emplace(day, end);
+        longestStreak = std::max(longestStreak, end - day + 1);
+        return;
+    }
+
+    runs.emplace(day, day);
+    longestStreak = std::max(longestStreak, 1);
+}
+
+int StreakTracker::currentStreakLocked(int todayDay) const {
+    if (runs.empty()) return 0;
+
+    // 今天还没完成任务时，昨天结束的连续记录仍然有效
+    const auto& last = *std::prev(runs.end());
+    if (last.second < todayDay - 1) return 0;
+    return last.second - last.first + 1;
+}
+
+bool StreakTracker::recordCompletion(int day) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!loaded) {
+        // 尚未加载时无需增量维护，首次读取会从数据库拿到包含本次完成的完整数据
+        return false;
+    }
+
+    int before = currentStreakLocked(today());
+    insertDay(day);
+    return currentStreakLocked(today()) != before;
+}
+
+void StreakTracker::invalidate() {
+    std::lock_guard<std::mutex> lock(mutex);
+    loaded = false;
+}
+
+// === 读取 ===
+
+int StreakTracker::getCurrentStreak() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ensureLoaded();
+    return currentStreakLocked(today());
+}
+
+int StreakTracker::getLongestStreak() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ensureLoaded();
+    return longestStreak;
+}
+
+std::vector<StreakRecord> StreakTracker::getStreakHistory() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ensureLoaded();
+
+    std::vector<StreakRecord> history;
+    history.reserve(runs.size());
+
+    const int todayDay = today();
+    int id = 1;
+    for (const auto& [start, end] : runs) {
+        StreakRecord record;
+        record.id = id++;
+        record.startDate = dateFromDay(start);
+        record.endDate = dateFromDay(end);
+        record.durationDays = end - start + 1;
+        record.isActive = end >= todayDay - 1;
+        history.push_back(record);
+    }
+    return history;
+}
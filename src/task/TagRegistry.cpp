@@ -0,0 +1,162 @@
+#include "task/TagRegistry.h"
+#include "database/DatabaseManager.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+namespace {
+    static constexpr const char* SQL_LOAD_TAGS = "SELECT id, name FROM tags;";
+    static constexpr const char* SQL_INSERT_TAG =
+        "INSERT INTO tags (name) VALUES (?1) ON CONFLICT(name) DO NOTHING;";
+    static constexpr const char* SQL_SELECT_TAG = "SELECT id, name FROM tags WHERE name = ?1;";
+
+    // 中文逗号（U+FF0C）的 UTF-8 编码，与半角逗号同样作为分隔符
+    static constexpr const char* FULLWIDTH_COMMA = "\xEF\xBC\x8C";
+
+    std::string lowerKey(const std::string& name) {
+        std::string key = name;
+        for (char& c : key) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return key;
+    }
+
+    std::string trim(const std::string& s) {
+        const char* spaces = " \t\r\n";
+        size_t begin = s.find_first_not_of(spaces);
+        if (begin == std::string::npos) return "";
+        size_t end = s.find_last_not_of(spaces);
+        return s.substr(begin, end - begin + 1);
+    }
+}
+
+TagRegistry& TagRegistry::getInstance() {
+    static TagRegistry instance;
+    return instance;
+}
+
+std::vector<std::string> TagRegistry::parse(const std::string& tags) {
+    std::vector<std::string> result;
+    std::vector<std::string> keys;
+    auto add = [&](const std::string& raw) {
+        std::string tag = trim(raw);
+        if (tag.empty()) return;
+        std::string key = lowerKey(tag);
+        if (std::find(keys.begin(), keys.end(), key) != keys.end()) return;
+        keys.push_back(std::move(key));
+        result.push_back(std::move(tag));
+    };
+
+    size_t start = 0;
+    for (size_t i = 0; i < tags.size();) {
+        if (tags[i] == ',') {
+            add(tags.substr(start, i - start));
+            start = ++i;
+        } else if (tags.compare(i, 3, FULLWIDTH_COMMA) == 0) {
+            add(tags.substr(start, i - start));
+            i += 3;
+            start = i;
+        } else {
+            ++i;
+        }
+    }
+    add(tags.substr(start));
+    return result;
+}
+
+std::string TagRegistry::join(const std::vector<std::string>& tags) {
+    std::string joined;
+    for (const auto& tag : tags) {
+        if (!joined.empty()) joined += ',';
+        joined += tag;
+    }
+    return joined;
+}
+
+void TagRegistry::remember(int id, const std::string& name) {
+    ids[lowerKey(name)] = id;
+    names[id] = name;
+}
+
+bool TagRegistry::ensureLoaded() {
+    if (loaded) return true;
+
+    auto& dbManager = DatabaseManager::getInstance();
+    if (!dbManager.isOpen()) return false;
+
+    ids.clear();
+    names.clear();
+    loaded = dbManager.executeQuery(SQL_LOAD_TAGS, [this](sqlite3_stmt* stmt) {
+        const char* name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        remember(sqlite3_column_int(stmt, 0), name ? name : "");
+        return true;
+    });
+    return loaded;
+}
+
+int TagRegistry::intern(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (name.empty() || !ensureLoaded()) return -1;
+
+    auto it = ids.find(lowerKey(name));
+    if (it != ids.end()) return it->second;
+
+    sqlite3* db = DatabaseManager::getInstance().getRawConnection();
+    if (!db) return -1;
+
+    // 插入后再按名称查询：大小写不同的同名标签已存在时取回已有的 id
+    int id = -1;
+    std::string stored;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, SQL_INSERT_TAG, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) == SQLITE_DONE) {
+            sqlite3_finalize(stmt);
+            stmt = nullptr;
+            if (sqlite3_prepare_v2(db, SQL_SELECT_TAG, -1, &stmt, nullptr) == SQLITE_OK) {
+                sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+                if (sqlite3_step(stmt) == SQLITE_ROW) {
+                    id = sqlite3_column_int(stmt, 0);
+                    const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+                    stored = text ? text : name;
+                }
+            }
+        }
+    }
+    if (id < 0) {
+        std::cerr << "写入标签失败: " << sqlite3_errmsg(db) << std::endl;
+    }
+    sqlite3_finalize(stmt);
+
+    if (id >= 0) remember(id, stored);
+    return id;
+}
+
+std::optional<int> TagRegistry::find(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ensureLoaded()) return std::nullopt;
+    auto it = ids.find(lowerKey(trim(name)));
+    if (it == ids.end()) return std::nullopt;
+    return it->second;
+}
+
+std::string TagRegistry::nameOf(int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ensureLoaded()) return "";
+    auto it = names.find(id);
+    if (it == names.end()) {
+        // 其他进程新建的标签：重新加载一次
+        loaded = false;
+        if (!ensureLoaded()) return "";
+        it = names.find(id);
+    }
+    return it == names.end() ? "" : it->second;
+}
+
+void TagRegistry::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    loaded = false;
+    ids.clear();
+    names.clear();
+}
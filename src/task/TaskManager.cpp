@@ -1,6 +1,32 @@
 #include "task/TaskManager.h"
+#include "statistics/StreakTracker.h"
+#include "gamification/EventBus.h"
 #include <iostream>
 
+namespace {
+    GameEvent taskEvent(GameEventType type, const Task& task) {
+        return {type, 1, 1, task.getPriority(), task.getProjectId().value_or(-1)};
+    }
+
+    // 任务完成状态变化后同步连续打卡记录，并通知成就等订阅方
+    // task 为变化所涉及的任务（完成时取新状态，撤销/删除时取原状态）
+    void publishCompletionChange(bool completed, const Task& task) {
+        auto& tracker = StreakTracker::getInstance();
+        auto& bus = EventBus::getInstance();
+
+        if (completed) {
+            bus.publish(taskEvent(GameEventType::TaskCompleted, task));
+            if (tracker.recordCompletion(StreakTracker::today())) {
+                bus.publish({GameEventType::StreakChanged, 1, tracker.getCurrentStreak()});
+            }
+        } else {
+            tracker.invalidate();
+            bus.publish(taskEvent(GameEventType::TaskReopened, task));
+            bus.publish({GameEventType::StreakChanged, 1, tracker.getCurrentStreak()});
+        }
+    }
+}
+
 TaskManager::TaskManager() {
     dao = new TaskDAOImpl();
     ownDAO = true;
@@ -31,11 +57,31 @@ std::vector<Task> TaskManager::getAllTasks() {
 }
 
 bool TaskManager::updateTask(const Task& task) {
-    return dao->updateTask(task);
+    auto before = dao->getTaskById(task.getId());
+    if (!dao->updateTask(task)) return false;
+
+    if (!before.has_value()) return true;
+
+    if (before->isCompleted() != task.isCompleted()) {
+        publishCompletionChange(task.isCompleted(), task.isCompleted() ? task : *before);
+    } else if (task.isCompleted() &&
+               (before->getPriority() != task.getPriority() || before->getProjectId() != task.getProjectId())) {
+        // 已完成任务换了优先级/项目：从旧分组移到新分组，连续打卡不受影响
+        auto& bus = EventBus::getInstance();
+        bus.publish(taskEvent(GameEventType::TaskReopened, *before));
+        bus.publish(taskEvent(GameEventType::TaskCompleted, task));
+    }
+    return true;
 }
 
 bool TaskManager::deleteTask(int id) {
-    return dao->deleteTask(id);
+    auto before = dao->getTaskById(id);
+    if (!dao->deleteTask(id)) return false;
+
+    if (before.has_value() && before->isCompleted()) {
+        publishCompletionChange(false, *before);
+    }
+    return true;
 }
 
 bool TaskManager::completeTask(int id) {
@@ -43,9 +89,15 @@ bool TaskManager::completeTask(int id) {
     if (!t.has_value()) return false;
 
     Task task = t.value();
+    bool wasCompleted = task.isCompleted();
     task.markCompleted();
 
-    return dao->updateTask(task);
+    if (!dao->updateTask(task)) return false;
+
+    if (!wasCompleted) {
+        publishCompletionChange(true, task);
+    }
+    return true;
 }
 
 // Query & stats & pomodoro
@@ -69,6 +121,28 @@ std::vector<Task> TaskManager::getTodayTasks() {
     return dao->getTodayTasks();
 }
 
+std::vector<TaskSearchHit> TaskManager::searchTasks(const std::string& query, int limit, int offset,
+                                                    bool* truncated) {
+    return dao->searchTasks(query, limit, offset, truncated);
+}
+
+bool TaskManager::queryTasks(const TaskQuery& query, TaskPage& page) {
+    return dao->queryTasks(query, page);
+}
+
+// Tags
+bool TaskManager::setTaskTags(int taskId, const std::string& tags) {
+    return dao->setTaskTags(taskId, tags);
+}
+
+std::vector<Task> TaskManager::getTasksByTags(const std::vector<std::string>& tags, bool matchAll) {
+    return dao->getTasksByTags(tags, matchAll);
+}
+
+std::vector<TagCount> TaskManager::getTagCloud(int limit) {
+    return dao->getTagCounts(limit);
+}
+
 int TaskManager::getTaskCount() { return dao->countAllTasks(); }
 int TaskManager::getCompletedTaskCount() { return dao->countCompletedTasks(); }
 
@@ -77,6 +151,7 @@ double TaskManager::getCompletionRate() {
     return total == 0 ? 0 : (double)getCompletedTaskCount() / total;
 }
 
+// 只调整任务上的番茄数；番茄钟统计与成就以完成的会话为准，PomodoroCompleted 由 PomodoroEngine 发布
 bool TaskManager::addPomodoro(int taskId) {
     return dao->incrementPomodoro(taskId);
 }
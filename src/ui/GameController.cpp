@@ -3,71 +3,95 @@
 GameController::GameController(XPSystem* xp, StatisticsAnalyzer* stats, Pomodoro* pomo, AchievementManager* achieve, QObject* parent)
     : QObject(parent), m_xp(xp), m_stats(stats), m_pomo(pomo), m_achieve(achieve) {
 
+    m_state = m_pomo->getState();
+    m_lastCompleted = m_state->completedTotal;
+    if (m_state->isActive()) m_timerMode = modeName(m_state->phase);
+
+    // Ự Web ˿ʼԶһ׶Σˢ¶ʱһֱ
     m_timer = new QTimer(this);
     m_timer->setInterval(1000);
     connect(m_timer, &QTimer::timeout, this, &GameController::onTick);
+    m_timer->start();
 
     // ʼˢ
     refresh();
 }
 
 void GameController::refresh() {
+    m_xp->refreshProfile();
     emit statsChanged();
 }
 
+QString GameController::modeName(PomodoroPhase phase) {
+    switch (phase) {
+        case PomodoroPhase::Work: return "Work";
+        case PomodoroPhase::ShortBreak: return "Short";
+        case PomodoroPhase::LongBreak: return "Long";
+        default: return "Idle";
+    }
+}
+
 QString GameController::timerText() const {
-    int m = m_remainingSeconds / 60;
-    int s = m_remainingSeconds % 60;
+    const int remaining = m_state->isActive() ? m_state->remainingSeconds() : 0;
+    int m = remaining / 60;
+    int s = remaining % 60;
     return QString("%1:%2").arg(m, 2, 10, QChar('0')).arg(s, 2, 10, QChar('0'));
 }
 
 double GameController::timerProgress() const {
-    if (m_totalSeconds <= 0) return 0.0;
-    return 1.0 - (double)m_remainingSeconds / m_totalSeconds;
+    if (!m_state->isActive() || m_state->phaseSeconds <= 0) return 0.0;
+    return 1.0 - (double)m_state->remainingMs() / (m_state->phaseSeconds * 1000.0);
 }
 
 void GameController::startTimer(const QString& mode) {
-    m_timerMode = mode;
-
-    if (mode == "Work") m_remainingSeconds = 25 * 60;
-    else if (mode == "Short") m_remainingSeconds = 5 * 60;
-    else if (mode == "Long") m_remainingSeconds = 15 * 60;
-    else m_remainingSeconds = 10; // Test
+    PomodoroPhase phase = PomodoroPhase::Idle; // ״̬һ׶
+    if (mode == "Work") phase = PomodoroPhase::Work;
+    else if (mode == "Short") phase = PomodoroPhase::ShortBreak;
+    else if (mode == "Long") phase = PomodoroPhase::LongBreak;
 
-    m_totalSeconds = m_remainingSeconds;
-    m_timer->start();
+    m_pomo->start(phase);
+    m_state = m_pomo->getState();
+    m_timerMode = modeName(m_state->phase);
     emit timerChanged();
 }
 
 void GameController::stopTimer() {
-    m_timer->stop();
+    m_pomo->stop("stopped");
+    m_state = m_pomo->getState();
     m_timerMode = "Idle";
-    m_remainingSeconds = 0;
     emit timerChanged();
 }
 
 void GameController::onTick() {
-    if (m_remainingSeconds > 0) {
-        m_remainingSeconds--;
-        emit timerChanged();
+    PomodoroStatePtr previous = m_state;
+    m_state = m_pomo->getState();
+    if (m_state->revision == previous->revision) {
+        if (m_state->isRunning()) emit timerChanged();
+        return;
     }
-    else {
-        m_timer->stop();
-        emit timerFinished(m_timerMode);
+
+    // ׶һ˿ʼԶһ׶ΣʱΪ׼
+    const bool workFinished = m_state->completedTotal > m_lastCompleted;
+    const bool phaseFinished = workFinished ||
+        (previous->isActive() && m_state->phase != previous->phase && m_state->lastPhaseCompleted);
+    m_lastCompleted = m_state->completedTotal;
+
+    if (phaseFinished) {
+        emit timerFinished(workFinished ? "Work" : modeName(previous->phase));
 
         // ߼
-        if (m_timerMode == "Work") {
+        if (workFinished) {
+            // ֵ PomodoroEngine ʱεʱţֻʾ
             int xp = m_xp->getXPForPomodoro();
-            m_xp->awardXP(xp, "Pomodoro Finished");
             emit xpGained(xp, "Focus Complete!");
-
-            // Ӧõ m_pomo->addCycle() ԭʼû򵥽ӿڣݺ
+            emit statsChanged();
         }
-
-        m_timerMode = "Finished";
-        emit timerChanged();
-        emit statsChanged();
     }
+
+    if (m_state->isActive()) m_timerMode = modeName(m_state->phase);
+    else if (phaseFinished) m_timerMode = "Finished";
+    else if (previous->isActive()) m_timerMode = "Idle";
+    emit timerChanged();
 }
 
 void GameController::checkAchievements() {
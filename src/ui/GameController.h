@@ -10,6 +10,7 @@
 #include "statistics/StatisticsAnalyzer.h"
 #include "Pomodoro/pomodoro.h"
 #include "achievement/AchievementManager.h"
+#include "gamification/UserProfileCache.h"
 
 class GameController : public QObject {
     Q_OBJECT
@@ -36,24 +37,25 @@ public:
     GameController(XPSystem* xp, StatisticsAnalyzer* stats, Pomodoro* pomo, AchievementManager* achieve, QObject* parent = nullptr);
 
     // Getters
-    int currentLevel() const { return m_xp->getCurrentLevel(); }
-    int currentXP() const { return m_xp->getCurrentXP(); }
-    int nextLevelXP() const { return m_xp->getXPForNextLevel(); }
-    double levelProgress() const { return m_xp->getLevelProgress(); }
-    QString currentTitle() const { return QString::fromStdString(m_xp->getCurrentLevelTitle()); }
-    int streakDays() const { return m_stats->getCurrentStreak(); }
+    // Getters: read the in-memory profile snapshot, no database access
+    int currentLevel() const { return profile()->level; }
+    int currentXP() const { return profile()->xpIntoLevel; }
+    int nextLevelXP() const { return profile()->nextLevelXP; }
+    double levelProgress() const { return profile()->levelProgress; }
+    QString currentTitle() const { return QString::fromStdString(profile()->title); }
+    int streakDays() const { return profile()->currentStreak; }
 
-    int totalTasks() const { return m_stats->getTotalTasksCompleted(); }
-    int totalPomodoros() const { return m_stats->getTotalPomodoros(); }
+    int totalTasks() const { return profile()->totalTasksCompleted; }
+    int totalPomodoros() const { return profile()->totalPomodoros; }
 
     // Timer Getters
     QString timerText() const;
     double timerProgress() const;
-    bool isTimerRunning() const { return m_timer->isActive(); }
+    bool isTimerRunning() const { return m_pomo->getIsRunning(); }
     QString timerMode() const { return m_timerMode; }
 
     // Invokables
-    Q_INVOKABLE void startTimer(const QString& mode); // "Work", "Short", "Long"
+    Q_INVOKABLE void startTimer(const QString& mode); // "Work", "Short", "Long"ֵʼһ׶
     Q_INVOKABLE void stopTimer();
     Q_INVOKABLE void checkAchievements();
     Q_INVOKABLE void refresh();
@@ -69,14 +71,19 @@ private slots:
     void onTick();
 
 private:
+    static std::shared_ptr<const UserProfile> profile() { return UserProfileCache::getInstance().snapshot(); }
+
     XPSystem* m_xp;
     StatisticsAnalyzer* m_stats;
     Pomodoro* m_pomo;
     AchievementManager* m_achieve;
 
+    // ʱ PomodoroEngine ڷ˽У Web ˹ͬһỰֻȡˢ½
     QTimer* m_timer;
-    int m_remainingSeconds = 0;
-    int m_totalSeconds = 1;
+    PomodoroStatePtr m_state;
+    int m_lastCompleted = 0;
     QString m_timerMode = "Idle";
+
+    static QString modeName(PomodoroPhase phase);
 };
 #endif // GAMECONTROLLER_H
\ No newline at end of file
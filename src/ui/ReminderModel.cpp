@@ -19,7 +19,7 @@ QVariant ReminderModel::data(const QModelIndex& index, int role) const {
     switch (role) {
     case IdRole: return r.id;
     case TitleRole: return QString::fromStdString(r.title);
-    case TimeRole: return QString::fromStdString(r.trigger_time);
+    case TimeRole: return QString::fromStdString(r.triggerAt.toLocalString());
     case MessageRole: return QString::fromStdString(r.message);
     case RecurrenceRole: return QString::fromStdString(r.recurrence);
     case IsTriggeredRole: return r.triggered;
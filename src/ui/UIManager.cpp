@@ -25,6 +25,7 @@
 #include "project/ProjectManager.h"
 #include "task/TaskManager.h"
 #include "Pomodoro/pomodoro.h"
+#include "Pomodoro/PomodoroSessionLog.h"
 #include "reminder/ReminderSystem.h"
 #include "database/DAO/ReminderDAO.h"
 #include "achievement/AchievementManager.h"
@@ -95,7 +96,7 @@ UIManager::UIManager() {
     reminderSystem = new ReminderSystem(std::move(reminderDAO));
     
     // 初始化成就系统
-    auto achievementDAO = std::make_unique<AchievementDAO>("./data/");
+    auto achievementDAO = createAchievementDAO("./data/");
     achievementMgr = new AchievementManager(std::move(achievementDAO), 1);
     
     cout << COLOR_GREEN << "✅ UI管理器初始化成功" << COLOR_RESET << endl;
@@ -447,7 +448,7 @@ void UIManager::displayHUD() {
     int level = xpSystem->getCurrentLevel();
     int currentXP = xpSystem->getCurrentXP();
     int nextLevelXP = xpSystem->getXPForNextLevel(); 
-    string title = xpSystem->getCurrentLevelTitle();
+    std::string_view title = xpSystem->getCurrentLevelTitle();
     int achievements = statsAnalyzer->getAchievementsUnlocked();
     int streak = statsAnalyzer->getCurrentStreak();
     
@@ -1221,6 +1222,7 @@ void UIManager::startPomodoroSession() {
     cout << BOLD << "⏱️  倒计时: " << COLOR_RESET;
     cout.flush();
     
+    pomodoro->setTaskId(taskId);
     bool completed = pomodoro->startWorkWithCountdown([this, duration](int remaining) {
         int mins = remaining / 60;
         int secs = remaining % 60;
@@ -1253,20 +1255,18 @@ void UIManager::startPomodoroSession() {
         // 番茄钟完成
         cout << COLOR_GREEN << BOLD << "🎉 番茄钟完成！" << COLOR_RESET << "\n";
         
-        // 奖励XP
+        // 经验值和关联任务的番茄数已由 PomodoroEngine 在时段到期时发放，这里只显示
         int xpReward = xpSystem->getXPForPomodoro();
-        xpSystem->awardXP(xpReward, "完成番茄钟");
         cout << "  +" << COLOR_YELLOW << xpReward << " XP" << COLOR_RESET << "\n";
         
-        // 如果关联了任务，增加任务的番茄数
         if (taskId > 0) {
-            taskManager->addPomodoro(taskId);
             displaySuccess("🍅 任务番茄数 +1");
         }
         
         cout << "\n  " << COLOR_CYAN << "☕ 休息一下吧！" << COLOR_RESET << "\n";
         
-        // 显示今日番茄钟统计
+        // 显示今日番茄钟统计（会话记录异步写入，先等本次记录落库）
+        PomodoroSessionLog::getInstance().flush();
         cout << "\n  📊 今日完成番茄钟: " << statsAnalyzer->getPomodorosToday() << " 个\n";
         cout << "  🍅 累计完成番茄钟: " << pomodoro->getCycleCount() << " 个\n";
     } else {
@@ -1518,8 +1518,7 @@ void UIManager::showAllAchievements() {
     clearScreen();
     printHeader("📋 所有成就 (All Achievements)");
     
-    // 刷新成就数据
-    achievementMgr->checkAllAchievements();
+    // 成就进度由任务/番茄钟事件实时维护，直接读取
     auto allProgress = achievementMgr->getAchievementProgress(1);
     
     if (allProgress.empty()) {
@@ -1988,7 +1987,7 @@ void UIManager::listAllReminders() {
         cout << reminder.title << "\n";
         
         cout << "   📝 " << (reminder.message.empty() ? "(无内容)" : reminder.message) << "\n";
-        cout << "   ⏰ " << reminder.trigger_time;
+        cout << "   ⏰ " << reminder.triggerAt.toLocalString();
         
         // 重复规则显示
         cout << "  🔄 ";
@@ -2044,7 +2043,7 @@ void UIManager::listPendingReminders() {
         const auto& reminder = pendingReminders[i];
         
         cout << "  " << COLOR_YELLOW << "[" << (i + 1) << "]" << COLOR_RESET << " ";
-        cout << "⏰ " << reminder.trigger_time << "\n";
+        cout << "⏰ " << reminder.triggerAt.toLocalString() << "\n";
         cout << "      📌 " << BOLD << reminder.title << COLOR_RESET << "\n";
         
         if (!reminder.message.empty()) {
@@ -2097,7 +2096,7 @@ void UIManager::listTodayReminders() {
         const auto& reminder = todayReminders[i];
         
         // 时间提取 (只显示时间部分)
-        string timeOnly = reminder.trigger_time;
+        string timeOnly = reminder.triggerAt.toLocalString();
         if (timeOnly.length() >= 19) {
             timeOnly = timeOnly.substr(11, 8);  // HH:MM:SS
         }
@@ -2145,7 +2144,7 @@ void UIManager::deleteReminder() {
     for (size_t i = 0; i < reminders.size(); i++) {
         const auto& r = reminders[i];
         cout << "  " << COLOR_YELLOW << "[" << (i + 1) << "]" << COLOR_RESET << " ";
-        cout << r.title << " (" << r.trigger_time << ")\n";
+        cout << r.title << " (" << r.triggerAt.toLocalString() << ")\n";
     }
     
     cout << "  " << COLOR_RED << "[0]" << COLOR_RESET << " 取消\n";
@@ -2208,7 +2207,7 @@ void UIManager::rescheduleReminder() {
         const auto& r = pendingReminders[i];
         cout << "  " << COLOR_YELLOW << "[" << (i + 1) << "]" << COLOR_RESET << " ";
         cout << r.title << "\n";
-        cout << "      当前时间: " << COLOR_CYAN << r.trigger_time << COLOR_RESET << "\n";
+        cout << "      当前时间: " << COLOR_CYAN << r.triggerAt.toLocalString() << COLOR_RESET << "\n";
     }
     
     cout << "  " << COLOR_RED << "[0]" << COLOR_RESET << " 取消\n";
@@ -2225,7 +2224,7 @@ void UIManager::rescheduleReminder() {
     const auto& selectedReminder = pendingReminders[choice - 1];
     
     cout << "\n📌 当前提醒: " << BOLD << selectedReminder.title << COLOR_RESET << "\n";
-    cout << "⏰ 当前时间: " << selectedReminder.trigger_time << "\n\n";
+    cout << "⏰ 当前时间: " << selectedReminder.triggerAt.toLocalString() << "\n\n";
     
     // 输入新时间
     string newTime;
@@ -12,7 +12,11 @@
 #include <iostream>
 #include <vector>
 #include <cctype>
+#include <algorithm>
 #include "HeatmapVisualizer/HeatmapVisualizer.h"
+#include "gamification/UserProfileCache.h"
+#include "Pomodoro/PomodoroSessionLog.h"
+#include "task/TagRegistry.h"
 #include <filesystem>
 #include <unordered_map>
 #include <chrono>
@@ -33,6 +37,22 @@ namespace {
         return out;
     }
 
+    // 检索结果转 HTML：先转义正文，再把匹配标记换成 <mark>
+    string highlightHtml(const string& s){
+        string out;
+        for(char c: s){
+            if(c==TASK_SEARCH_MARK_BEGIN[0]) out+="<mark>";
+            else if(c==TASK_SEARCH_MARK_END[0]) out+="</mark>";
+            else if(c=='&') out+="&amp;";
+            else if(c=='<') out+="&lt;";
+            else if(c=='>') out+="&gt;";
+            else if(c=='"') out+="&quot;";
+            else if(c=='\'') out+="&#39;";
+            else out+=c;
+        }
+        return escape(out);
+    }
+
     int createServerSocket(int port) {
         int sock = ::socket(AF_INET, SOCK_STREAM, 0);
         if (sock < 0) return -1;
@@ -98,7 +118,6 @@ void WebServer::start() {
 
 void WebServer::stop() {
     running = false;
-    stopPomodoroThread();
     if (serverThread.joinable()) serverThread.join();
 }
 
@@ -202,6 +221,29 @@ std::string WebServer::handleRequest(const std::string& method,
         if (path == "/api/tasks" && method == "GET") return jsonTasks();
         if (path == "/api/tasks/overdue" && method == "GET") return jsonOverdueTasks();
         if (path == "/api/tasks/today" && method == "GET") return jsonTodayTasks();
+        if (path.rfind("/api/tasks/search", 0) == 0 && method == "GET") {
+            // 服务端全文检索，只返回一页结果；limit 限制在 1..100
+            auto it = q.find("q");
+            int limit = 20, offset = 0;
+            tryGetInt(q, "limit", limit);
+            tryGetInt(q, "offset", offset);
+            limit = std::max(1, std::min(limit, 100));
+            return jsonTaskSearch(it != q.end() ? it->second : "", limit, std::max(0, offset));
+        }
+        if (path.rfind("/api/tasks/by-tags", 0) == 0 && method == "GET") {
+            // tags 逗号分隔；mode=any 为任一匹配，默认全部匹配
+            auto tags = TagRegistry::parse(q["tags"]);
+            return jsonTaskList(taskMgr->getTasksByTags(tags, q["mode"] != "any"));
+        }
+        if (path.rfind("/api/tasks/query", 0) == 0 && method == "GET") {
+            // 组合过滤 + 游标分页，参数见 parseTaskQuery
+            TaskQuery query;
+            string error;
+            if (!parseTaskQuery(q, query, error)) { status = 400; return errorJson(error); }
+            TaskPage page;
+            if (!taskMgr->queryTasks(query, page)) return errorJson("query failed");
+            return jsonTaskPage(page);
+        }
         if (path.rfind("/api/tasks/create", 0) == 0 && method == "POST") {
             Task t(q["name"], q["desc"]);
             int priority;
@@ -226,13 +268,15 @@ std::string WebServer::handleRequest(const std::string& method,
             int priority;
             if (tryGetInt(q, "priority", priority)) task.setPriority(priority);
             if (q.count("due")) task.setDueDate(q["due"]);
-            if (q.count("tags")) task.setTags(q["tags"]);
             if (q.count("completed")) task.setCompleted(q["completed"] == "true");
             int est;
             if (tryGetInt(q, "estPomodoro", est)) task.setEstimatedPomodoros(est);
             int projectId;
             if (tryGetInt(q, "projectId", projectId)) task.setProjectId(projectId);
-            if (taskMgr->updateTask(task)) return okJson(); else return errorJson("update failed");
+            if (!taskMgr->updateTask(task)) return errorJson("update failed");
+            // 标签单独写入：同时更新 tasks.tags 与 task_tags
+            if (q.count("tags") && !taskMgr->setTaskTags(id, q["tags"])) return errorJson("update tags failed");
+            return okJson();
         }
         if (path.rfind("/api/tasks/delete", 0) == 0 && method == "POST") {
             int id;
@@ -248,7 +292,6 @@ std::string WebServer::handleRequest(const std::string& method,
                 if (t.has_value()) prio = t->getPriority();
                 int xp = xpSys->getXPForTaskCompletion(prio);
                 xpSys->awardXP(xp, "complete task");
-                achieve->checkAllAchievements();
                 return okJson();
             }
             return errorJson("complete failed");
@@ -266,6 +309,15 @@ std::string WebServer::handleRequest(const std::string& method,
         }
     }
 
+    // Tags
+    if (path.rfind("/api/tags", 0) == 0 && method == "GET") {
+        contentType = "application/json";
+        auto q = parseQuery(path);
+        int limit = 50;
+        tryGetInt(q, "limit", limit);
+        return jsonTagCloud(std::max(1, std::min(limit, 200)));
+    }
+
     // Projects
     if (path.rfind("/api/projects", 0) == 0) {
         contentType = "application/json";
@@ -301,6 +353,7 @@ std::string WebServer::handleRequest(const std::string& method,
         auto q = parseQuery(path);
         if (path == "/api/reminders" && method == "GET") return jsonReminders();
         if (path == "/api/reminders/today" && method == "GET") return jsonRemindersToday();
+        if (path == "/api/reminders/week" && method == "GET") return jsonRemindersWeek();
         if (path == "/api/reminders/pending" && method == "GET") return jsonRemindersPending();
         if (path.rfind("/api/reminders/create", 0) == 0 && method == "POST") {
             int taskId = 0;
@@ -353,44 +406,47 @@ std::string WebServer::handleRequest(const std::string& method,
     if (path.rfind("/api/pomodoro", 0) == 0) {
         contentType = "application/json";
         auto q = parseQuery(path);
-        if (path == "/api/pomodoro/state" && method == "GET") {
-            stringstream ss; ss << "{";
-            ss << "\"running\":" << (pomoRunning.load() ? "true" : "false") << ",";
-            ss << "\"cycles\":" << pomodoro->getCycleCount();
-            ss << "}";
-            return ss.str();
-        }
-        auto startThread = [this](auto fn) {
-            stopPomodoroThread();
-            pomoRunning = true;
-            pomoThread = std::thread([this, fn]() {
-                fn();
-                pomoRunning = false;
-            });
-        };
-        if (path == "/api/pomodoro/start" && method == "POST") {
-            startThread([this]() { pomodoro->startWorkWithCountdown(nullptr); });
-            return okJson();
+        // 番茄钟按 (user, session) 区分，缺省为服务进程自己的会话；每个接口都返回最新状态，
+        // 客户端按 remainingMs 对齐显示，断线重连后重新读取 state 即可恢复
+        int userId = pomodoro->getUserId();
+        tryGetInt(q, "user", userId);
+        auto sessionIt = q.find("session");
+        const string sessionId = sessionIt != q.end() && !sessionIt->second.empty() ? sessionIt->second : pomodoro->getSessionId();
+        PomodoroEngine& engine = PomodoroEngine::getInstance();
+
+        if (path.rfind("/api/pomodoro/state", 0) == 0 && method == "GET") {
+            return jsonPomodoroState(*engine.getState(userId, sessionId));
         }
-        if (path == "/api/pomodoro/break" && method == "POST") {
-            startThread([this]() { pomodoro->startBreakWithCountdown(nullptr); });
-            return okJson();
+        // 计时在共享的 TimerService 上进行，请求线程立即返回；开始新的一段会中断正在进行的计时
+        if (path.rfind("/api/pomodoro/start", 0) == 0 && method == "POST") {
+            // 可选 taskId：完成或中断时随会话记录写入 pomodoro_sessions；phase 缺省为工作，next 表示状态机的下一阶段
+            int taskId = -1;
+            if (tryGetInt(q, "taskId", taskId)) engine.setTaskId(userId, sessionId, taskId);
+            PomodoroPhase phase = PomodoroPhase::Work;
+            auto phaseIt = q.find("phase");
+            if (phaseIt != q.end() && !parsePomodoroPhase(phaseIt->second, phase)) return errorJson("bad phase");
+            return jsonPomodoroState(*engine.start(userId, sessionId, phase));
         }
-        if (path == "/api/pomodoro/longbreak" && method == "POST") {
-            startThread([this]() { pomodoro->startLongBreakWithCountdown(nullptr); });
-            return okJson();
+        if (path.rfind("/api/pomodoro/break", 0) == 0 && method == "POST") {
+            return jsonPomodoroState(*engine.start(userId, sessionId, PomodoroPhase::ShortBreak));
         }
-        if (path == "/api/pomodoro/stop" && method == "POST") {
-            pomodoro->stop();
-            stopPomodoroThread();
-            return okJson();
+        if (path.rfind("/api/pomodoro/longbreak", 0) == 0 && method == "POST") {
+            return jsonPomodoroState(*engine.start(userId, sessionId, PomodoroPhase::LongBreak));
+        }
+        if (path.rfind("/api/pomodoro/stop", 0) == 0 && method == "POST") {
+            auto it = q.find("reason");
+            return jsonPomodoroState(*engine.stop(userId, sessionId, it != q.end() ? it->second : ""));
+        }
+        if (path.rfind("/api/pomodoro/pause", 0) == 0 && method == "POST") {
+            return jsonPomodoroState(*engine.pause(userId, sessionId));
+        }
+        if (path.rfind("/api/pomodoro/resume", 0) == 0 && method == "POST") {
+            return jsonPomodoroState(*engine.resume(userId, sessionId));
         }
         if (path == "/api/pomodoro/complete" && method == "POST") {
-            // Record a completed pomodoro session and award XP
-            int xp = xpSys->getXPForPomodoro();
-            xpSys->awardXP(xp, "complete pomodoro");
-            achieve->checkAllAchievements();
-            return okJson();
+            // Completion and its XP are handled by the engine when the work phase expires;
+            // kept for older clients and only reports the current state
+            return jsonPomodoroState(*engine.getState(userId, sessionId));
         }
     }
 
@@ -463,13 +519,25 @@ std::string WebServer::handleRequest(const std::string& method,
     if (path == "/api/stats/weekly" && method == "GET") { contentType="application/json"; return jsonStatsWeekly(); }
     if (path == "/api/stats/monthly" && method == "GET") { contentType="application/json"; return jsonStatsMonthly(); }
     if (path == "/api/stats/heatmap" && method == "GET") { contentType="application/json"; return jsonStatsHeatmap(); }
+    if (path.rfind("/api/stats/pomodoro", 0) == 0 && method == "GET") {
+        contentType = "application/json";
+        auto q = parseQuery(path);
+        int days = 7, taskId = -1;
+        tryGetInt(q, "days", days);
+        tryGetInt(q, "taskId", taskId);
+        if (days < 1 || days > 366) return errorJson("days must be 1-366");
+        return jsonStatsPomodoro(days, taskId);
+    }
 
     status = 404;
     return "Not Found";
 }
 
 std::string WebServer::jsonTasks() {
-    auto tasks = taskMgr->getAllTasks();
+    return jsonTaskList(taskMgr->getAllTasks());
+}
+
+std::string WebServer::jsonTaskList(const std::vector<Task>& tasks) {
     stringstream ss;
     ss << "[";
     for (size_t i = 0; i < tasks.size(); ++i) {
@@ -503,6 +571,62 @@ std::string WebServer::jsonTasks() {
     return ss.str();
 }
 
+std::string WebServer::jsonTaskSearch(const std::string& query, int limit, int offset) {
+    // 多取一条判断是否还有下一页；命中过多时只有最新的一批可排序，分页止于这一批末尾
+    bool truncated = false;
+    auto hits = taskMgr->searchTasks(query, limit + 1, offset, &truncated);
+    const bool hasMore = hits.size() > static_cast<size_t>(limit);
+    if (hasMore) hits.pop_back();
+
+    stringstream ss;
+    ss << "{\"query\":\"" << escape(query) << "\",\"offset\":" << offset << ",\"limit\":" << limit
+       << ",\"hasMore\":" << (hasMore ? "true" : "false")
+       << ",\"truncated\":" << (truncated ? "true" : "false") << ",\"results\":[";
+    for (size_t i = 0; i < hits.size(); ++i) {
+        const auto& t = hits[i].task;
+        ss << "{"
+           << "\"id\":" << t.getId() << ","
+           << "\"name\":\"" << escape(t.getName()) << "\","
+           << "\"completed\":" << (t.isCompleted() ? "true" : "false") << ","
+           << "\"priority\":" << t.getPriority() << ","
+           << "\"due\":\"" << t.getDueDate() << "\","
+           << "\"projectId\":" << t.getProjectId().value_or(0) << ","
+           << "\"tags\":\"" << escape(t.getTags()) << "\","
+           << "\"score\":" << hits[i].score << ","
+           << "\"nameHtml\":\"" << highlightHtml(hits[i].titleHighlight) << "\","
+           << "\"snippetHtml\":\"" << highlightHtml(hits[i].snippet) << "\""
+           << "}";
+        if (i + 1 < hits.size()) ss << ",";
+    }
+    ss << "]}";
+    return ss.str();
+}
+
+std::string WebServer::jsonTagCloud(int limit) {
+    auto cloud = taskMgr->getTagCloud(limit);
+    stringstream ss;
+    ss << "[";
+    for (size_t i = 0; i < cloud.size(); ++i) {
+        ss << "{"
+           << "\"name\":\"" << escape(cloud[i].name) << "\","
+           << "\"count\":" << cloud[i].taskCount << ","
+           << "\"open\":" << cloud[i].openCount
+           << "}";
+        if (i + 1 < cloud.size()) ss << ",";
+    }
+    ss << "]";
+    return ss.str();
+}
+
+std::string WebServer::jsonTaskPage(const TaskPage& page) {
+    stringstream ss;
+    ss << "{\"tasks\":" << jsonTaskList(page.tasks) << ",\"next\":";
+    if (page.next) ss << "\"" << page.next->key << ":" << page.next->id << "\"";
+    else ss << "null";
+    ss << ",\"index\":\"" << escape(page.index) << "\"}";
+    return ss.str();
+}
+
 std::string WebServer::jsonOverdueTasks() {
     auto tasks = taskMgr->getOverdueTasks();
     stringstream ss; ss << "[";
@@ -568,7 +692,7 @@ std::string WebServer::jsonReminders() {
            << "\"id\":" << r.id << ","
            << "\"title\":\"" << escape(r.title) << "\","
            << "\"message\":\"" << escape(r.message) << "\","
-           << "\"time\":\"" << r.trigger_time << "\","
+           << "\"time\":\"" << r.triggerAt.toLocalString() << "\","
            << "\"recurrence\":\"" << r.recurrence << "\","
            << "\"taskId\":" << r.task_id << ","
            << "\"enabled\":" << (r.enabled ? "true" : "false")
@@ -579,17 +703,25 @@ std::string WebServer::jsonReminders() {
     return ss.str();
 }
 
-std::string WebServer::jsonRemindersToday() {
-    auto reminders = reminderSys->getDueRemindersForToday();
+std::string WebServer::jsonAgenda(const std::vector<ReminderOccurrence>& agenda) {
     stringstream ss; ss<<"[";
-    for(size_t i=0;i<reminders.size();++i){
-        const auto& r=reminders[i];
-        ss<<"{\"id\":"<<r.id<<",\"title\":\""<<escape(r.title)<<"\",\"time\":\""<<r.trigger_time<<"\",\"recurrence\":\""<<r.recurrence<<"\"}";
-        if(i+1<reminders.size()) ss<<",";
+    for(size_t i=0;i<agenda.size();++i){
+        const auto& r=agenda[i].reminder;
+        ss<<"{\"id\":"<<r.id<<",\"title\":\""<<escape(r.title)<<"\",\"time\":\""<<agenda[i].occursAt.toLocalString()
+          <<"\",\"recurrence\":\""<<r.recurrence<<"\"}";
+        if(i+1<agenda.size()) ss<<",";
     }
     ss<<"]"; return ss.str();
 }
 
+std::string WebServer::jsonRemindersToday() {
+    return jsonAgenda(reminderSys->getTodayAgenda());
+}
+
+std::string WebServer::jsonRemindersWeek() {
+    return jsonAgenda(reminderSys->getWeekAgenda());
+}
+
 std::string WebServer::jsonRemindersPending() {
     auto all = reminderSys->getActiveReminders();
     vector<Reminder> pending;
@@ -597,26 +729,26 @@ std::string WebServer::jsonRemindersPending() {
     stringstream ss; ss<<"[";
     for(size_t i=0;i<pending.size();++i){
         const auto& r=pending[i];
-        ss<<"{\"id\":"<<r.id<<",\"title\":\""<<escape(r.title)<<"\",\"time\":\""<<r.trigger_time<<"\",\"recurrence\":\""<<r.recurrence<<"\"}";
+        ss<<"{\"id\":"<<r.id<<",\"title\":\""<<escape(r.title)<<"\",\"time\":\""<<r.triggerAt.toLocalString()<<"\",\"recurrence\":\""<<r.recurrence<<"\"}";
         if(i+1<pending.size()) ss<<",";
     }
     ss<<"]"; return ss.str();
 }
 
 std::string WebServer::jsonXP() {
+    // 读取内存中的档案快照，不访问数据库
+    auto profile = UserProfileCache::getInstance().snapshot();
     stringstream ss; ss<<"{";
-    ss<<"\"level\":"<<xpSys->getCurrentLevel()<<",";
-    ss<<"\"xp\":"<<xpSys->getCurrentXP()<<",";
-    ss<<"\"next\":"<<xpSys->getXPForNextLevel()<<",";
-    ss<<"\"title\":\""<<xpSys->getCurrentLevelTitle()<<"\"";
+    ss<<"\"level\":"<<profile->level<<",";
+    ss<<"\"xp\":"<<profile->xpIntoLevel<<",";
+    ss<<"\"next\":"<<profile->nextLevelXP<<",";
+    ss<<"\"title\":\""<<profile->title<<"\"";
     ss<<"}";
     return ss.str();
 }
 
 std::string WebServer::jsonAchievements() {
-    // Ensure user achievements are loaded
-    achieve->checkAllAchievements();
-    
+    // Progress is kept up to date by task/pomodoro events; just read the cache
     // Get all achievement definitions
     const auto& definitions = achieve->getAllDefinitions();
     
@@ -667,6 +799,71 @@ std::string WebServer::jsonStatsSummary() {
     return ss.str();
 }
 
+std::string WebServer::jsonStatsPomodoro(int days, int taskId) {
+    // 会话记录异步批量写入，读统计前先等已结束的会话落库
+    PomodoroSessionLog::getInstance().flush();
+    StatisticsDAO& dao = stats->getStatisticsDAO();
+    auto now = std::chrono::system_clock::now();
+    auto start = now - std::chrono::hours(24 * (days - 1));
+
+    auto focusJson = [](stringstream& ss, const PomodoroFocusStats& f) {
+        ss << "\"sessions\":" << f.sessions
+           << ",\"completed\":" << f.completed
+           << ",\"interrupted\":" << f.interrupted
+           << ",\"focusMinutes\":" << f.focusMinutes
+           << ",\"interruptionRate\":" << f.interruptionRate;
+    };
+
+    stringstream ss;
+    ss << "{\"days\":[";
+    bool first = true;
+    for (const auto& day : dao.getPomodoroFocusByDay(start, days)) {
+        if (!first) ss << ",";
+        first = false;
+        ss << "{\"date\":\"" << day.date << "\",";
+        focusJson(ss, day);
+        ss << "}";
+    }
+    ss << "],\"tasks\":[";
+    first = true;
+    for (const auto& task : dao.getPomodoroFocusByTask(start, now)) {
+        if (!first) ss << ",";
+        first = false;
+        ss << "{\"taskId\":" << task.taskId << ",";
+        focusJson(ss, task);
+        ss << "}";
+    }
+    ss << "]";
+    if (taskId > 0) {
+        ss << ",\"task\":{\"taskId\":" << taskId << ",";
+        focusJson(ss, dao.getPomodoroFocusForTask(taskId));
+        ss << "}";
+    }
+    ss << "}";
+    return ss.str();
+}
+
+std::string WebServer::jsonPomodoroState(const PomodoroState& state) {
+    const std::int64_t remainingMs = state.remainingMs();
+    stringstream ss; ss << "{";
+    ss << "\"user\":" << state.userId << ",";
+    ss << "\"session\":\"" << escape(state.sessionId) << "\",";
+    ss << "\"phase\":\"" << pomodoroPhaseName(state.phase) << "\",";
+    ss << "\"nextPhase\":\"" << pomodoroPhaseName(state.nextPhase) << "\",";
+    ss << "\"running\":" << (state.isRunning() ? "true" : "false") << ",";
+    ss << "\"paused\":" << (state.paused ? "true" : "false") << ",";
+    ss << "\"remaining\":" << (remainingMs + 999) / 1000 << ",";
+    ss << "\"remainingMs\":" << remainingMs << ",";
+    ss << "\"phaseSeconds\":" << state.phaseSeconds << ",";
+    ss << "\"taskId\":" << state.taskId << ",";
+    ss << "\"completedInCycle\":" << state.completedInCycle << ",";
+    ss << "\"pomodorosUntilLongBreak\":" << state.config.pomodorosUntilLongBreak << ",";
+    ss << "\"cycles\":" << state.completedTotal << ",";
+    ss << "\"revision\":" << state.revision;
+    ss << "}";
+    return ss.str();
+}
+
 std::string WebServer::jsonStatsDaily() {
     stringstream ss; ss<<"{\"report\":\""<<escape(stats->generateDailyReport())<<"\"}";
     return ss.str();
@@ -680,8 +877,8 @@ std::string WebServer::jsonStatsMonthly() {
     return ss.str();
 }
 std::string WebServer::jsonStatsHeatmap() {
-    // Get task completion data from stats analyzer
-    auto taskData = stats->getTaskCompletionData(90);
+    // 热力图数据与 ASCII 图共用 HeatmapVisualizer 的每日缓存，tasks 表未变化时不查询数据库
+    auto taskData = heatmap->getCompletionData(90);
     
     stringstream ss;
     ss << "{\"data\":[";
@@ -756,6 +953,65 @@ bool WebServer::tryGetInt(const std::unordered_map<std::string, std::string>& q,
     }
 }
 
+bool WebServer::parseTaskQuery(const std::unordered_map<std::string, std::string>& q,
+                               TaskQuery& out,
+                               std::string& error) {
+    auto get = [&q](const char* key) {
+        auto it = q.find(key);
+        return it != q.end() ? it->second : string();
+    };
+
+    const string status = get("status");
+    if (status == "open") out.status(false);
+    else if (status == "done") out.status(true);
+    else if (!status.empty() && status != "all") { error = "invalid status"; return false; }
+
+    int value;
+    if (tryGetInt(q, "project", value)) out.project(value);
+    if (tryGetInt(q, "minPriority", value)) out.minPriority = value;
+    if (tryGetInt(q, "maxPriority", value)) out.maxPriority = value;
+
+    auto parseDay = [&](const char* key, std::optional<DayNumber>& day) {
+        const string text = get(key);
+        if (text.empty()) return true;
+        DayNumber parsed;
+        if (!DayNumber::parse(text, parsed)) { error = string("invalid ") + key; return false; }
+        day = parsed;
+        return true;
+    };
+    if (!parseDay("dueFrom", out.dueFrom) || !parseDay("dueTo", out.dueTo)) return false;
+
+    out.tags(TagRegistry::parse(get("tags")), get("tagMode") != "any");
+    out.matching(get("q"));
+
+    const string sort = get("sort");
+    if (sort == "due") out.sortBy(TaskQuery::Sort::DueDate);
+    else if (sort == "priority") out.sortBy(TaskQuery::Sort::Priority);
+    else if (!sort.empty() && sort != "newest") { error = "invalid sort"; return false; }
+
+    if (tryGetInt(q, "limit", value)) out.take(std::max(1, std::min(value, TaskQuery::MAX_LIMIT)));
+
+    // 游标为上一页返回的 "key:id"，原样传回
+    const string after = get("after");
+    if (!after.empty()) {
+        TaskCursor cursor;
+        size_t colon = after.find(':');
+        try {
+            size_t used = 0;
+            if (colon == string::npos) throw std::invalid_argument("after");
+            cursor.key = stoll(after.substr(0, colon), &used);
+            if (used != colon) throw std::invalid_argument("after");
+            cursor.id = stoi(after.substr(colon + 1), &used);
+            if (used != after.size() - colon - 1) throw std::invalid_argument("after");
+        } catch (...) {
+            error = "invalid cursor";
+            return false;
+        }
+        out.startAfter(cursor);
+    }
+    return true;
+}
+
 std::string WebServer::okJson(const std::string& msg) {
     stringstream ss; ss<<"{\"status\":\"ok\"";
     if (!msg.empty()) ss<<",\"message\":\""<<msg<<"\"";
@@ -766,11 +1022,3 @@ std::string WebServer::errorJson(const std::string& msg) {
     stringstream ss; ss<<"{\"status\":\"error\",\"message\":\""<<msg<<"\"}";
     return ss.str();
 }
-
-void WebServer::stopPomodoroThread() {
-    if (pomoThread.joinable()) {
-        pomodoro->stop();
-        pomoThread.join();
-    }
-    pomoRunning = false;
-}
@@ -51,8 +51,6 @@ private:
 
     std::thread serverThread;
     std::atomic<bool> running;
-    std::thread pomoThread;
-    std::atomic<bool> pomoRunning{false};
 
     void run();
     void handleClient(int clientSock);
@@ -65,11 +63,17 @@ private:
 
     // API helpers
     std::string jsonTasks();
+    std::string jsonTaskList(const std::vector<Task>& tasks);
     std::string jsonOverdueTasks();
     std::string jsonTodayTasks();
+    std::string jsonTaskSearch(const std::string& query, int limit, int offset);
+    std::string jsonTagCloud(int limit);
+    std::string jsonTaskPage(const TaskPage& page);
     std::string jsonProjects();
     std::string jsonReminders();
     std::string jsonRemindersToday();
+    std::string jsonRemindersWeek();
+    std::string jsonAgenda(const std::vector<ReminderOccurrence>& agenda);
     std::string jsonRemindersPending();
     std::string jsonXP();
     std::string jsonAchievements();
@@ -78,6 +82,8 @@ private:
     std::string jsonStatsWeekly();
     std::string jsonStatsMonthly();
     std::string jsonStatsHeatmap();
+    std::string jsonStatsPomodoro(int days, int taskId);
+    std::string jsonPomodoroState(const PomodoroState& state);
 
     static std::string readFile(const std::string& path);
     static bool fileExists(const std::string& path);
@@ -87,9 +93,12 @@ private:
     static bool tryGetInt(const std::unordered_map<std::string, std::string>& q,
                           const std::string& key,
                           int& out);
+    // /api/tasks/query 的参数 → TaskQuery；日期或游标无法解析时返回 false 并给出 error
+    static bool parseTaskQuery(const std::unordered_map<std::string, std::string>& q,
+                               TaskQuery& out,
+                               std::string& error);
     std::string okJson(const std::string& msg = "ok");
     std::string errorJson(const std::string& msg);
-    void stopPomodoroThread();
 };
 
 #endif
@@ -0,0 +1,228 @@
+// 重复规则（RRULE 子集）边界情况检查
+// 用法: make tests && ./bin/recurrence_tests
+// 全部通过时返回 0；失败时逐条输出期望值与实际值。夏令时用例把时区固定为 EST5EDT。
+
+#include "reminder/Recurrence.h"
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    int failures = 0;
+    int checks = 0;
+
+    void check(bool ok, const std::string& what) {
+        ++checks;
+        if (!ok) {
+            ++failures;
+            std::cerr << "FAIL: " << what << "\n";
+        }
+    }
+
+    void setTimeZone(const char* tz) {
+#ifdef _WIN32
+        _putenv_s("TZ", tz);
+        _tzset();
+#else
+        setenv("TZ", tz, 1);
+        tzset();
+#endif
+    }
+
+    std::time_t local(int y, int mo, int d, int h = 9, int mi = 0) {
+        std::tm tm = {};
+        tm.tm_year = y - 1900;
+        tm.tm_mon = mo - 1;
+        tm.tm_mday = d;
+        tm.tm_hour = h;
+        tm.tm_min = mi;
+        tm.tm_isdst = -1;
+        return std::mktime(&tm);
+    }
+
+    std::string show(std::time_t t) {
+        if (t == -1) return "none";
+        std::tm tm = {};
+        civil::toLocalTm(t, tm);
+        char buf[32];
+        std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M", &tm);
+        return buf;
+    }
+
+    RecurrenceRule rule(const std::string& text) {
+        RecurrenceRule parsed;
+        std::string error;
+        check(RecurrenceRule::parse(text, parsed, &error), "parse " + text + ": " + error);
+        return parsed;
+    }
+
+    // 从 after 起依次取 expected.size() 次触发并逐个比较，最后确认没有多余的触发
+    void expectSeries(const std::string& name, const RecurrenceSeries& series, std::time_t after,
+                      const std::vector<std::time_t>& expected, bool exhausted) {
+        std::time_t t = after;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            t = series.nextAfter(t);
+            check(t == expected[i], name + " #" + std::to_string(i + 1) + ": expected " + show(expected[i]) + ", got " + show(t));
+            if (t == -1) return;
+        }
+        if (exhausted) {
+            std::time_t extra = series.nextAfter(t);
+            check(extra == -1, name + ": expected no more occurrences, got " + show(extra));
+        }
+    }
+
+    void testParse() {
+        RecurrenceRule r = rule("FREQ=WEEKLY;INTERVAL=2;BYDAY=MO,WE");
+        check(r.freq == RecurrenceRule::Frequency::Weekly && r.interval == 2 && r.byDayMask == 0b101, "weekly fields");
+        check(rule("RRULE:FREQ=MONTHLY;BYMONTHDAY=-1").byMonthDayMask == 1u, "BYMONTHDAY=-1 is bit 0");
+        check(rule("weekly").freq == RecurrenceRule::Frequency::Weekly, "legacy weekly");
+        check(!rule("once").isRecurring(), "legacy once");
+
+        RecurrenceRule bad;
+        check(!RecurrenceRule::parse("FREQ=DAILY;COUNT=2;UNTIL=20260101", bad), "COUNT with UNTIL rejected");
+        check(!RecurrenceRule::parse("FREQ=MONTHLY;BYMONTHDAY=0", bad), "BYMONTHDAY=0 rejected");
+        check(!RecurrenceRule::parse("FREQ=DAILY;INTERVAL=0", bad), "INTERVAL=0 rejected");
+        check(!RecurrenceRule::parse("FREQ=YEARLY", bad), "YEARLY rejected");
+        check(!RecurrenceRule::parse("INTERVAL=2", bad), "missing FREQ rejected");
+        check(!RecurrenceRule::parse("FREQ=DAILY;UNTIL=20261301", bad), "invalid UNTIL month rejected");
+
+        // UTC 的 UNTIL 不依赖本地时区
+        check(rule("FREQ=DAILY;UNTIL=20261231T120000Z").until == 1798718400, "UNTIL ...Z is UTC");
+        check(rule("FREQ=DAILY;UNTIL=20260112").until == local(2026, 1, 12, 23, 59) + 59, "date-only UNTIL is end of day");
+    }
+
+    void testCount() {
+        // COUNT 从起点开始数，与查询起点无关
+        const std::time_t anchor = local(2026, 1, 10);
+        RecurrenceSeries daily(rule("FREQ=DAILY;COUNT=3"), anchor);
+        expectSeries("COUNT=3 from anchor", daily, anchor - 1,
+                     {anchor, local(2026, 1, 11), local(2026, 1, 12)}, true);
+        expectSeries("COUNT=3 queried later", daily, local(2026, 1, 11, 12),
+                     {local(2026, 1, 12)}, true);
+
+        // BYDAY 过滤后的次数才计入 COUNT：周五起点，只数周一和周五
+        RecurrenceSeries weekly(rule("FREQ=WEEKLY;BYDAY=MO,FR;COUNT=3"), local(2026, 1, 9));
+        expectSeries("weekly COUNT", weekly, local(2026, 1, 1),
+                     {local(2026, 1, 9), local(2026, 1, 12), local(2026, 1, 16)}, true);
+
+        RecurrenceSeries until(rule("FREQ=DAILY;UNTIL=20260112"), anchor);
+        expectSeries("UNTIL inclusive", until, anchor - 1,
+                     {anchor, local(2026, 1, 11), local(2026, 1, 12)}, true);
+    }
+
+    void testMonthEnd() {
+        RecurrenceSeries lastDay(rule("FREQ=MONTHLY;BYMONTHDAY=-1"), local(2024, 1, 15));
+        expectSeries("BYMONTHDAY=-1", lastDay, local(2024, 1, 1),
+                     {local(2024, 1, 31), local(2024, 2, 29), local(2024, 3, 31), local(2024, 4, 30)}, false);
+
+        // 未指定日期时超出当月天数取月末
+        RecurrenceSeries clamped(rule("FREQ=MONTHLY"), local(2025, 1, 31));
+        expectSeries("monthly clamp", clamped, local(2025, 1, 31),
+                     {local(2025, 2, 28), local(2025, 3, 31), local(2025, 4, 30)}, false);
+
+        // 显式 BYMONTHDAY=31 跳过没有 31 日的月份
+        RecurrenceSeries explicit31(rule("FREQ=MONTHLY;BYMONTHDAY=31"), local(2025, 1, 31));
+        expectSeries("BYMONTHDAY=31 skips", explicit31, local(2025, 1, 31),
+                     {local(2025, 3, 31), local(2025, 5, 31), local(2025, 7, 31)}, false);
+
+        // 闰年 2 月 29 日起点，每 12 个月：平年取 2 月 28 日
+        RecurrenceSeries leap(rule("FREQ=MONTHLY;INTERVAL=12"), local(2024, 2, 29));
+        expectSeries("leap day yearly", leap, local(2024, 2, 29),
+                     {local(2025, 2, 28), local(2026, 2, 28), local(2027, 2, 28), local(2028, 2, 29)}, false);
+    }
+
+    void testWeeklyInterval() {
+        // 周三起点，隔周的周一和周三；起点所在周的周一早于起点，不触发
+        RecurrenceSeries series(rule("FREQ=WEEKLY;INTERVAL=2;BYDAY=MO,WE"), local(2026, 1, 7));
+        expectSeries("biweekly MO,WE", series, local(2026, 1, 1),
+                     {local(2026, 1, 7), local(2026, 1, 19), local(2026, 1, 21), local(2026, 2, 2)}, false);
+
+        // 跨年：起点所在周（2026-01-05）之后每 14 天一周，2026-12-28 所在周不触发
+        expectSeries("biweekly across year", series, local(2026, 12, 24),
+                     {local(2027, 1, 4), local(2027, 1, 6), local(2027, 1, 18)}, false);
+    }
+
+    void testDaylightSaving() {
+        // EST5EDT：2026-03-08 02:00 进入夏令时，2026-11-01 02:00 退出；墙上时间保持 09:00
+        RecurrenceSeries daily(rule("FREQ=DAILY"), local(2026, 3, 7));
+        const std::time_t before = local(2026, 3, 7);
+        const std::time_t spring = daily.nextAfter(before);
+        check(spring == local(2026, 3, 8), "spring forward keeps 09:00, got " + show(spring));
+        check(spring - before == 23 * 3600, "spring forward day is 23h");
+
+        const std::time_t fallBefore = local(2026, 10, 31);
+        const std::time_t fall = daily.nextAfter(fallBefore);
+        check(fall == local(2026, 11, 1), "fall back keeps 09:00, got " + show(fall));
+        check(fall - fallBefore == 25 * 3600, "fall back day is 25h");
+
+        // 落在跳过的一小时里的墙上时间（02:30）不能让序列停住或回退
+        RecurrenceSeries gap(rule("FREQ=DAILY"), local(2026, 3, 6, 2, 30));
+        std::time_t t = gap.nextAfter(local(2026, 3, 7, 3));
+        check(t > local(2026, 3, 7, 3) && t < local(2026, 3, 9), "nonexistent 02:30 still advances, got " + show(t));
+        check(gap.nextAfter(t) == local(2026, 3, 9, 2, 30), "02:30 resumes after the gap");
+    }
+
+    // nextAfter 从 firstPeriodNear 给出的周期开始找，必须与从起点逐个展开的结果一致
+    void testSkipAheadMatchesScan() {
+        const char* rules[] = {
+            "FREQ=DAILY;INTERVAL=3",
+            "FREQ=WEEKLY;INTERVAL=2;BYDAY=MO,WE,SU",
+            "FREQ=WEEKLY;INTERVAL=3",
+            "FREQ=MONTHLY;BYMONTHDAY=-1,15",
+            "FREQ=MONTHLY;INTERVAL=5",
+            "FREQ=MONTHLY;BYDAY=FR;BYMONTHDAY=13",
+        };
+        const std::time_t anchor = local(2025, 1, 31, 8, 15);
+        for (const char* text : rules) {
+            RecurrenceSeries series(rule(text), anchor);
+            std::vector<std::time_t> all;
+            // 展开范围比探测范围多出一年以上，最后一次探测的期望值也在其中
+            for (OccurrenceIterator it(series, anchor, local(2030, 1, 1)); it.valid(); ++it) {
+                all.push_back(*it);
+            }
+            check(!all.empty(), std::string(text) + ": no occurrences");
+
+            for (std::time_t probe = anchor - 86400; probe < local(2027, 12, 1); probe += 86400 * 7 + 3671) {
+                std::time_t expected = -1;
+                for (std::time_t t : all) {
+                    if (t > probe) { expected = t; break; }
+                }
+                std::time_t got = series.nextAfter(probe);
+                if (got != expected) {
+                    check(false, std::string(text) + " after " + show(probe) + ": expected " + show(expected) + ", got " + show(got));
+                    break;
+                }
+            }
+        }
+    }
+
+    void testNextFireCache() {
+        const std::string text = "FREQ=WEEKLY;BYDAY=TU,TH";
+        RecurrenceSeries series(rule(text), local(2026, 1, 6));
+        NextFireCache cache;
+        cache.refill(text, series, local(2026, 1, 6));
+
+        std::time_t next = 0;
+        check(cache.matches(text, series.anchor()), "cache matches its rule");
+        check(!cache.matches(text + ";COUNT=2", series.anchor()), "cache invalid for another rule");
+        check(cache.lookup(local(2026, 1, 9), next) && next == local(2026, 1, 13), "cache hit, got " + show(next));
+        check(!cache.lookup(local(2026, 1, 1), next), "cache miss before its range");
+    }
+}
+
+int main() {
+    setTimeZone("EST5EDT,M3.2.0,M11.1.0");
+
+    testParse();
+    testCount();
+    testMonthEnd();
+    testWeeklyInterval();
+    testDaylightSaving();
+    testSkipAheadMatchesScan();
+    testNextFireCache();
+
+    std::cout << (checks - failures) << "/" << checks << " checks passed\n";
+    return failures == 0 ? 0 : 1;
+}